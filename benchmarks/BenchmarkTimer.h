@@ -0,0 +1,65 @@
+/*******************************************************************************
+ *  @file BenchmarkTimer.h
+ *  @brief Small timing helpers shared by the benchmark executables
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef BENCHMARK_TIMER_H
+#define BENCHMARK_TIMER_H 1
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace bench
+{
+    /*******************************************************************************
+     * bestOf
+     *
+     * @brief run fn repeatedly and return the fastest run
+     *
+     * @param repetitions number of timed runs
+     * @param fn callable to time
+     * @return fastest run in milliseconds
+     *******************************************************************************/
+    template <class Fn>
+    double bestOf(int repetitions, Fn &&fn)
+    {
+        using clock = std::chrono::steady_clock;
+
+        double best = 1e300;
+        for (int i = 0; i < repetitions; ++i)
+        {
+            auto start = clock::now();
+            fn();
+            std::chrono::duration<double, std::milli> elapsed = clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+
+        return best;
+    }
+
+    /*******************************************************************************
+     * report
+     *
+     * @brief print one result line: label, time and throughput
+     *******************************************************************************/
+    inline void report(const char *label, double ms, double bytes)
+    {
+        std::printf("%-40s %10.3f ms %10.2f GB/s\n", label, ms, bytes / (ms * 1e6));
+    }
+
+    /*******************************************************************************
+     * doNotOptimize
+     *
+     * @brief keep the compiler from discarding a computed value
+     *******************************************************************************/
+    template <class T>
+    inline void doNotOptimize(const T &value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+}
+
+#endif // BENCHMARK_TIMER_H
@@ -0,0 +1,67 @@
+// Benchmark_CompressedVector.cpp
+//
+// Sums a column of sorted 64-bit timestamps stored plainly in a Vector and
+// in a CompressedVector (decoded block by block), and reports the memory
+// each one needs.
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#include "BenchmarkTimer.h"
+#include "CompressedVector.h"
+#include "CustomVector.h"
+
+using namespace custom;
+
+int main()
+{
+    constexpr std::size_t n = std::size_t{1} << 25;
+    constexpr int repetitions = 5;
+
+    std::mt19937_64 gen(1);
+    Vector<std::uint64_t> plain;
+    CompressedVector<std::uint64_t> packed;
+    plain.reserve(n);
+
+    std::uint64_t now = 1700000000000000000ull;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        now += gen() % 100000;
+        plain.push_back(now);
+        packed.push_back(now);
+    }
+
+    std::printf("plain      %8.1f MiB\n", plain.capacity() * 8.0 / (1 << 20));
+    std::printf("compressed %8.1f MiB\n", packed.memory_usage() / double(1 << 20));
+
+    double bytes = n * sizeof(std::uint64_t);
+
+    double plain_ms = bench::bestOf(repetitions, [&]
+                                    {
+        std::uint64_t sum = 0;
+        for (std::uint64_t val : plain)
+            sum += val;
+        bench::doNotOptimize(sum); });
+    bench::report("sum Vector", plain_ms, bytes);
+
+    double block_ms = bench::bestOf(repetitions, [&]
+                                    {
+        std::uint64_t sum = 0;
+        packed.for_each_block([&](std::span<const std::uint64_t> block)
+                              {
+            for (std::uint64_t val : block)
+                sum += val; });
+        bench::doNotOptimize(sum); });
+    bench::report("sum CompressedVector (for_each_block)", block_ms, bytes);
+
+    double iter_ms = bench::bestOf(repetitions, [&]
+                                   {
+        std::uint64_t sum = 0;
+        for (std::uint64_t val : packed)
+            sum += val;
+        bench::doNotOptimize(sum); });
+    bench::report("sum CompressedVector (iterator)", iter_ms, bytes);
+
+    return 0;
+}
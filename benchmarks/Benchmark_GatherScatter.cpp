@@ -0,0 +1,90 @@
+// Benchmark_GatherScatter.cpp
+//
+// Reorders a 64-bit column by a random permutation and filters it by a
+// random mask, the way a query engine applies a sort order and a
+// predicate: plain index loops against take / scatter / apply_permutation
+// and a push_back filter against compress.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+
+#include "BenchmarkTimer.h"
+#include "BitVector.h"
+#include "CustomVector.h"
+#include "GatherScatter.h"
+
+using namespace custom;
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 24;
+    constexpr int repetitions = 5;
+
+    std::mt19937_64 gen(1);
+    Vector<std::uint64_t> column(n);
+    Vector<std::uint32_t> perm(n);
+    for (std::size_t i = 0; i < n; ++i)
+        column.data()[i] = gen();
+    std::iota(perm.data(), perm.data() + n, 0u);
+    std::shuffle(perm.data(), perm.data() + n, gen);
+
+    BitVector<> mask(n);
+    for (std::size_t i = 0; i < n; ++i)
+        mask.set(i, gen() & 1);
+
+    double bytes = 2.0 * n * sizeof(std::uint64_t);
+
+    double loop_ms = bench::bestOf(repetitions, [&]
+                                   {
+        Vector<std::uint64_t> out(n);
+        for (std::size_t i = 0; i < n; ++i)
+            out.data()[i] = column.data()[perm.data()[i]];
+        bench::doNotOptimize(out.data()); });
+    bench::report("gather loop", loop_ms, bytes);
+
+    double take_ms = bench::bestOf(repetitions, [&]
+                                   {
+        Vector<std::uint64_t> out = take(column, perm);
+        bench::doNotOptimize(out.data()); });
+    bench::report("take", take_ms, bytes);
+
+    Vector<std::uint64_t> dest(n);
+    double scatter_loop_ms = bench::bestOf(repetitions, [&]
+                                           {
+        for (std::size_t i = 0; i < n; ++i)
+            dest.data()[perm.data()[i]] = column.data()[i];
+        bench::doNotOptimize(dest.data()); });
+    bench::report("scatter loop", scatter_loop_ms, bytes);
+
+    double scatter_ms = bench::bestOf(repetitions, [&]
+                                      {
+        scatter(dest, perm, column);
+        bench::doNotOptimize(dest.data()); });
+    bench::report("scatter", scatter_ms, bytes);
+
+    double permute_ms = bench::bestOf(repetitions, [&]
+                                      {
+        apply_permutation(column, perm);
+        bench::doNotOptimize(column.data()); });
+    bench::report("apply_permutation", permute_ms, bytes);
+
+    double filter_ms = bench::bestOf(repetitions, [&]
+                                     {
+        Vector<std::uint64_t> out;
+        for (std::size_t i = 0; i < n; ++i)
+            if (mask.test(i))
+                out.push_back(column.data()[i]);
+        bench::doNotOptimize(out.data()); });
+    bench::report("filter loop", filter_ms, bytes / 2);
+
+    double compress_ms = bench::bestOf(repetitions, [&]
+                                       {
+        Vector<std::uint64_t> out = compress(column, mask);
+        bench::doNotOptimize(out.data()); });
+    bench::report("compress", compress_ms, bytes / 2);
+
+    return 0;
+}
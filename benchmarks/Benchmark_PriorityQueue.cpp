@@ -0,0 +1,75 @@
+// Benchmark_PriorityQueue.cpp
+//
+// A timer wheel workload: a queue of pending 64-bit deadlines (1M by
+// default) from which the earliest is repeatedly fired and a new deadline
+// scheduled. Compares std::priority_queue (binary heap) with
+// custom::PriorityQueue at arity 2 and 4, using pop + push and push_pop.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "BenchmarkTimer.h"
+#include "PriorityQueue.h"
+
+using namespace custom;
+
+static std::vector<std::uint64_t> deadlines(std::size_t n, std::uint64_t seed)
+{
+    std::mt19937_64 gen(seed);
+    std::vector<std::uint64_t> out(n);
+    for (std::uint64_t &d : out)
+        d = gen() % 1000000000;
+    return out;
+}
+
+template <class Queue>
+static double fire(Queue &queue, const std::vector<std::uint64_t> &delays, bool fused)
+{
+    return bench::bestOf(1, [&]
+                         {
+        std::uint64_t checksum = 0;
+        for (std::uint64_t delay : delays)
+        {
+            std::uint64_t now = queue.top();
+            if (fused)
+            {
+                if constexpr (requires { queue.push_pop(delay); })
+                    checksum += queue.push_pop(now + delay);
+            }
+            else
+            {
+                queue.pop();
+                queue.push(now + delay);
+                checksum += now;
+            }
+        }
+        bench::doNotOptimize(checksum); });
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1000000};
+    std::size_t ops = 5 * n;
+
+    std::vector<std::uint64_t> initial = deadlines(n, 1);
+    std::vector<std::uint64_t> delays = deadlines(ops, 2);
+
+    std::priority_queue<std::uint64_t, std::vector<std::uint64_t>, std::greater<>> std_queue(
+        std::greater<>(), initial);
+    PriorityQueue<std::uint64_t, std::greater<>, 2> binary(initial);
+    PriorityQueue<std::uint64_t, std::greater<>, 4> quaternary(initial);
+    PriorityQueue<std::uint64_t, std::greater<>, 4> fused(initial);
+
+    std::printf("%zu pending timers, %zu fire + reschedule operations\n", n, ops);
+    std::printf("std::priority_queue        %8.1f ms\n", fire(std_queue, delays, false));
+    std::printf("PriorityQueue<2>           %8.1f ms\n", fire(binary, delays, false));
+    std::printf("PriorityQueue<4>           %8.1f ms\n", fire(quaternary, delays, false));
+    std::printf("PriorityQueue<4> push_pop  %8.1f ms\n", fire(fused, delays, true));
+
+    return 0;
+}
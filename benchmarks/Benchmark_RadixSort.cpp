@@ -0,0 +1,100 @@
+// Benchmark_RadixSort.cpp
+//
+// Sorts a column of 64-bit timestamps (and one of uniformly random 64-bit
+// keys) with std::sort, the parallel std::sort where the standard library
+// provides one, and custom::radix_sort on one thread and on all hardware
+// threads. Pass the element count as the first argument (default 2^25).
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#if defined(BENCHMARK_HAVE_PARALLEL_STL)
+#include <execution>
+#endif
+
+#include "BenchmarkTimer.h"
+#include "CustomVector.h"
+#include "RadixSort.h"
+
+using namespace custom;
+
+namespace
+{
+    using Column = Vector<std::uint64_t>;
+
+    // time sorting a fresh copy of input; the copy is not timed
+    template <class Sort>
+    double timeSort(const Column &input, Sort sort)
+    {
+        double best = 1e300;
+        for (int i = 0; i < 3; ++i)
+        {
+            Column work(input);
+            best = std::min(best, bench::bestOf(1, [&]
+                                                { sort(work); bench::doNotOptimize(work.data()); }));
+
+            if (!std::is_sorted(work.begin(), work.end()))
+            {
+                std::printf("not sorted!\n");
+                std::exit(1);
+            }
+        }
+
+        return best;
+    }
+
+    void run(const char *name, const Column &input)
+    {
+        double bytes = input.size() * sizeof(std::uint64_t);
+        char label[64];
+
+        std::snprintf(label, sizeof(label), "%s std::sort", name);
+        bench::report(label, timeSort(input, [](Column &c)
+                                      { std::sort(c.begin(), c.end()); }),
+                      bytes);
+
+#if defined(BENCHMARK_HAVE_PARALLEL_STL)
+        std::snprintf(label, sizeof(label), "%s std::sort(par)", name);
+        bench::report(label, timeSort(input, [](Column &c)
+                                      { std::sort(std::execution::par, c.begin(), c.end()); }),
+                      bytes);
+#endif
+
+        std::snprintf(label, sizeof(label), "%s radix_sort (1 thread)", name);
+        bench::report(label, timeSort(input, [](Column &c)
+                                      { radix_sort(c, ParallelInit{.threads = 1}); }),
+                      bytes);
+
+        std::snprintf(label, sizeof(label), "%s radix_sort", name);
+        bench::report(label, timeSort(input, [](Column &c)
+                                      { radix_sort(c); }),
+                      bytes);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 25;
+    std::mt19937_64 gen(42);
+
+    // nanosecond timestamps within about a day: the top three bytes are constant
+    Column timestamps;
+    timestamps.reserve(n);
+    const std::uint64_t epoch = 1700000000ull * 1000000000ull;
+    for (std::size_t i = 0; i < n; ++i)
+        timestamps.push_back(epoch + gen() % (std::uint64_t{1} << 46));
+
+    Column random;
+    random.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        random.push_back(gen());
+
+    std::printf("%zu elements, %u hardware threads\n", n, std::thread::hardware_concurrency());
+    run("timestamps", timestamps);
+    run("random    ", random);
+
+    return 0;
+}
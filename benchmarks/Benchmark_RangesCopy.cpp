@@ -0,0 +1,45 @@
+// Benchmark_RangesCopy.cpp
+//
+// Compares std::ranges::copy / std::copy over custom::Vector iterators with
+// the same copy over raw pointers. With contiguous iterators both should run
+// at memmove speed.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <ranges>
+
+#include "BenchmarkTimer.h"
+#include "CustomVector.h"
+
+using namespace custom;
+
+int main()
+{
+    constexpr std::size_t n = 1 << 24;
+    constexpr int repetitions = 10;
+    constexpr double bytes = 2.0 * n * sizeof(std::uint32_t);
+
+    Vector<std::uint32_t> src(n, 0);
+    Vector<std::uint32_t> dst(n, 0);
+    std::iota(src.begin(), src.end(), 0u);
+
+    double raw = bench::bestOf(repetitions, [&]
+                               { std::copy(src.data(), src.data() + n, dst.data()); bench::doNotOptimize(dst.data()); });
+    bench::report("std::copy (raw pointers)", raw, bytes);
+
+    double ranges = bench::bestOf(repetitions, [&]
+                                  { std::ranges::copy(src, dst.begin()); bench::doNotOptimize(dst.data()); });
+    bench::report("std::ranges::copy (Vector)", ranges, bytes);
+
+    double iters = bench::bestOf(repetitions, [&]
+                                 { std::copy(src.begin(), src.end(), dst.begin()); bench::doNotOptimize(dst.data()); });
+    bench::report("std::copy (Vector iterators)", iters, bytes);
+
+    double fill = bench::bestOf(repetitions, [&]
+                                { std::ranges::fill(dst, 7u); bench::doNotOptimize(dst.data()); });
+    bench::report("std::ranges::fill (Vector)", fill, n * sizeof(std::uint32_t));
+
+    return 0;
+}
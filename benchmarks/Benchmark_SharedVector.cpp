@@ -0,0 +1,103 @@
+// Benchmark_SharedVector.cpp
+//
+// Hands a column of 64-bit values (256 MiB by default) to a child process
+// that sums it, the way a feed handler hands data to an analytics
+// process: written through a pipe into the child's own Vector, against
+// built in a SharedVector that the child maps (from the inherited memfd,
+// at a new address) and reads in place. Both times include the fork.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <span>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "BenchmarkTimer.h"
+#include "CustomVector.h"
+#include "SharedVector.h"
+
+using namespace custom;
+
+static std::uint64_t sum_of(std::span<const std::uint64_t> values)
+{
+    return std::accumulate(values.begin(), values.end(), std::uint64_t{0});
+}
+
+// wait for the child and check it computed the expected sum
+static void join(pid_t child)
+{
+    int status = 0;
+    if (::waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        std::fprintf(stderr, "child process failed\n");
+        std::exit(1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 25;
+    std::size_t bytes = n * sizeof(std::uint64_t);
+
+    Vector<std::uint64_t> column(n);
+    std::iota(column.data(), column.data() + n, std::uint64_t{0});
+    std::uint64_t expected = sum_of(std::span<const std::uint64_t>(column.data(), n));
+
+    double pipe_ms = bench::bestOf(3, [&]
+                                   {
+        int fds[2];
+        if (::pipe(fds) != 0)
+            std::exit(1);
+
+        pid_t child = ::fork();
+        if (child == 0)
+        {
+            ::close(fds[1]);
+            Vector<std::uint64_t> received(n);
+            char *out = reinterpret_cast<char *>(received.data());
+            for (std::size_t done = 0; done < bytes;)
+            {
+                ssize_t got = ::read(fds[0], out + done, bytes - done);
+                if (got <= 0)
+                    ::_exit(1);
+                done += got;
+            }
+            ::_exit(sum_of(std::span<const std::uint64_t>(received.data(), n)) == expected ? 0 : 1);
+        }
+
+        ::close(fds[0]);
+        const char *in = reinterpret_cast<const char *>(column.data());
+        for (std::size_t done = 0; done < bytes;)
+        {
+            ssize_t put = ::write(fds[1], in + done, bytes - done);
+            if (put <= 0)
+                std::exit(1);
+            done += put;
+        }
+        ::close(fds[1]);
+        join(child); });
+    bench::report("pipe into the reader's Vector", pipe_ms, bytes);
+
+    SharedSegment segment = SharedSegment::create(2 * bytes + (std::size_t{1} << 20));
+    auto &shared = segment.find_or_construct<SharedVector<std::uint64_t>>("column", segment);
+    shared.append_range(std::span<const std::uint64_t>(column.data(), n));
+
+    double shared_ms = bench::bestOf(3, [&]
+                                     {
+        pid_t child = ::fork();
+        if (child == 0)
+        {
+            SharedSegment mapped = SharedSegment::attach(segment.fd());
+            auto *column_view = mapped.find<SharedVector<std::uint64_t>>("column");
+            std::uint64_t sum = column_view->read([](std::span<const std::uint64_t> values)
+                                                  { return sum_of(values); });
+            ::_exit(sum == expected ? 0 : 1);
+        }
+        join(child); });
+    bench::report("SharedVector read in place", shared_ms, bytes);
+
+    return 0;
+}
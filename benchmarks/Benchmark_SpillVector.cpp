@@ -0,0 +1,66 @@
+// Benchmark_SpillVector.cpp
+//
+// Fills a SpillVector with 64-bit values (512 MiB by default) and sums it
+// a chunk at a time, once with a budget that holds everything and once
+// with a quarter of that, against a plain custom::Vector. The spilled
+// scan reads back from the page cache unless the machine is short of
+// memory, which is the case the budget is for.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+
+#include "BenchmarkTimer.h"
+#include "CustomVector.h"
+#include "SpillVector.h"
+
+using namespace custom;
+
+static void scan(const char *label, std::size_t n, std::size_t budget)
+{
+    SpillVector<std::uint64_t> v(budget);
+    double fill_ms = bench::bestOf(1, [&]
+                                   {
+        for (std::size_t i = 0; i < n; ++i)
+            v.push_back(i); });
+    bench::report(label, fill_ms, n * sizeof(std::uint64_t));
+
+    double sum_ms = bench::bestOf(3, [&]
+                                  {
+        std::uint64_t sum = 0;
+        v.for_each_chunk([&](std::span<const std::uint64_t> chunk)
+                         {
+            for (std::uint64_t x : chunk)
+                sum += x; });
+        bench::doNotOptimize(sum); });
+    bench::report("  sum", sum_ms, n * sizeof(std::uint64_t));
+    std::printf("  %zu faults, %zu evictions\n", v.faults(), v.evictions());
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 26;
+    std::size_t bytes = n * sizeof(std::uint64_t);
+
+    Vector<std::uint64_t> plain;
+    double fill_ms = bench::bestOf(1, [&]
+                                   {
+        for (std::size_t i = 0; i < n; ++i)
+            plain.push_back(i); });
+    bench::report("Vector fill", fill_ms, bytes);
+
+    double sum_ms = bench::bestOf(3, [&]
+                                  {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            sum += plain.data()[i];
+        bench::doNotOptimize(sum); });
+    bench::report("  sum", sum_ms, bytes);
+    plain = Vector<std::uint64_t>();
+
+    scan("SpillVector fill, all resident", n, bytes);
+    scan("SpillVector fill, 1/4 resident", n, bytes / 4);
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Benchmark_StreamingStore.cpp
+//
+// Times Vector fill (Vector(n, val)) and copy construction with ordinary and
+// with streaming stores over a range of sizes, to pick streaming_threshold()
+// for a machine. Then measures what a large copy costs a bystander: the time
+// to re-read a small working set that was hot before the copy.
+
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+
+#include "BenchmarkTimer.h"
+#include "CustomVector.h"
+#include "StreamingStore.h"
+
+using namespace custom;
+
+namespace
+{
+    using Word = std::uint64_t;
+
+    double timeFill(std::size_t n, int repetitions)
+    {
+        return bench::bestOf(repetitions, [&]
+                             { Vector<Word> v(n, 42); bench::doNotOptimize(v.data()); });
+    }
+
+    double timeCopy(const Vector<Word> &src, int repetitions)
+    {
+        return bench::bestOf(repetitions, [&]
+                             { Vector<Word> v(src); bench::doNotOptimize(v.data()); });
+    }
+
+    Word sum(const Vector<Word> &v)
+    {
+        return std::accumulate(v.data(), v.data() + v.size(), Word{0});
+    }
+}
+
+int main()
+{
+    const std::size_t saved = streaming_threshold();
+
+    std::printf("%-40s %10s %10s\n", "", "ms", "GB/s");
+    for (std::size_t bytes = std::size_t{1} << 20; bytes <= std::size_t{1} << 30; bytes <<= 2)
+    {
+        std::size_t n = bytes / sizeof(Word);
+        int repetitions = bytes >= (std::size_t{1} << 28) ? 3 : 10;
+        char label[64];
+
+        Vector<Word> src(n, 1);
+
+        set_streaming_threshold(SIZE_MAX);
+        std::snprintf(label, sizeof(label), "fill %6zu KiB  regular", bytes >> 10);
+        bench::report(label, timeFill(n, repetitions), bytes);
+        std::snprintf(label, sizeof(label), "copy %6zu KiB  regular", bytes >> 10);
+        bench::report(label, timeCopy(src, repetitions), 2.0 * bytes);
+
+        set_streaming_threshold(0);
+        std::snprintf(label, sizeof(label), "fill %6zu KiB  streaming", bytes >> 10);
+        bench::report(label, timeFill(n, repetitions), bytes);
+        std::snprintf(label, sizeof(label), "copy %6zu KiB  streaming", bytes >> 10);
+        bench::report(label, timeCopy(src, repetitions), 2.0 * bytes);
+    }
+
+    // bystander: a 1 MiB working set, re-read after a 512 MiB snapshot copy
+    Vector<Word> hot((std::size_t{1} << 20) / sizeof(Word), 3);
+    Vector<Word> snapshot_src((std::size_t{1} << 29) / sizeof(Word), 5);
+
+    for (std::size_t threshold : {SIZE_MAX, std::size_t{0}})
+    {
+        set_streaming_threshold(threshold);
+
+        // time only the re-read, after each copy
+        double best = 1e300;
+        for (int i = 0; i < 5; ++i)
+        {
+            bench::doNotOptimize(sum(hot));
+            {
+                Vector<Word> snapshot(snapshot_src);
+                bench::doNotOptimize(snapshot.data());
+            }
+            best = std::min(best, bench::bestOf(1, [&]
+                                                { bench::doNotOptimize(sum(hot)); }));
+        }
+        bench::report(threshold ? "hot set re-read after copy  regular" : "hot set re-read after copy  streaming",
+                      best, hot.size() * sizeof(Word));
+    }
+
+    set_streaming_threshold(saved);
+
+    return 0;
+}
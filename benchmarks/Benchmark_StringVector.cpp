@@ -0,0 +1,85 @@
+// Benchmark_StringVector.cpp
+//
+// Builds a dictionary of short tokens (3-20 characters) as a
+// Vector<std::string> and as a StringVector, then counts the tokens with a
+// given prefix in each. Prints build time, scan time and the heap bytes
+// each layout needs.
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "BenchmarkTimer.h"
+#include "CustomVector.h"
+#include "StringVector.h"
+
+using namespace custom;
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{10000000};
+    constexpr int repetitions = 5;
+
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> length(3, 20), letter('a', 'z');
+    StringVector<> source;
+    std::string token;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        token.resize(length(gen));
+        for (char &c : token)
+            c = static_cast<char>(letter(gen));
+        source.push_back(token);
+    }
+
+    // heap bytes beyond the vector of strings itself: libstdc++ keeps up
+    // to 15 characters inline and allocates the rest
+    std::size_t long_bytes = 0;
+    for (std::string_view s : source)
+        long_bytes += s.size() > 15 ? s.size() + 1 : 0;
+
+    std::size_t hits = 0;
+
+    double strings_build_ms = bench::bestOf(repetitions, [&]
+                                            {
+        Vector<std::string> strings;
+        for (std::string_view s : source)
+            strings.push_back(std::string(s));
+        bench::doNotOptimize(strings.data()); });
+    bench::report("Vector<string> build", strings_build_ms, source.char_count());
+
+    double tokens_build_ms = bench::bestOf(repetitions, [&]
+                                           {
+        StringVector<> tokens;
+        for (std::string_view s : source)
+            tokens.push_back(s);
+        bench::doNotOptimize(tokens.char_count()); });
+    bench::report("StringVector build", tokens_build_ms, source.char_count());
+
+    Vector<std::string> strings;
+    strings.reserve(n);
+    for (std::string_view s : source)
+        strings.push_back(std::string(s));
+
+    double strings_scan_ms = bench::bestOf(repetitions, [&]
+                                           {
+        std::size_t count = 0;
+        for (const std::string &s : strings)
+            count += s.starts_with("ab");
+        hits = count;
+        bench::doNotOptimize(hits); });
+    bench::report("Vector<string> prefix", strings_scan_ms, source.char_count());
+
+    double tokens_scan_ms = bench::bestOf(repetitions, [&]
+                                          {
+        hits = source.count_prefix("ab");
+        bench::doNotOptimize(hits); });
+    bench::report("StringVector prefix", tokens_scan_ms, source.char_count());
+
+    std::printf("%zu tokens, %zu with prefix \"ab\"\n", n, hits);
+    std::printf("Vector<string> %8.1f MiB\n", (n * sizeof(std::string) + long_bytes) / 1048576.0);
+    std::printf("StringVector   %8.1f MiB\n", (source.char_count() + (n + 1) * 4) / 1048576.0);
+
+    return 0;
+}
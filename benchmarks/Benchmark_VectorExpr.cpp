@@ -0,0 +1,59 @@
+// Benchmark_VectorExpr.cpp
+//
+// Computes out = where(price > 0, sqrt(volume) * price + bias, 0) over
+// float columns twice: as a chain of per-operation loops with a temporary
+// Vector per step, and as one fused expression template.
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "BenchmarkTimer.h"
+#include "CustomVector.h"
+#include "VectorExpr.h"
+
+using namespace custom;
+
+int main()
+{
+    constexpr std::size_t n = std::size_t{1} << 24;
+    constexpr int repetitions = 10;
+    constexpr float bias = 0.5f;
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<float> dist(-1.f, 100.f);
+    Vector<float> price(n), volume(n), out(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        price.data()[i] = dist(gen);
+        volume.data()[i] = std::abs(dist(gen));
+    }
+
+    // three input/output columns per pass
+    double bytes = 3.0 * n * sizeof(float);
+
+    double chained_ms = bench::bestOf(repetitions, [&]
+                                      {
+        Vector<float> root(n), scaled(n), shifted(n);
+        const float *p = price.data(), *v = volume.data();
+
+        for (std::size_t i = 0; i < n; ++i)
+            root.data()[i] = std::sqrt(v[i]);
+        for (std::size_t i = 0; i < n; ++i)
+            scaled.data()[i] = root.data()[i] * p[i];
+        for (std::size_t i = 0; i < n; ++i)
+            shifted.data()[i] = scaled.data()[i] + bias;
+        for (std::size_t i = 0; i < n; ++i)
+            out.data()[i] = p[i] > 0.f ? shifted.data()[i] : 0.f;
+
+        bench::doNotOptimize(out.data()); });
+    bench::report("per-operation loops", chained_ms, bytes);
+
+    double fused_ms = bench::bestOf(repetitions, [&]
+                                    {
+        out = where(price > 0.f, sqrt(volume) * price + bias, 0.f);
+        bench::doNotOptimize(out.data()); });
+    bench::report("fused expression", fused_ms, bytes);
+
+    return 0;
+}
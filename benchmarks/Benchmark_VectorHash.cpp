@@ -0,0 +1,102 @@
+// Benchmark_VectorHash.cpp
+//
+// Hashes the keys of a result cache that is keyed on whole vectors: one
+// large 64-bit column (64 MiB by default) and a million 16-int keys, each
+// hashed element by element through at() with a boost-style combine, the
+// way the cache did it, and with hash(v). Then removes duplicates from a
+// column of 32-bit ids with a copy + sort + unique against dedup().
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+
+#include "BenchmarkTimer.h"
+#include "CustomVector.h"
+
+using namespace custom;
+
+template <class T>
+static std::size_t hash_through_at(const Vector<T> &v)
+{
+    std::size_t h = v.size();
+    for (std::size_t i = 0; i < v.size(); ++i)
+        h ^= std::hash<T>{}(v.at(i)) + 0x9E3779B9 + (h << 6) + (h >> 2);
+    return h;
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 23;
+    constexpr int repetitions = 5;
+
+    std::mt19937_64 gen(1);
+    Vector<std::uint64_t> column(n);
+    for (std::size_t i = 0; i < n; ++i)
+        column.data()[i] = gen();
+
+    double column_bytes = n * sizeof(std::uint64_t);
+
+    double at_ms = bench::bestOf(repetitions, [&]
+                                 { bench::doNotOptimize(hash_through_at(column)); });
+    bench::report("column, element by element", at_ms, column_bytes);
+
+    double hash_ms = bench::bestOf(repetitions, [&]
+                                   { bench::doNotOptimize(hash(column)); });
+    bench::report("column, hash(v)", hash_ms, column_bytes);
+
+    constexpr std::size_t key_count = 1 << 20;
+    Vector<Vector<int>> keys;
+    keys.reserve(key_count);
+    for (std::size_t k = 0; k < key_count; ++k)
+    {
+        Vector<int> key(16);
+        for (int &x : key)
+            x = static_cast<int>(gen());
+        keys.push_back(std::move(key));
+    }
+
+    double keys_bytes = key_count * 16.0 * sizeof(int);
+
+    double keys_at_ms = bench::bestOf(repetitions, [&]
+                                      {
+        std::size_t sum = 0;
+        for (const Vector<int> &key : keys)
+            sum += hash_through_at(key);
+        bench::doNotOptimize(sum); });
+    bench::report("16-int keys, element by element", keys_at_ms, keys_bytes);
+
+    double keys_hash_ms = bench::bestOf(repetitions, [&]
+                                        {
+        std::size_t sum = 0;
+        for (const Vector<int> &key : keys)
+            sum += hash(key);
+        bench::doNotOptimize(sum); });
+    bench::report("16-int keys, hash(v)", keys_hash_ms, keys_bytes);
+
+    // ids drawn from a range of n / 16, so most are repeats
+    Vector<std::uint32_t> ids(n);
+    for (std::size_t i = 0; i < n; ++i)
+        ids.data()[i] = static_cast<std::uint32_t>(gen() % (n / 16));
+
+    double ids_bytes = n * sizeof(std::uint32_t);
+
+    double sort_ms = bench::bestOf(repetitions, [&]
+                                   {
+        Vector<std::uint32_t> work = ids;
+        std::sort(work.data(), work.data() + work.size());
+        work.unique_sorted();
+        bench::doNotOptimize(work.size()); });
+    bench::report("ids, copy + sort + unique", sort_ms, ids_bytes);
+
+    double dedup_ms = bench::bestOf(repetitions, [&]
+                                    {
+        Vector<std::uint32_t> work = ids;
+        work.dedup();
+        bench::doNotOptimize(work.size()); });
+    bench::report("ids, copy + dedup", dedup_ms, ids_bytes);
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+// Benchmark_ZeroedVector.cpp
+//
+// Builds a large zero-initialized histogram, increments a sparse set of
+// buckets and releases it, once on the default allocator (which fills
+// every element) and once on MallocAllocator (whose calloc'd block is
+// left to the kernel's zero pages). Reports the time and the growth of
+// the process's resident set during the run.
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "BenchmarkTimer.h"
+#include "CustomVector.h"
+#include "MallocAllocator.h"
+
+using namespace custom;
+
+// current resident set size in MiB, from /proc/self/statm
+static double residentMiB()
+{
+    std::ifstream statm("/proc/self/statm");
+    double pages = 0, resident = 0;
+    statm >> pages >> resident;
+
+    return resident * 4096 / (1 << 20);
+}
+
+template <class Alloc>
+static void run(const char *label, std::size_t n, std::size_t stride)
+{
+    double peak = 0;
+    double before = residentMiB();
+
+    double ms = bench::bestOf(5, [&]
+                              {
+        Vector<std::uint32_t, Alloc> histogram(n);
+        for (std::size_t i = 0; i < n; i += stride)
+            ++histogram[i];
+
+        peak = residentMiB() - before;
+        bench::doNotOptimize(histogram.data()); });
+
+    std::printf("%-40s %10.3f ms %10.1f MiB resident\n", label, ms, peak);
+}
+
+int main()
+{
+    // 1 GiB of 32-bit buckets, one bucket in every 64 KiB written
+    constexpr std::size_t n = std::size_t{1} << 28;
+    constexpr std::size_t stride = std::size_t{1} << 14;
+
+    run<std::allocator<std::uint32_t>>("Vector(n) std::allocator", n, stride);
+    run<MallocAllocator<std::uint32_t>>("Vector(n) MallocAllocator", n, stride);
+
+    return 0;
+}
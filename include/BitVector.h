@@ -0,0 +1,620 @@
+/*******************************************************************************
+ *  @file BitVector.h
+ *  @brief This file contains methods that define and implement a bit-packed
+ *  vector of flags with word-at-a-time operations
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef BIT_VECTOR_H
+#define BIT_VECTOR_H 1
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "CustomVector.h"
+
+namespace custom
+{
+    /*******************************************************************************
+     * class BitVector
+     *
+     *  @brief A dynamic array of flags packed 64 to a word
+     *
+     *  Uses one bit per flag instead of the byte per flag of Vector<bool>.
+     *  Bulk queries (count, any, all, none, find_first, find_next) and the
+     *  bitwise operators work on whole 64-bit words, so a scan touches 1/8th
+     *  of the memory and handles 64 flags per iteration in loops the compiler
+     *  can vectorize.
+     *
+     *  Invariant: bits of the last word past size() are always zero, so word
+     *  level operations never need to mask anything but the tail on writes.
+     *
+     *  @tparam AllocType  Allocator type, default value is allocator<uint64_t>.
+     *
+     *******************************************************************************/
+    template <typename AllocType = std::allocator<std::uint64_t>>
+    class BitVector
+    {
+    public:
+        using size_type = size_t;
+        using word_type = std::uint64_t;
+        using value_type = bool;
+
+        static constexpr size_type bits_per_word = 64;
+        static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+        /*******************************************************************************
+         * class Reference
+         *
+         *  @brief proxy returned by the non-const operator[], behaves like bool&
+         *******************************************************************************/
+        class Reference
+        {
+        public:
+            Reference(word_type *word, word_type mask) : m_word(word), m_mask(mask) {}
+
+            operator bool() const noexcept { return (*m_word & m_mask) != 0; }
+
+            Reference &operator=(bool val) noexcept
+            {
+                if (val)
+                    *m_word |= m_mask;
+                else
+                    *m_word &= ~m_mask;
+                return *this;
+            }
+            Reference &operator=(const Reference &other) noexcept { return *this = bool(other); }
+
+            void flip() noexcept { *m_word ^= m_mask; }
+
+        private:
+            word_type *m_word;
+            word_type m_mask;
+        };
+
+        /*******************************************************************************
+         * class Const_Iterator
+         *
+         *  @brief read-only iterator yielding each flag as a bool
+         *******************************************************************************/
+        class Const_Iterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = bool;
+            using pointer = void;
+            using reference = bool;
+
+            Const_Iterator() = default;
+            Const_Iterator(const BitVector *vec, size_type idx) : m_vec(vec), m_idx(idx) {}
+
+            bool operator*() const { return m_vec->test(m_idx); }
+            bool operator[](difference_type n) const { return m_vec->test(m_idx + n); }
+
+            Const_Iterator &operator++()
+            {
+                ++m_idx;
+                return *this;
+            }
+            Const_Iterator operator++(int)
+            {
+                Const_Iterator temp = *this;
+                ++m_idx;
+                return temp;
+            }
+            Const_Iterator &operator--()
+            {
+                --m_idx;
+                return *this;
+            }
+            Const_Iterator operator--(int)
+            {
+                Const_Iterator temp = *this;
+                --m_idx;
+                return temp;
+            }
+            Const_Iterator &operator+=(difference_type n)
+            {
+                m_idx += n;
+                return *this;
+            }
+            Const_Iterator &operator-=(difference_type n)
+            {
+                m_idx -= n;
+                return *this;
+            }
+
+            Const_Iterator operator+(difference_type n) const { return Const_Iterator(m_vec, m_idx + n); }
+            Const_Iterator operator-(difference_type n) const { return Const_Iterator(m_vec, m_idx - n); }
+            friend Const_Iterator operator+(difference_type n, const Const_Iterator &it) { return it + n; }
+
+            friend difference_type operator-(const Const_Iterator &a, const Const_Iterator &b)
+            {
+                return static_cast<difference_type>(a.m_idx) - static_cast<difference_type>(b.m_idx);
+            }
+
+            friend bool operator==(const Const_Iterator &a, const Const_Iterator &b) { return a.m_idx == b.m_idx; }
+            friend auto operator<=>(const Const_Iterator &a, const Const_Iterator &b) { return a.m_idx <=> b.m_idx; }
+
+        private:
+            const BitVector *m_vec = nullptr;
+            size_type m_idx = 0;
+        };
+
+        using reference = Reference;
+        using const_iterator = Const_Iterator;
+        using iterator = const_iterator;
+
+        BitVector(const AllocType &alloc = AllocType());
+        BitVector(std::initializer_list<bool> ilist, const AllocType &alloc = AllocType());
+        explicit BitVector(size_type n, bool val = false, const AllocType &alloc = AllocType());
+
+        // Element Access
+        bool test(size_type idx) const noexcept
+        {
+            return (m_words.data()[idx / bits_per_word] >> (idx % bits_per_word)) & 1;
+        }
+        bool at(size_type idx) const;
+        bool operator[](size_type idx) const noexcept { return test(idx); }
+        Reference operator[](size_type idx) noexcept
+        {
+            return Reference(m_words.data() + idx / bits_per_word, word_type{1} << (idx % bits_per_word));
+        }
+
+        // Modifiers
+        void set(size_type idx, bool val = true) noexcept { (*this)[idx] = val; }
+        void reset(size_type idx) noexcept { (*this)[idx] = false; }
+        void flip(size_type idx) noexcept { (*this)[idx].flip(); }
+        BitVector &set() noexcept;
+        BitVector &reset() noexcept;
+        BitVector &flip() noexcept;
+
+        void push_back(bool val);
+        void pop_back();
+        void resize(size_type n, bool val = false);
+        void clear() noexcept;
+
+        // Word Level Queries
+        size_type count() const noexcept;
+        bool any() const noexcept;
+        bool none() const noexcept { return !any(); }
+        bool all() const noexcept;
+        size_type find_first() const noexcept { return find_next_from(0); }
+        size_type find_next(size_type pos) const noexcept;
+
+        // Bitwise Operations (sizes must match)
+        BitVector &operator&=(const BitVector &other);
+        BitVector &operator|=(const BitVector &other);
+        BitVector &operator^=(const BitVector &other);
+        BitVector operator~() const;
+
+        friend BitVector operator&(BitVector a, const BitVector &b) { return a &= b; }
+        friend BitVector operator|(BitVector a, const BitVector &b) { return a |= b; }
+        friend BitVector operator^(BitVector a, const BitVector &b) { return a ^= b; }
+        friend bool operator==(const BitVector &a, const BitVector &b) noexcept
+        {
+            return a.size() == b.size() &&
+                   std::equal(a.m_words.data(), a.m_words.data() + a.word_count(), b.m_words.data());
+        }
+
+        // Size and Capacity
+        size_type size() const noexcept { return m_size; }
+        bool empty() const noexcept { return m_size == 0; }
+        size_type capacity() const noexcept { return m_words.capacity() * bits_per_word; }
+        void reserve(size_type n) { m_words.reserve(words_for(n)); }
+
+        // Raw Word Access
+        size_type word_count() const noexcept { return m_words.size(); }
+        std::span<const word_type> words() const noexcept { return {m_words.data(), m_words.size()}; }
+
+        friend void swap(BitVector &a, BitVector &b) noexcept
+        {
+            swap(a.m_words, b.m_words);
+            std::swap(a.m_size, b.m_size);
+        }
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator cbegin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, m_size); }
+        const_iterator cend() const { return const_iterator(this, m_size); }
+
+    private:
+        static constexpr size_type words_for(size_type bits) noexcept
+        {
+            return (bits + bits_per_word - 1) / bits_per_word;
+        }
+
+        size_type find_next_from(size_type pos) const noexcept;
+        void check_same_size(const BitVector &other) const;
+        void clear_tail() noexcept;
+
+        Vector<word_type, AllocType> m_words;
+        size_type m_size = 0;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    BIT VECTOR METHODS  -------------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * default constructor
+     *
+     * @param alloc allocator
+     *******************************************************************************/
+    template <typename A>
+    BitVector<A>::BitVector(const A &alloc)
+        : m_words{alloc}
+    {
+    }
+
+    /*******************************************************************************
+     * @brief initializer_list constructor
+     *
+     * @param ilist list of flags
+     * @param alloc allocator
+     *******************************************************************************/
+    template <typename A>
+    BitVector<A>::BitVector(std::initializer_list<bool> ilist, const A &alloc)
+        : m_words{alloc}
+    {
+        reserve(ilist.size());
+
+        for (bool val : ilist)
+            push_back(val);
+    }
+
+    /*******************************************************************************
+     * @brief parameter constructor
+     *
+     * @param n number of flags
+     * @param val initial value of every flag
+     * @param alloc allocator
+     *******************************************************************************/
+    template <typename A>
+    BitVector<A>::BitVector(size_type n, bool val, const A &alloc)
+        : m_words{words_for(n), val ? ~word_type{0} : word_type{0}, alloc}, m_size{n}
+    {
+        clear_tail();
+    }
+
+    /*******************************************************************************
+     * at
+     *
+     * @return flag at idx, bounds checked
+     *******************************************************************************/
+    template <typename A>
+    bool BitVector<A>::at(size_type idx) const
+    {
+        if (idx >= size())
+            throw std::out_of_range("Invalid index");
+
+        return test(idx);
+    }
+
+    /*******************************************************************************
+     * set
+     *
+     * @brief set every flag
+     *******************************************************************************/
+    template <typename A>
+    BitVector<A> &BitVector<A>::set() noexcept
+    {
+        std::fill_n(m_words.data(), word_count(), ~word_type{0});
+        clear_tail();
+
+        return *this;
+    }
+
+    /*******************************************************************************
+     * reset
+     *
+     * @brief clear every flag
+     *******************************************************************************/
+    template <typename A>
+    BitVector<A> &BitVector<A>::reset() noexcept
+    {
+        std::fill_n(m_words.data(), word_count(), word_type{0});
+
+        return *this;
+    }
+
+    /*******************************************************************************
+     * flip
+     *
+     * @brief invert every flag
+     *******************************************************************************/
+    template <typename A>
+    BitVector<A> &BitVector<A>::flip() noexcept
+    {
+        word_type *words = m_words.data();
+        for (size_type i = 0, n = word_count(); i < n; ++i)
+            words[i] = ~words[i];
+
+        clear_tail();
+
+        return *this;
+    }
+
+    /*******************************************************************************
+     * push_back
+     *
+     * @brief append a flag
+     *******************************************************************************/
+    template <typename A>
+    void BitVector<A>::push_back(bool val)
+    {
+        if (m_size % bits_per_word == 0)
+            m_words.push_back(0);
+
+        ++m_size;
+        set(m_size - 1, val);
+    }
+
+    /*******************************************************************************
+     * pop_back
+     *
+     * @brief remove the last flag
+     *******************************************************************************/
+    template <typename A>
+    void BitVector<A>::pop_back()
+    {
+        if (empty())
+            throw std::out_of_range(__PRETTY_FUNCTION__ + std::string(": BitVector is empty"));
+
+        reset(m_size - 1);
+        --m_size;
+
+        if (m_size % bits_per_word == 0)
+            m_words.pop_back();
+    }
+
+    /*******************************************************************************
+     * resize
+     *
+     * @param n number of flags after the call
+     * @param val value of any added flags
+     *******************************************************************************/
+    template <typename A>
+    void BitVector<A>::resize(size_type n, bool val)
+    {
+        size_type old_size = m_size;
+        size_type old_words = word_count();
+
+        m_words.resize(words_for(n), val ? ~word_type{0} : word_type{0});
+        m_size = n;
+
+        // the old tail word had its unused bits cleared
+        if (val && n > old_size && old_size % bits_per_word != 0)
+            m_words.data()[old_words - 1] |= ~word_type{0} << (old_size % bits_per_word);
+
+        clear_tail();
+    }
+
+    /*******************************************************************************
+     * clear
+     *
+     * @brief remove every flag
+     *******************************************************************************/
+    template <typename A>
+    void BitVector<A>::clear() noexcept
+    {
+        m_words.clear();
+        m_size = 0;
+    }
+
+    /*******************************************************************************
+     * count
+     *
+     * @return number of set flags
+     *******************************************************************************/
+    template <typename A>
+    typename BitVector<A>::size_type BitVector<A>::count() const noexcept
+    {
+        const word_type *words = m_words.data();
+        size_type n = word_count();
+        size_type i = 0;
+
+        // independent accumulators so consecutive popcounts can overlap
+        size_type c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            c0 += std::popcount(words[i]);
+            c1 += std::popcount(words[i + 1]);
+            c2 += std::popcount(words[i + 2]);
+            c3 += std::popcount(words[i + 3]);
+        }
+        for (; i < n; ++i)
+            c0 += std::popcount(words[i]);
+
+        return c0 + c1 + c2 + c3;
+    }
+
+    /*******************************************************************************
+     * any
+     *
+     * @return true if at least one flag is set
+     *******************************************************************************/
+    template <typename A>
+    bool BitVector<A>::any() const noexcept
+    {
+        const word_type *words = m_words.data();
+        size_type n = word_count();
+
+        // test 8 words per branch
+        size_type i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            word_type acc = 0;
+            for (size_type j = 0; j < 8; ++j)
+                acc |= words[i + j];
+            if (acc)
+                return true;
+        }
+        for (; i < n; ++i)
+            if (words[i])
+                return true;
+
+        return false;
+    }
+
+    /*******************************************************************************
+     * all
+     *
+     * @return true if every flag is set (also true when empty)
+     *******************************************************************************/
+    template <typename A>
+    bool BitVector<A>::all() const noexcept
+    {
+        const word_type *words = m_words.data();
+        size_type full_words = m_size / bits_per_word;
+
+        for (size_type i = 0; i < full_words; ++i)
+            if (~words[i])
+                return false;
+
+        size_type tail = m_size % bits_per_word;
+
+        return tail == 0 || words[full_words] == (word_type{1} << tail) - 1;
+    }
+
+    /*******************************************************************************
+     * find_next
+     *
+     * @param pos flag to search after
+     * @return index of the first set flag after pos, or npos
+     *******************************************************************************/
+    template <typename A>
+    typename BitVector<A>::size_type BitVector<A>::find_next(size_type pos) const noexcept
+    {
+        if (pos >= m_size)
+            return npos;
+
+        return find_next_from(pos + 1);
+    }
+
+    /*******************************************************************************
+     * find_next_from
+     *
+     * @return index of the first set flag at or after pos, or npos
+     *******************************************************************************/
+    template <typename A>
+    typename BitVector<A>::size_type BitVector<A>::find_next_from(size_type pos) const noexcept
+    {
+        if (pos >= m_size)
+            return npos;
+
+        const word_type *words = m_words.data();
+        size_type i = pos / bits_per_word;
+
+        // drop the flags before pos in the first word
+        word_type word = words[i] & (~word_type{0} << (pos % bits_per_word));
+
+        for (size_type n = word_count(); !word;)
+        {
+            if (++i == n)
+                return npos;
+            word = words[i];
+        }
+
+        return i * bits_per_word + std::countr_zero(word);
+    }
+
+    /*******************************************************************************
+     * bitwise and / or / xor assignment
+     *
+     * @brief combine other into this vector, one word at a time
+     *******************************************************************************/
+    template <typename A>
+    BitVector<A> &BitVector<A>::operator&=(const BitVector &other)
+    {
+        check_same_size(other);
+
+        word_type *words = m_words.data();
+        const word_type *other_words = other.m_words.data();
+        for (size_type i = 0, n = word_count(); i < n; ++i)
+            words[i] &= other_words[i];
+
+        return *this;
+    }
+
+    template <typename A>
+    BitVector<A> &BitVector<A>::operator|=(const BitVector &other)
+    {
+        check_same_size(other);
+
+        word_type *words = m_words.data();
+        const word_type *other_words = other.m_words.data();
+        for (size_type i = 0, n = word_count(); i < n; ++i)
+            words[i] |= other_words[i];
+
+        return *this;
+    }
+
+    template <typename A>
+    BitVector<A> &BitVector<A>::operator^=(const BitVector &other)
+    {
+        check_same_size(other);
+
+        word_type *words = m_words.data();
+        const word_type *other_words = other.m_words.data();
+        for (size_type i = 0, n = word_count(); i < n; ++i)
+            words[i] ^= other_words[i];
+
+        return *this;
+    }
+
+    /*******************************************************************************
+     * bitwise not
+     *
+     * @return copy with every flag inverted
+     *******************************************************************************/
+    template <typename A>
+    BitVector<A> BitVector<A>::operator~() const
+    {
+        BitVector result(*this);
+        result.flip();
+
+        return result;
+    }
+
+    /*******************************************************************************
+     * check_same_size
+     *
+     * @brief throw if other does not hold the same number of flags
+     *******************************************************************************/
+    template <typename A>
+    void BitVector<A>::check_same_size(const BitVector &other) const
+    {
+        if (size() != other.size())
+            throw std::invalid_argument("BitVector: operands differ in size");
+    }
+
+    /*******************************************************************************
+     * clear_tail
+     *
+     * @brief zero the bits of the last word past size()
+     *******************************************************************************/
+    template <typename A>
+    void BitVector<A>::clear_tail() noexcept
+    {
+        size_type tail = m_size % bits_per_word;
+
+        if (tail != 0)
+            m_words.data()[word_count() - 1] &= (word_type{1} << tail) - 1;
+    }
+}
+
+#endif // BIT_VECTOR_H
@@ -0,0 +1,457 @@
+/*******************************************************************************
+ *  @file CachingAllocator.h
+ *  @brief This file contains methods that define and implement a per-thread
+ *  cache of recently released memory blocks, and an allocator using it
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef CACHING_ALLOCATOR_H
+#define CACHING_ALLOCATOR_H 1
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace custom
+{
+    /*******************************************************************************
+     * struct BlockCacheStats
+     *
+     *  @brief counters describing how well the block cache is working
+     *
+     *  hits          allocations served from the calling thread's cache
+     *  central_hits  allocations served from the shared central depot
+     *  misses        allocations that went to the global allocator
+     *  releases      blocks handed back to the global allocator
+     *  bytes_cached  bytes currently held by the cache
+     *******************************************************************************/
+    struct BlockCacheStats
+    {
+        std::size_t hits = 0;
+        std::size_t central_hits = 0;
+        std::size_t misses = 0;
+        std::size_t releases = 0;
+        std::size_t bytes_cached = 0;
+    };
+
+    /*******************************************************************************
+     * class BlockCache
+     *
+     *  @brief Thread-local free lists of memory blocks, by power-of-two size
+     *
+     *  Requests are rounded up to a power of two (at least 16 bytes) and a
+     *  freed block is pushed onto the calling thread's free list for its size
+     *  class instead of being returned to the global allocator. A vector that
+     *  is destroyed and recreated in a loop therefore gets its block back
+     *  without a lock or a call to operator new.
+     *
+     *  Each thread cache holds at most a bounded number of bytes. Blocks that
+     *  do not fit spill into a mutex protected central depot (also bounded),
+     *  and a thread whose own list is empty looks there before falling back to
+     *  operator new. The depot is the cross-thread return path: memory freed
+     *  by a consumer thread can be reused by the producer that allocated it.
+     *  A thread's cache is moved to the depot when the thread exits.
+     *
+     *  Blocks larger than max_block_bytes, or needing more than the default
+     *  new alignment, bypass the cache.
+     *******************************************************************************/
+    class BlockCache
+    {
+    public:
+        static constexpr std::size_t min_block_shift = 4;
+        static constexpr std::size_t max_block_shift = 26;
+        static constexpr std::size_t max_block_bytes = std::size_t{1} << max_block_shift;
+        static constexpr std::size_t default_thread_budget = std::size_t{8} << 20;
+        static constexpr std::size_t default_central_budget = std::size_t{64} << 20;
+
+        static void *allocate(std::size_t bytes, std::size_t alignment);
+        static void deallocate(void *block, std::size_t bytes, std::size_t alignment) noexcept;
+
+        // Tuning and statistics
+        static BlockCacheStats thread_stats() noexcept;
+        static BlockCacheStats central_stats() noexcept;
+        static void set_thread_budget(std::size_t bytes) noexcept;
+        static void set_central_budget(std::size_t bytes) noexcept;
+        static void trim() noexcept;
+
+    private:
+        static constexpr std::size_t num_classes = max_block_shift - min_block_shift + 1;
+
+        struct Free_Block
+        {
+            Free_Block *next;
+        };
+
+        struct Free_Lists
+        {
+            // pop a block of class c, or nullptr
+            void *pop(std::size_t c) noexcept;
+            void push(std::size_t c, void *block) noexcept;
+
+            Free_Block *heads[num_classes] = {};
+            std::size_t bytes = 0;
+            std::size_t budget = 0;
+        };
+
+        struct Central_Depot
+        {
+            std::mutex lock;
+            Free_Lists lists{.budget = default_central_budget};
+            BlockCacheStats stats;
+        };
+
+        struct Thread_Cache
+        {
+            ~Thread_Cache();
+
+            Free_Lists lists{.budget = default_thread_budget};
+            BlockCacheStats stats;
+        };
+
+        static constexpr bool cacheable(std::size_t bytes, std::size_t alignment) noexcept
+        {
+            return bytes <= max_block_bytes && alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+        }
+
+        static constexpr std::size_t size_class(std::size_t bytes) noexcept
+        {
+            if (bytes <= (std::size_t{1} << min_block_shift))
+                return 0;
+
+            return std::bit_width(bytes - 1) - min_block_shift;
+        }
+
+        static constexpr std::size_t class_bytes(std::size_t c) noexcept
+        {
+            return std::size_t{1} << (c + min_block_shift);
+        }
+
+        static Central_Depot &central() noexcept;
+        static Thread_Cache *local() noexcept;
+        static void release_to_central(std::size_t c, void *block) noexcept;
+
+        // set once this thread's cache has been destroyed
+        static inline thread_local bool thread_cache_destroyed = false;
+    };
+
+    /*******************************************************************************
+     * class CachingAllocator
+     *
+     *  @brief Standard allocator drawing its blocks from BlockCache
+     *
+     *  Use it as the AllocType of a Vector (or any allocator aware container)
+     *  whose instances are short-lived and frequently recreated:
+     *
+     *      custom::Vector<int, custom::CachingAllocator<int>> scratch;
+     *
+     *  All instances are interchangeable, so the allocator is stateless and
+     *  always compares equal.
+     *
+     *  @tparam T  Type of element.
+     *
+     *******************************************************************************/
+    template <class T>
+    class CachingAllocator
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using is_always_equal = std::true_type;
+
+        CachingAllocator() noexcept = default;
+
+        template <class U>
+        CachingAllocator(const CachingAllocator<U> &) noexcept
+        {
+        }
+
+        T *allocate(size_type n)
+        {
+            if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+                throw std::bad_array_new_length();
+
+            return static_cast<T *>(BlockCache::allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *block, size_type n) noexcept
+        {
+            BlockCache::deallocate(block, n * sizeof(T), alignof(T));
+        }
+
+        template <class U>
+        friend bool operator==(const CachingAllocator &, const CachingAllocator<U> &) noexcept
+        {
+            return true;
+        }
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    BLOCK CACHE METHODS  ------------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * allocate
+     *
+     * @brief get a block of at least bytes bytes
+     *
+     * Tries the thread cache, then the central depot, then operator new.
+     *
+     * @return pointer to the block
+     *******************************************************************************/
+    inline void *BlockCache::allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (!cacheable(bytes, alignment))
+            return ::operator new(bytes, std::align_val_t(alignment));
+
+        std::size_t c = size_class(bytes);
+        Thread_Cache *cache = local();
+
+        if (cache)
+        {
+            if (void *block = cache->lists.pop(c))
+            {
+                ++cache->stats.hits;
+                return block;
+            }
+        }
+
+        Central_Depot &depot = central();
+        {
+            std::lock_guard<std::mutex> guard(depot.lock);
+            if (void *block = depot.lists.pop(c))
+            {
+                ++depot.stats.central_hits;
+                if (cache)
+                    ++cache->stats.central_hits;
+                return block;
+            }
+            ++depot.stats.misses;
+        }
+
+        if (cache)
+            ++cache->stats.misses;
+
+        return ::operator new(class_bytes(c));
+    }
+
+    /*******************************************************************************
+     * deallocate
+     *
+     * @brief give a block back to the cache
+     *
+     * @param block block returned by allocate
+     * @param bytes, alignment the values passed to allocate
+     *******************************************************************************/
+    inline void BlockCache::deallocate(void *block, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if (!block)
+            return;
+
+        if (!cacheable(bytes, alignment))
+        {
+            ::operator delete(block, std::align_val_t(alignment));
+            return;
+        }
+
+        std::size_t c = size_class(bytes);
+        Thread_Cache *cache = local();
+
+        if (cache && cache->lists.bytes + class_bytes(c) <= cache->lists.budget)
+        {
+            cache->lists.push(c, block);
+            return;
+        }
+
+        release_to_central(c, block);
+    }
+
+    /*******************************************************************************
+     * thread_stats
+     *
+     * @return counters of the calling thread's cache
+     *******************************************************************************/
+    inline BlockCacheStats BlockCache::thread_stats() noexcept
+    {
+        Thread_Cache *cache = local();
+        if (!cache)
+            return {};
+
+        BlockCacheStats stats = cache->stats;
+        stats.bytes_cached = cache->lists.bytes;
+
+        return stats;
+    }
+
+    /*******************************************************************************
+     * central_stats
+     *
+     * @return counters of the central depot, covering all threads
+     *******************************************************************************/
+    inline BlockCacheStats BlockCache::central_stats() noexcept
+    {
+        Central_Depot &depot = central();
+        std::lock_guard<std::mutex> guard(depot.lock);
+
+        BlockCacheStats stats = depot.stats;
+        stats.bytes_cached = depot.lists.bytes;
+
+        return stats;
+    }
+
+    /*******************************************************************************
+     * set_thread_budget
+     *
+     * @brief limit the bytes cached by the calling thread
+     *
+     * Blocks over the new budget are released immediately.
+     *******************************************************************************/
+    inline void BlockCache::set_thread_budget(std::size_t bytes) noexcept
+    {
+        Thread_Cache *cache = local();
+        if (!cache)
+            return;
+
+        cache->lists.budget = bytes;
+
+        // release the largest blocks first
+        for (std::size_t c = num_classes; c-- > 0 && cache->lists.bytes > bytes;)
+            while (cache->lists.bytes > bytes && cache->lists.heads[c])
+                release_to_central(c, cache->lists.pop(c));
+    }
+
+    /*******************************************************************************
+     * set_central_budget
+     *
+     * @brief limit the bytes held by the central depot
+     *******************************************************************************/
+    inline void BlockCache::set_central_budget(std::size_t bytes) noexcept
+    {
+        Central_Depot &depot = central();
+        std::lock_guard<std::mutex> guard(depot.lock);
+
+        depot.lists.budget = bytes;
+
+        for (std::size_t c = num_classes; c-- > 0 && depot.lists.bytes > bytes;)
+        {
+            while (depot.lists.bytes > bytes && depot.lists.heads[c])
+            {
+                ::operator delete(depot.lists.pop(c));
+                ++depot.stats.releases;
+            }
+        }
+    }
+
+    /*******************************************************************************
+     * trim
+     *
+     * @brief move every block cached by the calling thread to the central depot
+     *******************************************************************************/
+    inline void BlockCache::trim() noexcept
+    {
+        Thread_Cache *cache = local();
+        if (!cache)
+            return;
+
+        for (std::size_t c = 0; c < num_classes; ++c)
+            while (cache->lists.heads[c])
+                release_to_central(c, cache->lists.pop(c));
+    }
+
+    /*******************************************************************************
+     * Free_Lists::pop / push
+     *
+     * @brief intrusive singly linked free lists; the link lives in the block
+     *******************************************************************************/
+    inline void *BlockCache::Free_Lists::pop(std::size_t c) noexcept
+    {
+        Free_Block *head = heads[c];
+        if (!head)
+            return nullptr;
+
+        heads[c] = head->next;
+        bytes -= class_bytes(c);
+
+        return head;
+    }
+
+    inline void BlockCache::Free_Lists::push(std::size_t c, void *block) noexcept
+    {
+        heads[c] = ::new (block) Free_Block{heads[c]};
+        bytes += class_bytes(c);
+    }
+
+    /*******************************************************************************
+     * Thread_Cache destructor
+     *
+     * @brief hand the exiting thread's blocks to the central depot
+     *******************************************************************************/
+    inline BlockCache::Thread_Cache::~Thread_Cache()
+    {
+        thread_cache_destroyed = true;
+
+        for (std::size_t c = 0; c < num_classes; ++c)
+            while (lists.heads[c])
+                release_to_central(c, lists.pop(c));
+    }
+
+    /*******************************************************************************
+     * central
+     *
+     * @return the process-wide depot
+     *******************************************************************************/
+    inline BlockCache::Central_Depot &BlockCache::central() noexcept
+    {
+        // never destroyed, so threads exiting during static
+        // destruction can still return their blocks
+        static Central_Depot *depot = new Central_Depot;
+
+        return *depot;
+    }
+
+    /*******************************************************************************
+     * local
+     *
+     * @return the calling thread's cache, or nullptr once it has been destroyed
+     *******************************************************************************/
+    inline BlockCache::Thread_Cache *BlockCache::local() noexcept
+    {
+        if (thread_cache_destroyed)
+            return nullptr;
+
+        thread_local Thread_Cache cache;
+
+        return &cache;
+    }
+
+    /*******************************************************************************
+     * release_to_central
+     *
+     * @brief store block in the depot, or free it when the depot is full
+     *******************************************************************************/
+    inline void BlockCache::release_to_central(std::size_t c, void *block) noexcept
+    {
+        Central_Depot &depot = central();
+        {
+            std::lock_guard<std::mutex> guard(depot.lock);
+            if (depot.lists.bytes + class_bytes(c) <= depot.lists.budget)
+            {
+                depot.lists.push(c, block);
+                return;
+            }
+            ++depot.stats.releases;
+        }
+
+        if (Thread_Cache *cache = local())
+            ++cache->stats.releases;
+
+        ::operator delete(block);
+    }
+}
+
+#endif // CACHING_ALLOCATOR_H
@@ -0,0 +1,614 @@
+/*******************************************************************************
+ *  @file CircularVector.h
+ *  @brief This file contains methods that define and implement a ring buffer
+ *  with constant time insertion and removal at both ends
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef CIRCULAR_VECTOR_H
+#define CIRCULAR_VECTOR_H 1
+
+#include <algorithm>
+#include <compare>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "CustomVector.h"
+
+namespace custom
+{
+    /*******************************************************************************
+     * class CircularVector
+     *
+     *  @brief A ring buffer with O(1) push and pop at both ends and random
+     *  access, stored in a single Vector_Memory_Manager block
+     *
+     *  Elements occupy the block from a moving head index, wrapping around at
+     *  the end, so queue-style use never shifts elements the way
+     *  Vector::erase(begin()) does. When the block is full the ring either
+     *  grows, moving the elements once into a block of twice the size in
+     *  logical order, or (Overflow::overwrite_oldest, fixed capacity) drops
+     *  the element at the opposite end: push_back drops the front and
+     *  push_front drops the back.
+     *
+     *  as_spans() exposes the (at most two) contiguous segments for bulk
+     *  I/O; linearize() makes them one.
+     *
+     *  @tparam T  Type of element.
+     *  @tparam AllocType  Allocator type, default value is allocator<T>.
+     *
+     *******************************************************************************/
+    template <class T, typename AllocType = std::allocator<T>>
+    class CircularVector
+    {
+    public:
+        using size_type = size_t;
+        using value_type = T;
+
+        enum class Overflow
+        {
+            grow,
+            overwrite_oldest
+        };
+
+        /*******************************************************************************
+         * class Basic_Iterator
+         *
+         *  @brief random access iterator over logical positions of a CircularVector
+         *******************************************************************************/
+        template <bool IsConst>
+        class Basic_Iterator
+        {
+            using container_type = std::conditional_t<IsConst, const CircularVector, CircularVector>;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = T;
+            using pointer = std::conditional_t<IsConst, const T *, T *>;
+            using reference = std::conditional_t<IsConst, const T &, T &>;
+
+            Basic_Iterator() = default;
+            Basic_Iterator(container_type *ring, size_type idx) : m_ring(ring), m_idx(idx) {}
+
+            // allow iterator -> const_iterator conversion
+            template <bool OtherConst>
+                requires(IsConst && !OtherConst)
+            Basic_Iterator(const Basic_Iterator<OtherConst> &other)
+                : m_ring(other.m_ring), m_idx(other.m_idx)
+            {
+            }
+
+            reference operator*() const { return (*m_ring)[m_idx]; }
+            pointer operator->() const { return &(*m_ring)[m_idx]; }
+            reference operator[](difference_type n) const { return (*m_ring)[m_idx + n]; }
+
+            Basic_Iterator &operator++()
+            {
+                ++m_idx;
+                return *this;
+            }
+            Basic_Iterator operator++(int)
+            {
+                Basic_Iterator temp = *this;
+                ++m_idx;
+                return temp;
+            }
+            Basic_Iterator &operator--()
+            {
+                --m_idx;
+                return *this;
+            }
+            Basic_Iterator operator--(int)
+            {
+                Basic_Iterator temp = *this;
+                --m_idx;
+                return temp;
+            }
+
+            Basic_Iterator &operator+=(difference_type n)
+            {
+                m_idx += n;
+                return *this;
+            }
+            Basic_Iterator &operator-=(difference_type n)
+            {
+                m_idx -= n;
+                return *this;
+            }
+
+            Basic_Iterator operator+(difference_type n) const { return Basic_Iterator(m_ring, m_idx + n); }
+            Basic_Iterator operator-(difference_type n) const { return Basic_Iterator(m_ring, m_idx - n); }
+            friend Basic_Iterator operator+(difference_type n, const Basic_Iterator &it) { return it + n; }
+
+            friend difference_type operator-(const Basic_Iterator &a, const Basic_Iterator &b)
+            {
+                return static_cast<difference_type>(a.m_idx) - static_cast<difference_type>(b.m_idx);
+            }
+
+            friend bool operator==(const Basic_Iterator &a, const Basic_Iterator &b) { return a.m_idx == b.m_idx; }
+            friend auto operator<=>(const Basic_Iterator &a, const Basic_Iterator &b) { return a.m_idx <=> b.m_idx; }
+
+        private:
+            template <bool>
+            friend class Basic_Iterator;
+
+            container_type *m_ring = nullptr;
+            size_type m_idx = 0;
+        };
+
+        using iterator = Basic_Iterator<false>;
+        using const_iterator = Basic_Iterator<true>;
+
+        CircularVector(const AllocType &alloc = AllocType());
+        explicit CircularVector(size_type capacity, Overflow overflow = Overflow::grow,
+                                const AllocType &alloc = AllocType());
+        CircularVector(std::initializer_list<T> ilist, const AllocType &alloc = AllocType());
+
+        CircularVector(const CircularVector &other);
+        CircularVector(CircularVector &&other) noexcept;
+
+        CircularVector &operator=(const CircularVector &other);
+        CircularVector &operator=(CircularVector &&other) noexcept;
+
+        ~CircularVector() { clear(); }
+
+        // Element Access
+        T &at(size_type idx);
+        const T &at(size_type idx) const;
+
+        T &operator[](size_type idx) { return m_mem.block_start[physical(idx)]; }
+        const T &operator[](size_type idx) const { return m_mem.block_start[physical(idx)]; }
+        T &front() { return at(0); }
+        const T &front() const { return at(0); }
+        T &back() { return at(m_size - 1); }
+        const T &back() const { return at(m_size - 1); }
+
+        // Modifiers
+        void push_back(const T &val) { emplace_back(val); }
+        void push_back(T &&val) { emplace_back(std::move(val)); }
+        void push_front(const T &val) { emplace_front(val); }
+        void push_front(T &&val) { emplace_front(std::move(val)); }
+        template <class... Args>
+        T &emplace_back(Args &&...args);
+        template <class... Args>
+        T &emplace_front(Args &&...args);
+        void pop_back();
+        void pop_front();
+        void clear();
+
+        // Bulk Access
+        std::pair<std::span<T>, std::span<T>> as_spans() noexcept;
+        std::pair<std::span<const T>, std::span<const T>> as_spans() const noexcept;
+        std::span<T> linearize();
+
+        // Size and Capacity
+        void reserve(size_type);
+        size_type size() const noexcept { return m_size; }
+        size_type capacity() const noexcept { return m_mem.block_end - m_mem.block_start; }
+        bool empty() const noexcept { return m_size == 0; }
+        bool full() const noexcept { return m_size == capacity(); }
+        Overflow overflow() const noexcept { return m_overflow; }
+
+        friend void swap(CircularVector &a, CircularVector &b) noexcept
+        {
+            using std::swap;
+
+            swap(a.m_mem, b.m_mem);
+            swap(a.m_head, b.m_head);
+            swap(a.m_size, b.m_size);
+            swap(a.m_overflow, b.m_overflow);
+        }
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        iterator begin() noexcept { return iterator(this, 0); }
+        const_iterator begin() const noexcept { return const_iterator(this, 0); }
+        const_iterator cbegin() const noexcept { return const_iterator(this, 0); }
+        iterator end() noexcept { return iterator(this, m_size); }
+        const_iterator end() const noexcept { return const_iterator(this, m_size); }
+        const_iterator cend() const noexcept { return const_iterator(this, m_size); }
+
+    private:
+        // block index of logical position idx (idx <= capacity)
+        size_type physical(size_type idx) const noexcept
+        {
+            size_type pos = m_head + idx;
+            return pos >= capacity() ? pos - capacity() : pos;
+        }
+
+        size_type next_capacity() const noexcept { return capacity() ? 2 * capacity() : 8; }
+        void move_into(T *dest);
+        void relocate(size_type new_capacity);
+
+        Vector_Memory_Manager<T, AllocType> m_mem;
+        size_type m_head = 0;
+        size_type m_size = 0;
+        Overflow m_overflow = Overflow::grow;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    CIRCULAR VECTOR METHODS  --------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * default constructor
+     *
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, typename A>
+    CircularVector<T, A>::CircularVector(const A &alloc)
+        : m_mem{alloc, 0}
+    {
+    }
+
+    /*******************************************************************************
+     * @brief capacity constructor
+     *
+     * @param capacity number of elements the block holds
+     * @param overflow what a push onto a full ring does
+     * @param alloc allocator
+     *
+     * @throw std::invalid_argument for overwrite_oldest with zero capacity
+     *******************************************************************************/
+    template <class T, typename A>
+    CircularVector<T, A>::CircularVector(size_type capacity, Overflow overflow, const A &alloc)
+        : m_mem{alloc, capacity}, m_overflow{overflow}
+    {
+        if (overflow == Overflow::overwrite_oldest && capacity == 0)
+            throw std::invalid_argument("CircularVector: overwrite_oldest needs a capacity");
+    }
+
+    /*******************************************************************************
+     * @brief initializer_list constructor
+     *
+     * @param ilist list of type T objects
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, typename A>
+    CircularVector<T, A>::CircularVector(std::initializer_list<T> ilist, const A &alloc)
+        : m_mem{alloc, ilist.size()}
+    {
+        std::uninitialized_copy(ilist.begin(), ilist.end(), m_mem.block_start);
+        m_size = ilist.size();
+    }
+
+    /*******************************************************************************
+     * copy constructor
+     *
+     * @brief copy other's elements, linearized, into a block of the same capacity
+     *******************************************************************************/
+    template <class T, typename A>
+    CircularVector<T, A>::CircularVector(const CircularVector &other)
+        : m_mem{other.m_mem.alloc, other.capacity()}, m_overflow{other.m_overflow}
+    {
+        auto [first, second] = other.as_spans();
+        T *dest = std::uninitialized_copy(first.begin(), first.end(), m_mem.block_start);
+
+        try
+        {
+            std::uninitialized_copy(second.begin(), second.end(), dest);
+        }
+        catch (...)
+        {
+            std::destroy(m_mem.block_start, dest);
+            throw;
+        }
+
+        m_size = other.m_size;
+    }
+
+    /*******************************************************************************
+     * @brief move constructor
+     *******************************************************************************/
+    template <class T, typename A>
+    CircularVector<T, A>::CircularVector(CircularVector &&other) noexcept
+        : m_mem{other.m_mem.alloc, 0}
+    {
+        swap(*this, other);
+    }
+
+    /*******************************************************************************
+     * copy assignment operator
+     *******************************************************************************/
+    template <class T, typename A>
+    CircularVector<T, A> &CircularVector<T, A>::operator=(const CircularVector &other)
+    {
+        // copy-and-swap
+        CircularVector temp(other);
+        swap(*this, temp);
+
+        return *this;
+    }
+
+    /*******************************************************************************
+     * @brief move assignment operator
+     *******************************************************************************/
+    template <class T, typename A>
+    CircularVector<T, A> &CircularVector<T, A>::operator=(CircularVector &&other) noexcept
+    {
+        swap(*this, other);
+
+        return *this;
+    }
+
+    /*******************************************************************************
+     * at
+     *
+     * @brief bounds checked access to logical position idx
+     *******************************************************************************/
+    template <class T, typename A>
+    T &CircularVector<T, A>::at(size_type idx)
+    {
+        if (idx >= m_size)
+            throw std::out_of_range("CircularVector: index out of range");
+
+        return (*this)[idx];
+    }
+
+    template <class T, typename A>
+    const T &CircularVector<T, A>::at(size_type idx) const
+    {
+        if (idx >= m_size)
+            throw std::out_of_range("CircularVector: index out of range");
+
+        return (*this)[idx];
+    }
+
+    /*******************************************************************************
+     * emplace_back
+     *
+     * @brief construct an element after the last one
+     *
+     * On a full ring this grows, or in overwrite_oldest mode replaces the
+     * front element (the new element is built before the old one is
+     * destroyed, so args may refer to it).
+     *
+     * @return reference to the new element
+     *******************************************************************************/
+    template <class T, typename A>
+    template <class... Args>
+    T &CircularVector<T, A>::emplace_back(Args &&...args)
+    {
+        if (!full())
+        {
+            T *elem = std::construct_at(m_mem.block_start + physical(m_size), std::forward<Args>(args)...);
+            ++m_size;
+            return *elem;
+        }
+
+        if (m_overflow == Overflow::overwrite_oldest)
+        {
+            T val(std::forward<Args>(args)...);
+            T *slot = m_mem.block_start + m_head;
+
+            std::destroy_at(slot);
+            std::construct_at(slot, std::move(val));
+            m_head = physical(1);
+            return *slot;
+        }
+
+        Vector_Memory_Manager<T, A> next{m_mem.alloc, next_capacity()};
+        T *elem = std::construct_at(next.block_start + m_size, std::forward<Args>(args)...);
+
+        try
+        {
+            move_into(next.block_start);
+        }
+        catch (...)
+        {
+            std::destroy_at(elem);
+            throw;
+        }
+
+        size_type count = m_size + 1;
+        clear();
+        swap(m_mem, next);
+        m_size = count;
+
+        return *elem;
+    }
+
+    /*******************************************************************************
+     * emplace_front
+     *
+     * @brief construct an element before the first one
+     *
+     * On a full ring this grows, or in overwrite_oldest mode replaces the
+     * back element.
+     *
+     * @return reference to the new element
+     *******************************************************************************/
+    template <class T, typename A>
+    template <class... Args>
+    T &CircularVector<T, A>::emplace_front(Args &&...args)
+    {
+        if (!full())
+        {
+            size_type slot = m_head ? m_head - 1 : capacity() - 1;
+            T *elem = std::construct_at(m_mem.block_start + slot, std::forward<Args>(args)...);
+            m_head = slot;
+            ++m_size;
+            return *elem;
+        }
+
+        if (m_overflow == Overflow::overwrite_oldest)
+        {
+            T val(std::forward<Args>(args)...);
+            size_type slot = m_head ? m_head - 1 : capacity() - 1;
+
+            // on a full ring the slot before the head holds the back element
+            std::destroy_at(m_mem.block_start + slot);
+            T *elem = std::construct_at(m_mem.block_start + slot, std::move(val));
+            m_head = slot;
+            return *elem;
+        }
+
+        Vector_Memory_Manager<T, A> next{m_mem.alloc, next_capacity()};
+        T *elem = std::construct_at(next.block_start, std::forward<Args>(args)...);
+
+        try
+        {
+            move_into(next.block_start + 1);
+        }
+        catch (...)
+        {
+            std::destroy_at(elem);
+            throw;
+        }
+
+        size_type count = m_size + 1;
+        clear();
+        swap(m_mem, next);
+        m_size = count;
+
+        return *elem;
+    }
+
+    /*******************************************************************************
+     * pop_back
+     *
+     * @brief destroy the last element
+     *******************************************************************************/
+    template <class T, typename A>
+    void CircularVector<T, A>::pop_back()
+    {
+        if (m_size == 0)
+            throw std::out_of_range("CircularVector: pop_back on empty ring");
+
+        std::destroy_at(m_mem.block_start + physical(m_size - 1));
+        --m_size;
+    }
+
+    /*******************************************************************************
+     * pop_front
+     *
+     * @brief destroy the first element
+     *******************************************************************************/
+    template <class T, typename A>
+    void CircularVector<T, A>::pop_front()
+    {
+        if (m_size == 0)
+            throw std::out_of_range("CircularVector: pop_front on empty ring");
+
+        std::destroy_at(m_mem.block_start + m_head);
+        m_head = physical(1);
+        --m_size;
+    }
+
+    /*******************************************************************************
+     * clear
+     *
+     * @brief destroy all elements, keeping the block
+     *******************************************************************************/
+    template <class T, typename A>
+    void CircularVector<T, A>::clear()
+    {
+        auto [first, second] = as_spans();
+        std::destroy(first.begin(), first.end());
+        std::destroy(second.begin(), second.end());
+
+        m_head = 0;
+        m_size = 0;
+    }
+
+    /*******************************************************************************
+     * as_spans
+     *
+     * @return the elements as two contiguous segments in logical order; the
+     *  second is empty unless the elements wrap around the end of the block
+     *******************************************************************************/
+    template <class T, typename A>
+    std::pair<std::span<T>, std::span<T>> CircularVector<T, A>::as_spans() noexcept
+    {
+        T *head = m_mem.block_start + m_head;
+        size_type first = std::min(m_size, capacity() - m_head);
+
+        return {std::span<T>(head, first), std::span<T>(m_mem.block_start, m_size - first)};
+    }
+
+    template <class T, typename A>
+    std::pair<std::span<const T>, std::span<const T>> CircularVector<T, A>::as_spans() const noexcept
+    {
+        const T *head = m_mem.block_start + m_head;
+        size_type first = std::min(m_size, capacity() - m_head);
+
+        return {std::span<const T>(head, first), std::span<const T>(m_mem.block_start, m_size - first)};
+    }
+
+    /*******************************************************************************
+     * linearize
+     *
+     * @brief make the elements contiguous, moving them only if they wrap
+     *
+     * @return span over all elements in logical order
+     *******************************************************************************/
+    template <class T, typename A>
+    std::span<T> CircularVector<T, A>::linearize()
+    {
+        if (m_head + m_size > capacity())
+            relocate(capacity());
+
+        return as_spans().first;
+    }
+
+    /*******************************************************************************
+     * reserve
+     *
+     * @brief make room for at least n elements
+     *******************************************************************************/
+    template <class T, typename A>
+    void CircularVector<T, A>::reserve(size_type n)
+    {
+        if (n > capacity())
+            relocate(n);
+    }
+
+    /*******************************************************************************
+     * move_into
+     *
+     * @brief move-construct the elements, in logical order, to dest
+     *******************************************************************************/
+    template <class T, typename A>
+    void CircularVector<T, A>::move_into(T *dest)
+    {
+        auto [first, second] = as_spans();
+        T *next = std::uninitialized_move(first.begin(), first.end(), dest);
+
+        try
+        {
+            std::uninitialized_move(second.begin(), second.end(), next);
+        }
+        catch (...)
+        {
+            std::destroy(dest, next);
+            throw;
+        }
+    }
+
+    /*******************************************************************************
+     * relocate
+     *
+     * @brief move the elements to the start of a new block
+     *******************************************************************************/
+    template <class T, typename A>
+    void CircularVector<T, A>::relocate(size_type new_capacity)
+    {
+        Vector_Memory_Manager<T, A> next{m_mem.alloc, new_capacity};
+        move_into(next.block_start);
+
+        size_type count = m_size;
+        clear();
+        swap(m_mem, next);
+        m_size = count;
+    }
+}
+
+#endif // CIRCULAR_VECTOR_H
@@ -0,0 +1,550 @@
+/*******************************************************************************
+ *  @file CompressedVector.h
+ *  @brief This file contains methods that define and implement an append-only
+ *  vector of integers compressed in bit-packed blocks
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef COMPRESSED_VECTOR_H
+#define COMPRESSED_VECTOR_H 1
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "CustomVector.h"
+
+namespace custom
+{
+    namespace detail
+    {
+        /*******************************************************************************
+         * unpack_bits
+         *
+         * @brief decode 128 values of Bits bits each from words into out
+         *
+         * Value j occupies bits [j * Bits, (j + 1) * Bits) of the little-endian
+         * word array. Bits is a template parameter so every shift and mask is a
+         * constant; the fully unrolled loop has no data-dependent control flow
+         * and the compiler vectorizes it.
+         *******************************************************************************/
+        template <unsigned Bits>
+        void unpack_bits(const std::uint64_t *words, std::uint64_t *out) noexcept
+        {
+            if constexpr (Bits == 0)
+            {
+                for (int j = 0; j < 128; ++j)
+                    out[j] = 0;
+            }
+            else if constexpr (Bits == 64)
+            {
+                for (int j = 0; j < 128; ++j)
+                    out[j] = words[j];
+            }
+            else
+            {
+                constexpr std::uint64_t mask = (std::uint64_t{1} << Bits) - 1;
+
+#pragma GCC unroll 128
+                for (unsigned j = 0; j < 128; ++j)
+                {
+                    unsigned bit = j * Bits;
+                    unsigned word = bit / 64;
+                    unsigned offset = bit % 64;
+
+                    std::uint64_t val = words[word] >> offset;
+                    if (offset + Bits > 64)
+                        val |= words[word + 1] << (64 - offset);
+
+                    out[j] = val & mask;
+                }
+            }
+        }
+
+        using unpack_fn = void (*)(const std::uint64_t *, std::uint64_t *) noexcept;
+
+        template <size_t... Bits>
+        constexpr std::array<unpack_fn, sizeof...(Bits)> make_unpack_table(std::index_sequence<Bits...>)
+        {
+            return {&unpack_bits<Bits>...};
+        }
+
+        // unpack_table[b] decodes a block packed with b bits per value
+        inline constexpr std::array<unpack_fn, 65> unpack_table = make_unpack_table(std::make_index_sequence<65>());
+
+        // read value j of a block packed with bits bits per value
+        inline std::uint64_t read_packed(const std::uint64_t *words, unsigned bits, size_t j) noexcept
+        {
+            if (bits == 0)
+                return 0;
+
+            size_t bit = j * bits;
+            size_t word = bit / 64;
+            unsigned offset = bit % 64;
+
+            std::uint64_t val = words[word] >> offset;
+            if (offset + bits > 64)
+                val |= words[word + 1] << (64 - offset);
+
+            return bits == 64 ? val : val & ((std::uint64_t{1} << bits) - 1);
+        }
+    }
+
+    /*******************************************************************************
+     * class CompressedVector
+     *
+     *  @brief An append-only sequence of integers stored in compressed blocks
+     *  of 128 values
+     *
+     *  Values are buffered uncompressed until 128 have arrived. The block is
+     *  then encoded with whichever of two schemes needs fewer bits:
+     *
+     *   frame of reference  each value is stored as value - min(block)
+     *   delta               (non-decreasing blocks only) each value is stored
+     *                       as the difference to its predecessor
+     *
+     *  and the results are bit-packed with the smallest width that fits,
+     *  128 values of b bits taking exactly 2b words. Sorted ids and
+     *  timestamps typically need a few bits to a couple of dozen bits per
+     *  value instead of 64.
+     *
+     *  A header per block records its reference value, encoding, width and
+     *  word offset, so random access finds its block directly. Frame of
+     *  reference blocks then read one value; delta blocks sum the deltas up
+     *  to the value (at most 127 additions). Sequential scans should use
+     *  decode_block, for_each_block or the iterators, which decode a whole
+     *  block at a time with width-specialized kernels.
+     *
+     *  @tparam IntT  Integer type of element.
+     *  @tparam AllocType  Allocator type, default value is allocator<IntT>.
+     *
+     *******************************************************************************/
+    template <std::integral IntT, typename AllocType = std::allocator<IntT>>
+    class CompressedVector
+    {
+    public:
+        using size_type = size_t;
+        using value_type = IntT;
+
+        static constexpr size_type block_size = 128;
+
+        enum class Encoding : std::uint8_t
+        {
+            frame_of_reference,
+            delta
+        };
+
+        class Const_Iterator;
+        using const_iterator = Const_Iterator;
+        using iterator = Const_Iterator;
+
+        CompressedVector(const AllocType &alloc = AllocType());
+        CompressedVector(std::initializer_list<IntT> ilist, const AllocType &alloc = AllocType());
+
+        // Element Access
+        IntT at(size_type idx) const;
+        IntT operator[](size_type idx) const;
+
+        // Modifiers
+        void push_back(IntT val);
+        void clear();
+
+        // Block Access
+        size_type block_count() const noexcept { return m_headers.size() + (m_tail_size ? 1 : 0); }
+        size_type decode_block(size_type block, IntT *out) const;
+        template <class Fn>
+        void for_each_block(Fn fn) const;
+        Encoding block_encoding(size_type block) const { return m_headers.at(block).encoding; }
+        unsigned block_bits(size_type block) const { return m_headers.at(block).bits; }
+
+        // Size and Capacity
+        size_type size() const noexcept { return m_headers.size() * block_size + m_tail_size; }
+        bool empty() const noexcept { return size() == 0; }
+        size_type memory_usage() const noexcept;
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator cbegin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+        const_iterator cend() const { return const_iterator(this, size()); }
+
+        /*******************************************************************************
+         * class Const_Iterator
+         *
+         *  @brief forward iterator decoding one block at a time into an
+         *  internal buffer
+         *******************************************************************************/
+        class Const_Iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = IntT;
+            using pointer = const IntT *;
+            using reference = const IntT &;
+
+            Const_Iterator() = default;
+
+            reference operator*() const { return m_buffer[m_idx % block_size]; }
+            pointer operator->() const { return &**this; }
+
+            Const_Iterator &operator++()
+            {
+                if (++m_idx % block_size == 0)
+                    load();
+                return *this;
+            }
+
+            Const_Iterator operator++(int)
+            {
+                Const_Iterator temp = *this;
+                ++*this;
+                return temp;
+            }
+
+            friend bool operator==(const Const_Iterator &a, const Const_Iterator &b) noexcept
+            {
+                return a.m_idx == b.m_idx;
+            }
+
+        private:
+            friend class CompressedVector;
+
+            Const_Iterator(const CompressedVector *owner, size_type idx)
+                : m_owner{owner}, m_idx{idx}
+            {
+                load();
+            }
+
+            void load()
+            {
+                if (m_idx < m_owner->size())
+                    m_owner->decode_block(m_idx / block_size, m_buffer.data());
+            }
+
+            const CompressedVector *m_owner = nullptr;
+            size_type m_idx = 0;
+            std::array<IntT, block_size> m_buffer{};
+        };
+
+    private:
+        using U = std::make_unsigned_t<IntT>;
+
+        struct Block_Header
+        {
+            std::uint64_t reference;
+            size_type word_offset;
+            std::uint8_t bits;
+            Encoding encoding;
+        };
+
+        using Header_Alloc = typename std::allocator_traits<AllocType>::template rebind_alloc<Block_Header>;
+        using Word_Alloc = typename std::allocator_traits<AllocType>::template rebind_alloc<std::uint64_t>;
+
+        // order preserving map between IntT and uint64_t
+        static std::uint64_t to_code(IntT val) noexcept
+        {
+            if constexpr (std::is_signed_v<IntT>)
+                return static_cast<U>(static_cast<U>(val) ^ (U(1) << (std::numeric_limits<U>::digits - 1)));
+            else
+                return val;
+        }
+
+        static IntT from_code(std::uint64_t code) noexcept
+        {
+            if constexpr (std::is_signed_v<IntT>)
+                return static_cast<IntT>(static_cast<U>(code) ^ (U(1) << (std::numeric_limits<U>::digits - 1)));
+            else
+                return static_cast<IntT>(code);
+        }
+
+        void seal_tail();
+        void decode_codes(const Block_Header &header, std::uint64_t *codes) const;
+
+        Vector<Block_Header, Header_Alloc> m_headers;
+        Vector<std::uint64_t, Word_Alloc> m_words;
+        std::array<IntT, block_size> m_tail{};
+        size_type m_tail_size = 0;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    COMPRESSED VECTOR METHODS  ------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * default constructor
+     *
+     * @param alloc allocator
+     *******************************************************************************/
+    template <std::integral IntT, typename A>
+    CompressedVector<IntT, A>::CompressedVector(const A &alloc)
+        : m_headers{Header_Alloc(alloc)}, m_words{Word_Alloc(alloc)}
+    {
+    }
+
+    /*******************************************************************************
+     * @brief initializer_list constructor
+     *
+     * @param ilist values to append
+     * @param alloc allocator
+     *******************************************************************************/
+    template <std::integral IntT, typename A>
+    CompressedVector<IntT, A>::CompressedVector(std::initializer_list<IntT> ilist, const A &alloc)
+        : CompressedVector(alloc)
+    {
+        for (IntT val : ilist)
+            push_back(val);
+    }
+
+    /*******************************************************************************
+     * at
+     *
+     * @brief bounds checked random access
+     *
+     * @return value at idx
+     *******************************************************************************/
+    template <std::integral IntT, typename A>
+    IntT CompressedVector<IntT, A>::at(size_type idx) const
+    {
+        if (idx >= size())
+            throw std::out_of_range("CompressedVector: index out of range");
+
+        return (*this)[idx];
+    }
+
+    /*******************************************************************************
+     * operator[]
+     *
+     * @brief random access through the block header
+     *
+     * @return value at idx
+     *******************************************************************************/
+    template <std::integral IntT, typename A>
+    IntT CompressedVector<IntT, A>::operator[](size_type idx) const
+    {
+        size_type block = idx / block_size;
+        size_type j = idx % block_size;
+
+        if (block == m_headers.size())
+            return m_tail[j];
+
+        const Block_Header &header = m_headers.data()[block];
+        const std::uint64_t *words = m_words.data() + header.word_offset;
+
+        if (header.encoding == Encoding::frame_of_reference)
+            return from_code(header.reference + detail::read_packed(words, header.bits, j));
+
+        std::uint64_t code = header.reference;
+        for (size_type k = 1; k <= j; ++k)
+            code += detail::read_packed(words, header.bits, k);
+
+        return from_code(code);
+    }
+
+    /*******************************************************************************
+     * push_back
+     *
+     * @brief append val, compressing the tail once it holds a full block
+     *******************************************************************************/
+    template <std::integral IntT, typename A>
+    void CompressedVector<IntT, A>::push_back(IntT val)
+    {
+        m_tail[m_tail_size++] = val;
+
+        if (m_tail_size == block_size)
+            seal_tail();
+    }
+
+    /*******************************************************************************
+     * clear
+     *
+     * @brief remove all values
+     *******************************************************************************/
+    template <std::integral IntT, typename A>
+    void CompressedVector<IntT, A>::clear()
+    {
+        m_headers.clear();
+        m_words.clear();
+        m_tail_size = 0;
+    }
+
+    /*******************************************************************************
+     * decode_block
+     *
+     * @brief decode block number block (the last one may be partial) to out
+     *
+     * @param out room for block_size values
+     * @return number of values written
+     *******************************************************************************/
+    template <std::integral IntT, typename A>
+    typename CompressedVector<IntT, A>::size_type
+    CompressedVector<IntT, A>::decode_block(size_type block, IntT *out) const
+    {
+        if (block == m_headers.size())
+        {
+            std::copy(m_tail.begin(), m_tail.begin() + m_tail_size, out);
+            return m_tail_size;
+        }
+
+        if (block > m_headers.size())
+            throw std::out_of_range("CompressedVector: block out of range");
+
+        if constexpr (std::is_same_v<IntT, std::uint64_t>)
+        {
+            // codes are the values themselves, skip the extra copy
+            decode_codes(m_headers.data()[block], out);
+        }
+        else
+        {
+            std::uint64_t codes[block_size];
+            decode_codes(m_headers.data()[block], codes);
+
+            for (size_type j = 0; j < block_size; ++j)
+                out[j] = from_code(codes[j]);
+        }
+
+        return block_size;
+    }
+
+    /*******************************************************************************
+     * for_each_block
+     *
+     * @brief call fn(std::span<const IntT>) for every block in order
+     *******************************************************************************/
+    template <std::integral IntT, typename A>
+    template <class Fn>
+    void CompressedVector<IntT, A>::for_each_block(Fn fn) const
+    {
+        IntT buffer[block_size];
+
+        for (size_type block = 0; block < m_headers.size(); ++block)
+        {
+            decode_block(block, buffer);
+            fn(std::span<const IntT>(buffer, block_size));
+        }
+
+        if (m_tail_size)
+            fn(std::span<const IntT>(m_tail.data(), m_tail_size));
+    }
+
+    /*******************************************************************************
+     * memory_usage
+     *
+     * @return bytes held by headers, packed words and the tail buffer
+     *******************************************************************************/
+    template <std::integral IntT, typename A>
+    typename CompressedVector<IntT, A>::size_type CompressedVector<IntT, A>::memory_usage() const noexcept
+    {
+        return m_headers.capacity() * sizeof(Block_Header) +
+               m_words.capacity() * sizeof(std::uint64_t) + sizeof(m_tail);
+    }
+
+    /*******************************************************************************
+     * seal_tail
+     *
+     * @brief encode the full tail buffer as a new block
+     *******************************************************************************/
+    template <std::integral IntT, typename A>
+    void CompressedVector<IntT, A>::seal_tail()
+    {
+        std::uint64_t codes[block_size];
+        std::uint64_t low = to_code(m_tail[0]);
+        std::uint64_t high = low;
+        std::uint64_t max_delta = 0;
+        bool ascending = true;
+
+        for (size_type j = 0; j < block_size; ++j)
+        {
+            codes[j] = to_code(m_tail[j]);
+            low = std::min(low, codes[j]);
+            high = std::max(high, codes[j]);
+
+            if (j > 0)
+            {
+                ascending = ascending && codes[j] >= codes[j - 1];
+                max_delta = std::max(max_delta, codes[j] - codes[j - 1]);
+            }
+        }
+
+        Block_Header header{low, m_words.size(), 0, Encoding::frame_of_reference};
+        unsigned for_bits = std::bit_width(high - low);
+        unsigned delta_bits = std::bit_width(max_delta);
+
+        if (ascending && delta_bits < for_bits)
+        {
+            header.reference = codes[0];
+            header.encoding = Encoding::delta;
+            header.bits = static_cast<std::uint8_t>(delta_bits);
+
+            // the first delta is always 0
+            for (size_type j = block_size - 1; j > 0; --j)
+                codes[j] -= codes[j - 1];
+            codes[0] = 0;
+        }
+        else
+        {
+            header.bits = static_cast<std::uint8_t>(for_bits);
+            for (std::uint64_t &code : codes)
+                code -= low;
+        }
+
+        // 128 values of b bits fill exactly 2b words
+        size_type word_count = 2 * header.bits;
+        if (m_words.size() + word_count > m_words.capacity())
+            m_words.reserve(std::max(m_words.size() + word_count, 2 * m_words.capacity()));
+        m_words.resize(m_words.size() + word_count, 0);
+        std::uint64_t *words = m_words.data() + header.word_offset;
+
+        for (size_type j = 0; j < block_size && header.bits; ++j)
+        {
+            size_type bit = j * header.bits;
+            size_type word = bit / 64;
+            unsigned offset = bit % 64;
+
+            words[word] |= codes[j] << offset;
+            if (offset + header.bits > 64)
+                words[word + 1] |= codes[j] >> (64 - offset);
+        }
+
+        m_headers.push_back(header);
+        m_tail_size = 0;
+    }
+
+    /*******************************************************************************
+     * decode_codes
+     *
+     * @brief decode a sealed block to order-preserving codes
+     *******************************************************************************/
+    template <std::integral IntT, typename A>
+    void CompressedVector<IntT, A>::decode_codes(const Block_Header &header, std::uint64_t *codes) const
+    {
+        detail::unpack_table[header.bits](m_words.data() + header.word_offset, codes);
+
+        if (header.encoding == Encoding::frame_of_reference)
+        {
+            for (size_type j = 0; j < block_size; ++j)
+                codes[j] += header.reference;
+        }
+        else
+        {
+            std::uint64_t running = header.reference;
+            for (size_type j = 0; j < block_size; ++j)
+                codes[j] = running += codes[j];
+        }
+    }
+}
+
+#endif // COMPRESSED_VECTOR_H
@@ -9,11 +9,175 @@
 #define CUSTOM_VECTOR_H 1
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "HashBytes.h"
+#include "Parallel.h"
+#include "StreamingStore.h"
 
 namespace custom
 {
+#if defined(__cpp_lib_containers_ranges)
+    using std::from_range;
+    using std::from_range_t;
+#else
+    /*******************************************************************************
+     * from_range_t
+     *
+     * @brief tag selecting the range constructor, same as C++23 std::from_range_t
+     *******************************************************************************/
+    struct from_range_t
+    {
+        explicit from_range_t() = default;
+    };
+    inline constexpr from_range_t from_range{};
+#endif
+
+    namespace detail
+    {
+        // an allocator that can hand out blocks already filled with zero bytes
+        template <class A>
+        concept zeroing_allocator = requires(A &alloc, typename std::allocator_traits<A>::size_type n) {
+            { alloc.allocate_zeroed(n) } -> std::same_as<typename std::allocator_traits<A>::pointer>;
+        };
+
+        // all-zero bytes are a value-initialized T (member pointers are not: null is -1)
+        template <class T>
+        concept zero_is_value_init =
+            std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T> ||
+            std::is_null_pointer_v<T>;
+
+        // a lazy element-wise expression (see VectorExpr.h) yielding values convertible to T
+        template <class E, class T>
+        concept vector_expression = requires(const E &expr, size_t i) {
+            typename E::expression_tag;
+            { expr.size() } -> std::convertible_to<size_t>;
+            { expr[i] } -> std::convertible_to<T>;
+        };
+
+        // a range whose elements can construct a T (C++23 container-compatible-range)
+        template <class R, class T>
+        concept container_compatible_range =
+            std::ranges::input_range<R> &&
+            std::convertible_to<std::ranges::range_reference_t<R>, T>;
+
+        // a class whose == compares every member declares
+        // using is_byte_hashable = std::true_type to be hashed as bytes
+        template <class T>
+        concept opts_into_byte_hash = requires { requires T::is_byte_hashable::value; };
+
+        // equal values of T have equal bytes, so T can be hashed as bytes:
+        // integers, enums and pointers, and classes that opt in
+        template <class T>
+        concept byte_hashable = std::has_unique_object_representations_v<T> &&
+                                (std::is_scalar_v<T> || opts_into_byte_hash<T>);
+
+        template <class T>
+        concept element_hashable = byte_hashable<T> || requires(const T &x) {
+            { std::hash<T>{}(x) } -> std::convertible_to<size_t>;
+        };
+
+        /*******************************************************************************
+         * hash_element
+         *
+         * @brief hash one element: by its bytes when T is byte_hashable, else
+         * std::hash mixed (it is the identity for integers in libstdc++)
+         *******************************************************************************/
+        template <element_hashable T>
+        std::uint64_t hash_element(const T &x)
+        {
+            if constexpr (byte_hashable<T>)
+                return hash_bytes(std::addressof(x), sizeof(T));
+            else
+                return mix64(std::hash<T>{}(x));
+        }
+
+        /*******************************************************************************
+         * construct_copy / construct_move / construct_fill
+         *
+         * @brief constexpr counterparts of std::uninitialized_copy, _move and
+         * _fill (which are not constexpr before C++26)
+         *
+         * At run time they forward to the std algorithms, which use memmove /
+         * memset for trivial types, or to the streaming store kernels once a
+         * block of trivially copyable elements reaches streaming_threshold().
+         * During constant evaluation the elements are constructed one by one
+         * with std::construct_at.
+         *
+         * @return pointer one past the last constructed element
+         *******************************************************************************/
+        template <class InputIt, class T>
+        constexpr T *construct_copy(InputIt first, InputIt last, T *dest)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                if constexpr (std::is_trivially_copyable_v<T> &&
+                              (std::is_same_v<InputIt, T *> || std::is_same_v<InputIt, const T *>))
+                    if (use_streaming<T>(last - first))
+                        return stream_copy<T>(first, last - first, dest);
+
+                return std::uninitialized_copy(first, last, dest);
+            }
+
+            for (; first != last; ++first, ++dest)
+                std::construct_at(dest, *first);
+
+            return dest;
+        }
+
+        template <class T>
+        constexpr T *construct_move(T *first, T *last, T *dest)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                // relocating a trivially copyable element is a byte copy
+                if constexpr (std::is_trivially_copyable_v<T>)
+                    if (use_streaming<T>(last - first))
+                        return stream_copy<T>(first, last - first, dest);
+
+                return std::uninitialized_move(first, last, dest);
+            }
+
+            for (; first != last; ++first, ++dest)
+                std::construct_at(dest, std::move(*first));
+
+            return dest;
+        }
+
+        template <class T>
+        constexpr T *construct_fill(T *first, T *last, const T &val)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                if constexpr (std::is_trivially_copyable_v<T>)
+                    if (use_streaming<T>(last - first))
+                        return stream_fill(first, last - first, val);
+
+                std::uninitialized_fill(first, last, val);
+                return last;
+            }
+
+            for (; first != last; ++first)
+                std::construct_at(first, val);
+
+            return last;
+        }
+    }
+
     /*******************************************************************************
      * struct Vector_Memory_Manager
      *
@@ -24,6 +188,11 @@ namespace custom
      *   class object and will be destroyed upon destruction of its associated
      *   vector object.
      *
+     *   When AllocType has allocate_zeroed(n) (calloc, or a fresh anonymous
+     *   mapping) and zero bytes are a value-initialized T, a block requested
+     *   with zeroed = true comes from it and needs no fill: its pages are
+     *   only materialized when first written.
+     *
      *
      *  @tparam Type  Type of element.
      *  @tparam AllocType  Allocator type, default value is allocator<Type>.
@@ -32,10 +201,11 @@ namespace custom
     template <class T, class AllocType>
     struct Vector_Memory_Manager
     {
-        Vector_Memory_Manager(const AllocType &_alloc, typename AllocType::size_type n);
+        constexpr Vector_Memory_Manager(const AllocType &_alloc, typename AllocType::size_type n,
+                                        bool zeroed = false);
 
-        Vector_Memory_Manager(Vector_Memory_Manager &&other);
-        Vector_Memory_Manager &operator=(Vector_Memory_Manager &&other);
+        constexpr Vector_Memory_Manager(Vector_Memory_Manager &&other);
+        constexpr Vector_Memory_Manager &operator=(Vector_Memory_Manager &&other);
 
         Vector_Memory_Manager() = delete;
 
@@ -43,11 +213,20 @@ namespace custom
         Vector_Memory_Manager(const Vector_Memory_Manager &) = delete;
         Vector_Memory_Manager &operator=(const Vector_Memory_Manager &) = delete;
 
-        ~Vector_Memory_Manager();
+        constexpr ~Vector_Memory_Manager();
 
-        typename AllocType::size_type max_size() const noexcept;
+        constexpr typename AllocType::size_type max_size() const noexcept;
 
-        friend void swap(Vector_Memory_Manager &a, Vector_Memory_Manager &b) noexcept
+        // true if a block allocated with zeroed = true already holds value-initialized Ts
+        static constexpr bool allocates_zeroed() noexcept
+        {
+            if constexpr (detail::zeroing_allocator<AllocType> && detail::zero_is_value_init<T>)
+                return !std::is_constant_evaluated();
+            else
+                return false;
+        }
+
+        friend constexpr void swap(Vector_Memory_Manager &a, Vector_Memory_Manager &b) noexcept
         {
             // enable ADL (argument dependent lookup)
             using namespace std;
@@ -84,155 +263,248 @@ namespace custom
 
     public:
         using size_type = size_t;
-
-        class Iterator
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using allocator_type = AllocType;
+        using reference = T &;
+        using const_reference = const T &;
+        using pointer = T *;
+        using const_pointer = const T *;
+
+        /*******************************************************************************
+         * class Basic_Iterator
+         *
+         *  @brief contiguous iterator over the elements of a Vector
+         *
+         *  Models std::contiguous_iterator, so std::to_address and the ranges
+         *  algorithms can see that the storage is a plain array. IsConst selects
+         *  between iterator (yields T&) and const_iterator (yields const T&);
+         *  an iterator converts implicitly to a const_iterator.
+         *******************************************************************************/
+        template <bool IsConst>
+        class Basic_Iterator
         {
         public:
+            using iterator_concept = std::contiguous_iterator_tag;
             using iterator_category = std::random_access_iterator_tag;
             using difference_type = std::ptrdiff_t;
             using value_type = T;
-            using pointer = T *;
-            using reference = T &;
-
-            Iterator(T *ptr) : m_ptr(ptr) {}
+            using element_type = std::conditional_t<IsConst, const T, T>;
+            using pointer = element_type *;
+            using reference = element_type &;
+
+            constexpr Basic_Iterator() noexcept = default;
+            constexpr Basic_Iterator(pointer ptr) noexcept : m_ptr(ptr) {}
+
+            // allow iterator -> const_iterator conversion
+            template <bool OtherConst>
+                requires(IsConst && !OtherConst)
+            constexpr Basic_Iterator(const Basic_Iterator<OtherConst> &other) noexcept
+                : m_ptr(other.m_ptr)
+            {
+            }
 
-            reference operator*() const { return *m_ptr; }
-            pointer operator->() const { return m_ptr; }
+            constexpr reference operator*() const noexcept { return *m_ptr; }
+            constexpr pointer operator->() const noexcept { return m_ptr; }
+            constexpr reference operator[](difference_type n) const noexcept { return m_ptr[n]; }
 
-            Iterator &operator++()
+            constexpr Basic_Iterator &operator++() noexcept
             {
                 ++m_ptr;
                 return *this;
             }
 
-            Iterator operator++(int)
+            constexpr Basic_Iterator operator++(int) noexcept
             {
-                Iterator temp = *this;
+                Basic_Iterator temp = *this;
 
                 ++m_ptr;
                 return temp;
             }
-            Iterator &operator--()
+            constexpr Basic_Iterator &operator--() noexcept
             {
                 --m_ptr;
                 return *this;
             }
 
-            Iterator operator--(int)
+            constexpr Basic_Iterator operator--(int) noexcept
             {
-                Iterator temp = *this;
+                Basic_Iterator temp = *this;
 
                 --m_ptr;
                 return temp;
             }
 
-            Iterator &operator+=(difference_type n)
+            constexpr Basic_Iterator &operator+=(difference_type n) noexcept
             {
                 m_ptr += n;
                 return *this;
             }
-            Iterator &operator-=(difference_type n)
+            constexpr Basic_Iterator &operator-=(difference_type n) noexcept
             {
                 m_ptr -= n;
                 return *this;
             }
 
-            Iterator operator+(difference_type n) const { return Iterator(m_ptr + n); }
-            Iterator operator-(difference_type n) const { return Iterator(m_ptr - n); }
+            constexpr Basic_Iterator operator+(difference_type n) const noexcept { return Basic_Iterator(m_ptr + n); }
+            constexpr Basic_Iterator operator-(difference_type n) const noexcept { return Basic_Iterator(m_ptr - n); }
 
-            reference operator[](difference_type n) const { return *(m_ptr + n); }
+            friend constexpr Basic_Iterator operator+(difference_type n, const Basic_Iterator &it) noexcept
+            {
+                return it + n;
+            }
 
-            friend difference_type operator-(const Iterator &a, const Iterator &b)
+            friend constexpr difference_type operator-(const Basic_Iterator &a, const Basic_Iterator &b) noexcept
             {
                 return a.m_ptr - b.m_ptr;
             }
 
-            friend bool operator>(const Iterator &a, const Iterator &b) { return a.m_ptr > b.m_ptr; }
-            friend bool operator<(const Iterator &a, const Iterator &b) { return a.m_ptr < b.m_ptr; }
-            friend bool operator==(const Iterator &a, const Iterator &b) { return a.m_ptr == b.m_ptr; }
-            friend bool operator!=(const Iterator &a, const Iterator &b) { return a.m_ptr != b.m_ptr; }
+            friend constexpr bool operator==(const Basic_Iterator &a, const Basic_Iterator &b) noexcept
+            {
+                return a.m_ptr == b.m_ptr;
+            }
+            friend constexpr auto operator<=>(const Basic_Iterator &a, const Basic_Iterator &b) noexcept
+            {
+                return a.m_ptr <=> b.m_ptr;
+            }
 
         private:
-            T *m_ptr;
+            template <bool>
+            friend class Basic_Iterator;
+
+            pointer m_ptr = nullptr;
         };
 
-        Vector(const AllocType &alloc = AllocType());
+        using Iterator = Basic_Iterator<false>;
+        using Const_Iterator = Basic_Iterator<true>;
+
+        constexpr Vector(const AllocType &alloc = AllocType());
+
+        constexpr Vector(std::initializer_list<T> ilist, const AllocType &alloc = AllocType());
+
+        constexpr explicit Vector(size_type n, const AllocType &alloc = AllocType());
+        constexpr explicit Vector(size_type n, const T &val,
+                                  const AllocType &alloc = AllocType());
+        Vector(size_type n, const T &val, const ParallelInit &policy,
+               const AllocType &alloc = AllocType());
+
+        template <std::input_iterator InputIt>
+        constexpr Vector(InputIt first, InputIt last, const AllocType &alloc = AllocType());
 
-        Vector(std::initializer_list<T> ilist, const AllocType &alloc = AllocType());
+        template <detail::container_compatible_range<T> R>
+        constexpr Vector(from_range_t, R &&rg, const AllocType &alloc = AllocType());
 
-        explicit Vector(size_type n, const T &val = T(),
-                        const AllocType &alloc = AllocType());
+        template <detail::vector_expression<T> Expr>
+        constexpr Vector(const Expr &expr, const AllocType &alloc = AllocType());
 
-        Vector(const Vector &other);
-        Vector(Vector &&other);
+        constexpr Vector(const Vector &other);
+        constexpr Vector(Vector &&other);
 
-        Vector &operator=(Vector &other);
-        Vector &operator=(Vector &&other);
+        constexpr Vector &operator=(const Vector &other);
+        constexpr Vector &operator=(Vector &&other);
+        template <detail::vector_expression<T> Expr>
+        constexpr Vector &operator=(const Expr &expr);
 
-        ~Vector() { destroyElements(); }
+        constexpr ~Vector() { destroyElements(); }
 
         // Element Access
-        T &at(size_type idx);
+        constexpr T &at(size_type idx);
         constexpr T &at(size_type idx) const;
 
-        T &operator[](size_type idx) { return at(idx); }
-        const T &operator[](size_type idx) const { return at(idx); }
-        T &front();
-        T &back();
+        constexpr T &operator[](size_type idx) { return at(idx); }
+        constexpr const T &operator[](size_type idx) const { return at(idx); }
+        constexpr T &front();
+        constexpr T &back();
         constexpr T *data() noexcept { return mem_manager.block_start; }
         constexpr const T *data() const noexcept { return mem_manager.block_start; }
+        constexpr AllocType get_allocator() const noexcept { return mem_manager.alloc; }
 
         // Modifiers
-        void push_back(const T &val);
-        Iterator insert(Iterator index, const T &val);
-        void erase(Iterator position);
-        void pop_back();
-        void clear() { resize(0); }
-        void resize(size_type, T = {});
+        constexpr void push_back(const T &val);
+        constexpr void push_back(T &&val);
+        template <class... Args>
+        constexpr T &emplace_back(Args &&...args);
+        template <detail::container_compatible_range<T> R>
+        constexpr void append_range(R &&rg);
+        template <std::input_iterator InputIt>
+        constexpr void append(InputIt first, InputIt last)
+        {
+            append_range(std::ranges::subrange(first, last));
+        }
+        template <class Fn>
+        constexpr void append_construct(size_type n, Fn construct);
+        constexpr Iterator insert(Const_Iterator index, const T &val);
+        constexpr Iterator insert(Const_Iterator index, T &&val);
+        constexpr void erase(Const_Iterator position);
+        constexpr void pop_back();
+        constexpr void clear() { destroyElements(); }
+        constexpr void resize(size_type new_size);
+        constexpr void resize(size_type new_size, T val);
+        void resize(size_type new_size, const T &val, const ParallelInit &policy);
         constexpr void assign(size_type n, const T val);
+        size_type dedup();
+        constexpr size_type unique_sorted();
+        size_type unique_unsorted();
 
         // Size and Capacity
-        void reserve(size_type);
-        size_type capacity() const noexcept
+        constexpr void reserve(size_type);
+        void reserve(size_type size_to_reserve, const ParallelInit &policy);
+        constexpr void shrink_to_fit();
+        constexpr size_type capacity() const noexcept
         {
             return mem_manager.block_end - mem_manager.block_start;
         }
-        bool empty() const noexcept
+        constexpr bool empty() const noexcept
         {
             return mem_manager.uninitialized_block_start - mem_manager.block_start == 0;
         }
-        size_type maxSize() const noexcept;
+        constexpr size_type maxSize() const noexcept;
 
-        size_type size() const noexcept
+        constexpr size_type size() const noexcept
         {
             return mem_manager.uninitialized_block_start - mem_manager.block_start;
         }
 
-        friend void swap(Vector &a, Vector &b) noexcept
+        friend constexpr void swap(Vector &a, Vector &b) noexcept
         {
             swap(a.mem_manager, b.mem_manager);
         }
+
+        friend constexpr bool operator==(const Vector &a, const Vector &b)
+            requires std::equality_comparable<T>
+        {
+            return std::equal(a.data(), a.data() + a.size(), b.data(), b.data() + b.size());
+        }
         //--------------------------------------------
         // Iterator Methods
         //--------------------------------------------
         using iterator = Iterator;
-        using const_iterator = const Iterator;
-        using reverse_iterator = std::reverse_iterator<Iterator>;
-        constexpr iterator begin() { return Iterator(mem_manager.block_start); }
-        constexpr const_iterator begin() const { return const_iterator(mem_manager.block_start); }
-        constexpr const_iterator cbegin() const { return const_iterator(mem_manager.block_start); }
+        using const_iterator = Const_Iterator;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        constexpr iterator begin() noexcept { return iterator(mem_manager.block_start); }
+        constexpr const_iterator begin() const noexcept { return const_iterator(mem_manager.block_start); }
+        constexpr const_iterator cbegin() const noexcept { return const_iterator(mem_manager.block_start); }
+
+        constexpr iterator end() noexcept { return iterator(mem_manager.uninitialized_block_start); }
+        constexpr const_iterator end() const noexcept { return const_iterator(mem_manager.uninitialized_block_start); }
+        constexpr const_iterator cend() const noexcept { return const_iterator(mem_manager.uninitialized_block_start); }
 
-        constexpr iterator end() { return Iterator(mem_manager.uninitialized_block_start); }
-        constexpr const_iterator end() const { return const_iterator(mem_manager.uninitialized_block_start); }
-        constexpr const_iterator cend() const { return const_iterator(mem_manager.uninitialized_block_start); }
+        constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        constexpr const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
 
-        constexpr reverse_iterator rbegin() const { return reverse_iterator(mem_manager.uninitialized_block_start); }
-        constexpr reverse_iterator rend() const { return reverse_iterator(mem_manager.block_start); }
+        constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+        constexpr const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
 
     protected:
-        void destroyElements();
+        constexpr void destroyElements();
 
     private:
+        template <class Index>
+        size_type unique_unsorted_indexed();
+
         Vector_Memory_Manager<T, AllocType> mem_manager;
     };
 
@@ -245,15 +517,30 @@ namespace custom
      *
      *  @param _alloc allocation object
      *  @param n allocation size
+     *  @param zeroed ask for a zero-filled block (see allocates_zeroed)
      *
      *******************************************************************************/
     template <class T, class A>
-    Vector_Memory_Manager<T, A>::Vector_Memory_Manager(
-        const A &_alloc, typename A::size_type n)
+    constexpr Vector_Memory_Manager<T, A>::Vector_Memory_Manager(
+        const A &_alloc, typename A::size_type n, bool zeroed)
         : alloc{_alloc}
     {
         using traits = std::allocator_traits<decltype(alloc)>;
-        block_start = traits::allocate(alloc, n);
+
+        // an empty manager owns no block, so default constructed
+        // vectors never touch the allocator
+        block_start = nullptr;
+        if (n)
+        {
+            if constexpr (detail::zeroing_allocator<A>)
+            {
+                if (zeroed && allocates_zeroed())
+                    block_start = alloc.allocate_zeroed(n);
+            }
+
+            if (!block_start)
+                block_start = traits::allocate(alloc, n);
+        }
         uninitialized_block_start = block_start;
         block_end = block_start + n;
     }
@@ -265,7 +552,7 @@ namespace custom
      *
      *******************************************************************************/
     template <class T, class A>
-    Vector_Memory_Manager<T, A>::Vector_Memory_Manager(Vector_Memory_Manager &&other)
+    constexpr Vector_Memory_Manager<T, A>::Vector_Memory_Manager(Vector_Memory_Manager &&other)
         : alloc{other.alloc},
           block_start{nullptr},
           uninitialized_block_start{nullptr},
@@ -285,7 +572,7 @@ namespace custom
      * 'other' go out of scope in due time and free the memory without intervention
      *******************************************************************************/
     template <class T, class A>
-    Vector_Memory_Manager<T, A> &
+    constexpr Vector_Memory_Manager<T, A> &
     Vector_Memory_Manager<T, A>::operator=(Vector_Memory_Manager<T, A> &&other)
     {
         swap(*this, other);
@@ -297,11 +584,12 @@ namespace custom
      *  Vector_Memory_Manager:: destructor
      *******************************************************************************/
     template <class T, class A>
-    Vector_Memory_Manager<T, A>::~Vector_Memory_Manager()
+    constexpr Vector_Memory_Manager<T, A>::~Vector_Memory_Manager()
     {
         using traits = std::allocator_traits<decltype(alloc)>;
 
-        traits::deallocate(alloc, block_start, block_end - block_start);
+        if (block_start)
+            traits::deallocate(alloc, block_start, block_end - block_start);
 
         block_end = uninitialized_block_start = block_start = nullptr;
     }
@@ -310,7 +598,7 @@ namespace custom
      *  @brief Vector_Memory_Manager:: max_size
      *******************************************************************************/
     template <class T, class A>
-    typename A::size_type Vector_Memory_Manager<T, A>::max_size() const noexcept
+    constexpr typename A::size_type Vector_Memory_Manager<T, A>::max_size() const noexcept
     {
         return std::allocator_traits<decltype(alloc)>::max_size(alloc);
     }
@@ -326,7 +614,7 @@ namespace custom
      * @return n/a
      *******************************************************************************/
     template <class T, typename A>
-    Vector<T, A>::Vector(const A &alloc)
+    constexpr Vector<T, A>::Vector(const A &alloc)
         : mem_manager{alloc, 0}
     {
     }
@@ -339,14 +627,35 @@ namespace custom
      * @return n/a
      *******************************************************************************/
     template <class T, typename A>
-    Vector<T, A>::Vector(std::initializer_list<T> ilist, const A &alloc)
+    constexpr Vector<T, A>::Vector(std::initializer_list<T> ilist, const A &alloc)
         : mem_manager{alloc, ilist.size()}
     {
-        std::uninitialized_copy(ilist.begin(), ilist.end(), mem_manager.block_start);
+        detail::construct_copy(ilist.begin(), ilist.end(), mem_manager.block_start);
 
         mem_manager.uninitialized_block_start = mem_manager.block_start + ilist.size();
     }
 
+    /*******************************************************************************
+     * @brief size constructor
+     *
+     * n value-initialized elements. Skips the fill when the allocator can
+     * provide zeroed memory (see Vector_Memory_Manager).
+     *
+     * @param n size
+     * @param alloc allocator
+     * @return n/a
+     *******************************************************************************/
+    template <class T, typename A>
+    constexpr Vector<T, A>::Vector(size_type n, const A &alloc)
+        : mem_manager{alloc, n, true}
+    {
+        if (!mem_manager.allocates_zeroed())
+            detail::construct_fill(mem_manager.block_start,
+                                   mem_manager.block_start + n, T());
+
+        mem_manager.uninitialized_block_start = mem_manager.block_start + n;
+    }
+
     /*******************************************************************************
      * @brief parameter constructor
      *
@@ -356,16 +665,87 @@ namespace custom
      * @return n/a
      *******************************************************************************/
     template <class T, typename A>
-    Vector<T, A>::Vector(size_type n, const T &val, const A &alloc)
+    constexpr Vector<T, A>::Vector(size_type n, const T &val, const A &alloc)
         : mem_manager{alloc, n}
     {
         // construct n copies of val (in-place)
-        std::uninitialized_fill(mem_manager.block_start,
-                                mem_manager.block_start + n, val);
+        detail::construct_fill(mem_manager.block_start,
+                               mem_manager.block_start + n, val);
+
+        mem_manager.uninitialized_block_start = mem_manager.block_start + n;
+    }
+
+    /*******************************************************************************
+     * @brief parallel parameter constructor
+     *
+     * The block is split into chunks and each chunk is filled by its own
+     * worker thread, so every page is first touched (and, under the usual
+     * first-touch policy, placed on the NUMA node of) the worker that
+     * parallel_for_chunks will hand that chunk to later on.
+     *
+     * @param n size
+     * @param val value for constructed objects
+     * @param policy thread count, grain and pinning
+     * @param alloc allocator
+     * @return n/a
+     *******************************************************************************/
+    template <class T, typename A>
+    Vector<T, A>::Vector(size_type n, const T &val, const ParallelInit &policy, const A &alloc)
+        : mem_manager{alloc, n}
+    {
+        detail::parallel_construct(mem_manager.block_start, mem_manager.block_start + n, policy,
+                                   [&val](T *first, T *last, unsigned)
+                                   { detail::construct_fill(first, last, val); });
 
         mem_manager.uninitialized_block_start = mem_manager.block_start + n;
     }
 
+    /*******************************************************************************
+     * @brief iterator range constructor
+     *
+     * @param first start of the range to copy
+     * @param last end of the range to copy
+     * @param alloc allocator
+     * @return n/a
+     *******************************************************************************/
+    template <class T, typename A>
+    template <std::input_iterator InputIt>
+    constexpr Vector<T, A>::Vector(InputIt first, InputIt last, const A &alloc)
+        : mem_manager{alloc, 0}
+    {
+        append(first, last);
+    }
+
+    /*******************************************************************************
+     * @brief range constructor
+     *
+     * @param rg range whose elements are copied
+     * @param alloc allocator
+     * @return n/a
+     *******************************************************************************/
+    template <class T, typename A>
+    template <detail::container_compatible_range<T> R>
+    constexpr Vector<T, A>::Vector(from_range_t, R &&rg, const A &alloc)
+        : mem_manager{alloc, 0}
+    {
+        append_range(std::forward<R>(rg));
+    }
+
+    /*******************************************************************************
+     * @brief expression constructor
+     *
+     * @param expr element-wise expression, evaluated in a single loop
+     * @param alloc allocator
+     * @return n/a
+     *******************************************************************************/
+    template <class T, typename A>
+    template <detail::vector_expression<T> Expr>
+    constexpr Vector<T, A>::Vector(const Expr &expr, const A &alloc)
+        : mem_manager{alloc, 0}
+    {
+        *this = expr;
+    }
+
     /*******************************************************************************
      * copy constructor
      *
@@ -373,13 +753,13 @@ namespace custom
      * @return n/a
      *******************************************************************************/
     template <class T, class A>
-    Vector<T, A>::Vector(const Vector &other)
+    constexpr Vector<T, A>::Vector(const Vector &other)
         : mem_manager{other.mem_manager.alloc, other.size()}
     {
-        int n = other.size();
+        size_type n = other.size();
         T *other_start = other.mem_manager.block_start;
         T *other_end = other.mem_manager.block_start + n;
-        std::uninitialized_copy(other_start, other_end, mem_manager.block_start);
+        detail::construct_copy(other_start, other_end, mem_manager.block_start);
 
         mem_manager.uninitialized_block_start = mem_manager.block_start + n;
     }
@@ -391,7 +771,7 @@ namespace custom
      * @return Vector reference
      *******************************************************************************/
     template <class T, typename A>
-    Vector<T, A> &Vector<T, A>::operator=(Vector<T, A> &other)
+    constexpr Vector<T, A> &Vector<T, A>::operator=(const Vector<T, A> &other)
     {
         // copy-and-swap
         Vector<T, A> temp(other);
@@ -407,7 +787,7 @@ namespace custom
      * @return n/a
      *******************************************************************************/
     template <class T, typename A>
-    Vector<T, A>::Vector(Vector &&other)
+    constexpr Vector<T, A>::Vector(Vector &&other)
         : mem_manager{other.mem_manager.alloc, 0}
     {
         // call move assignment operator to avoid duplicate code
@@ -421,7 +801,7 @@ namespace custom
      * @return Vector reference
      *******************************************************************************/
     template <class T, typename A>
-    Vector<T, A> &Vector<T, A>::operator=(Vector &&other)
+    constexpr Vector<T, A> &Vector<T, A>::operator=(Vector &&other)
     {
         // TO-DO: Consider whether or not this simple swap suffices, or if after
         // the swap, 'other' should explicibly have its objects destroyed
@@ -430,6 +810,52 @@ namespace custom
         return *this;
     }
 
+    /*******************************************************************************
+     * expression assignment operator
+     *
+     * @brief evaluate expr element by element into this vector, with no
+     * temporaries
+     *
+     * An expression may read this vector: element i is only read when
+     * element i is computed. When the sizes differ this vector cannot be an
+     * operand (all operands have expr.size() elements), so it is rebuilt.
+     *
+     * @param expr element-wise expression
+     * @return reference
+     *******************************************************************************/
+    template <class T, typename A>
+    template <detail::vector_expression<T> Expr>
+    constexpr Vector<T, A> &Vector<T, A>::operator=(const Expr &expr)
+    {
+        size_type n = expr.size();
+
+        if (n != size())
+        {
+            clear();
+            append_construct(n, [&expr](T *first, T *last)
+                             {
+                T *out = first;
+                try
+                {
+                    for (; out != last; ++out)
+                        std::construct_at(out, expr[out - first]);
+                }
+                catch (...)
+                {
+                    std::destroy(first, out);
+                    throw;
+                } });
+
+            return *this;
+        }
+
+        T *out = data();
+        for (size_type i = 0; i < n; ++i)
+            out[i] = expr[i];
+
+        return *this;
+    }
+
     /*******************************************************************************
      * reserve
      *
@@ -439,7 +865,7 @@ namespace custom
      * @return n/a
      *******************************************************************************/
     template <class T, typename A>
-    void Vector<T, A>::reserve(size_type size_to_reserve)
+    constexpr void Vector<T, A>::reserve(size_type size_to_reserve)
     {
         if (size_to_reserve <= capacity())
             return;
@@ -447,14 +873,78 @@ namespace custom
         Vector_Memory_Manager<T, A> next_mem_manager{
             mem_manager.alloc, size_to_reserve};
 
-        std::uninitialized_move(mem_manager.block_start,
-                                mem_manager.block_start + size(),
-                                next_mem_manager.block_start);
+        detail::construct_move(mem_manager.block_start,
+                               mem_manager.block_start + size(),
+                               next_mem_manager.block_start);
+
+        next_mem_manager.uninitialized_block_start =
+            next_mem_manager.block_start + size();
+
+        // destroy the moved-from elements before their block is released
+        destroyElements();
+        swap(next_mem_manager, mem_manager);
+    }
+
+    /*******************************************************************************
+     * shrink_to_fit
+     *
+     * @brief move the elements into a block of exactly size() elements and
+     * release the old one; an empty vector gives up its block entirely
+     *
+     * @return n/a
+     *******************************************************************************/
+    template <class T, typename A>
+    constexpr void Vector<T, A>::shrink_to_fit()
+    {
+        if (size() == capacity())
+            return;
+
+        Vector_Memory_Manager<T, A> next_mem_manager{
+            mem_manager.alloc, size()};
+
+        detail::construct_move(mem_manager.block_start,
+                               mem_manager.uninitialized_block_start,
+                               next_mem_manager.block_start);
 
         next_mem_manager.uninitialized_block_start =
             next_mem_manager.block_start + size();
 
-        std::swap(next_mem_manager, mem_manager);
+        destroyElements();
+        swap(next_mem_manager, mem_manager);
+    }
+
+    /*******************************************************************************
+     * resize
+     *
+     * @brief resize vector to new_size, value-initializing new elements
+     *
+     * Growth beyond the capacity moves the elements into a zeroed block when
+     * the allocator provides one, so the new tail needs no fill.
+     *
+     * @param new_size number of objects in vector after the method completes
+     * @return void
+     *******************************************************************************/
+    template <class T, typename A>
+    constexpr void Vector<T, A>::resize(size_type new_size)
+    {
+        if (new_size > capacity() && mem_manager.allocates_zeroed())
+        {
+            Vector_Memory_Manager<T, A> next_mem_manager{
+                mem_manager.alloc, new_size, true};
+
+            detail::construct_move(mem_manager.block_start,
+                                   mem_manager.uninitialized_block_start,
+                                   next_mem_manager.block_start);
+
+            next_mem_manager.uninitialized_block_start =
+                next_mem_manager.block_start + new_size;
+
+            destroyElements();
+            swap(next_mem_manager, mem_manager);
+            return;
+        }
+
+        resize(new_size, T());
     }
 
     /*******************************************************************************
@@ -473,7 +963,7 @@ namespace custom
      * @return void
      *******************************************************************************/
     template <class T, typename A>
-    void Vector<T, A>::resize(size_type new_size, T val)
+    constexpr void Vector<T, A>::resize(size_type new_size, T val)
     {
         if (new_size == size())
             return;
@@ -485,14 +975,14 @@ namespace custom
         {
             // The vector is expanding
             // construct new elements in the uninitialized memory spaces
-            std::uninitialized_fill(mem_manager.uninitialized_block_start,
-                                    mem_manager.block_start + new_size, val);
+            detail::construct_fill(mem_manager.uninitialized_block_start,
+                                   mem_manager.block_start + new_size, val);
         }
         else // shrink
         {
             // The vector size is shrinking
             // remove all elements at and after vector[new_size]
-            T *remove_start = mem_manager.block_start + size();
+            T *remove_start = mem_manager.block_start + new_size;
 
             size_type num_to_destroy = mem_manager.uninitialized_block_start -
                                        remove_start;
@@ -503,6 +993,73 @@ namespace custom
         mem_manager.uninitialized_block_start = mem_manager.block_start + new_size;
     }
 
+    /*******************************************************************************
+     * reserve (parallel)
+     *
+     * @brief reserve, relocating the existing elements in parallel chunks
+     *
+     * Pages holding the relocated elements are first touched by the worker
+     * owning their chunk. The spare capacity is left untouched.
+     *
+     * @param size_to_reserve size of memory to allocate
+     * @param policy thread count, grain and pinning
+     * @return n/a
+     *******************************************************************************/
+    template <class T, typename A>
+    void Vector<T, A>::reserve(size_type size_to_reserve, const ParallelInit &policy)
+    {
+        if (size_to_reserve <= capacity())
+            return;
+
+        Vector_Memory_Manager<T, A> next_mem_manager{
+            mem_manager.alloc, size_to_reserve};
+
+        T *old_start = mem_manager.block_start;
+        T *new_start = next_mem_manager.block_start;
+
+        detail::parallel_construct(new_start, new_start + size(), policy,
+                                   [old_start, new_start](T *first, T *last, unsigned)
+                                   { detail::construct_move(old_start + (first - new_start),
+                                                            old_start + (last - new_start), first); });
+
+        next_mem_manager.uninitialized_block_start = new_start + size();
+
+        destroyElements();
+        swap(next_mem_manager, mem_manager);
+    }
+
+    /*******************************************************************************
+     * resize (parallel)
+     *
+     * @brief resize, constructing the new elements in parallel chunks
+     *
+     * Growth beyond the capacity reallocates with reserve(new_size, policy).
+     *
+     * @param new_size number of objects in vector after the method completes
+     * @param val value for the new elements
+     * @param policy thread count, grain and pinning
+     * @return void
+     *******************************************************************************/
+    template <class T, typename A>
+    void Vector<T, A>::resize(size_type new_size, const T &val, const ParallelInit &policy)
+    {
+        if (new_size <= size())
+        {
+            std::destroy(mem_manager.block_start + new_size, mem_manager.uninitialized_block_start);
+            mem_manager.uninitialized_block_start = mem_manager.block_start + new_size;
+            return;
+        }
+
+        reserve(new_size, policy);
+
+        detail::parallel_construct(mem_manager.uninitialized_block_start,
+                                   mem_manager.block_start + new_size, policy,
+                                   [&val](T *first, T *last, unsigned)
+                                   { detail::construct_fill(first, last, val); });
+
+        mem_manager.uninitialized_block_start = mem_manager.block_start + new_size;
+    }
+
     /*******************************************************************************
      * assign
      *
@@ -528,7 +1085,7 @@ namespace custom
      * @return size_type
      *******************************************************************************/
     template <class T, typename A>
-    typename Vector<T, A>::size_type Vector<T, A>::maxSize() const noexcept
+    constexpr typename Vector<T, A>::size_type Vector<T, A>::maxSize() const noexcept
     {
         return mem_manager.max_size();
     }
@@ -539,7 +1096,7 @@ namespace custom
      * @return value at index
      *******************************************************************************/
     template <class T, typename A>
-    T &Vector<T, A>::at(size_type idx)
+    constexpr T &Vector<T, A>::at(size_type idx)
     {
         if (idx < 0 || idx >= size())
             throw std::out_of_range("Invalid index");
@@ -567,7 +1124,7 @@ namespace custom
      * @return reference
      *******************************************************************************/
     template <class T, typename A>
-    T &Vector<T, A>::front()
+    constexpr T &Vector<T, A>::front()
     {
         if (empty())
             throw std::out_of_range("Vector is empty");
@@ -582,7 +1139,7 @@ namespace custom
      * @return reference
      *******************************************************************************/
     template <class T, typename A>
-    T &Vector<T, A>::back()
+    constexpr T &Vector<T, A>::back()
     {
         if (empty())
             throw std::out_of_range("Vector is empty");
@@ -598,14 +1155,168 @@ namespace custom
      * @return n/a
      *******************************************************************************/
     template <class T, typename A>
-    void Vector<T, A>::push_back(const T &val)
+    constexpr void Vector<T, A>::push_back(const T &val)
     {
-        if (size() == capacity())
-            reserve(empty() ? 1 : size() << 1);
+        emplace_back(val);
+    }
+
+    /*******************************************************************************
+     * push_back
+     *
+     * @brief append element to end of vector by moving it
+     * @param val the value to move into the vector
+     * @return n/a
+     *******************************************************************************/
+    template <class T, typename A>
+    constexpr void Vector<T, A>::push_back(T &&val)
+    {
+        emplace_back(std::move(val));
+    }
+
+    /*******************************************************************************
+     * emplace_back
+     *
+     * @brief construct an element in place at the end of vector
+     * @param args arguments forwarded to the constructor of T
+     * @return reference to the new element
+     *******************************************************************************/
+    template <class T, typename A>
+    template <class... Args>
+    constexpr T &Vector<T, A>::emplace_back(Args &&...args)
+    {
+        if (size() < capacity())
+        {
+            T *slot = std::construct_at(mem_manager.uninitialized_block_start,
+                                        std::forward<Args>(args)...);
 
-        std::construct_at(mem_manager.uninitialized_block_start, val);
+            ++mem_manager.uninitialized_block_start;
 
-        ++mem_manager.uninitialized_block_start;
+            return *slot;
+        }
+
+        size_type n = size();
+        Vector_Memory_Manager<T, A> next_mem_manager{
+            mem_manager.alloc, empty() ? 1 : n << 1};
+
+        // construct the new element before relocating the old ones,
+        // since args may refer to an element of this vector
+        T *slot = std::construct_at(next_mem_manager.block_start + n,
+                                    std::forward<Args>(args)...);
+
+        // uninitialized_move destroys what it relocated before rethrowing,
+        // but the new element lives in the block about to be freed
+        try
+        {
+            detail::construct_move(mem_manager.block_start,
+                                   mem_manager.block_start + n,
+                                   next_mem_manager.block_start);
+        }
+        catch (...)
+        {
+            std::destroy_at(slot);
+            throw;
+        }
+
+        next_mem_manager.uninitialized_block_start =
+            next_mem_manager.block_start + n + 1;
+
+        destroyElements();
+        swap(next_mem_manager, mem_manager);
+
+        return *slot;
+    }
+
+    /*******************************************************************************
+     * append_range
+     *
+     * @brief append every element of rg to the end of vector
+     *
+     * When the size of rg is known up front (sized or forward ranges) the
+     * vector grows at most once, and a contiguous range of trivially copyable
+     * elements is copied with a single memcpy. Ranges that can only be walked
+     * once fall back to geometric growth through emplace_back. If copying an
+     * element of a sized range throws, the elements already appended by this
+     * call are destroyed and the size is unchanged.
+     *
+     * @param rg range whose elements are copied, must not refer to this vector
+     * @return void
+     *******************************************************************************/
+    template <class T, typename A>
+    template <detail::container_compatible_range<T> R>
+    constexpr void Vector<T, A>::append_range(R &&rg)
+    {
+        if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>)
+        {
+            size_type n = static_cast<size_type>(std::ranges::distance(rg));
+            size_type needed = size() + n;
+
+            // grow geometrically so that repeated appends stay amortized O(1)
+            if (needed > capacity())
+                reserve(std::max(needed, capacity() << 1));
+
+            T *dest = mem_manager.uninitialized_block_start;
+
+            if constexpr (std::ranges::contiguous_range<R> &&
+                          std::is_trivially_copyable_v<T> &&
+                          std::is_same_v<std::remove_cvref_t<std::ranges::range_reference_t<R>>, T>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    if (n != 0)
+                        std::memcpy(dest, std::ranges::data(rg), n * sizeof(T));
+
+                    mem_manager.uninitialized_block_start += n;
+                    return;
+                }
+            }
+
+            auto first = std::ranges::begin(rg);
+            try
+            {
+                for (size_type i = 0; i < n; ++i, ++first, ++dest)
+                    std::construct_at(dest, *first);
+            }
+            catch (...)
+            {
+                std::destroy(mem_manager.uninitialized_block_start, dest);
+                throw;
+            }
+
+            mem_manager.uninitialized_block_start += n;
+        }
+        else
+        {
+            for (auto &&val : rg)
+                emplace_back(std::forward<decltype(val)>(val));
+        }
+    }
+
+    /*******************************************************************************
+     * append_construct
+     *
+     * @brief grow the vector by n elements constructed in place by construct
+     *
+     * The storage is sized exactly once, then construct(first, last) is
+     * called on the uninitialized range [first, last) at the end of the
+     * vector. It must construct every element of the range, or throw having
+     * constructed none (as the std uninitialized algorithms do), and must
+     * not touch the vector itself. This lets bulk producers, such as a
+     * parallel copy, write straight into the vector's storage.
+     *
+     * @param n number of elements to append
+     * @param construct callable taking (T *first, T *last)
+     * @return void
+     *******************************************************************************/
+    template <class T, typename A>
+    template <class Fn>
+    constexpr void Vector<T, A>::append_construct(size_type n, Fn construct)
+    {
+        reserve(size() + n);
+
+        T *first = mem_manager.uninitialized_block_start;
+        construct(first, first + n);
+
+        mem_manager.uninitialized_block_start += n;
     }
 
     /*******************************************************************************
@@ -616,33 +1327,52 @@ namespace custom
      * @param index position to insert
      * @param val the value to add
      *
-     * @return void
+     * @return iterator to the inserted element
      *******************************************************************************/
     template <class T, typename A>
-    Vector<T, A>::Iterator Vector<T, A>::insert(Iterator pos, const T &val)
+    constexpr Vector<T, A>::Iterator Vector<T, A>::insert(Const_Iterator pos, const T &val)
     {
-        // Implementation logic: First insert the new element at the end
-        // of the vector. Then move slide the new element into its correct
-        // position via a series of swaps
+        // copy first, val may refer to an element that is about to shift
+        return insert(pos, T(val));
+    }
+
+    /*******************************************************************************
+     * insert
+     *
+     * @brief move val into given index
+     *
+     * @param index position to insert
+     * @param val the value to add
+     *
+     * @return iterator to the inserted element
+     *******************************************************************************/
+    template <class T, typename A>
+    constexpr Vector<T, A>::Iterator Vector<T, A>::insert(Const_Iterator pos, T &&val)
+    {
+        // Implementation logic: Grow the vector by one at the end, then
+        // shift the tail right by one slot with a single move per element
+        // and move val into the opened gap
 
         if (pos < begin() || pos > end())
         {
             throw std::out_of_range("Invalid iterator. Insertion failed.");
         }
-        // store the pos idx since the call to
-        // push_back may invalidate the iterator
+        // store the pos idx since growing the
+        // vector may invalidate the iterator
         size_t idx_to_insert = pos - begin();
-        push_back(val);
 
-        Iterator location = this->begin() + idx_to_insert;
-
-        auto right = --end();
-        while (right != location)
+        if (idx_to_insert == size())
         {
-            std::swap(*(right - 1), *right);
-            --right;
+            emplace_back(std::move(val));
+            return begin() + idx_to_insert;
         }
 
+        emplace_back(std::move(back()));
+
+        Iterator location = this->begin() + idx_to_insert;
+        std::move_backward(location, end() - 2, end() - 1);
+        *location = std::move(val);
+
         return location;
     }
 
@@ -654,20 +1384,16 @@ namespace custom
      * @return void
      *******************************************************************************/
     template <class T, typename A>
-    void Vector<T, A>::erase(Iterator position)
+    constexpr void Vector<T, A>::erase(Const_Iterator position)
     {
-        // throw std::logic_error(__PRETTY_FUNCTION__ + std::string("function not yet implemented"));
-
         if (empty() || position == end())
             return;
 
-        while (position + 1 != end())
-        {
-            std::swap(*position, *(position + 1));
-            ++position;
-        }
-        // the element to erase is now
-        // the last element in the vector;
+        Iterator location = begin() + (position - cbegin());
+
+        // shift the tail left over the erased element, the
+        // last element is then a moved-from duplicate
+        std::move(location + 1, end(), location);
         pop_back();
     }
 
@@ -679,7 +1405,7 @@ namespace custom
      * @return void
      *******************************************************************************/
     template <class T, typename A>
-    void Vector<T, A>::pop_back()
+    constexpr void Vector<T, A>::pop_back()
     {
         if (empty())
             throw std::out_of_range(__PRETTY_FUNCTION__ + std::string(": Vector is empty"));
@@ -690,6 +1416,118 @@ namespace custom
         mem_manager.uninitialized_block_start -= 1;
     }
 
+    /*******************************************************************************
+     * unique_sorted
+     *
+     * @brief remove duplicates from a vector whose equal elements are
+     * adjacent (e.g. a sorted one), in one pass, keeping the first of each run
+     *
+     * @return number of elements removed
+     *******************************************************************************/
+    template <class T, typename A>
+    constexpr typename Vector<T, A>::size_type Vector<T, A>::unique_sorted()
+    {
+        T *first = mem_manager.block_start;
+        T *last = mem_manager.uninitialized_block_start;
+        T *new_end = std::unique(first, last);
+
+        std::destroy(new_end, last);
+        mem_manager.uninitialized_block_start = new_end;
+
+        return last - new_end;
+    }
+
+    /*******************************************************************************
+     * unique_unsorted
+     *
+     * @brief remove duplicates in one pass, keeping the first occurrence of
+     * each value and the order of the kept elements
+     *
+     * Kept elements are moved down to the front and their positions put in a
+     * scratch open-addressing table (at most half full, linear probing)
+     * allocated from the vector's allocator. Elements are hashed with
+     * hash_element, so T needs std::hash or must be detail::byte_hashable.
+     * If the table cannot be allocated the vector is left unchanged.
+     *
+     * @return number of elements removed
+     *******************************************************************************/
+    template <class T, typename A>
+    typename Vector<T, A>::size_type Vector<T, A>::unique_unsorted()
+    {
+        if (size() < 2)
+            return 0;
+
+        // 32-bit positions halve the table whenever they are enough
+        if (size() < std::numeric_limits<std::uint32_t>::max())
+            return unique_unsorted_indexed<std::uint32_t>();
+
+        return unique_unsorted_indexed<size_type>();
+    }
+
+    template <class T, typename A>
+    template <class Index>
+    typename Vector<T, A>::size_type Vector<T, A>::unique_unsorted_indexed()
+    {
+        using Index_Alloc = typename std::allocator_traits<A>::template rebind_alloc<Index>;
+        constexpr Index empty_slot = std::numeric_limits<Index>::max();
+
+        size_type n = size();
+        size_type mask = std::bit_ceil(2 * n) - 1;
+        Vector<Index, Index_Alloc> table(mask + 1, empty_slot, Index_Alloc(mem_manager.alloc));
+
+        T *elems = mem_manager.block_start;
+        Index *slots = table.data();
+        size_type kept = 0;
+
+        for (size_type i = 0; i < n; ++i)
+        {
+            size_type slot = detail::hash_element(elems[i]) & mask;
+            bool seen = false;
+
+            for (; slots[slot] != empty_slot; slot = (slot + 1) & mask)
+            {
+                if (elems[slots[slot]] == elems[i])
+                {
+                    seen = true;
+                    break;
+                }
+            }
+
+            if (seen)
+                continue;
+
+            if (kept != i)
+                elems[kept] = std::move(elems[i]);
+            slots[slot] = static_cast<Index>(kept++);
+        }
+
+        std::destroy(elems + kept, elems + n);
+        mem_manager.uninitialized_block_start = elems + kept;
+
+        return n - kept;
+    }
+
+    /*******************************************************************************
+     * dedup
+     *
+     * @brief remove duplicates, keeping the first occurrence of each value
+     * and the order of the kept elements
+     *
+     * A vector that is already sorted takes the unique_sorted pass (one
+     * is_sorted scan decides), anything else unique_unsorted.
+     *
+     * @return number of elements removed
+     *******************************************************************************/
+    template <class T, typename A>
+    typename Vector<T, A>::size_type Vector<T, A>::dedup()
+    {
+        if constexpr (std::totally_ordered<T>)
+            if (std::is_sorted(mem_manager.block_start, mem_manager.uninitialized_block_start))
+                return unique_sorted();
+
+        return unique_unsorted();
+    }
+
     /********************************************************************************
      * destroyElements
      *
@@ -699,12 +1537,85 @@ namespace custom
      * @return void
      ********************************************************************************/
     template <class T, typename A>
-    void Vector<T, A>::destroyElements()
+    constexpr void Vector<T, A>::destroyElements()
     {
         std::destroy_n(mem_manager.block_start, size());
 
         mem_manager.uninitialized_block_start = mem_manager.block_start;
     }
+
+    /********************************************************************************
+     * materialize
+     *
+     * @brief run a Vector generator at compile time and copy its result
+     * into a std::array
+     *
+     * Memory allocated during constant evaluation must be freed before the
+     * evaluation ends, so a Vector cannot itself be a constexpr variable.
+     * Instead, build the table inside a constexpr lambda and materialize it:
+     *
+     *     constexpr auto make = [] { Vector<int> v; ...; return v; };
+     *     constexpr auto table = materialize<make().size()>(make);
+     *
+     * @tparam N  number of elements gen produces
+     * @param gen callable returning a Vector
+     * @return std::array holding a copy of the generated elements
+     ********************************************************************************/
+    template <std::size_t N, class Generator>
+    constexpr auto materialize(Generator gen)
+    {
+        auto vec = gen();
+
+        std::array<typename decltype(vec)::value_type, N> table{};
+
+        if (vec.size() != N)
+            throw std::length_error("materialize: generator size does not match N");
+
+        std::copy(vec.data(), vec.data() + N, table.begin());
+
+        return table;
+    }
+
+    /********************************************************************************
+     * hash
+     *
+     * @brief hash the contents of a Vector, consistent with its ==
+     *
+     * Integers, enums and pointers are hashed as one block of bytes with
+     * detail::hash_bytes, which runs SSE2 / AVX2 kernels when the build has
+     * them. So is a padding-free class that declares
+     * using is_byte_hashable = std::true_type, promising its == compares
+     * every member. Other elements (floating point, strings, nested Vectors,
+     * classes that do not opt in) are combined one std::hash at a time.
+     *
+     * @param seed changes the whole function, e.g. per cache
+     ********************************************************************************/
+    template <class T, class A>
+        requires detail::element_hashable<T>
+    std::uint64_t hash(const Vector<T, A> &v, std::uint64_t seed = 0)
+    {
+        if constexpr (detail::byte_hashable<T>)
+            return detail::hash_bytes(v.data(), v.size() * sizeof(T), seed);
+        else
+        {
+            std::uint64_t h = detail::hash_combine(seed, v.size());
+            for (const T *p = v.data(), *end = p + v.size(); p != end; ++p)
+                h = detail::hash_combine(h, std::hash<T>{}(*p));
+
+            return detail::avalanche(h);
+        }
+    }
 }
 
+// lets a Vector key std::unordered_map / unordered_set
+template <class T, class A>
+    requires custom::detail::element_hashable<T>
+struct std::hash<custom::Vector<T, A>>
+{
+    std::size_t operator()(const custom::Vector<T, A> &v) const
+    {
+        return custom::hash(v);
+    }
+};
+
 #endif // CUSTOM_VECTOR_H
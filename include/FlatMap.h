@@ -0,0 +1,309 @@
+/*******************************************************************************
+ *  @file FlatMap.h
+ *  @brief This file contains methods that define and implement a sorted
+ *  key/value map stored contiguously in a custom Vector
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H 1
+
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "CustomVector.h"
+#include "SortedVector.h"
+
+namespace custom
+{
+    /*******************************************************************************
+     * class FlatMap
+     *
+     *  @brief An associative container of unique keys kept as sorted
+     *  (key, value) pairs in a contiguous Vector
+     *
+     *  A cache friendly replacement for small, read-heavy std::map
+     *  dictionaries. Lookup is a branchless binary search; bulk loads should go
+     *  through insert_batch, which merges a sorted batch in one pass. As with
+     *  std::map::insert, inserting a key that is already present leaves the
+     *  existing value untouched.
+     *
+     *  Iterators give mutable access to the pairs; changing a key through
+     *  them is not allowed.
+     *
+     *  @tparam K  Type of key.
+     *  @tparam V  Type of mapped value.
+     *  @tparam Compare  Strict weak ordering of keys, default value is less<K>.
+     *  @tparam AllocType  Allocator type, default value is allocator<pair<K, V>>.
+     *
+     *******************************************************************************/
+    template <class K, class V, class Compare = std::less<K>,
+              typename AllocType = std::allocator<std::pair<K, V>>>
+    class FlatMap
+    {
+    public:
+        using size_type = size_t;
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+        using iterator = value_type *;
+        using const_iterator = const value_type *;
+
+        FlatMap(const Compare &comp = Compare(), const AllocType &alloc = AllocType());
+        FlatMap(std::initializer_list<value_type> ilist, const Compare &comp = Compare(),
+                const AllocType &alloc = AllocType());
+
+        // Lookup
+        iterator lower_bound(const K &key);
+        const_iterator lower_bound(const K &key) const;
+        iterator find(const K &key);
+        const_iterator find(const K &key) const;
+        bool contains(const K &key) const { return find(key) != end(); }
+
+        // Element Access
+        V &at(const K &key);
+        const V &at(const K &key) const;
+        V &operator[](const K &key);
+        AllocType get_allocator() const noexcept { return m_items.get_allocator(); }
+
+        // Modifiers
+        std::pair<iterator, bool> insert(const value_type &val) { return insert(value_type(val)); }
+        std::pair<iterator, bool> insert(value_type &&val);
+        std::pair<iterator, bool> insert_or_assign(const K &key, const V &val);
+        template <class InputIt>
+        size_type insert_batch(InputIt first, InputIt last);
+        size_type insert_batch(std::initializer_list<value_type> ilist) { return insert_batch(ilist.begin(), ilist.end()); }
+        size_type erase(const K &key);
+        void clear() { m_items.clear(); }
+
+        // Size and Capacity
+        void reserve(size_type n) { m_items.reserve(n); }
+        size_type size() const noexcept { return m_items.size(); }
+        size_type capacity() const noexcept { return m_items.capacity(); }
+        bool empty() const noexcept { return m_items.empty(); }
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        iterator begin() noexcept { return m_items.data(); }
+        const_iterator begin() const noexcept { return m_items.data(); }
+        const_iterator cbegin() const noexcept { return m_items.data(); }
+        iterator end() noexcept { return m_items.data() + size(); }
+        const_iterator end() const noexcept { return m_items.data() + size(); }
+        const_iterator cend() const noexcept { return m_items.data() + size(); }
+
+    private:
+        // orders pairs by key, and compares pairs against bare keys
+        struct Key_Compare
+        {
+            bool operator()(const value_type &a, const value_type &b) const { return comp(a.first, b.first); }
+            bool operator()(const value_type &a, const K &b) const { return comp(a.first, b); }
+            bool operator()(const K &a, const value_type &b) const { return comp(a, b.first); }
+
+            Compare comp;
+        };
+
+        Vector<value_type, AllocType> m_items;
+        Key_Compare m_comp;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    FLAT MAP METHODS  ---------------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * default constructor
+     *
+     * @param comp key comparison object
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class K, class V, class C, typename A>
+    FlatMap<K, V, C, A>::FlatMap(const C &comp, const A &alloc)
+        : m_items{alloc}, m_comp{comp}
+    {
+    }
+
+    /*******************************************************************************
+     * @brief initializer_list constructor
+     *
+     * @param ilist list of (key, value) pairs, need not be sorted; for a
+     *  repeated key the first pair wins
+     * @param comp key comparison object
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class K, class V, class C, typename A>
+    FlatMap<K, V, C, A>::FlatMap(std::initializer_list<value_type> ilist, const C &comp, const A &alloc)
+        : m_items{ilist, alloc}, m_comp{comp}
+    {
+        detail::sort_unique(m_items, m_comp);
+    }
+
+    /*******************************************************************************
+     * lower_bound
+     *
+     * @return iterator to the first pair whose key is not less than key
+     *******************************************************************************/
+    template <class K, class V, class C, typename A>
+    typename FlatMap<K, V, C, A>::iterator FlatMap<K, V, C, A>::lower_bound(const K &key)
+    {
+        return detail::branchless_partition_point(m_items.data(), size(), [&](const value_type &val)
+                                                  { return m_comp(val, key); });
+    }
+
+    template <class K, class V, class C, typename A>
+    typename FlatMap<K, V, C, A>::const_iterator FlatMap<K, V, C, A>::lower_bound(const K &key) const
+    {
+        return detail::branchless_partition_point(m_items.data(), size(), [&](const value_type &val)
+                                                  { return m_comp(val, key); });
+    }
+
+    /*******************************************************************************
+     * find
+     *
+     * @return iterator to the pair with the given key, or end()
+     *******************************************************************************/
+    template <class K, class V, class C, typename A>
+    typename FlatMap<K, V, C, A>::iterator FlatMap<K, V, C, A>::find(const K &key)
+    {
+        iterator pos = lower_bound(key);
+
+        return (pos != end() && !m_comp(key, *pos)) ? pos : end();
+    }
+
+    template <class K, class V, class C, typename A>
+    typename FlatMap<K, V, C, A>::const_iterator FlatMap<K, V, C, A>::find(const K &key) const
+    {
+        const_iterator pos = lower_bound(key);
+
+        return (pos != end() && !m_comp(key, *pos)) ? pos : end();
+    }
+
+    /*******************************************************************************
+     * at
+     *
+     * @return reference to the value mapped to key
+     *******************************************************************************/
+    template <class K, class V, class C, typename A>
+    V &FlatMap<K, V, C, A>::at(const K &key)
+    {
+        iterator pos = find(key);
+
+        if (pos == end())
+            throw std::out_of_range("FlatMap: key not found");
+
+        return pos->second;
+    }
+
+    template <class K, class V, class C, typename A>
+    const V &FlatMap<K, V, C, A>::at(const K &key) const
+    {
+        const_iterator pos = find(key);
+
+        if (pos == end())
+            throw std::out_of_range("FlatMap: key not found");
+
+        return pos->second;
+    }
+
+    /*******************************************************************************
+     * operator[]
+     *
+     * @brief access the value mapped to key, inserting V() if key is absent
+     *
+     * @return reference to the mapped value
+     *******************************************************************************/
+    template <class K, class V, class C, typename A>
+    V &FlatMap<K, V, C, A>::operator[](const K &key)
+    {
+        return insert(value_type(key, V())).first->second;
+    }
+
+    /*******************************************************************************
+     * insert
+     *
+     * @brief insert val unless its key is already present
+     *
+     * @return iterator to the pair with val's key, and whether val was inserted
+     *******************************************************************************/
+    template <class K, class V, class C, typename A>
+    std::pair<typename FlatMap<K, V, C, A>::iterator, bool> FlatMap<K, V, C, A>::insert(value_type &&val)
+    {
+        iterator pos = lower_bound(val.first);
+
+        if (pos != end() && !m_comp(val, *pos))
+            return {pos, false};
+
+        size_type idx = pos - begin();
+        m_items.insert(m_items.begin() + idx, std::move(val));
+
+        return {begin() + idx, true};
+    }
+
+    /*******************************************************************************
+     * insert_or_assign
+     *
+     * @brief map key to val, replacing any existing value
+     *
+     * @return iterator to the pair, and whether a new pair was inserted
+     *******************************************************************************/
+    template <class K, class V, class C, typename A>
+    std::pair<typename FlatMap<K, V, C, A>::iterator, bool>
+    FlatMap<K, V, C, A>::insert_or_assign(const K &key, const V &val)
+    {
+        std::pair<iterator, bool> result = insert(value_type(key, val));
+
+        if (!result.second)
+            result.first->second = val;
+
+        return result;
+    }
+
+    /*******************************************************************************
+     * insert_batch
+     *
+     * @brief insert every pair of [first, last) in a single merge pass
+     *
+     * Pairs whose key is already present, or repeated within the batch
+     * after its first occurrence, are ignored.
+     *
+     * @return number of pairs inserted
+     *******************************************************************************/
+    template <class K, class V, class C, typename A>
+    template <class InputIt>
+    typename FlatMap<K, V, C, A>::size_type FlatMap<K, V, C, A>::insert_batch(InputIt first, InputIt last)
+    {
+        Vector<value_type, A> batch(m_items.get_allocator());
+        for (; first != last; ++first)
+            batch.push_back(*first);
+
+        detail::sort_unique(batch, m_comp);
+
+        return detail::merge_sorted_batch(m_items, batch, m_comp);
+    }
+
+    /*******************************************************************************
+     * erase
+     *
+     * @brief remove the pair with the given key
+     *
+     * @return number of pairs removed (0 or 1)
+     *******************************************************************************/
+    template <class K, class V, class C, typename A>
+    typename FlatMap<K, V, C, A>::size_type FlatMap<K, V, C, A>::erase(const K &key)
+    {
+        iterator pos = find(key);
+
+        if (pos == end())
+            return 0;
+
+        m_items.erase(m_items.begin() + (pos - begin()));
+
+        return 1;
+    }
+}
+
+#endif // FLAT_MAP_H
@@ -0,0 +1,575 @@
+/*******************************************************************************
+ *  @file GatherScatter.h
+ *  @brief This file contains methods that gather, scatter, permute and
+ *  filter custom Vectors by index and mask
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef GATHER_SCATTER_H
+#define GATHER_SCATTER_H 1
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "BitVector.h"
+#include "CustomVector.h"
+
+namespace custom
+{
+    namespace detail
+    {
+        template <class I>
+        concept gather_index = std::integral<I> && !std::same_as<I, bool>;
+
+        // elements the hardware can gather, scatter and compress as integers
+        template <class T>
+        concept simd_lane = std::is_trivially_copyable_v<T> && (sizeof(T) == 4 || sizeof(T) == 8);
+
+        // sources past this size miss cache on random indices, so the loops
+        // prefetch the element prefetch_distance indices ahead
+        inline constexpr size_t gather_prefetch_bytes = size_t{1} << 21;
+        inline constexpr size_t prefetch_distance = 32;
+
+        inline void prefetch_read(const void *p) noexcept
+        {
+#if defined(__GNUC__)
+            __builtin_prefetch(p, 0);
+#else
+            (void)p;
+#endif
+        }
+
+        inline void prefetch_write(const void *p) noexcept
+        {
+#if defined(__GNUC__)
+            __builtin_prefetch(p, 1);
+#else
+            (void)p;
+#endif
+        }
+
+        /*******************************************************************************
+         * check_indices
+         *
+         * @brief throw unless every one of the n indices is below bound
+         *
+         * One sequential max over the indices (negative ones wrap to huge
+         * unsigned values), so the gather loops need no per-element checks.
+         *******************************************************************************/
+        template <gather_index I>
+        void check_indices(const I *idx, size_t n, size_t bound, const char *what)
+        {
+            using U = std::make_unsigned_t<I>;
+
+            U max = 0;
+            for (size_t i = 0; i < n; ++i)
+                max = static_cast<U>(idx[i]) > max ? static_cast<U>(idx[i]) : max;
+
+            if (n && max >= bound)
+                throw std::out_of_range(what);
+        }
+
+        // whether the hardware gather/scatter, whose 32-bit indices are signed, can address bound elements
+        template <class T, class I>
+        constexpr bool use_simd_indices(size_t bound) noexcept
+        {
+            if constexpr (simd_lane<T> && (sizeof(I) == 4 || sizeof(I) == 8))
+                return sizeof(I) == 8 || bound <= size_t(std::numeric_limits<std::int32_t>::max());
+            else
+                return false;
+        }
+
+#if defined(__AVX512F__)
+        /*******************************************************************************
+         * gather_simd
+         *
+         * @brief out[i] = src[idx[i]] for whole 512-bit vectors of output,
+         * with AVX-512 gathers
+         *
+         * @return elements done; the caller finishes the tail
+         *******************************************************************************/
+        template <class T, class I>
+        size_t gather_simd(T *out, const T *src, const I *idx, size_t n) noexcept
+        {
+            // the masked forms with every lane on and a zero source; the
+            // unmasked ones merge into an undefined register, which GCC
+            // reports as maybe uninitialized
+            size_t i = 0;
+            if constexpr (sizeof(T) == 4 && sizeof(I) == 4)
+                for (; i + 16 <= n; i += 16)
+                    _mm512_storeu_si512(out + i, _mm512_mask_i32gather_epi32(
+                                                     _mm512_setzero_si512(), 0xFFFF, _mm512_loadu_si512(idx + i), src, 4));
+            else if constexpr (sizeof(T) == 8 && sizeof(I) == 4)
+                for (; i + 8 <= n; i += 8)
+                    _mm512_storeu_si512(out + i, _mm512_mask_i32gather_epi64(
+                                                     _mm512_setzero_si512(), 0xFF,
+                                                     _mm256_loadu_si256(reinterpret_cast<const __m256i *>(idx + i)), src, 8));
+            else if constexpr (sizeof(T) == 4 && sizeof(I) == 8)
+                for (; i + 8 <= n; i += 8)
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                                        _mm512_mask_i64gather_epi32(
+                                            _mm256_setzero_si256(), 0xFF, _mm512_loadu_si512(idx + i), src, 4));
+            else
+                for (; i + 8 <= n; i += 8)
+                    _mm512_storeu_si512(out + i, _mm512_mask_i64gather_epi64(
+                                                     _mm512_setzero_si512(), 0xFF, _mm512_loadu_si512(idx + i), src, 8));
+            return i;
+        }
+
+        /*******************************************************************************
+         * scatter_simd
+         *
+         * @brief dest[idx[i]] = values[i] for whole 512-bit vectors of values,
+         * with AVX-512 scatters
+         *
+         * Lanes are written in order, so a repeated index keeps the later
+         * value, as in the scalar loop.
+         *
+         * @return elements done; the caller finishes the tail
+         *******************************************************************************/
+        template <class T, class I>
+        size_t scatter_simd(T *dest, const T *values, const I *idx, size_t n) noexcept
+        {
+            size_t i = 0;
+            if constexpr (sizeof(T) == 4 && sizeof(I) == 4)
+                for (; i + 16 <= n; i += 16)
+                    _mm512_i32scatter_epi32(dest, _mm512_loadu_si512(idx + i), _mm512_loadu_si512(values + i), 4);
+            else if constexpr (sizeof(T) == 8 && sizeof(I) == 4)
+                for (; i + 8 <= n; i += 8)
+                    _mm512_i32scatter_epi64(dest, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(idx + i)),
+                                            _mm512_loadu_si512(values + i), 8);
+            else if constexpr (sizeof(T) == 4 && sizeof(I) == 8)
+                for (; i + 8 <= n; i += 8)
+                    _mm512_i64scatter_epi32(dest, _mm512_loadu_si512(idx + i),
+                                            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i)), 4);
+            else
+                for (; i + 8 <= n; i += 8)
+                    _mm512_i64scatter_epi64(dest, _mm512_loadu_si512(idx + i), _mm512_loadu_si512(values + i), 8);
+            return i;
+        }
+#elif defined(__AVX2__)
+        template <class T, class I>
+        size_t gather_simd(T *out, const T *src, const I *idx, size_t n) noexcept
+        {
+            auto base32 = reinterpret_cast<const int *>(src);
+            auto base64 = reinterpret_cast<const long long *>(src);
+
+            size_t i = 0;
+            if constexpr (sizeof(T) == 4 && sizeof(I) == 4)
+                for (; i + 8 <= n; i += 8)
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                                        _mm256_i32gather_epi32(base32, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(idx + i)), 4));
+            else if constexpr (sizeof(T) == 8 && sizeof(I) == 4)
+                for (; i + 4 <= n; i += 4)
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                                        _mm256_i32gather_epi64(base64, _mm_loadu_si128(reinterpret_cast<const __m128i *>(idx + i)), 8));
+            else if constexpr (sizeof(T) == 4 && sizeof(I) == 8)
+                for (; i + 4 <= n; i += 4)
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                                     _mm256_i64gather_epi32(base32, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(idx + i)), 4));
+            else
+                for (; i + 4 <= n; i += 4)
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                                        _mm256_i64gather_epi64(base64, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(idx + i)), 8));
+            return i;
+        }
+
+        // AVX2 has no scatter
+        template <class T, class I>
+        size_t scatter_simd(T *, const T *, const I *, size_t) noexcept { return 0; }
+#endif
+
+        /*******************************************************************************
+         * gather_into
+         *
+         * @brief construct out[i] from src[idx[i]] for i in [0, n)
+         *
+         * Indices must already be checked. When src is too large for cache,
+         * the element prefetch_distance indices ahead is prefetched, so
+         * several random misses are in flight instead of one at a time.
+         * Elements constructed before an exception are destroyed again.
+         *******************************************************************************/
+        template <class T, gather_index I>
+        void gather_into(T *out, const T *src, size_t bound, const I *idx, size_t n)
+        {
+            bool prefetch = bound * sizeof(T) > gather_prefetch_bytes;
+            size_t i = 0;
+
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+#if defined(__AVX2__) || defined(__AVX512F__)
+                if (use_simd_indices<T, I>(bound))
+                {
+                    // the same prefetching, for a few vectors at a time
+                    constexpr size_t step = 16;
+                    for (; i + step <= n; i += step)
+                    {
+                        if (prefetch && i + prefetch_distance + step <= n)
+                            for (size_t k = 0; k < step; ++k)
+                                prefetch_read(src + idx[i + prefetch_distance + k]);
+                        gather_simd(out + i, src, idx + i, step);
+                    }
+                    i += gather_simd(out + i, src, idx + i, n - i);
+                }
+#endif
+                for (; i < n; ++i)
+                {
+                    if (prefetch && i + prefetch_distance < n)
+                        prefetch_read(src + idx[i + prefetch_distance]);
+                    out[i] = src[idx[i]];
+                }
+            }
+            else
+            {
+                try
+                {
+                    for (; i < n; ++i)
+                    {
+                        if (prefetch && i + prefetch_distance < n)
+                            prefetch_read(src + idx[i + prefetch_distance]);
+                        std::construct_at(out + i, src[idx[i]]);
+                    }
+                }
+                catch (...)
+                {
+                    std::destroy(out, out + i);
+                    throw;
+                }
+            }
+        }
+
+        /*******************************************************************************
+         * compress_chunk
+         *
+         * @brief write the elements of src[0, lanes) whose bit is set in bits,
+         * in order, to out
+         *
+         * The AVX2 version stores a whole vector, so up to compress_lanes<T>
+         * elements at out may be written; callers leave that much slack.
+         *
+         * @return number of elements selected
+         *******************************************************************************/
+#if defined(__AVX512F__)
+        template <class T>
+        inline constexpr size_t compress_lanes = simd_lane<T> ? 64 / sizeof(T) : 0;
+
+        template <class T>
+        size_t compress_chunk(T *out, const T *src, std::uint64_t bits) noexcept
+        {
+            if constexpr (sizeof(T) == 4)
+                _mm512_mask_compressstoreu_epi32(out, static_cast<__mmask16>(bits), _mm512_loadu_si512(src));
+            else
+                _mm512_mask_compressstoreu_epi64(out, static_cast<__mmask8>(bits), _mm512_loadu_si512(src));
+            return std::popcount(bits);
+        }
+#elif defined(__AVX2__)
+        template <class T>
+        inline constexpr size_t compress_lanes = simd_lane<T> ? 32 / sizeof(T) : 0;
+
+        // for each 8-bit mask, the 32-bit lanes to move to the front, packed 4 bits per lane
+        inline constexpr std::array<std::uint32_t, 256> compress_table = []
+        {
+            std::array<std::uint32_t, 256> table{};
+            for (unsigned mask = 0; mask < 256; ++mask)
+            {
+                unsigned k = 0;
+                for (unsigned lane = 0; lane < 8; ++lane)
+                    if (mask >> lane & 1)
+                        table[mask] |= lane << (4 * k++);
+            }
+            return table;
+        }();
+
+        template <class T>
+        size_t compress_chunk(T *out, const T *src, std::uint64_t bits) noexcept
+        {
+            // 64-bit lanes move as pairs of 32-bit lanes
+            unsigned mask32 = static_cast<unsigned>(bits);
+            if constexpr (sizeof(T) == 8)
+                mask32 = (bits & 1) * 0x03 | (bits >> 1 & 1) * 0x0c | (bits >> 2 & 1) * 0x30 | (bits >> 3 & 1) * 0xc0;
+
+            __m256i shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+            __m256i perm = _mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(compress_table[mask32])), shifts);
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_permutevar8x32_epi32(v, perm));
+            return std::popcount(bits);
+        }
+#else
+        template <class T>
+        inline constexpr size_t compress_lanes = 0;
+#endif
+
+        /*******************************************************************************
+         * compress_into
+         *
+         * @brief construct, in order, the elements of src[0, n) whose bit in
+         * bits_at(base) is set, 64 elements per call of bits_at
+         *
+         * Chunks with no bit set are skipped, then set bits are either handed
+         * to compress_chunk or walked one at a time with countr_zero.
+         *******************************************************************************/
+        template <class T, class BitsAt>
+        void compress_into(T *out, const T *src, size_t n, BitsAt bits_at)
+        {
+            T *first = out;
+            try
+            {
+                for (size_t base = 0; base < n; base += 64)
+                {
+                    std::uint64_t word = bits_at(base);
+#if defined(__AVX2__) || defined(__AVX512F__)
+                    if constexpr (simd_lane<T>)
+                    {
+                        constexpr size_t lanes = compress_lanes<T>;
+                        if (base + 64 <= n)
+                        {
+                            for (size_t lane = 0; lane < 64; lane += lanes)
+                            {
+                                std::uint64_t bits = word >> lane & ((std::uint64_t{1} << lanes) - 1);
+                                if (bits)
+                                    out += compress_chunk(out, src + base + lane, bits);
+                            }
+                            continue;
+                        }
+                    }
+#endif
+                    for (; word; word &= word - 1)
+                        std::construct_at(out++, src[base + std::countr_zero(word)]);
+                }
+            }
+            catch (...)
+            {
+                std::destroy(first, out);
+                throw;
+            }
+        }
+
+        /*******************************************************************************
+         * byte_mask_bits
+         *
+         * @brief the 64 (or, at the end, fewer) flags of mask from base, one bit each
+         *******************************************************************************/
+        template <class M>
+        std::uint64_t byte_mask_bits(const M *mask, size_t base, size_t n) noexcept
+        {
+            size_t count = n - base < 64 ? n - base : 64;
+
+            std::uint64_t bits = 0;
+            for (size_t i = 0; i < count; ++i)
+                bits |= std::uint64_t{mask[base + i] != M{}} << i;
+            return bits;
+        }
+    }
+
+    /*******************************************************************************
+     * take
+     *
+     * @brief gather: a Vector of src[indices[i]] for each i
+     *
+     * Trivially copyable 32- and 64-bit elements are gathered eight or
+     * sixteen at a time with AVX2 / AVX-512 gather instructions when the
+     * build enables them; otherwise, and for other types, a scalar loop.
+     * Both prefetch ahead when src is larger than the cache.
+     *
+     * @throw std::out_of_range if an index is not below src.size()
+     *******************************************************************************/
+    template <class T, class A, detail::gather_index I, class AI>
+    Vector<T, A> take(const Vector<T, A> &src, const Vector<I, AI> &indices)
+    {
+        size_t n = indices.size();
+        detail::check_indices(indices.data(), n, src.size(), "take: index out of range");
+
+        Vector<T, A> out(src.get_allocator());
+        out.append_construct(n, [&](T *first, T *)
+                             { detail::gather_into(first, src.data(), src.size(), indices.data(), n); });
+        return out;
+    }
+
+    /*******************************************************************************
+     * scatter
+     *
+     * @brief dest[indices[i]] = values[i] for each i, in order, so a repeated
+     * index keeps the last of its values
+     *
+     * Uses AVX-512 scatters for trivially copyable 32- and 64-bit elements
+     * when the build enables them, a scalar loop (prefetching dest for
+     * writing when it is larger than the cache) otherwise.
+     *
+     * @throw std::invalid_argument if indices and values differ in size
+     * @throw std::out_of_range if an index is not below dest.size()
+     *******************************************************************************/
+    template <class T, class A, detail::gather_index I, class AI, class AV>
+    void scatter(Vector<T, A> &dest, const Vector<I, AI> &indices, const Vector<T, AV> &values)
+    {
+        size_t n = indices.size();
+        if (values.size() != n)
+            throw std::invalid_argument("scatter: indices and values differ in size");
+        detail::check_indices(indices.data(), n, dest.size(), "scatter: index out of range");
+
+        T *out = dest.data();
+        const T *vals = values.data();
+        const I *idx = indices.data();
+        bool prefetch = dest.size() * sizeof(T) > detail::gather_prefetch_bytes;
+        size_t i = 0;
+
+#if defined(__AVX512F__)
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (detail::use_simd_indices<T, I>(dest.size()))
+            {
+                constexpr size_t step = 16;
+                for (; i + step <= n; i += step)
+                {
+                    if (prefetch && i + detail::prefetch_distance + step <= n)
+                        for (size_t k = 0; k < step; ++k)
+                            detail::prefetch_write(out + idx[i + detail::prefetch_distance + k]);
+                    detail::scatter_simd(out, vals + i, idx + i, step);
+                }
+                i += detail::scatter_simd(out, vals + i, idx + i, n - i);
+            }
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            if (prefetch && i + detail::prefetch_distance < n)
+                detail::prefetch_write(out + idx[i + detail::prefetch_distance]);
+            out[idx[i]] = vals[i];
+        }
+    }
+
+    /*******************************************************************************
+     * apply_permutation
+     *
+     * @brief reorder v in place so that the new v[i] is the old v[perm[i]],
+     * as take(v, perm) would, without a second copy of v
+     *
+     * Follows each cycle of perm, moving every element once and holding one
+     * element aside per cycle. A BitVector (n bits) records which positions
+     * are done; the same pass that fills it first checks that perm is a
+     * permutation, before v is touched.
+     *
+     * Each step of a cycle needs the index loaded by the step before, so on
+     * a large random permutation this runs at memory latency, several times
+     * slower than take and a swap. It is the choice when a second copy of v
+     * does not fit.
+     *
+     * @throw std::invalid_argument if perm is not a permutation of [0, v.size())
+     *******************************************************************************/
+    template <class T, class A, detail::gather_index I, class AI>
+    void apply_permutation(Vector<T, A> &v, const Vector<I, AI> &perm)
+    {
+        using U = std::make_unsigned_t<I>;
+
+        size_t n = v.size();
+        const I *p = perm.data();
+        if (perm.size() != n)
+            throw std::invalid_argument("apply_permutation: permutation and vector differ in size");
+
+        // every position is the source of exactly one other
+        BitVector<> pending(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            U from = static_cast<U>(p[i]);
+            if (from >= n || pending.test(from))
+                throw std::invalid_argument("apply_permutation: not a permutation");
+            pending.set(from);
+        }
+
+        T *data = v.data();
+        for (size_t start = pending.find_first(); start != BitVector<>::npos; start = pending.find_next(start))
+        {
+            pending.reset(start);
+            size_t from = static_cast<U>(p[start]);
+            if (from == start)
+                continue;
+
+            T held = std::move(data[start]);
+            size_t to = start;
+            do
+            {
+                data[to] = std::move(data[from]);
+                pending.reset(from);
+                to = from;
+                from = static_cast<U>(p[from]);
+            } while (from != start);
+            data[to] = std::move(held);
+        }
+    }
+
+    /*******************************************************************************
+     * compress
+     *
+     * @brief filter: a Vector of the elements of src whose mask bit is set,
+     * in order
+     *
+     * The result is sized by mask.count() and filled 64 flags at a time;
+     * all-zero words are skipped. Trivially copyable 32- and 64-bit
+     * elements go through AVX-512 compress stores, or an AVX2 permute, when
+     * the build enables them.
+     *
+     * @throw std::invalid_argument if src and mask differ in size
+     *******************************************************************************/
+    template <class T, class A, class MA>
+    Vector<T, A> compress(const Vector<T, A> &src, const BitVector<MA> &mask)
+    {
+        if (mask.size() != src.size())
+            throw std::invalid_argument("compress: mask and vector differ in size");
+
+        const std::uint64_t *words = mask.words().data();
+        size_t count = mask.count();
+
+        Vector<T, A> out(src.get_allocator());
+        out.reserve(count + detail::compress_lanes<T>);
+        out.append_construct(count, [&](T *first, T *)
+                             { detail::compress_into(first, src.data(), src.size(), [words](size_t base)
+                                                     { return words[base / 64]; }); });
+        return out;
+    }
+
+    /*******************************************************************************
+     * compress
+     *
+     * @brief filter by a Vector of flags, one per element, nonzero to keep
+     *
+     * This is the form a comparison evaluated into a Vector<bool> or
+     * Vector<std::uint8_t> produces. The flags are packed 64 at a time and
+     * take the same path as a BitVector mask.
+     *
+     * @throw std::invalid_argument if src and mask differ in size
+     *******************************************************************************/
+    template <class T, class A, class M, class MA>
+        requires std::integral<M>
+    Vector<T, A> compress(const Vector<T, A> &src, const Vector<M, MA> &mask)
+    {
+        size_t n = src.size();
+        if (mask.size() != n)
+            throw std::invalid_argument("compress: mask and vector differ in size");
+
+        const M *flags = mask.data();
+        size_t count = 0;
+        for (size_t i = 0; i < n; ++i)
+            count += flags[i] != M{};
+
+        Vector<T, A> out(src.get_allocator());
+        out.reserve(count + detail::compress_lanes<T>);
+        out.append_construct(count, [&](T *first, T *)
+                             { detail::compress_into(first, src.data(), n, [flags, n](size_t base)
+                                                     { return detail::byte_mask_bits(flags, base, n); }); });
+        return out;
+    }
+}
+
+#endif // GATHER_SCATTER_H
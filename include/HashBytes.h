@@ -0,0 +1,346 @@
+/*******************************************************************************
+ *  @file HashBytes.h
+ *  @brief This file contains the byte hash behind hash(const Vector &), with
+ *  SSE2 / AVX2 kernels for long inputs
+ *
+ *  Inputs up to 64 bytes are mixed from a few overlapping 64-bit loads.
+ *  Longer inputs run through eight 64-bit accumulators, 64 bytes (a stripe)
+ *  at a time. Each stripe is xored with a key that depends on its position
+ *  in a 1 KiB block, so reordered stripes hash differently, and the
+ *  accumulators are scrambled after each block. The lane arithmetic is
+ *  32x32->64 multiplies and adds, which SSE2 and AVX2 do two and four
+ *  lanes at a time; every path computes the same value, so hashes do not
+ *  depend on how the build was configured.
+ *
+ *  This is a hash for tables and caches, not a cryptographic one.
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef HASH_BYTES_H
+#define HASH_BYTES_H 1
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace custom
+{
+    namespace detail
+    {
+        inline constexpr std::uint64_t hash_prime32 = 0x9E3779B1u;
+        inline constexpr std::uint64_t hash_prime64 = 0x9E3779B185EBCA87ull;
+
+        inline constexpr size_t hash_stripe_bytes = 64;
+        inline constexpr size_t hash_block_stripes = 16;
+
+        // stripe s of a block is keyed by hash_key[s .. s + 8), the block
+        // scramble by hash_key[16 .. 24) and the final stripe by hash_key[17 .. 25)
+        alignas(64) inline constexpr std::uint64_t hash_key[26] = {
+            0xBE4BA423396CFEB8ull, 0x1CAD21F72C81017Cull, 0xDB979083E96DD4DEull, 0x1F67B3B7A4A44072ull,
+            0x78E5C0CC4EE679CBull, 0x2172FFCC7DD05A82ull, 0x8E2443F7744608B8ull, 0x4C263A81E69035E0ull,
+            0xCB00C391BB52283Cull, 0xA32E531B8B65D088ull, 0x4EF90DA297486471ull, 0xD8ACDEA946EF1938ull,
+            0x3F349CE33F76FAA8ull, 0x1D4F0BC7C7BBDCF9ull, 0x3159B4CD4BE0518Aull, 0x647378D9C97E9FC8ull,
+            0xC3EBD33483ACC5EAull, 0xEB6313FAFFA081C5ull, 0x49DAF0B751DD0D17ull, 0x9E68D429265516D3ull,
+            0xFCA1477D58BE162Bull, 0xCE31D07AD1B8F88Full, 0x280416958F3ACB45ull, 0x7E404BBBCAFBD7AFull,
+            0x0B1F7D4E9A63C852ull, 0x5A84E2C01D3B6F97ull};
+
+        inline std::uint64_t read64(const char *p) noexcept
+        {
+            std::uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline std::uint32_t read32(const char *p) noexcept
+        {
+            std::uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        // fold the 128-bit product of a and b into 64 bits
+        inline std::uint64_t mul_fold(std::uint64_t a, std::uint64_t b) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+            return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            std::uint64_t high;
+            std::uint64_t low = _umul128(a, b, &high);
+            return low ^ high;
+#else
+            // schoolbook product from 32-bit halves
+            std::uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+            std::uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+
+            std::uint64_t lo_lo = a_lo * b_lo;
+            std::uint64_t hi_lo = a_hi * b_lo;
+            std::uint64_t lo_hi = a_lo * b_hi;
+            std::uint64_t hi_hi = a_hi * b_hi;
+
+            std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+            std::uint64_t high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+            std::uint64_t low = (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+            return low ^ high;
+#endif
+        }
+
+        inline std::uint64_t avalanche(std::uint64_t h) noexcept
+        {
+            h ^= h >> 37;
+            h *= 0x165667919E3779F9ull;
+            return h ^ (h >> 32);
+        }
+
+        // spread the bits of an integer hash (std::hash of an integer is the identity)
+        inline std::uint64_t mix64(std::uint64_t h) noexcept
+        {
+            return avalanche(mul_fold(h ^ hash_key[0], hash_prime64));
+        }
+
+        // fold h into seed; the product alone is 0 whenever h equals its key
+        // (losing seed) or seed does (losing h), so both are added back in
+        inline std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t h) noexcept
+        {
+            return mul_fold(seed ^ hash_key[1], h ^ hash_key[2]) + (std::rotl(seed, 23) ^ h);
+        }
+
+        inline std::uint64_t mix16(const char *p, const std::uint64_t *key, std::uint64_t seed) noexcept
+        {
+            return mul_fold(read64(p) ^ (key[0] + seed), read64(p + 8) ^ (key[1] - seed));
+        }
+
+        /*******************************************************************************
+         * hash_short
+         *
+         * @brief hash len <= 64 bytes
+         *******************************************************************************/
+        inline std::uint64_t hash_short(const char *p, size_t len, std::uint64_t seed) noexcept
+        {
+            if (len > 16)
+            {
+                std::uint64_t acc = len * hash_prime64;
+                acc += mix16(p, hash_key, seed);
+                acc += mix16(p + len - 16, hash_key + 2, seed);
+                if (len > 32)
+                {
+                    acc += mix16(p + 16, hash_key + 4, seed);
+                    acc += mix16(p + len - 32, hash_key + 6, seed);
+                }
+                return avalanche(acc);
+            }
+
+            std::uint64_t lo, hi;
+            if (len > 8)
+            {
+                lo = read64(p);
+                hi = read64(p + len - 8);
+            }
+            else if (len >= 4)
+            {
+                lo = read32(p);
+                hi = read32(p + len - 4);
+            }
+            else if (len)
+            {
+                lo = static_cast<unsigned char>(p[0]) | static_cast<unsigned char>(p[len / 2]) << 8;
+                hi = static_cast<unsigned char>(p[len - 1]);
+            }
+            else
+            {
+                lo = hi = 0;
+            }
+
+            return avalanche(mul_fold(lo ^ (hash_key[8] + seed), hi ^ (hash_key[9] - seed) ^ len) ^ len);
+        }
+
+        //--------------------------------------------------------------------------------------------
+        //--------------------------------   stripe kernels    ---------------------------------------
+        //--------------------------------------------------------------------------------------------
+
+        /*******************************************************************************
+         * Scalar_Stripes
+         *
+         * @brief the reference stripe kernel; the SIMD kernels match it bit for bit
+         *******************************************************************************/
+        struct Scalar_Stripes
+        {
+            // add n stripes from p into acc, stripe s keyed by key + s
+            static void accumulate(std::uint64_t *acc, const char *p, size_t n, const std::uint64_t *key) noexcept
+            {
+                for (size_t s = 0; s < n; ++s, p += hash_stripe_bytes)
+                {
+                    for (size_t i = 0; i < 8; ++i)
+                    {
+                        std::uint64_t data = read64(p + 8 * i);
+                        std::uint64_t keyed = data ^ key[s + i];
+                        acc[i ^ 1] += data;
+                        acc[i] += (keyed & 0xFFFFFFFFu) * (keyed >> 32);
+                    }
+                }
+            }
+
+            static void scramble(std::uint64_t *acc, const std::uint64_t *key) noexcept
+            {
+                for (size_t i = 0; i < 8; ++i)
+                    acc[i] = (acc[i] ^ (acc[i] >> 47) ^ key[i]) * hash_prime32;
+            }
+        };
+
+#if defined(__AVX2__)
+        struct Simd_Stripes
+        {
+            static void accumulate(std::uint64_t *acc, const char *p, size_t n, const std::uint64_t *key) noexcept
+            {
+                __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc));
+                __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + 4));
+
+                for (size_t s = 0; s < n; ++s, p += hash_stripe_bytes)
+                {
+                    __m256i d0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                    __m256i d1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32));
+                    __m256i k0 = _mm256_xor_si256(d0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key + s)));
+                    __m256i k1 = _mm256_xor_si256(d1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key + s + 4)));
+
+                    // lane i gets lo32 * hi32 of its keyed word and the data of lane i ^ 1
+                    a0 = _mm256_add_epi64(a0, _mm256_mul_epu32(k0, _mm256_srli_epi64(k0, 32)));
+                    a1 = _mm256_add_epi64(a1, _mm256_mul_epu32(k1, _mm256_srli_epi64(k1, 32)));
+                    a0 = _mm256_add_epi64(a0, _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2)));
+                    a1 = _mm256_add_epi64(a1, _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2)));
+                }
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc), a0);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc + 4), a1);
+            }
+
+            static void scramble(std::uint64_t *acc, const std::uint64_t *key) noexcept
+            {
+                const __m256i prime = _mm256_set1_epi64x(hash_prime32);
+                for (size_t i = 0; i < 8; i += 4)
+                {
+                    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + i));
+                    a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+                    a = _mm256_xor_si256(a, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key + i)));
+
+                    // 64 x 32 bit multiply from two 32 x 32 -> 64 ones
+                    __m256i lo = _mm256_mul_epu32(a, prime);
+                    __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+                    a = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc + i), a);
+                }
+            }
+        };
+#elif defined(__SSE2__)
+        struct Simd_Stripes
+        {
+            static void accumulate(std::uint64_t *acc, const char *p, size_t n, const std::uint64_t *key) noexcept
+            {
+                __m128i a[4];
+                for (size_t j = 0; j < 4; ++j)
+                    a[j] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + 2 * j));
+
+                for (size_t s = 0; s < n; ++s, p += hash_stripe_bytes)
+                {
+                    for (size_t j = 0; j < 4; ++j)
+                    {
+                        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * j));
+                        __m128i k = _mm_xor_si128(d, _mm_loadu_si128(reinterpret_cast<const __m128i *>(key + s + 2 * j)));
+
+                        a[j] = _mm_add_epi64(a[j], _mm_mul_epu32(k, _mm_srli_epi64(k, 32)));
+                        a[j] = _mm_add_epi64(a[j], _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)));
+                    }
+                }
+
+                for (size_t j = 0; j < 4; ++j)
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + 2 * j), a[j]);
+            }
+
+            static void scramble(std::uint64_t *acc, const std::uint64_t *key) noexcept
+            {
+                const __m128i prime = _mm_set1_epi32(static_cast<int>(hash_prime32));
+                for (size_t i = 0; i < 8; i += 2)
+                {
+                    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + i));
+                    a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+                    a = _mm_xor_si128(a, _mm_loadu_si128(reinterpret_cast<const __m128i *>(key + i)));
+
+                    __m128i lo = _mm_mul_epu32(a, prime);
+                    __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), prime);
+                    a = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + i), a);
+                }
+            }
+        };
+#else
+        using Simd_Stripes = Scalar_Stripes;
+#endif
+
+        /*******************************************************************************
+         * hash_long
+         *
+         * @brief hash len > 64 bytes with the stripe kernel Stripes
+         *
+         * Whole blocks of 16 stripes, then the whole stripes left, then the
+         * last 64 bytes of the input (overlapping what came before) as a
+         * final stripe with its own key.
+         *******************************************************************************/
+        template <class Stripes>
+        std::uint64_t hash_long(const char *p, size_t len, std::uint64_t seed) noexcept
+        {
+            alignas(32) std::uint64_t acc[8] = {
+                hash_prime32, hash_prime64, hash_key[0] + seed, hash_key[1] - seed,
+                hash_key[2] ^ seed, hash_key[3], hash_prime64 ^ seed, hash_prime32 + seed};
+
+            constexpr size_t block_bytes = hash_stripe_bytes * hash_block_stripes;
+            size_t blocks = (len - 1) / block_bytes;
+
+            for (size_t b = 0; b < blocks; ++b)
+            {
+                Stripes::accumulate(acc, p + b * block_bytes, hash_block_stripes, hash_key);
+                Stripes::scramble(acc, hash_key + 16);
+            }
+
+            size_t done = blocks * block_bytes;
+            size_t stripes = (len - 1 - done) / hash_stripe_bytes;
+            Stripes::accumulate(acc, p + done, stripes, hash_key);
+            Stripes::accumulate(acc, p + len - hash_stripe_bytes, 1, hash_key + 17);
+
+            std::uint64_t h = len * hash_prime64;
+            for (size_t i = 0; i < 8; i += 2)
+                h += mul_fold(acc[i] ^ hash_key[i + 8], acc[i + 1] ^ hash_key[i + 9]);
+
+            return avalanche(h);
+        }
+
+        /*******************************************************************************
+         * hash_bytes
+         *
+         * @brief hash the len bytes at p
+         *
+         * @param seed changes the whole function, e.g. per table
+         *******************************************************************************/
+        inline std::uint64_t hash_bytes(const void *p, size_t len, std::uint64_t seed = 0) noexcept
+        {
+            const char *bytes = static_cast<const char *>(p);
+
+            if (len <= hash_stripe_bytes)
+                return hash_short(bytes, len, seed);
+
+            return hash_long<Simd_Stripes>(bytes, len, seed);
+        }
+    }
+}
+
+#endif // HASH_BYTES_H
@@ -0,0 +1,571 @@
+/*******************************************************************************
+ *  @file IncrementalVector.h
+ *  @brief This file contains methods that define and implement a vector
+ *  whose growth is spread over the appends that follow it
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef INCREMENTAL_VECTOR_H
+#define INCREMENTAL_VECTOR_H 1
+
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "CustomVector.h"
+
+namespace custom
+{
+    namespace detail
+    {
+        // blocks from A are private heap or anonymous memory that nobody else
+        // maps, so pages of one can be dropped with madvise while it is still
+        // allocated; allocators opt in with `using is_page_backed = std::true_type`
+        template <class A>
+        concept page_backed_allocator =
+            std::is_same_v<A, std::allocator<typename A::value_type>> ||
+            requires { requires A::is_page_backed::value; };
+    }
+
+    /*******************************************************************************
+     * class IncrementalVector
+     *
+     *  @brief A vector with bounded push_back latency: a full block is
+     *  replaced by one of twice the size, but the elements are moved over a
+     *  few at a time by the appends that follow
+     *
+     *  Vector::push_back on a full vector relocates every element before it
+     *  returns, so one append in millions stalls for as long as copying the
+     *  whole vector takes. Here growth only allocates the new block. Each
+     *  push_back then migrates migration_step() elements from the front of
+     *  the old block, and the old block is released once it is empty.
+     *  Until then element i lives in the old block if it has not been
+     *  migrated yet and in the new one otherwise, which operator[] decides
+     *  with a single comparison.
+     *
+     *  The new block has room for as many appends as there are elements to
+     *  migrate, so with any step of at least one the migration is over
+     *  before the new block fills up, and no append ever moves more than
+     *  migration_step() elements.
+     *
+     *  Freeing a large block is itself slow (the kernel returns each of its
+     *  pages), so on Linux the pages of the old block are handed back with
+     *  madvise in release_granule steps as the migration passes them. That
+     *  is only done for page_backed_allocator types; blocks of any other
+     *  allocator (a cache, a shared segment) are left to it untouched.
+     *
+     *  Elements are not contiguous while migrating() is true, so there is
+     *  no data(); finish_migration() completes the move on demand.
+     *
+     *  @tparam T  Type of element.
+     *  @tparam AllocType  Allocator type, default value is allocator<T>.
+     *
+     *******************************************************************************/
+    template <class T, typename AllocType = std::allocator<T>>
+    class IncrementalVector
+    {
+    public:
+        using size_type = size_t;
+        using value_type = T;
+
+        // elements migrated per append unless set_migration_step says otherwise
+        static constexpr size_type default_migration_step = std::max<size_type>(1, 256 / sizeof(T));
+
+        // bytes of migrated old block returned to the kernel at a time
+        static constexpr size_type release_granule = size_type{256} << 10;
+
+        /*******************************************************************************
+         * class Basic_Iterator
+         *
+         *  @brief random access iterator over the positions of an IncrementalVector
+         *******************************************************************************/
+        template <bool IsConst>
+        class Basic_Iterator
+        {
+            using container_type = std::conditional_t<IsConst, const IncrementalVector, IncrementalVector>;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = T;
+            using pointer = std::conditional_t<IsConst, const T *, T *>;
+            using reference = std::conditional_t<IsConst, const T &, T &>;
+
+            Basic_Iterator() = default;
+            Basic_Iterator(container_type *vec, size_type idx) : m_vec(vec), m_idx(idx) {}
+
+            // allow iterator -> const_iterator conversion
+            template <bool OtherConst>
+                requires(IsConst && !OtherConst)
+            Basic_Iterator(const Basic_Iterator<OtherConst> &other)
+                : m_vec(other.m_vec), m_idx(other.m_idx)
+            {
+            }
+
+            reference operator*() const { return (*m_vec)[m_idx]; }
+            pointer operator->() const { return &(*m_vec)[m_idx]; }
+            reference operator[](difference_type n) const { return (*m_vec)[m_idx + n]; }
+
+            Basic_Iterator &operator++()
+            {
+                ++m_idx;
+                return *this;
+            }
+            Basic_Iterator operator++(int)
+            {
+                Basic_Iterator temp = *this;
+                ++m_idx;
+                return temp;
+            }
+            Basic_Iterator &operator--()
+            {
+                --m_idx;
+                return *this;
+            }
+            Basic_Iterator operator--(int)
+            {
+                Basic_Iterator temp = *this;
+                --m_idx;
+                return temp;
+            }
+
+            Basic_Iterator &operator+=(difference_type n)
+            {
+                m_idx += n;
+                return *this;
+            }
+            Basic_Iterator &operator-=(difference_type n)
+            {
+                m_idx -= n;
+                return *this;
+            }
+
+            Basic_Iterator operator+(difference_type n) const { return Basic_Iterator(m_vec, m_idx + n); }
+            Basic_Iterator operator-(difference_type n) const { return Basic_Iterator(m_vec, m_idx - n); }
+            friend Basic_Iterator operator+(difference_type n, const Basic_Iterator &it) { return it + n; }
+
+            friend difference_type operator-(const Basic_Iterator &a, const Basic_Iterator &b)
+            {
+                return static_cast<difference_type>(a.m_idx) - static_cast<difference_type>(b.m_idx);
+            }
+
+            friend bool operator==(const Basic_Iterator &a, const Basic_Iterator &b) { return a.m_idx == b.m_idx; }
+            friend auto operator<=>(const Basic_Iterator &a, const Basic_Iterator &b) { return a.m_idx <=> b.m_idx; }
+
+        private:
+            template <bool>
+            friend class Basic_Iterator;
+
+            container_type *m_vec = nullptr;
+            size_type m_idx = 0;
+        };
+
+        using iterator = Basic_Iterator<false>;
+        using const_iterator = Basic_Iterator<true>;
+
+        IncrementalVector(const AllocType &alloc = AllocType());
+        IncrementalVector(std::initializer_list<T> ilist, const AllocType &alloc = AllocType());
+
+        IncrementalVector(const IncrementalVector &other);
+        IncrementalVector(IncrementalVector &&other) noexcept;
+
+        IncrementalVector &operator=(const IncrementalVector &other);
+        IncrementalVector &operator=(IncrementalVector &&other) noexcept;
+
+        ~IncrementalVector() { clear(); }
+
+        // Element Access
+        T &at(size_type idx);
+        const T &at(size_type idx) const;
+
+        T &operator[](size_type idx) { return *locate(idx); }
+        const T &operator[](size_type idx) const { return *locate(idx); }
+        T &front() { return at(0); }
+        const T &front() const { return at(0); }
+        T &back() { return at(m_size - 1); }
+        const T &back() const { return at(m_size - 1); }
+
+        // Modifiers
+        void push_back(const T &val) { emplace_back(val); }
+        void push_back(T &&val) { emplace_back(std::move(val)); }
+        template <class... Args>
+        T &emplace_back(Args &&...args);
+        void pop_back();
+        void clear();
+
+        // Migration
+        bool migrating() const noexcept { return m_migrated != m_old_size; }
+        void finish_migration() { migrate(m_old_size - m_migrated); }
+        size_type migration_step() const noexcept { return m_step; }
+        void set_migration_step(size_type step) noexcept { m_step = std::max<size_type>(step, 1); }
+
+        // Size and Capacity
+        void reserve(size_type);
+        size_type size() const noexcept { return m_size; }
+        size_type capacity() const noexcept { return m_mem.block_end - m_mem.block_start; }
+        bool empty() const noexcept { return m_size == 0; }
+
+        friend void swap(IncrementalVector &a, IncrementalVector &b) noexcept
+        {
+            using std::swap;
+
+            swap(a.m_mem, b.m_mem);
+            swap(a.m_old, b.m_old);
+            swap(a.m_size, b.m_size);
+            swap(a.m_old_size, b.m_old_size);
+            swap(a.m_migrated, b.m_migrated);
+            swap(a.m_step, b.m_step);
+            swap(a.m_released, b.m_released);
+        }
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        iterator begin() noexcept { return iterator(this, 0); }
+        const_iterator begin() const noexcept { return const_iterator(this, 0); }
+        const_iterator cbegin() const noexcept { return const_iterator(this, 0); }
+        iterator end() noexcept { return iterator(this, m_size); }
+        const_iterator end() const noexcept { return const_iterator(this, m_size); }
+        const_iterator cend() const noexcept { return const_iterator(this, m_size); }
+
+    private:
+        // elements [m_migrated, m_old_size) are still in the old block
+        T *locate(size_type idx) const noexcept
+        {
+            bool in_old = idx - m_migrated < m_old_size - m_migrated;
+            return (in_old ? m_old.block_start : m_mem.block_start) + idx;
+        }
+
+        void migrate(size_type count);
+        void release_migrated_pages() noexcept;
+        void release_old() noexcept;
+
+        Vector_Memory_Manager<T, AllocType> m_mem;
+        Vector_Memory_Manager<T, AllocType> m_old;
+        size_type m_size = 0;
+        size_type m_old_size = 0;
+        size_type m_migrated = 0;
+        size_type m_step = default_migration_step;
+        char *m_released = nullptr; // old block pages before this are returned
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    INCREMENTAL VECTOR METHODS  -----------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * default constructor
+     *
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, typename A>
+    IncrementalVector<T, A>::IncrementalVector(const A &alloc)
+        : m_mem{alloc, 0}, m_old{alloc, 0}
+    {
+    }
+
+    /*******************************************************************************
+     * @brief initializer_list constructor
+     *
+     * @param ilist list of type T objects
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, typename A>
+    IncrementalVector<T, A>::IncrementalVector(std::initializer_list<T> ilist, const A &alloc)
+        : m_mem{alloc, ilist.size()}, m_old{alloc, 0}
+    {
+        detail::construct_copy(ilist.begin(), ilist.end(), m_mem.block_start);
+        m_size = ilist.size();
+    }
+
+    /*******************************************************************************
+     * copy constructor
+     *
+     * @brief copy other's elements into a single block of exactly their size
+     *******************************************************************************/
+    template <class T, typename A>
+    IncrementalVector<T, A>::IncrementalVector(const IncrementalVector &other)
+        : m_mem{other.m_mem.alloc, other.m_size}, m_old{other.m_mem.alloc, 0}, m_step{other.m_step}
+    {
+        T *dest = m_mem.block_start;
+
+        try
+        {
+            for (; m_size < other.m_size; ++m_size, ++dest)
+                std::construct_at(dest, other[m_size]);
+        }
+        catch (...)
+        {
+            std::destroy(m_mem.block_start, dest);
+            throw;
+        }
+    }
+
+    /*******************************************************************************
+     * @brief move constructor
+     *******************************************************************************/
+    template <class T, typename A>
+    IncrementalVector<T, A>::IncrementalVector(IncrementalVector &&other) noexcept
+        : m_mem{other.m_mem.alloc, 0}, m_old{other.m_mem.alloc, 0}
+    {
+        swap(*this, other);
+    }
+
+    /*******************************************************************************
+     * copy assignment operator
+     *******************************************************************************/
+    template <class T, typename A>
+    IncrementalVector<T, A> &IncrementalVector<T, A>::operator=(const IncrementalVector &other)
+    {
+        // copy-and-swap
+        IncrementalVector temp(other);
+        swap(*this, temp);
+
+        return *this;
+    }
+
+    /*******************************************************************************
+     * @brief move assignment operator
+     *******************************************************************************/
+    template <class T, typename A>
+    IncrementalVector<T, A> &IncrementalVector<T, A>::operator=(IncrementalVector &&other) noexcept
+    {
+        swap(*this, other);
+
+        return *this;
+    }
+
+    /*******************************************************************************
+     * at
+     *
+     * @brief bounds checked access to position idx
+     *******************************************************************************/
+    template <class T, typename A>
+    T &IncrementalVector<T, A>::at(size_type idx)
+    {
+        if (idx >= m_size)
+            throw std::out_of_range("IncrementalVector: index out of range");
+
+        return (*this)[idx];
+    }
+
+    template <class T, typename A>
+    const T &IncrementalVector<T, A>::at(size_type idx) const
+    {
+        if (idx >= m_size)
+            throw std::out_of_range("IncrementalVector: index out of range");
+
+        return (*this)[idx];
+    }
+
+    /*******************************************************************************
+     * emplace_back
+     *
+     * @brief construct an element after the last one, then migrate up to
+     * migration_step() elements
+     *
+     * A full block is replaced by one of twice the size without moving
+     * anything, so args may refer to an element of this vector. If a
+     * migration step throws, the new element is removed again and the
+     * vector is left as it was apart from the elements already migrated.
+     *
+     * @return reference to the new element
+     *******************************************************************************/
+    template <class T, typename A>
+    template <class... Args>
+    T &IncrementalVector<T, A>::emplace_back(Args &&...args)
+    {
+        if (m_size == capacity())
+        {
+            // always complete by now (see the class comment); kept for safety
+            finish_migration();
+
+            Vector_Memory_Manager<T, A> next{m_mem.alloc, capacity() ? 2 * capacity() : 8};
+            swap(m_old, m_mem);
+            swap(m_mem, next);
+
+            m_old_size = m_size;
+            m_migrated = 0;
+            m_released = reinterpret_cast<char *>(m_old.block_start);
+            if (m_old_size == 0)
+                release_old();
+        }
+
+        T *elem = std::construct_at(m_mem.block_start + m_size, std::forward<Args>(args)...);
+        ++m_size;
+
+        try
+        {
+            migrate(m_step);
+        }
+        catch (...)
+        {
+            --m_size;
+            std::destroy_at(elem);
+            throw;
+        }
+
+        return *elem;
+    }
+
+    /*******************************************************************************
+     * pop_back
+     *
+     * @brief destroy the last element
+     *******************************************************************************/
+    template <class T, typename A>
+    void IncrementalVector<T, A>::pop_back()
+    {
+        if (m_size == 0)
+            throw std::out_of_range("IncrementalVector: pop_back on empty vector");
+
+        --m_size;
+        std::destroy_at(locate(m_size));
+
+        // popped into the part still waiting to be migrated
+        if (m_size < m_old_size)
+        {
+            m_old_size = m_size;
+            m_migrated = std::min(m_migrated, m_old_size);
+            if (m_migrated == m_old_size)
+                release_old();
+        }
+    }
+
+    /*******************************************************************************
+     * clear
+     *
+     * @brief destroy all elements, keeping the newest block
+     *******************************************************************************/
+    template <class T, typename A>
+    void IncrementalVector<T, A>::clear()
+    {
+        std::destroy(m_mem.block_start, m_mem.block_start + m_migrated);
+        std::destroy(m_old.block_start + m_migrated, m_old.block_start + m_old_size);
+        std::destroy(m_mem.block_start + m_old_size, m_mem.block_start + m_size);
+
+        release_old();
+        m_size = 0;
+    }
+
+    /*******************************************************************************
+     * reserve
+     *
+     * @brief make room for size_to_reserve elements, relocating at once
+     *
+     * An explicit reserve is a planned pause, so the elements are moved in
+     * one go and any pending migration is completed first.
+     *******************************************************************************/
+    template <class T, typename A>
+    void IncrementalVector<T, A>::reserve(size_type size_to_reserve)
+    {
+        if (size_to_reserve <= capacity())
+            return;
+
+        finish_migration();
+
+        Vector_Memory_Manager<T, A> next{m_mem.alloc, size_to_reserve};
+        detail::construct_move(m_mem.block_start, m_mem.block_start + m_size, next.block_start);
+
+        std::destroy_n(m_mem.block_start, m_size);
+        swap(m_mem, next);
+    }
+
+    /*******************************************************************************
+     * migrate
+     *
+     * @brief move up to count elements from the old block to the new one
+     *
+     * Elements that cannot be moved without throwing are copied, so a
+     * failure leaves every element in one of the two blocks.
+     *******************************************************************************/
+    template <class T, typename A>
+    void IncrementalVector<T, A>::migrate(size_type count)
+    {
+        if (!migrating())
+            return;
+
+        size_type end = m_migrated + std::min(count, m_old_size - m_migrated);
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            std::memcpy(static_cast<void *>(m_mem.block_start + m_migrated),
+                        m_old.block_start + m_migrated, (end - m_migrated) * sizeof(T));
+            m_migrated = end;
+        }
+        else
+        {
+            for (; m_migrated < end; ++m_migrated)
+            {
+                std::construct_at(m_mem.block_start + m_migrated,
+                                  std::move_if_noexcept(m_old.block_start[m_migrated]));
+                std::destroy_at(m_old.block_start + m_migrated);
+            }
+        }
+
+        if (m_migrated == m_old_size)
+            release_old();
+        else
+            release_migrated_pages();
+    }
+
+    /*******************************************************************************
+     * release_migrated_pages
+     *
+     * @brief return whole granules of the old block that only held migrated
+     * elements to the kernel, so freeing the block later is cheap
+     *
+     * The memory stays allocated and reads back as zeros; nothing in it is
+     * used again.
+     *******************************************************************************/
+    template <class T, typename A>
+    void IncrementalVector<T, A>::release_migrated_pages() noexcept
+    {
+#if defined(__linux__) && defined(MADV_DONTNEED)
+        if constexpr (!detail::page_backed_allocator<A>)
+            return;
+
+        auto granule_floor = [](char *p)
+        { return reinterpret_cast<char *>(reinterpret_cast<std::uintptr_t>(p) / release_granule * release_granule); };
+
+        // granules lying wholly inside the block
+        char *first = granule_floor(m_released + release_granule - 1);
+        char *last = granule_floor(reinterpret_cast<char *>(m_old.block_start + m_migrated));
+
+        if (first < last)
+        {
+            madvise(first, last - first, MADV_DONTNEED);
+            m_released = last;
+        }
+#endif
+    }
+
+    /*******************************************************************************
+     * release_old
+     *
+     * @brief free the old block, which must hold no elements
+     *******************************************************************************/
+    template <class T, typename A>
+    void IncrementalVector<T, A>::release_old() noexcept
+    {
+        Vector_Memory_Manager<T, A> empty{m_old.alloc, 0};
+        swap(m_old, empty);
+
+        m_old_size = 0;
+        m_migrated = 0;
+    }
+}
+
+#endif // INCREMENTAL_VECTOR_H
@@ -0,0 +1,153 @@
+/*******************************************************************************
+ *  @file MallocAllocator.h
+ *  @brief This file contains methods that define and implement an allocator
+ *  on malloc / calloc that can hand out zero-filled blocks for free
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef MALLOC_ALLOCATOR_H
+#define MALLOC_ALLOCATOR_H 1
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace custom
+{
+    /*******************************************************************************
+     * class MallocAllocator
+     *
+     *  @brief Allocator on the C heap providing allocate_zeroed
+     *
+     *  allocate_zeroed uses calloc. Large requests are served by the C
+     *  library from fresh anonymous mappings, whose pages the kernel zeroes
+     *  on first touch, so calloc returns without writing them. A Vector
+     *  built on this allocator therefore skips the fill in Vector(n) and
+     *  resize(n) for arithmetic, enum and pointer element types:
+     *
+     *      custom::Vector<std::uint32_t, custom::MallocAllocator<std::uint32_t>> histogram(1 << 28);
+     *
+     *  costs neither time nor resident memory until buckets are written.
+     *
+     *  Types needing more than the default new alignment fall back to
+     *  aligned_alloc, and allocate_zeroed then clears the block itself.
+     *
+     *  @tparam T  Type of element.
+     *
+     *******************************************************************************/
+    template <class T>
+    class MallocAllocator
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        // blocks are private memory, so their pages may be dropped with madvise
+        using is_page_backed = std::true_type;
+
+        MallocAllocator() noexcept = default;
+
+        template <class U>
+        MallocAllocator(const MallocAllocator<U> &) noexcept
+        {
+        }
+
+        T *allocate(size_type n);
+        T *allocate_zeroed(size_type n);
+        void deallocate(T *block, size_type n) noexcept;
+
+        template <class U>
+        friend bool operator==(const MallocAllocator &, const MallocAllocator<U> &) noexcept
+        {
+            return true;
+        }
+
+    private:
+        static constexpr bool over_aligned = alignof(T) > alignof(std::max_align_t);
+
+        static size_type checked_bytes(size_type n);
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    MALLOC ALLOCATOR METHODS  -------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * allocate
+     *
+     * @return uninitialized block for n elements
+     *******************************************************************************/
+    template <class T>
+    T *MallocAllocator<T>::allocate(size_type n)
+    {
+        size_type bytes = checked_bytes(n);
+        void *block;
+
+        if constexpr (over_aligned)
+            // aligned_alloc wants a multiple of the alignment
+            block = std::aligned_alloc(alignof(T), (bytes + alignof(T) - 1) / alignof(T) * alignof(T));
+        else
+            block = std::malloc(bytes);
+
+        if (!block)
+            throw std::bad_alloc();
+
+        return static_cast<T *>(block);
+    }
+
+    /*******************************************************************************
+     * allocate_zeroed
+     *
+     * @return block for n elements with every byte zero
+     *******************************************************************************/
+    template <class T>
+    T *MallocAllocator<T>::allocate_zeroed(size_type n)
+    {
+        if constexpr (over_aligned)
+        {
+            T *block = allocate(n);
+            std::memset(static_cast<void *>(block), 0, n * sizeof(T));
+            return block;
+        }
+        else
+        {
+            void *block = std::calloc(checked_bytes(n), 1);
+            if (!block)
+                throw std::bad_alloc();
+
+            return static_cast<T *>(block);
+        }
+    }
+
+    /*******************************************************************************
+     * deallocate
+     *
+     * @param block block returned by allocate(n) or allocate_zeroed(n)
+     *******************************************************************************/
+    template <class T>
+    void MallocAllocator<T>::deallocate(T *block, size_type) noexcept
+    {
+        std::free(block);
+    }
+
+    /*******************************************************************************
+     * checked_bytes
+     *
+     * @return n * sizeof(T), at least 1
+     * @throw std::bad_array_new_length if that overflows
+     *******************************************************************************/
+    template <class T>
+    typename MallocAllocator<T>::size_type MallocAllocator<T>::checked_bytes(size_type n)
+    {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+
+        return n ? n * sizeof(T) : 1;
+    }
+}
+
+#endif // MALLOC_ALLOCATOR_H
@@ -0,0 +1,674 @@
+/*******************************************************************************
+ *  @file MemoryBudget.h
+ *  @brief This file contains methods that define and implement process-wide
+ *  named memory budgets, and an allocator charging its blocks to one
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H 1
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+
+#include "CustomVector.h"
+
+namespace custom
+{
+    class MemoryBudget;
+
+    /*******************************************************************************
+     * class budget_exceeded
+     *
+     *  @brief thrown by MemoryBudget::charge when a request would take a
+     *  budget past its hard limit
+     *
+     *  Derives from std::bad_alloc, so code that already survives an
+     *  allocation failure handles it unchanged.
+     *******************************************************************************/
+    class budget_exceeded : public std::bad_alloc
+    {
+    public:
+        budget_exceeded(const MemoryBudget &budget, std::size_t requested);
+
+        const char *what() const noexcept override { return m_what.c_str(); }
+        const MemoryBudget &budget() const noexcept { return *m_budget; }
+        std::size_t requested() const noexcept { return m_requested; }
+
+    private:
+        const MemoryBudget *m_budget;
+        std::size_t m_requested;
+        std::string m_what;
+    };
+
+    /*******************************************************************************
+     * class MemoryBudget
+     *
+     *  @brief Named byte counter with current / peak usage, a soft limit
+     *  callback and a hard limit
+     *
+     *  MemoryBudget::global() counts everything charged through any budget;
+     *  MemoryBudget::tag(name) returns the budget for one subsystem, whose
+     *  charges are also applied to the global one. Budgets are created on
+     *  first use and live until the process exits, so for_each can hand
+     *  them all to a metrics exporter at any time.
+     *
+     *  Charges are batched per thread: each thread accumulates up to
+     *  batch_bytes per budget before adding it to the shared relaxed atomic
+     *  counter, and flushes the rest when it exits (or on flush_thread). A
+     *  small allocation therefore costs a thread-local add and a relaxed
+     *  load, and current() / peak() lag by at most batch_bytes per thread.
+     *
+     *  The hard limit is checked before the memory is requested: a charge
+     *  that would exceed it throws budget_exceeded, and growth fails cleanly
+     *  in the process instead of the OS killing it. The check sees other
+     *  threads' counts up to their unflushed batches.
+     *
+     *  When a charge takes a budget above its soft limit, the callback set
+     *  with set_soft_limit runs once, on the charging thread, before the
+     *  memory is allocated; it can evict caches or shrink_to_fit registered
+     *  vectors. It runs again only after usage has dropped below the limit.
+     *******************************************************************************/
+    class MemoryBudget
+    {
+    public:
+        using size_type = std::size_t;
+        using Soft_Limit_Callback = std::function<void(MemoryBudget &)>;
+
+        static constexpr size_type unlimited = std::numeric_limits<size_type>::max();
+        static constexpr std::int64_t batch_bytes = std::int64_t{64} << 10;
+
+        static MemoryBudget &global() noexcept;
+        static MemoryBudget &tag(std::string_view name);
+        template <class Fn>
+        static void for_each(Fn fn);
+        static void flush_thread() noexcept;
+
+        MemoryBudget(const MemoryBudget &) = delete;
+        MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+        // Accounting
+        void charge(size_type bytes);
+        void refund(size_type bytes) noexcept;
+
+        // Limits
+        void set_hard_limit(size_type bytes) noexcept;
+        void set_soft_limit(size_type bytes, Soft_Limit_Callback callback);
+        size_type hard_limit() const noexcept { return m_hard_limit.load(std::memory_order_relaxed); }
+        size_type soft_limit() const noexcept { return m_soft_limit.load(std::memory_order_relaxed); }
+
+        // Statistics
+        const std::string &name() const noexcept { return m_name; }
+        MemoryBudget *parent() const noexcept { return m_parent; }
+        std::int64_t current() const noexcept { return m_current.load(std::memory_order_relaxed); }
+        std::int64_t peak() const noexcept { return m_peak.load(std::memory_order_relaxed); }
+        void reset_peak() noexcept { m_peak.store(current(), std::memory_order_relaxed); }
+
+    private:
+        static constexpr size_type ledger_slots = 16;
+
+        struct Pending
+        {
+            MemoryBudget *budget = nullptr;
+            std::int64_t bytes = 0;
+        };
+
+        struct Thread_Ledger
+        {
+            ~Thread_Ledger();
+
+            Pending slots[ledger_slots];
+        };
+
+        MemoryBudget(std::string name, MemoryBudget *parent, size_type id)
+            : m_name{std::move(name)}, m_parent{parent}, m_id{id}
+        {
+        }
+
+        static MemoryBudget *create(std::string_view name, MemoryBudget *parent);
+        static std::int64_t as_signed(size_type bytes) noexcept
+        {
+            return static_cast<std::int64_t>(std::min<size_type>(bytes, std::numeric_limits<std::int64_t>::max()));
+        }
+        static Thread_Ledger *ledger() noexcept
+        {
+            if (Thread_Ledger *local = thread_ledger)
+                return local;
+
+            return attach_ledger();
+        }
+        static Thread_Ledger *attach_ledger() noexcept;
+
+        std::int64_t pending(const Thread_Ledger *local) const noexcept;
+        void add(Thread_Ledger *local, std::int64_t bytes) noexcept;
+        void publish(std::int64_t bytes) noexcept;
+        void enforce_limits(Thread_Ledger *local, size_type bytes, MemoryBudget *first);
+        void rollback(Thread_Ledger *local, size_type bytes, MemoryBudget *first) noexcept;
+        bool crossed_soft_limit(const Thread_Ledger *local) noexcept;
+        void run_soft_limit_callback();
+
+        const std::string m_name;
+        MemoryBudget *const m_parent;
+        const size_type m_id;
+        MemoryBudget *m_next = nullptr;
+
+        std::atomic<std::int64_t> m_current{0};
+        std::atomic<std::int64_t> m_peak{0};
+        std::atomic<size_type> m_hard_limit{unlimited};
+        std::atomic<size_type> m_soft_limit{unlimited};
+        std::atomic<bool> m_limited{false};
+        std::atomic<bool> m_soft_triggered{false};
+
+        std::mutex m_callback_lock;
+        Soft_Limit_Callback m_callback;
+
+        // every budget, newest first; budgets are never destroyed
+        static inline std::atomic<MemoryBudget *> s_head{nullptr};
+        static inline std::mutex s_registry_lock;
+        static inline size_type s_next_id = 0;
+
+        // this thread's ledger once created (a trivial thread_local is a
+        // single load), and a flag set once it has been destroyed
+        static inline thread_local Thread_Ledger *thread_ledger = nullptr;
+        static inline thread_local bool thread_ledger_destroyed = false;
+    };
+
+    /*******************************************************************************
+     * class AccountedAllocator
+     *
+     *  @brief Allocator charging every block it hands out to a MemoryBudget,
+     *  and drawing it from an upstream allocator
+     *
+     *      auto &budget = custom::MemoryBudget::tag("ingest");
+     *      custom::Vector<Row, custom::AccountedAllocator<Row>> rows{
+     *          custom::AccountedAllocator<Row>(budget)};
+     *
+     *  Growth past the budget's hard limit throws budget_exceeded before the
+     *  upstream allocator is asked. Vectors on other allocators are not
+     *  accounted and pay nothing. allocate_zeroed is forwarded when the
+     *  upstream allocator has it (MallocAllocator, NumaAllocator).
+     *
+     *  @tparam T  Type of element.
+     *  @tparam Upstream  Allocator providing the memory, default allocator<T>.
+     *
+     *******************************************************************************/
+    template <class T, class Upstream = std::allocator<T>>
+    class AccountedAllocator
+    {
+        using upstream_traits = std::allocator_traits<Upstream>;
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = AccountedAllocator<U, typename upstream_traits::template rebind_alloc<U>>;
+        };
+
+        AccountedAllocator() : m_budget{&MemoryBudget::global()} {}
+        explicit AccountedAllocator(MemoryBudget &budget, const Upstream &upstream = Upstream())
+            : m_budget{&budget}, m_upstream{upstream}
+        {
+        }
+
+        template <class U, class UpstreamU>
+        AccountedAllocator(const AccountedAllocator<U, UpstreamU> &other)
+            : m_budget{&other.budget()}, m_upstream(other.upstream())
+        {
+        }
+
+        T *allocate(size_type n);
+        T *allocate_zeroed(size_type n)
+            requires detail::zeroing_allocator<Upstream>;
+        void deallocate(T *block, size_type n) noexcept;
+
+        MemoryBudget &budget() const noexcept { return *m_budget; }
+        const Upstream &upstream() const noexcept { return m_upstream; }
+
+        template <class U, class UpstreamU>
+        friend bool operator==(const AccountedAllocator &a, const AccountedAllocator<U, UpstreamU> &b) noexcept
+        {
+            return &a.budget() == &b.budget() && a.upstream() == b.upstream();
+        }
+
+    private:
+        static size_type checked_bytes(size_type n);
+
+        MemoryBudget *m_budget;
+        Upstream m_upstream;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    MEMORY BUDGET METHODS  ----------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    inline budget_exceeded::budget_exceeded(const MemoryBudget &budget, std::size_t requested)
+        : m_budget{&budget}, m_requested{requested},
+          m_what{"memory budget '" + budget.name() + "' exceeded: " + std::to_string(requested) +
+                 " bytes requested, " + std::to_string(budget.current()) + " of " +
+                 std::to_string(budget.hard_limit()) + " in use"}
+    {
+    }
+
+    /*******************************************************************************
+     * global
+     *
+     * @return the budget every charge is applied to
+     *******************************************************************************/
+    inline MemoryBudget &MemoryBudget::global() noexcept
+    {
+        // never destroyed, so threads exiting during static
+        // destruction can still flush their ledgers
+        static MemoryBudget *budget = []
+        {
+            std::lock_guard<std::mutex> guard(s_registry_lock);
+            return create("global", nullptr);
+        }();
+
+        return *budget;
+    }
+
+    /*******************************************************************************
+     * tag
+     *
+     * @return the budget named name, created (under the global one) on first use
+     *******************************************************************************/
+    inline MemoryBudget &MemoryBudget::tag(std::string_view name)
+    {
+        MemoryBudget &root = global();
+        std::lock_guard<std::mutex> guard(s_registry_lock);
+
+        for (MemoryBudget *b = s_head.load(std::memory_order_relaxed); b; b = b->m_next)
+            if (b->m_name == name && b != &root)
+                return *b;
+
+        return *create(name, &root);
+    }
+
+    /*******************************************************************************
+     * for_each
+     *
+     * @brief call fn(const MemoryBudget &) on every budget, newest first,
+     * without locking
+     *******************************************************************************/
+    template <class Fn>
+    void MemoryBudget::for_each(Fn fn)
+    {
+        global();
+        for (MemoryBudget *b = s_head.load(std::memory_order_acquire); b; b = b->m_next)
+            fn(static_cast<const MemoryBudget &>(*b));
+    }
+
+    /*******************************************************************************
+     * flush_thread
+     *
+     * @brief add the calling thread's batched charges to the shared counters
+     *******************************************************************************/
+    inline void MemoryBudget::flush_thread() noexcept
+    {
+        Thread_Ledger *local = ledger();
+        if (!local)
+            return;
+
+        for (Pending &slot : local->slots)
+            if (slot.budget && slot.bytes)
+            {
+                std::int64_t bytes = slot.bytes;
+                slot.bytes = 0;
+                slot.budget->publish(bytes);
+            }
+    }
+
+    /*******************************************************************************
+     * charge
+     *
+     * @brief count bytes against this budget and its parents
+     *
+     * @throw budget_exceeded if that would exceed a hard limit; nothing is
+     * charged then
+     * @throw whatever a soft limit callback throws; the charge is undone
+     *******************************************************************************/
+    inline void MemoryBudget::charge(size_type bytes)
+    {
+        Thread_Ledger *local = ledger();
+
+        // budgets without limits cost only the ledger add
+        for (MemoryBudget *b = this; b; b = b->m_parent)
+        {
+            b->add(local, static_cast<std::int64_t>(bytes));
+            if (b->m_limited.load(std::memory_order_relaxed))
+                b->enforce_limits(local, bytes, this);
+        }
+    }
+
+    /*******************************************************************************
+     * refund
+     *
+     * @brief give back bytes previously charged to this budget
+     *******************************************************************************/
+    inline void MemoryBudget::refund(size_type bytes) noexcept
+    {
+        Thread_Ledger *local = ledger();
+
+        for (MemoryBudget *b = this; b; b = b->m_parent)
+            b->add(local, -static_cast<std::int64_t>(bytes));
+    }
+
+    /*******************************************************************************
+     * set_soft_limit
+     *
+     * @param bytes usage above which callback runs (unlimited to disable)
+     * @param callback called with this budget, may be empty
+     *******************************************************************************/
+    inline void MemoryBudget::set_soft_limit(size_type bytes, Soft_Limit_Callback callback)
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_callback_lock);
+            m_callback = std::move(callback);
+        }
+        m_soft_triggered.store(false, std::memory_order_relaxed);
+        m_soft_limit.store(bytes, std::memory_order_relaxed);
+        m_limited.store(bytes != unlimited || hard_limit() != unlimited, std::memory_order_relaxed);
+    }
+
+    /*******************************************************************************
+     * set_hard_limit
+     *
+     * @param bytes usage no charge may take this budget past (unlimited to disable)
+     *******************************************************************************/
+    inline void MemoryBudget::set_hard_limit(size_type bytes) noexcept
+    {
+        m_hard_limit.store(bytes, std::memory_order_relaxed);
+        m_limited.store(bytes != unlimited || soft_limit() != unlimited, std::memory_order_relaxed);
+    }
+
+    /*******************************************************************************
+     * create
+     *
+     * @brief allocate and register a budget; s_registry_lock must be held
+     *******************************************************************************/
+    inline MemoryBudget *MemoryBudget::create(std::string_view name, MemoryBudget *parent)
+    {
+        MemoryBudget *budget = new MemoryBudget(std::string(name), parent, s_next_id++);
+        budget->m_next = s_head.load(std::memory_order_relaxed);
+        s_head.store(budget, std::memory_order_release);
+
+        return budget;
+    }
+
+    /*******************************************************************************
+     * ~Thread_Ledger
+     *
+     * @brief flush the exiting thread's batched charges
+     *******************************************************************************/
+    inline MemoryBudget::Thread_Ledger::~Thread_Ledger()
+    {
+        for (Pending &slot : slots)
+            if (slot.budget && slot.bytes)
+                slot.budget->publish(slot.bytes);
+
+        thread_ledger = nullptr;
+        thread_ledger_destroyed = true;
+    }
+
+    /*******************************************************************************
+     * attach_ledger
+     *
+     * @brief create the calling thread's ledger on its first charge
+     *
+     * @return the ledger, or nullptr once it has been destroyed
+     *******************************************************************************/
+    inline MemoryBudget::Thread_Ledger *MemoryBudget::attach_ledger() noexcept
+    {
+        if (thread_ledger_destroyed)
+            return nullptr;
+
+        thread_local Thread_Ledger local;
+        thread_ledger = &local;
+
+        return &local;
+    }
+
+    /*******************************************************************************
+     * pending
+     *
+     * @return bytes the thread owning local has charged but not yet published
+     *******************************************************************************/
+    inline std::int64_t MemoryBudget::pending(const Thread_Ledger *local) const noexcept
+    {
+        if (!local)
+            return 0;
+
+        const Pending &slot = local->slots[m_id % ledger_slots];
+
+        return slot.budget == this ? slot.bytes : 0;
+    }
+
+    /*******************************************************************************
+     * add
+     *
+     * @brief record bytes (negative for a refund) in the thread's ledger,
+     * publishing once a batch is full
+     *
+     * A budget sharing the slot is published first and evicted. local is
+     * the calling thread's ledger, or nullptr after it has been destroyed.
+     *******************************************************************************/
+    inline void MemoryBudget::add(Thread_Ledger *local, std::int64_t bytes) noexcept
+    {
+        if (!local)
+        {
+            publish(bytes);
+            return;
+        }
+
+        Pending &slot = local->slots[m_id % ledger_slots];
+        if (slot.budget != this)
+        {
+            if (slot.budget && slot.bytes)
+                slot.budget->publish(slot.bytes);
+
+            slot = Pending{this, 0};
+        }
+
+        slot.bytes += bytes;
+        if (slot.bytes >= batch_bytes || slot.bytes <= -batch_bytes)
+        {
+            std::int64_t batch = slot.bytes;
+            slot.bytes = 0;
+            publish(batch);
+        }
+    }
+
+    /*******************************************************************************
+     * publish
+     *
+     * @brief add bytes to the shared counter and keep the peak, re-arming the
+     * soft limit once usage is back under it
+     *******************************************************************************/
+    inline void MemoryBudget::publish(std::int64_t bytes) noexcept
+    {
+        std::int64_t now = m_current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+        if (bytes > 0)
+        {
+            std::int64_t seen = m_peak.load(std::memory_order_relaxed);
+            while (now > seen && !m_peak.compare_exchange_weak(seen, now, std::memory_order_relaxed))
+            {
+            }
+        }
+        else if (now <= as_signed(soft_limit()) &&
+                 m_soft_triggered.load(std::memory_order_relaxed))
+            m_soft_triggered.store(false, std::memory_order_relaxed);
+    }
+
+    /*******************************************************************************
+     * enforce_limits
+     *
+     * @brief check the hard and soft limit after bytes were added to this
+     * budget, counting this thread's batch exactly
+     *
+     * @param first the budget charge was called on, whose chain up to this
+     * one is rolled back on failure
+     * @throw budget_exceeded if usage is now past the hard limit
+     * @throw whatever the soft limit callback throws
+     *******************************************************************************/
+    inline void MemoryBudget::enforce_limits(Thread_Ledger *local, size_type bytes, MemoryBudget *first)
+    {
+        std::int64_t used = current() + pending(local);
+
+        if (used > as_signed(hard_limit()))
+        {
+            rollback(local, bytes, first);
+            throw budget_exceeded(*this, bytes);
+        }
+
+        if (crossed_soft_limit(local))
+        {
+            try
+            {
+                run_soft_limit_callback();
+            }
+            catch (...)
+            {
+                rollback(local, bytes, first);
+                throw;
+            }
+        }
+    }
+
+    /*******************************************************************************
+     * rollback
+     *
+     * @brief undo a charge of bytes from first up to and including this budget
+     *******************************************************************************/
+    inline void MemoryBudget::rollback(Thread_Ledger *local, size_type bytes, MemoryBudget *first) noexcept
+    {
+        for (MemoryBudget *b = first; b != m_parent; b = b->m_parent)
+            b->add(local, -static_cast<std::int64_t>(bytes));
+    }
+
+    /*******************************************************************************
+     * crossed_soft_limit
+     *
+     * @return true for the first charge that finds usage above the soft limit
+     *******************************************************************************/
+    inline bool MemoryBudget::crossed_soft_limit(const Thread_Ledger *local) noexcept
+    {
+        size_type limit = soft_limit();
+        if (limit == unlimited || current() + pending(local) <= as_signed(limit))
+            return false;
+
+        return !m_soft_triggered.load(std::memory_order_relaxed) &&
+               !m_soft_triggered.exchange(true, std::memory_order_relaxed);
+    }
+
+    /*******************************************************************************
+     * run_soft_limit_callback
+     *
+     * @brief call the soft limit callback outside the lock, so it may
+     * allocate and free accounted memory itself
+     *******************************************************************************/
+    inline void MemoryBudget::run_soft_limit_callback()
+    {
+        Soft_Limit_Callback callback;
+        {
+            std::lock_guard<std::mutex> guard(m_callback_lock);
+            callback = m_callback;
+        }
+
+        if (callback)
+            callback(*this);
+    }
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    ACCOUNTED ALLOCATOR METHODS  ----------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * allocate
+     *
+     * @return uninitialized block for n elements, charged to budget()
+     * @throw budget_exceeded if the budget's hard limit does not allow it
+     *******************************************************************************/
+    template <class T, class U>
+    T *AccountedAllocator<T, U>::allocate(size_type n)
+    {
+        size_type bytes = checked_bytes(n);
+        m_budget->charge(bytes);
+
+        try
+        {
+            return upstream_traits::allocate(m_upstream, n);
+        }
+        catch (...)
+        {
+            m_budget->refund(bytes);
+            throw;
+        }
+    }
+
+    /*******************************************************************************
+     * allocate_zeroed
+     *
+     * @return block for n elements with every byte zero, charged to budget()
+     *******************************************************************************/
+    template <class T, class U>
+    T *AccountedAllocator<T, U>::allocate_zeroed(size_type n)
+        requires detail::zeroing_allocator<U>
+    {
+        size_type bytes = checked_bytes(n);
+        m_budget->charge(bytes);
+
+        try
+        {
+            return m_upstream.allocate_zeroed(n);
+        }
+        catch (...)
+        {
+            m_budget->refund(bytes);
+            throw;
+        }
+    }
+
+    /*******************************************************************************
+     * deallocate
+     *
+     * @param block block returned by allocate(n) or allocate_zeroed(n)
+     *******************************************************************************/
+    template <class T, class U>
+    void AccountedAllocator<T, U>::deallocate(T *block, size_type n) noexcept
+    {
+        upstream_traits::deallocate(m_upstream, block, n);
+        m_budget->refund(n * sizeof(T));
+    }
+
+    /*******************************************************************************
+     * checked_bytes
+     *
+     * @return n * sizeof(T)
+     * @throw std::bad_array_new_length if that overflows
+     *******************************************************************************/
+    template <class T, class U>
+    typename AccountedAllocator<T, U>::size_type AccountedAllocator<T, U>::checked_bytes(size_type n)
+    {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+
+        return n * sizeof(T);
+    }
+}
+
+#endif // MEMORY_BUDGET_H
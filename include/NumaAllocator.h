@@ -0,0 +1,307 @@
+/*******************************************************************************
+ *  @file NumaAllocator.h
+ *  @brief This file contains methods that define and implement an allocator
+ *  controlling the NUMA placement of large blocks
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef NUMA_ALLOCATOR_H
+#define NUMA_ALLOCATOR_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace custom
+{
+    /*******************************************************************************
+     * enum NumaPolicy
+     *
+     *  local       leave placement to the kernel's first-touch policy; pair
+     *              with a ParallelInit construction so each worker touches
+     *              its own chunk
+     *  interleave  spread pages round-robin over the nodes in the mask
+     *  bind        only use the nodes in the mask
+     *******************************************************************************/
+    enum class NumaPolicy
+    {
+        local,
+        interleave,
+        bind
+    };
+
+    /*******************************************************************************
+     * class NumaAllocator
+     *
+     *  @brief Allocator mapping large blocks directly with mmap and applying a
+     *  NumaPolicy to them with mbind
+     *
+     *  Blocks smaller than mmap_threshold come from operator new. Large
+     *  blocks are fresh mappings and so already zero, which lets
+     *  allocate_zeroed hand them out without writing a page. Where
+     *  mbind is unavailable, refused, or the machine has a single node, the
+     *  placement request is dropped and the block behaves like plain
+     *  anonymous memory; numa_available() tells which case applies.
+     *
+     *      custom::NumaAllocator<float> interleaved(custom::NumaPolicy::interleave);
+     *      custom::Vector<float, custom::NumaAllocator<float>> big(n, 0.f, interleaved);
+     *
+     *  @tparam T  Type of element.
+     *
+     *******************************************************************************/
+    template <class T>
+    class NumaAllocator
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        // blocks are private memory, so their pages may be dropped with madvise
+        using is_page_backed = std::true_type;
+
+        static constexpr size_type mmap_threshold = size_type{1} << 20;
+
+        /*******************************************************************************
+         * @param policy placement policy
+         * @param node_mask bit i selects node i; 0 means every online node
+         *******************************************************************************/
+        explicit NumaAllocator(NumaPolicy policy = NumaPolicy::local, unsigned long node_mask = 0) noexcept
+            : m_policy{policy}, m_node_mask{node_mask}
+        {
+        }
+
+        template <class U>
+        NumaAllocator(const NumaAllocator<U> &other) noexcept
+            : m_policy{other.policy()}, m_node_mask{other.node_mask()}
+        {
+        }
+
+        T *allocate(size_type n);
+        T *allocate_zeroed(size_type n);
+        void deallocate(T *block, size_type n) noexcept;
+
+        NumaPolicy policy() const noexcept { return m_policy; }
+        unsigned long node_mask() const noexcept { return m_node_mask; }
+
+        static unsigned node_count() noexcept;
+        static bool numa_available() noexcept;
+
+        template <class U>
+        friend bool operator==(const NumaAllocator &a, const NumaAllocator<U> &b) noexcept
+        {
+            return a.policy() == b.policy() && a.node_mask() == b.node_mask();
+        }
+
+    private:
+        static size_type mapped_bytes(size_type n) noexcept;
+        static unsigned long online_mask() noexcept;
+
+        NumaPolicy m_policy;
+        unsigned long m_node_mask;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    NUMA ALLOCATOR METHODS  ---------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * allocate
+     *
+     * @brief map a block for n elements and apply the placement policy
+     *
+     * Nothing is touched here; pages are placed when first written.
+     *
+     * @return pointer to the block
+     *******************************************************************************/
+    template <class T>
+    T *NumaAllocator<T>::allocate(size_type n)
+    {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+
+#if defined(__linux__)
+        if (n * sizeof(T) >= mmap_threshold)
+        {
+            size_type bytes = mapped_bytes(n);
+            void *block = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (block == MAP_FAILED)
+                throw std::bad_alloc();
+
+#if defined(SYS_mbind)
+            // values of MPOL_BIND and MPOL_INTERLEAVE from <linux/mempolicy.h>
+            constexpr int mpol_bind = 2;
+            constexpr int mpol_interleave = 3;
+
+            if (m_policy != NumaPolicy::local && numa_available())
+            {
+                unsigned long mask = m_node_mask ? m_node_mask : online_mask();
+                int mode = m_policy == NumaPolicy::bind ? mpol_bind : mpol_interleave;
+
+                // failure (EPERM in containers, bad mask) leaves default placement
+                syscall(SYS_mbind, block, bytes, mode, &mask, sizeof(mask) * 8, 0);
+            }
+#endif
+            return static_cast<T *>(block);
+        }
+#endif
+
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    /*******************************************************************************
+     * allocate_zeroed
+     *
+     * @return block for n elements with every byte zero
+     *******************************************************************************/
+    template <class T>
+    T *NumaAllocator<T>::allocate_zeroed(size_type n)
+    {
+        T *block = allocate(n);
+
+#if defined(__linux__)
+        // anonymous mappings start out zero-filled
+        if (n * sizeof(T) >= mmap_threshold)
+            return block;
+#endif
+
+        std::memset(static_cast<void *>(block), 0, n * sizeof(T));
+        return block;
+    }
+
+    /*******************************************************************************
+     * deallocate
+     *
+     * @param block block returned by allocate(n)
+     * @param n element count passed to allocate
+     *******************************************************************************/
+    template <class T>
+    void NumaAllocator<T>::deallocate(T *block, size_type n) noexcept
+    {
+#if defined(__linux__)
+        if (n * sizeof(T) >= mmap_threshold)
+        {
+            munmap(block, mapped_bytes(n));
+            return;
+        }
+#endif
+
+        ::operator delete(block, std::align_val_t(alignof(T)));
+    }
+
+    /*******************************************************************************
+     * node_count
+     *
+     * @return number of online NUMA nodes (1 where this cannot be determined)
+     *******************************************************************************/
+    template <class T>
+    unsigned NumaAllocator<T>::node_count() noexcept
+    {
+        unsigned long mask = online_mask();
+        unsigned count = 0;
+
+        for (; mask; mask &= mask - 1)
+            ++count;
+
+        return count ? count : 1;
+    }
+
+    /*******************************************************************************
+     * numa_available
+     *
+     * @return true if placement policies can have any effect
+     *******************************************************************************/
+    template <class T>
+    bool NumaAllocator<T>::numa_available() noexcept
+    {
+#if defined(__linux__) && defined(SYS_mbind)
+        return node_count() > 1;
+#else
+        return false;
+#endif
+    }
+
+    /*******************************************************************************
+     * mapped_bytes
+     *
+     * @return size of the mapping for n elements, rounded up to whole pages
+     *******************************************************************************/
+    template <class T>
+    typename NumaAllocator<T>::size_type NumaAllocator<T>::mapped_bytes(size_type n) noexcept
+    {
+#if defined(__linux__)
+        static const size_type page = static_cast<size_type>(sysconf(_SC_PAGESIZE));
+#else
+        constexpr size_type page = 4096;
+#endif
+
+        return (n * sizeof(T) + page - 1) / page * page;
+    }
+
+    /*******************************************************************************
+     * online_mask
+     *
+     * @brief parse /sys/devices/system/node/online (e.g. "0-1" or "0,2-3")
+     *
+     * @return bit mask of online nodes below 64, 1 (node 0) on failure
+     *******************************************************************************/
+    template <class T>
+    unsigned long NumaAllocator<T>::online_mask() noexcept
+    {
+        static const unsigned long mask = []() noexcept
+        {
+            unsigned long result = 0;
+            try
+            {
+                std::ifstream file("/sys/devices/system/node/online");
+                std::string list;
+                if (!std::getline(file, list))
+                    return 1ul;
+
+                size_t pos = 0;
+                while (pos < list.size())
+                {
+                    size_t used = 0;
+                    unsigned long first = std::stoul(list.substr(pos), &used);
+                    unsigned long last = first;
+                    pos += used;
+
+                    if (pos < list.size() && list[pos] == '-')
+                    {
+                        last = std::stoul(list.substr(pos + 1), &used);
+                        pos += used + 1;
+                    }
+
+                    for (unsigned long node = first; node <= last && node < 64; ++node)
+                        result |= 1ul << node;
+
+                    if (pos < list.size() && list[pos] == ',')
+                        ++pos;
+                    else
+                        break;
+                }
+            }
+            catch (...)
+            {
+                return 1ul;
+            }
+
+            return result ? result : 1ul;
+        }();
+
+        return mask;
+    }
+}
+
+#endif // NUMA_ALLOCATOR_H
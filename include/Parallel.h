@@ -0,0 +1,225 @@
+/*******************************************************************************
+ *  @file Parallel.h
+ *  @brief This file contains methods that split work on large contiguous
+ *  ranges across threads with a fixed chunk-to-thread mapping
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H 1
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace custom
+{
+    /*******************************************************************************
+     * struct ParallelInit
+     *
+     *  @brief policy for parallel construction and processing of large ranges
+     *
+     *  threads       number of workers, 0 means std::thread::hardware_concurrency
+     *  grain_bytes   minimum bytes per worker; smaller ranges use fewer workers,
+     *                and a range below one grain runs on the calling thread
+     *  pin_threads   pin worker w to the w-th CPU the process may run on
+     *
+     *  For a given policy and range length the mapping of chunks to workers
+     *  is fixed: worker w always gets the w-th of `workers` equal slices. A
+     *  Vector constructed with a policy and later processed with
+     *  parallel_for_chunks using the same policy therefore has each chunk
+     *  handled by the worker that first touched its pages, and with
+     *  pin_threads on a NUMA machine those pages sit on that worker's node.
+     *******************************************************************************/
+    struct ParallelInit
+    {
+        unsigned threads = 0;
+        size_t grain_bytes = size_t{1} << 22;
+        bool pin_threads = false;
+
+        unsigned workers(size_t bytes) const noexcept
+        {
+            unsigned limit = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+            size_t by_grain = grain_bytes ? bytes / grain_bytes : bytes;
+
+            return static_cast<unsigned>(std::clamp<size_t>(by_grain, 1, limit));
+        }
+    };
+
+    // the default policy: all hardware threads, 4 MiB grain, no pinning
+    inline constexpr ParallelInit parallel_init{};
+
+    namespace detail
+    {
+        /*******************************************************************************
+         * chunk_bounds
+         *
+         * @return index of the first element of chunk w when n elements are
+         *  split into `workers` chunks (chunk w is [bound(w), bound(w + 1)))
+         *******************************************************************************/
+        constexpr size_t chunk_bounds(size_t n, unsigned workers, unsigned w) noexcept
+        {
+            return n / workers * w + std::min<size_t>(n % workers, w);
+        }
+
+        /*******************************************************************************
+         * pin_to_cpu
+         *
+         * @brief restrict the calling thread to the w-th CPU of the process
+         * affinity mask (wrapping around); a no-op where unsupported
+         *******************************************************************************/
+        inline void pin_to_cpu(unsigned w) noexcept
+        {
+#if defined(__linux__)
+            cpu_set_t allowed;
+            if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+                return;
+
+            int count = CPU_COUNT(&allowed);
+            if (count == 0)
+                return;
+
+            int target = static_cast<int>(w % count);
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &allowed) && target-- == 0)
+                {
+                    cpu_set_t one;
+                    CPU_ZERO(&one);
+                    CPU_SET(cpu, &one);
+                    pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+                    return;
+                }
+            }
+#else
+            (void)w;
+#endif
+        }
+
+        /*******************************************************************************
+         * run_chunks
+         *
+         * @brief call fn(chunk_first, chunk_last, w) for every chunk of
+         * [first, last), one thread per chunk
+         *
+         * Exceptions are caught per worker and stored in errors[w], which must
+         * hold policy.workers(...) entries.
+         *
+         * @return number of workers used
+         *******************************************************************************/
+        template <class T, class Fn>
+        unsigned run_chunks(T *first, T *last, const ParallelInit &policy, Fn &fn,
+                            std::unique_ptr<std::exception_ptr[]> &errors)
+        {
+            size_t n = last - first;
+            unsigned workers = policy.workers(n * sizeof(T));
+            errors = std::make_unique<std::exception_ptr[]>(workers);
+
+            auto work = [&](unsigned w)
+            {
+                try
+                {
+                    if (policy.pin_threads)
+                        pin_to_cpu(w);
+
+                    fn(first + chunk_bounds(n, workers, w), first + chunk_bounds(n, workers, w + 1), w);
+                }
+                catch (...)
+                {
+                    errors[w] = std::current_exception();
+                }
+            };
+
+            if (workers == 1 && !policy.pin_threads)
+            {
+                work(0);
+                return 1;
+            }
+
+            std::unique_ptr<std::thread[]> pool = std::make_unique<std::thread[]>(workers);
+            for (unsigned w = 0; w < workers; ++w)
+                pool[w] = std::thread(work, w);
+
+            for (unsigned w = 0; w < workers; ++w)
+                pool[w].join();
+
+            return workers;
+        }
+
+        /*******************************************************************************
+         * parallel_construct
+         *
+         * @brief run construct(chunk_first, chunk_last, w) on every chunk of the
+         * uninitialized range [first, last)
+         *
+         * construct must leave its chunk either fully constructed or empty, as
+         * the std uninitialized algorithms do. If any chunk fails, the chunks
+         * that succeeded are destroyed and the first exception is rethrown.
+         *******************************************************************************/
+        template <class T, class Construct>
+        void parallel_construct(T *first, T *last, const ParallelInit &policy, Construct construct)
+        {
+            std::unique_ptr<std::exception_ptr[]> errors;
+            unsigned workers = run_chunks(first, last, policy, construct, errors);
+
+            std::exception_ptr failure;
+            for (unsigned w = 0; w < workers && !failure; ++w)
+                failure = errors[w];
+
+            if (!failure)
+                return;
+
+            size_t n = last - first;
+            for (unsigned w = 0; w < workers; ++w)
+                if (!errors[w])
+                    std::destroy(first + chunk_bounds(n, workers, w), first + chunk_bounds(n, workers, w + 1));
+
+            std::rethrow_exception(failure);
+        }
+    }
+
+    /*******************************************************************************
+     * parallel_for_chunks
+     *
+     * @brief call fn(chunk_first, chunk_last, worker) for each chunk of
+     * [first, last), on up to policy.workers() threads
+     *
+     * The first exception thrown by any worker is rethrown after all
+     * workers have finished.
+     *******************************************************************************/
+    template <class T, class Fn>
+    void parallel_for_chunks(T *first, T *last, Fn fn, const ParallelInit &policy = parallel_init)
+    {
+        std::unique_ptr<std::exception_ptr[]> errors;
+        unsigned workers = detail::run_chunks(first, last, policy, fn, errors);
+
+        for (unsigned w = 0; w < workers; ++w)
+            if (errors[w])
+                std::rethrow_exception(errors[w]);
+    }
+
+    /*******************************************************************************
+     * parallel_for_each
+     *
+     * @brief call fn(element) for every element of [first, last), using the
+     * same chunk mapping as parallel_for_chunks
+     *******************************************************************************/
+    template <class T, class Fn>
+    void parallel_for_each(T *first, T *last, Fn fn, const ParallelInit &policy = parallel_init)
+    {
+        parallel_for_chunks(
+            first, last, [&fn](T *chunk_first, T *chunk_last, unsigned)
+            { std::for_each(chunk_first, chunk_last, fn); },
+            policy);
+    }
+}
+
+#endif // PARALLEL_H
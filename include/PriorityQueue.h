@@ -0,0 +1,726 @@
+/*******************************************************************************
+ *  @file PriorityQueue.h
+ *  @brief This file contains methods that define and implement d-ary heap
+ *  priority queues on Vector, with and without handles to queued elements
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H 1
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "CustomVector.h"
+#include "SlotMap.h"
+
+namespace custom
+{
+    namespace detail
+    {
+        /*******************************************************************************
+         * heap_sift_up
+         *
+         * @brief move value from hole toward the root of the Arity-ary heap at
+         * heap until its parent does not rank below it
+         *
+         * Parents are moved down into the hole instead of swapped, one move
+         * per level. placed(elem, pos) is called for every element stored,
+         * so a caller can track positions.
+         *******************************************************************************/
+        template <std::size_t Arity, class T, class Compare, class Placed>
+        void heap_sift_up(T *heap, std::size_t hole, T value, Compare &cmp, Placed placed)
+        {
+            while (hole > 0)
+            {
+                std::size_t parent = (hole - 1) / Arity;
+                if (!cmp(heap[parent], value))
+                    break;
+
+                heap[hole] = std::move(heap[parent]);
+                placed(heap[hole], hole);
+                hole = parent;
+            }
+
+            heap[hole] = std::move(value);
+            placed(heap[hole], hole);
+        }
+
+        /*******************************************************************************
+         * heap_sift_down
+         *
+         * @brief move value from hole toward the leaves of the n-element heap
+         * until no child ranks above it
+         *
+         * The children of a node are the Arity consecutive elements starting
+         * at Arity * hole + 1, so picking the best one reads one contiguous
+         * group instead of following pointers. A full group has a constant
+         * trip count the compiler can unroll.
+         *******************************************************************************/
+        template <std::size_t Arity, class T, class Compare, class Placed>
+        void heap_sift_down(T *heap, std::size_t n, std::size_t hole, T value, Compare &cmp, Placed placed)
+        {
+            for (;;)
+            {
+                std::size_t first = Arity * hole + 1;
+                if (first >= n)
+                    break;
+
+                std::size_t best = first;
+                if (first + Arity <= n)
+                {
+                    for (std::size_t c = first + 1; c < first + Arity; ++c)
+                        best = cmp(heap[best], heap[c]) ? c : best;
+                }
+                else
+                {
+                    for (std::size_t c = first + 1; c < n; ++c)
+                        best = cmp(heap[best], heap[c]) ? c : best;
+                }
+
+                if (!cmp(value, heap[best]))
+                    break;
+
+                heap[hole] = std::move(heap[best]);
+                placed(heap[hole], hole);
+                hole = best;
+            }
+
+            heap[hole] = std::move(value);
+            placed(heap[hole], hole);
+        }
+
+        /*******************************************************************************
+         * heap_sift_down_to_leaf
+         *
+         * @brief heap_sift_down for a value expected to belong near the leaves,
+         * like the last element refilling the root on pop
+         *
+         * The hole first follows the best children all the way down without
+         * comparing value at each level, then value sifts up from the leaf,
+         * usually by zero or one level. That saves a hard-to-predict compare
+         * per level.
+         *******************************************************************************/
+        template <std::size_t Arity, class T, class Compare, class Placed>
+        void heap_sift_down_to_leaf(T *heap, std::size_t n, std::size_t hole, T value, Compare &cmp, Placed placed)
+        {
+            std::size_t top = hole;
+            for (;;)
+            {
+                std::size_t first = Arity * hole + 1;
+                if (first >= n)
+                    break;
+
+                std::size_t best = first;
+                if (first + Arity <= n)
+                {
+                    for (std::size_t c = first + 1; c < first + Arity; ++c)
+                        best = cmp(heap[best], heap[c]) ? c : best;
+                }
+                else
+                {
+                    for (std::size_t c = first + 1; c < n; ++c)
+                        best = cmp(heap[best], heap[c]) ? c : best;
+                }
+
+                heap[hole] = std::move(heap[best]);
+                placed(heap[hole], hole);
+                hole = best;
+            }
+
+            // sift up, but no further than where the hole started
+            while (hole > top)
+            {
+                std::size_t parent = (hole - 1) / Arity;
+                if (!cmp(heap[parent], value))
+                    break;
+
+                heap[hole] = std::move(heap[parent]);
+                placed(heap[hole], hole);
+                hole = parent;
+            }
+
+            heap[hole] = std::move(value);
+            placed(heap[hole], hole);
+        }
+
+        struct ignore_placement
+        {
+            template <class T>
+            void operator()(const T &, std::size_t) const noexcept {}
+        };
+    }
+
+    /*******************************************************************************
+     * class PriorityQueue
+     *
+     *  @brief Priority queue on an Arity-ary heap stored in a Vector
+     *
+     *  Like std::priority_queue, top() is the element no other ranks above
+     *  under Compare (the largest for std::less; use std::greater for the
+     *  earliest deadline first). A 4-ary heap is half as deep as a binary
+     *  one, and the 4 children compared at each level of a pop sit next to
+     *  each other in memory, so a pop touches about half as many cache
+     *  lines.
+     *
+     *  For trivially default constructible T the heap starts Arity - 1
+     *  elements into the Vector, which puts every group of siblings at an
+     *  index that is a multiple of Arity. When Arity * sizeof(T) is 64 and
+     *  the allocator returns 64-byte aligned blocks, each group is exactly
+     *  one cache line. std::allocator only aligns to alignof(T), so with the
+     *  default allocator a group can still straddle two lines.
+     *
+     *  Storage grows through the Vector and its allocator. Construction from
+     *  a range, and push_range of a batch comparable to the queue's size,
+     *  rebuild the heap bottom-up in O(n).
+     *
+     *  @tparam T  Type of element.
+     *  @tparam Compare  Strict weak ordering; top() is a maximum under it.
+     *  @tparam Arity  Children per node, at least 2.
+     *  @tparam AllocType  Allocator type, default value is allocator<T>.
+     *
+     *******************************************************************************/
+    template <class T, class Compare = std::less<T>, std::size_t Arity = 4, typename AllocType = std::allocator<T>>
+    class PriorityQueue
+    {
+        static_assert(Arity >= 2, "PriorityQueue: a heap node needs at least two children");
+
+    public:
+        using size_type = size_t;
+        using value_type = T;
+        using value_compare = Compare;
+
+        // leading elements that align sibling groups to multiples of Arity
+        static constexpr size_type padding = std::is_trivially_default_constructible_v<T> ? Arity - 1 : 0;
+
+        explicit PriorityQueue(const Compare &cmp = Compare(), const AllocType &alloc = AllocType());
+        template <std::ranges::input_range R>
+            requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+        explicit PriorityQueue(R &&values, const Compare &cmp = Compare(), const AllocType &alloc = AllocType());
+
+        // Element Access
+        const T &top() const;
+
+        // Modifiers
+        void push(const T &val) { emplace(val); }
+        void push(T &&val) { emplace(std::move(val)); }
+        template <class... Args>
+        void emplace(Args &&...args);
+        template <std::ranges::input_range R>
+            requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+        void push_range(R &&values);
+        void pop();
+        T push_pop(T val);
+        void clear();
+
+        // Size and Capacity
+        void reserve(size_type n) { m_heap.reserve(padding + n); }
+        size_type size() const noexcept { return m_heap.size() - padding; }
+        bool empty() const noexcept { return size() == 0; }
+
+    private:
+        T *heap() noexcept { return m_heap.data() + padding; }
+        const T *heap() const noexcept { return m_heap.data() + padding; }
+        void add_padding();
+        void heapify();
+
+        Vector<T, AllocType> m_heap;
+        [[no_unique_address]] Compare m_cmp;
+    };
+
+    /*******************************************************************************
+     * class HandlePriorityQueue
+     *
+     *  @brief Arity-ary heap priority queue whose push returns a key to the
+     *  queued element, for changing its priority or removing it later
+     *
+     *  A SlotMap from key to heap position is kept up to date as the heap
+     *  moves elements, so update, decrease_key and erase find their element
+     *  in O(1) and then sift it in O(log n). Keys of popped or erased
+     *  elements go stale and are rejected, as SlotMap keys are.
+     *
+     *  @tparam T  Type of element.
+     *  @tparam Compare  Strict weak ordering; top() is a maximum under it.
+     *  @tparam Arity  Children per node, at least 2.
+     *  @tparam AllocType  Allocator type, default value is allocator<T>.
+     *
+     *******************************************************************************/
+    template <class T, class Compare = std::less<T>, std::size_t Arity = 4, typename AllocType = std::allocator<T>>
+    class HandlePriorityQueue
+    {
+        static_assert(Arity >= 2, "HandlePriorityQueue: a heap node needs at least two children");
+
+        struct Entry
+        {
+            T value;
+            SlotMapKey key;
+        };
+
+        using Entry_Alloc = typename std::allocator_traits<AllocType>::template rebind_alloc<Entry>;
+        using Position_Alloc = typename std::allocator_traits<AllocType>::template rebind_alloc<size_t>;
+
+    public:
+        using size_type = size_t;
+        using value_type = T;
+        using value_compare = Compare;
+        using key_type = SlotMapKey;
+
+        explicit HandlePriorityQueue(const Compare &cmp = Compare(), const AllocType &alloc = AllocType());
+
+        // Element Access
+        const T &top() const;
+        key_type top_key() const;
+        const T *get(key_type key) const noexcept;
+        bool contains(key_type key) const noexcept { return m_positions.contains(key); }
+
+        // Modifiers
+        key_type push(T val);
+        void pop();
+        void update(key_type key, T val);
+        void decrease_key(key_type key, T val);
+        bool erase(key_type key);
+        void clear();
+
+        // Size and Capacity
+        void reserve(size_type n);
+        size_type size() const noexcept { return m_heap.size(); }
+        bool empty() const noexcept { return m_heap.empty(); }
+
+    private:
+        bool less(const Entry &a, const Entry &b) const { return m_cmp(a.value, b.value); }
+        void sift_up(size_type hole, Entry entry);
+        void sift_down(size_type hole, Entry entry, bool near_leaves = false);
+        void remove_at(size_type pos);
+
+        Vector<Entry, Entry_Alloc> m_heap;
+        SlotMap<size_type, Position_Alloc> m_positions;
+        [[no_unique_address]] Compare m_cmp;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    PRIORITY QUEUE METHODS  ---------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * constructor
+     *
+     * @param cmp ordering
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    PriorityQueue<T, C, Arity, A>::PriorityQueue(const C &cmp, const A &alloc)
+        : m_heap(alloc), m_cmp{cmp}
+    {
+        add_padding();
+    }
+
+    /*******************************************************************************
+     * @brief range constructor
+     *
+     * Queues every element of values, building the heap in O(n).
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+    PriorityQueue<T, C, Arity, A>::PriorityQueue(R &&values, const C &cmp, const A &alloc)
+        : PriorityQueue(cmp, alloc)
+    {
+        for (auto &&val : values)
+            m_heap.emplace_back(std::forward<decltype(val)>(val));
+
+        heapify();
+    }
+
+    /*******************************************************************************
+     * top
+     *
+     * @return the element no other ranks above
+     * @throw std::out_of_range if the queue is empty
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    const T &PriorityQueue<T, C, Arity, A>::top() const
+    {
+        if (empty())
+            throw std::out_of_range("PriorityQueue: top of empty queue");
+
+        return heap()[0];
+    }
+
+    /*******************************************************************************
+     * emplace
+     *
+     * @brief queue an element constructed from args
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    template <class... Args>
+    void PriorityQueue<T, C, Arity, A>::emplace(Args &&...args)
+    {
+        m_heap.emplace_back(std::forward<Args>(args)...);
+
+        size_type hole = size() - 1;
+        detail::heap_sift_up<Arity>(heap(), hole, std::move(heap()[hole]), m_cmp, detail::ignore_placement{});
+    }
+
+    /*******************************************************************************
+     * push_range
+     *
+     * @brief queue every element of values
+     *
+     * A batch at least as large as the queue is appended and the whole heap
+     * rebuilt in O(n + batch); a smaller one is pushed element by element.
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+    void PriorityQueue<T, C, Arity, A>::push_range(R &&values)
+    {
+        if constexpr (std::ranges::sized_range<R>)
+        {
+            if (std::ranges::size(values) < size())
+            {
+                for (auto &&val : values)
+                    emplace(std::forward<decltype(val)>(val));
+                return;
+            }
+        }
+
+        for (auto &&val : values)
+            m_heap.emplace_back(std::forward<decltype(val)>(val));
+
+        heapify();
+    }
+
+    /*******************************************************************************
+     * pop
+     *
+     * @brief remove top()
+     *
+     * @throw std::out_of_range if the queue is empty
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    void PriorityQueue<T, C, Arity, A>::pop()
+    {
+        if (empty())
+            throw std::out_of_range("PriorityQueue: pop of empty queue");
+
+        T last = std::move(heap()[size() - 1]);
+        m_heap.pop_back();
+
+        if (!empty())
+            detail::heap_sift_down_to_leaf<Arity>(heap(), size(), 0, std::move(last), m_cmp,
+                                                  detail::ignore_placement{});
+    }
+
+    /*******************************************************************************
+     * push_pop
+     *
+     * @brief push val and pop top(), in one sift instead of two
+     *
+     * @return the element popped, val itself if nothing queued ranks above it
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    T PriorityQueue<T, C, Arity, A>::push_pop(T val)
+    {
+        if (empty() || !m_cmp(val, heap()[0]))
+            return val;
+
+        T result = std::move(heap()[0]);
+        detail::heap_sift_down_to_leaf<Arity>(heap(), size(), 0, std::move(val), m_cmp, detail::ignore_placement{});
+        return result;
+    }
+
+    /*******************************************************************************
+     * clear
+     *
+     * @brief remove every element, keeping the padding
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    void PriorityQueue<T, C, Arity, A>::clear()
+    {
+        m_heap.clear();
+        add_padding();
+    }
+
+    /*******************************************************************************
+     * add_padding
+     *
+     * @brief append the padding to an empty m_heap
+     *
+     * Padding is only used for trivially default constructible T, so it is
+     * default-initialized: nothing is written and T needs no default
+     * constructor otherwise.
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    void PriorityQueue<T, C, Arity, A>::add_padding()
+    {
+        if constexpr (padding > 0)
+            m_heap.append_construct(padding, [](T *first, T *last)
+                                    { std::uninitialized_default_construct(first, last); });
+    }
+
+    /*******************************************************************************
+     * heapify
+     *
+     * @brief restore the heap property over every element, bottom-up
+     *
+     * Sifting each internal node down, starting from the last, costs O(n)
+     * in total, where n pushes cost O(n log n).
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    void PriorityQueue<T, C, Arity, A>::heapify()
+    {
+        size_type n = size();
+        if (n < 2)
+            return;
+
+        for (size_type i = (n - 2) / Arity + 1; i-- > 0;)
+            detail::heap_sift_down<Arity>(heap(), n, i, std::move(heap()[i]), m_cmp, detail::ignore_placement{});
+    }
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    HANDLE PRIORITY QUEUE METHODS  --------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * constructor
+     *
+     * @param cmp ordering
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    HandlePriorityQueue<T, C, Arity, A>::HandlePriorityQueue(const C &cmp, const A &alloc)
+        : m_heap{Entry_Alloc(alloc)}, m_positions{Position_Alloc(alloc)}, m_cmp{cmp}
+    {
+    }
+
+    /*******************************************************************************
+     * top
+     *
+     * @return the element no other ranks above
+     * @throw std::out_of_range if the queue is empty
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    const T &HandlePriorityQueue<T, C, Arity, A>::top() const
+    {
+        if (empty())
+            throw std::out_of_range("HandlePriorityQueue: top of empty queue");
+
+        return m_heap.data()[0].value;
+    }
+
+    /*******************************************************************************
+     * top_key
+     *
+     * @return key of top()
+     * @throw std::out_of_range if the queue is empty
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    typename HandlePriorityQueue<T, C, Arity, A>::key_type HandlePriorityQueue<T, C, Arity, A>::top_key() const
+    {
+        if (empty())
+            throw std::out_of_range("HandlePriorityQueue: top of empty queue");
+
+        return m_heap.data()[0].key;
+    }
+
+    /*******************************************************************************
+     * get
+     *
+     * @return pointer to the queued element of key, nullptr if it has left
+     * the queue
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    const T *HandlePriorityQueue<T, C, Arity, A>::get(key_type key) const noexcept
+    {
+        const size_type *pos = m_positions.get(key);
+        return pos ? &m_heap.data()[*pos].value : nullptr;
+    }
+
+    /*******************************************************************************
+     * push
+     *
+     * @brief queue val
+     *
+     * @return key for update, decrease_key and erase of the element
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    typename HandlePriorityQueue<T, C, Arity, A>::key_type HandlePriorityQueue<T, C, Arity, A>::push(T val)
+    {
+        key_type key = m_positions.insert(size());
+        try
+        {
+            m_heap.push_back(Entry{std::move(val), key});
+        }
+        catch (...)
+        {
+            m_positions.erase(key);
+            throw;
+        }
+
+        sift_up(size() - 1, std::move(m_heap.data()[size() - 1]));
+        return key;
+    }
+
+    /*******************************************************************************
+     * pop
+     *
+     * @brief remove top(), making its key stale
+     *
+     * @throw std::out_of_range if the queue is empty
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    void HandlePriorityQueue<T, C, Arity, A>::pop()
+    {
+        if (empty())
+            throw std::out_of_range("HandlePriorityQueue: pop of empty queue");
+
+        remove_at(0);
+    }
+
+    /*******************************************************************************
+     * update
+     *
+     * @brief replace the element of key with val, moving it up or down
+     *
+     * @throw std::out_of_range if key is stale
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    void HandlePriorityQueue<T, C, Arity, A>::update(key_type key, T val)
+    {
+        size_type pos = m_positions.at(key);
+        bool rises = m_cmp(m_heap.data()[pos].value, val);
+
+        if (rises)
+            sift_up(pos, Entry{std::move(val), key});
+        else
+            sift_down(pos, Entry{std::move(val), key});
+    }
+
+    /*******************************************************************************
+     * decrease_key
+     *
+     * @brief replace the element of key with val, which must not rank below
+     * it, and move it toward the top
+     *
+     * The name follows the min-heap convention: with Compare = std::greater
+     * it takes a smaller value, such as an earlier deadline.
+     *
+     * @throw std::out_of_range if key is stale
+     * @throw std::invalid_argument if val ranks below the current element
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    void HandlePriorityQueue<T, C, Arity, A>::decrease_key(key_type key, T val)
+    {
+        size_type pos = m_positions.at(key);
+        if (m_cmp(val, m_heap.data()[pos].value))
+            throw std::invalid_argument("HandlePriorityQueue: decrease_key would lower the priority");
+
+        sift_up(pos, Entry{std::move(val), key});
+    }
+
+    /*******************************************************************************
+     * erase
+     *
+     * @brief remove the element of key from anywhere in the queue
+     *
+     * @return false if key was stale and nothing was removed
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    bool HandlePriorityQueue<T, C, Arity, A>::erase(key_type key)
+    {
+        const size_type *pos = m_positions.get(key);
+        if (!pos)
+            return false;
+
+        remove_at(*pos);
+        return true;
+    }
+
+    /*******************************************************************************
+     * clear
+     *
+     * @brief remove every element, making all keys stale
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    void HandlePriorityQueue<T, C, Arity, A>::clear()
+    {
+        m_heap.clear();
+        m_positions.clear();
+    }
+
+    /*******************************************************************************
+     * reserve
+     *
+     * @brief make room for n elements without reallocating
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    void HandlePriorityQueue<T, C, Arity, A>::reserve(size_type n)
+    {
+        m_heap.reserve(n);
+        m_positions.reserve(n);
+    }
+
+    /*******************************************************************************
+     * sift_up
+     *
+     * @brief place entry at hole or above, recording every move in m_positions
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    void HandlePriorityQueue<T, C, Arity, A>::sift_up(size_type hole, Entry entry)
+    {
+        auto cmp = [this](const Entry &a, const Entry &b) { return less(a, b); };
+        auto placed = [this](const Entry &e, size_type pos) { m_positions[e.key] = pos; };
+
+        detail::heap_sift_up<Arity>(m_heap.data(), hole, std::move(entry), cmp, placed);
+    }
+
+    /*******************************************************************************
+     * sift_down
+     *
+     * @brief place entry at hole or below, recording every move in m_positions
+     *
+     * @param near_leaves entry is the former last element, likely to sink
+     * all the way
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    void HandlePriorityQueue<T, C, Arity, A>::sift_down(size_type hole, Entry entry, bool near_leaves)
+    {
+        auto cmp = [this](const Entry &a, const Entry &b) { return less(a, b); };
+        auto placed = [this](const Entry &e, size_type pos) { m_positions[e.key] = pos; };
+
+        if (near_leaves)
+            detail::heap_sift_down_to_leaf<Arity>(m_heap.data(), size(), hole, std::move(entry), cmp, placed);
+        else
+            detail::heap_sift_down<Arity>(m_heap.data(), size(), hole, std::move(entry), cmp, placed);
+    }
+
+    /*******************************************************************************
+     * remove_at
+     *
+     * @brief remove the element at heap position pos, refilling the hole with
+     * the last element sifted whichever way it has to go
+     *******************************************************************************/
+    template <class T, class C, std::size_t Arity, typename A>
+    void HandlePriorityQueue<T, C, Arity, A>::remove_at(size_type pos)
+    {
+        m_positions.erase(m_heap.data()[pos].key);
+
+        Entry last = std::move(m_heap.data()[size() - 1]);
+        m_heap.pop_back();
+        if (pos == size())
+            return;
+
+        if (pos > 0 && less(m_heap.data()[(pos - 1) / Arity], last))
+            sift_up(pos, std::move(last));
+        else
+            sift_down(pos, std::move(last), true);
+    }
+}
+
+#endif // PRIORITY_QUEUE_H
@@ -0,0 +1,298 @@
+/*******************************************************************************
+ *  @file RadixSort.h
+ *  @brief This file contains methods that sort custom Vectors of integral
+ *  and floating-point keys with a parallel LSD radix sort
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H 1
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "CustomVector.h"
+#include "Parallel.h"
+
+namespace custom
+{
+    namespace detail
+    {
+        // integers (but not bool) and 32/64-bit IEEE floating point
+        template <class T>
+        concept radix_key =
+            (std::integral<T> && !std::same_as<T, bool>) ||
+            (std::floating_point<T> && std::numeric_limits<T>::is_iec559 &&
+             (sizeof(T) == 4 || sizeof(T) == 8));
+
+        template <class T>
+        using radix_unsigned_t = typename std::conditional_t<
+            std::floating_point<T>,
+            std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>,
+            std::make_unsigned<T>>::type;
+
+        /*******************************************************************************
+         * to_radix
+         *
+         * @brief map key to an unsigned integer with the same ordering
+         *
+         * Signed integers get their sign bit flipped. Floats get their sign
+         * bit set when positive and all bits inverted when negative, so
+         * -inf < negatives < -0.0 < +0.0 < positives < +inf. NaNs sort by
+         * their bit pattern, below -inf or above +inf depending on sign.
+         *******************************************************************************/
+        template <radix_key T>
+        constexpr radix_unsigned_t<T> to_radix(T key) noexcept
+        {
+            using U = radix_unsigned_t<T>;
+            constexpr U sign = U(1) << (std::numeric_limits<U>::digits - 1);
+
+            if constexpr (std::floating_point<T>)
+            {
+                U bits = std::bit_cast<U>(key);
+                return (bits & sign) ? U(~bits) : U(bits | sign);
+            }
+            else if constexpr (std::is_signed_v<T>)
+                return U(key) ^ sign;
+            else
+                return key;
+        }
+
+        // below this many elements a comparison sort is cheaper than the passes
+        inline constexpr size_t radix_sort_cutoff = 256;
+
+        /*******************************************************************************
+         * radix_passes
+         *
+         * @brief LSD radix sort engine, one pass per 8-bit digit of U
+         *
+         * Elements live in two buffers, the input (0) and a scratch (1).
+         * key_at(buffer, i) returns the key of element i of a buffer and
+         * scatter(buffer, from, to) moves element from of that buffer to
+         * position to of the other one.
+         *
+         * A first parallel pass counts every digit of every key. A digit
+         * that has the same value in all keys would leave the order
+         * unchanged, so its pass is skipped. Each remaining pass counts the
+         * digit per worker chunk, turns the counts into per-worker output
+         * offsets (worker w's elements with digit d follow worker w-1's),
+         * and scatters the chunks in parallel. Chunks are processed in
+         * order, so every pass is stable.
+         *
+         * base is the input array, used for the chunk-to-worker mapping.
+         *
+         * @return the buffer holding the sorted elements
+         *******************************************************************************/
+        template <class U, class T, class KeyAt, class Scatter>
+        int radix_passes(T *base, size_t n, const ParallelInit &policy, KeyAt key_at, Scatter scatter)
+        {
+            constexpr unsigned passes = sizeof(U);
+            constexpr size_t radix = 256;
+
+            unsigned workers = policy.workers(n * sizeof(T));
+
+            // counts[w][pass][digit]
+            Vector<size_t> counts(workers * passes * radix, 0);
+            auto worker_counts = [&](unsigned w, unsigned pass)
+            { return counts.data() + (w * passes + pass) * radix; };
+
+            parallel_for_chunks(
+                base, base + n, [&](T *first, T *last, unsigned w)
+                {
+                    size_t *mine = worker_counts(w, 0);
+                    for (size_t i = first - base; i < size_t(last - base); ++i)
+                    {
+                        U key = key_at(0, i);
+                        for (unsigned pass = 0; pass < passes; ++pass)
+                            ++mine[pass * radix + ((key >> (8 * pass)) & 0xFF)];
+                    } },
+                policy);
+
+            Vector<size_t> offsets(workers * radix, 0);
+            int buffer = 0;
+            bool scattered = false;
+
+            for (unsigned pass = 0; pass < passes; ++pass)
+            {
+                bool constant = false;
+                for (size_t d = 0; d < radix && !constant; ++d)
+                {
+                    size_t total = 0;
+                    for (unsigned w = 0; w < workers; ++w)
+                        total += worker_counts(w, pass)[d];
+                    constant = total == n;
+                }
+
+                if (constant)
+                    continue;
+
+                // after the first scatter the chunks hold different elements
+                if (scattered)
+                {
+                    parallel_for_chunks(
+                        base, base + n, [&](T *first, T *last, unsigned w)
+                        {
+                            size_t *mine = worker_counts(w, pass);
+                            std::fill(mine, mine + radix, 0);
+                            for (size_t i = first - base; i < size_t(last - base); ++i)
+                                ++mine[(key_at(buffer, i) >> (8 * pass)) & 0xFF]; },
+                        policy);
+                }
+
+                size_t running = 0;
+                for (size_t d = 0; d < radix; ++d)
+                {
+                    for (unsigned w = 0; w < workers; ++w)
+                    {
+                        offsets.data()[w * radix + d] = running;
+                        running += worker_counts(w, pass)[d];
+                    }
+                }
+
+                parallel_for_chunks(
+                    base, base + n, [&](T *first, T *last, unsigned w)
+                    {
+                        size_t *next = offsets.data() + w * radix;
+                        for (size_t i = first - base; i < size_t(last - base); ++i)
+                            scatter(buffer, i, next[(key_at(buffer, i) >> (8 * pass)) & 0xFF]++); },
+                    policy);
+
+                buffer ^= 1;
+                scattered = true;
+            }
+
+            return buffer;
+        }
+    }
+
+    /*******************************************************************************
+     * radix_sort
+     *
+     * @brief sort a Vector of integers or IEEE floats in ascending order
+     *
+     * O(n) per non-constant byte of the key, with the counting and scattering
+     * split across policy.workers() threads. The scratch buffer comes from
+     * v's allocator and is first touched by the same workers; when the
+     * sorted data ends up in it, the two are swapped instead of copied.
+     *******************************************************************************/
+    template <detail::radix_key T, class A>
+    void radix_sort(Vector<T, A> &v, const ParallelInit &policy = parallel_init)
+    {
+        using U = detail::radix_unsigned_t<T>;
+
+        size_t n = v.size();
+        if (n < detail::radix_sort_cutoff)
+        {
+            std::sort(v.data(), v.data() + n, [](T a, T b)
+                      { return detail::to_radix(a) < detail::to_radix(b); });
+            return;
+        }
+
+        Vector<T, A> scratch(n, T{}, policy, v.get_allocator());
+        T *buffers[2] = {v.data(), scratch.data()};
+
+        int sorted = detail::radix_passes<U>(
+            v.data(), n, policy,
+            [&buffers](int b, size_t i)
+            { return detail::to_radix(buffers[b][i]); },
+            [&buffers](int b, size_t from, size_t to)
+            { buffers[b ^ 1][to] = buffers[b][from]; });
+
+        if (sorted)
+            swap(v, scratch);
+    }
+
+    /*******************************************************************************
+     * radix_sort_by_key
+     *
+     * @brief stable sort of v by key(element), where key returns an integer
+     * or IEEE float
+     *
+     * key is called several times per element, so it should be cheap (a
+     * member access, say). Elements are moved, and must be default
+     * constructible to fill the scratch buffer.
+     *******************************************************************************/
+    template <class T, class A, class KeyFn>
+        requires detail::radix_key<std::remove_cvref_t<std::invoke_result_t<KeyFn &, const T &>>> &&
+                 std::default_initializable<T> && std::movable<T>
+    void radix_sort_by_key(Vector<T, A> &v, KeyFn key, const ParallelInit &policy = parallel_init)
+    {
+        using K = std::remove_cvref_t<std::invoke_result_t<KeyFn &, const T &>>;
+        using U = detail::radix_unsigned_t<K>;
+
+        size_t n = v.size();
+        if (n < detail::radix_sort_cutoff)
+        {
+            std::stable_sort(v.data(), v.data() + n, [&key](const T &a, const T &b)
+                             { return detail::to_radix<K>(std::invoke(key, a)) <
+                                      detail::to_radix<K>(std::invoke(key, b)); });
+            return;
+        }
+
+        Vector<T, A> scratch(n, T{}, policy, v.get_allocator());
+        T *buffers[2] = {v.data(), scratch.data()};
+
+        int sorted = detail::radix_passes<U>(
+            v.data(), n, policy,
+            [&](int b, size_t i)
+            { return detail::to_radix<K>(std::invoke(key, std::as_const(buffers[b][i]))); },
+            [&buffers](int b, size_t from, size_t to)
+            { buffers[b ^ 1][to] = std::move(buffers[b][from]); });
+
+        if (sorted)
+            swap(v, scratch);
+    }
+
+    /*******************************************************************************
+     * radix_sort (key/value pairs)
+     *
+     * @brief sort keys ascending and apply the same (stable) permutation to
+     * values
+     *
+     * @throw std::invalid_argument if keys and values differ in size
+     *******************************************************************************/
+    template <detail::radix_key K, class AK, class V, class AV>
+        requires std::default_initializable<V> && std::movable<V>
+    void radix_sort(Vector<K, AK> &keys, Vector<V, AV> &values, const ParallelInit &policy = parallel_init)
+    {
+        using U = detail::radix_unsigned_t<K>;
+
+        if (keys.size() != values.size())
+            throw std::invalid_argument("radix_sort: keys and values differ in size");
+
+        size_t n = keys.size();
+        if (n < 2)
+            return;
+
+        Vector<K, AK> key_scratch(n, K{}, policy, keys.get_allocator());
+        Vector<V, AV> value_scratch(n, V{}, policy, values.get_allocator());
+        K *key_buffers[2] = {keys.data(), key_scratch.data()};
+        V *value_buffers[2] = {values.data(), value_scratch.data()};
+
+        int sorted = detail::radix_passes<U>(
+            keys.data(), n, policy,
+            [&key_buffers](int b, size_t i)
+            { return detail::to_radix(key_buffers[b][i]); },
+            [&](int b, size_t from, size_t to)
+            {
+                key_buffers[b ^ 1][to] = key_buffers[b][from];
+                value_buffers[b ^ 1][to] = std::move(value_buffers[b][from]);
+            });
+
+        if (sorted)
+        {
+            swap(keys, key_scratch);
+            swap(values, value_scratch);
+        }
+    }
+}
+
+#endif // RADIX_SORT_H
@@ -0,0 +1,531 @@
+/*******************************************************************************
+ *  @file SegmentedVector.h
+ *  @brief This file contains methods that define and implement a segmented
+ *  vector whose elements never move once constructed
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef SEGMENTED_VECTOR_H
+#define SEGMENTED_VECTOR_H 1
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace custom
+{
+    /*******************************************************************************
+     * class SegmentedVector
+     *
+     *  @brief A random access container that grows by allocating additional
+     *  chunks instead of relocating its elements
+     *
+     *  Chunk k holds (FirstChunk << k) elements, so the first k chunks always
+     *  hold FirstChunk * (2^k - 1) elements. This lets operator[] locate the
+     *  owning chunk of any index with a single bit_width, keeping random
+     *  access O(1) while growth never copies or moves existing elements.
+     *  Pointers, references and iterators therefore stay valid until the
+     *  element they refer to is removed.
+     *
+     *  Each chunk is contiguous, so hot loops can use chunk() / chunk_count()
+     *  to work on plain spans that the compiler can vectorize.
+     *
+     *  @tparam T  Type of element.
+     *  @tparam AllocType  Allocator type, default value is allocator<T>.
+     *  @tparam FirstChunk  Capacity of the first chunk, must be a power of two.
+     *
+     *******************************************************************************/
+    template <class T, typename AllocType = std::allocator<T>, std::size_t FirstChunk = 16>
+    class SegmentedVector
+    {
+        static_assert(std::has_single_bit(FirstChunk),
+                      "SegmentedVector: FirstChunk must be a power of two");
+
+    public:
+        using size_type = size_t;
+        using value_type = T;
+
+        template <bool IsConst>
+        class Basic_Iterator
+        {
+            using container_type = std::conditional_t<IsConst, const SegmentedVector, SegmentedVector>;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = T;
+            using pointer = std::conditional_t<IsConst, const T *, T *>;
+            using reference = std::conditional_t<IsConst, const T &, T &>;
+
+            Basic_Iterator() = default;
+            Basic_Iterator(container_type *vec, size_type idx) : m_vec(vec), m_idx(idx) {}
+
+            // allow iterator -> const_iterator conversion
+            template <bool OtherConst>
+                requires(IsConst && !OtherConst)
+            Basic_Iterator(const Basic_Iterator<OtherConst> &other)
+                : m_vec(other.m_vec), m_idx(other.m_idx)
+            {
+            }
+
+            reference operator*() const { return (*m_vec)[m_idx]; }
+            pointer operator->() const { return &(*m_vec)[m_idx]; }
+            reference operator[](difference_type n) const { return (*m_vec)[m_idx + n]; }
+
+            Basic_Iterator &operator++()
+            {
+                ++m_idx;
+                return *this;
+            }
+            Basic_Iterator operator++(int)
+            {
+                Basic_Iterator temp = *this;
+                ++m_idx;
+                return temp;
+            }
+            Basic_Iterator &operator--()
+            {
+                --m_idx;
+                return *this;
+            }
+            Basic_Iterator operator--(int)
+            {
+                Basic_Iterator temp = *this;
+                --m_idx;
+                return temp;
+            }
+
+            Basic_Iterator &operator+=(difference_type n)
+            {
+                m_idx += n;
+                return *this;
+            }
+            Basic_Iterator &operator-=(difference_type n)
+            {
+                m_idx -= n;
+                return *this;
+            }
+
+            Basic_Iterator operator+(difference_type n) const { return Basic_Iterator(m_vec, m_idx + n); }
+            Basic_Iterator operator-(difference_type n) const { return Basic_Iterator(m_vec, m_idx - n); }
+            friend Basic_Iterator operator+(difference_type n, const Basic_Iterator &it) { return it + n; }
+
+            friend difference_type operator-(const Basic_Iterator &a, const Basic_Iterator &b)
+            {
+                return static_cast<difference_type>(a.m_idx) - static_cast<difference_type>(b.m_idx);
+            }
+
+            friend bool operator==(const Basic_Iterator &a, const Basic_Iterator &b) { return a.m_idx == b.m_idx; }
+            friend auto operator<=>(const Basic_Iterator &a, const Basic_Iterator &b) { return a.m_idx <=> b.m_idx; }
+
+        private:
+            template <bool>
+            friend class Basic_Iterator;
+
+            container_type *m_vec = nullptr;
+            size_type m_idx = 0;
+        };
+
+        using iterator = Basic_Iterator<false>;
+        using const_iterator = Basic_Iterator<true>;
+
+        SegmentedVector(const AllocType &alloc = AllocType());
+        SegmentedVector(std::initializer_list<T> ilist, const AllocType &alloc = AllocType());
+        explicit SegmentedVector(size_type n, const T &val = T(), const AllocType &alloc = AllocType());
+
+        SegmentedVector(const SegmentedVector &other);
+        SegmentedVector(SegmentedVector &&other) noexcept;
+
+        SegmentedVector &operator=(const SegmentedVector &other);
+        SegmentedVector &operator=(SegmentedVector &&other) noexcept;
+
+        ~SegmentedVector();
+
+        // Element Access
+        T &at(size_type idx);
+        const T &at(size_type idx) const;
+
+        T &operator[](size_type idx) { return *locate(idx); }
+        const T &operator[](size_type idx) const { return *locate(idx); }
+        T &front() { return at(0); }
+        const T &front() const { return at(0); }
+        T &back() { return at(size() - 1); }
+        const T &back() const { return at(size() - 1); }
+
+        // Modifiers
+        void push_back(const T &val) { emplace_back(val); }
+        void push_back(T &&val) { emplace_back(std::move(val)); }
+        template <class... Args>
+        T &emplace_back(Args &&...args);
+        void pop_back();
+        void clear();
+
+        // Size and Capacity
+        void reserve(size_type);
+        size_type size() const noexcept { return m_size; }
+        size_type capacity() const noexcept { return chunk_offset(m_num_chunks); }
+        bool empty() const noexcept { return m_size == 0; }
+
+        // Chunk Access
+        size_type chunk_count() const noexcept;
+        std::span<T> chunk(size_type k) noexcept;
+        std::span<const T> chunk(size_type k) const noexcept;
+
+        friend void swap(SegmentedVector &a, SegmentedVector &b) noexcept
+        {
+            using std::swap;
+
+            swap(a.alloc, b.alloc);
+            swap(a.m_chunks, b.m_chunks);
+            swap(a.m_num_chunks, b.m_num_chunks);
+            swap(a.m_size, b.m_size);
+        }
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        iterator begin() { return iterator(this, 0); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator cbegin() const { return const_iterator(this, 0); }
+
+        iterator end() { return iterator(this, m_size); }
+        const_iterator end() const { return const_iterator(this, m_size); }
+        const_iterator cend() const { return const_iterator(this, m_size); }
+
+    private:
+        using traits = std::allocator_traits<AllocType>;
+
+        static constexpr size_type first_chunk_shift = std::countr_zero(FirstChunk);
+        static constexpr size_type max_chunks = std::numeric_limits<size_type>::digits - first_chunk_shift;
+
+        // number of elements held by chunk k
+        static constexpr size_type chunk_capacity(size_type k) noexcept { return FirstChunk << k; }
+
+        // index of the first element of chunk k
+        static constexpr size_type chunk_offset(size_type k) noexcept
+        {
+            return FirstChunk * ((size_type{1} << k) - 1);
+        }
+
+        T *locate(size_type idx) const noexcept;
+        void add_chunk();
+
+        AllocType alloc;
+        T *m_chunks[max_chunks] = {};
+        size_type m_num_chunks = 0;
+        size_type m_size = 0;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    SEGMENTED VECTOR METHODS  -------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * default constructor
+     *
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    SegmentedVector<T, A, F>::SegmentedVector(const A &alloc)
+        : alloc{alloc}
+    {
+    }
+
+    /*******************************************************************************
+     * @brief initializer_list constructor
+     *
+     * @param ilist list of type T objects
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    SegmentedVector<T, A, F>::SegmentedVector(std::initializer_list<T> ilist, const A &alloc)
+        : SegmentedVector(alloc)
+    {
+        reserve(ilist.size());
+
+        for (const T &val : ilist)
+            emplace_back(val);
+    }
+
+    /*******************************************************************************
+     * @brief parameter constructor
+     *
+     * Delegates to the allocator constructor, so if a copy of val throws the
+     * destructor releases the chunks and the elements of the chunks already
+     * filled (uninitialized_fill_n cleans up the chunk it was filling).
+     *
+     * @param n size
+     * @param val default value for constructed objects
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    SegmentedVector<T, A, F>::SegmentedVector(size_type n, const T &val, const A &alloc)
+        : SegmentedVector(alloc)
+    {
+        reserve(n);
+
+        for (size_type k = 0; m_size < n; ++k)
+        {
+            size_type count = std::min(chunk_capacity(k), n - m_size);
+            std::uninitialized_fill_n(m_chunks[k], count, val);
+            m_size += count;
+        }
+    }
+
+    /*******************************************************************************
+     * copy constructor
+     *
+     * Delegates like the parameter constructor, so a throwing element copy
+     * leaks nothing.
+     *
+     * @param other segmented vector object
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    SegmentedVector<T, A, F>::SegmentedVector(const SegmentedVector &other)
+        : SegmentedVector(traits::select_on_container_copy_construction(other.alloc))
+    {
+        reserve(other.size());
+
+        // chunk k of both vectors has the same capacity,
+        // so the copy can be done one chunk at a time
+        for (size_type k = 0; m_size < other.size(); ++k)
+        {
+            std::span<const T> src = other.chunk(k);
+            std::uninitialized_copy(src.begin(), src.end(), m_chunks[k]);
+            m_size += src.size();
+        }
+    }
+
+    /*******************************************************************************
+     * @brief move constructor
+     *
+     * @param other segmented vector object
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    SegmentedVector<T, A, F>::SegmentedVector(SegmentedVector &&other) noexcept
+        : alloc{other.alloc}
+    {
+        swap(*this, other);
+    }
+
+    /*******************************************************************************
+     * copy assignment operator
+     *
+     * @param other segmented vector object
+     * @return SegmentedVector reference
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    SegmentedVector<T, A, F> &SegmentedVector<T, A, F>::operator=(const SegmentedVector &other)
+    {
+        // copy-and-swap
+        SegmentedVector temp(other);
+        swap(*this, temp);
+
+        return *this;
+    }
+
+    /*******************************************************************************
+     * @brief move assignment operator
+     *
+     * @param other segmented vector object
+     * @return SegmentedVector reference
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    SegmentedVector<T, A, F> &SegmentedVector<T, A, F>::operator=(SegmentedVector &&other) noexcept
+    {
+        swap(*this, other);
+
+        return *this;
+    }
+
+    /*******************************************************************************
+     * destructor
+     *
+     * @brief destroys every element and releases all chunks
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    SegmentedVector<T, A, F>::~SegmentedVector()
+    {
+        clear();
+
+        for (size_type k = 0; k < m_num_chunks; ++k)
+            traits::deallocate(alloc, m_chunks[k], chunk_capacity(k));
+
+        m_num_chunks = 0;
+    }
+
+    /*******************************************************************************
+     * at
+     *
+     * @return reference to the element at idx
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    T &SegmentedVector<T, A, F>::at(size_type idx)
+    {
+        if (idx >= size())
+            throw std::out_of_range("Invalid index");
+
+        return *locate(idx);
+    }
+
+    /*******************************************************************************
+     * at
+     *
+     * @return const reference to the element at idx
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    const T &SegmentedVector<T, A, F>::at(size_type idx) const
+    {
+        if (idx >= size())
+            throw std::out_of_range("Invalid index");
+
+        return *locate(idx);
+    }
+
+    /*******************************************************************************
+     * emplace_back
+     *
+     * @brief construct an element in place at the end of the vector
+     *
+     * When the last chunk is full a new chunk is allocated; existing elements
+     * are never relocated.
+     *
+     * @param args arguments forwarded to the constructor of T
+     * @return reference to the new element
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    template <class... Args>
+    T &SegmentedVector<T, A, F>::emplace_back(Args &&...args)
+    {
+        if (size() == capacity())
+            add_chunk();
+
+        T *slot = std::construct_at(locate(m_size), std::forward<Args>(args)...);
+        ++m_size;
+
+        return *slot;
+    }
+
+    /*******************************************************************************
+     * pop_back
+     *
+     * @brief destroy and remove the last element
+     *
+     * Chunks are kept so that a following push_back does not reallocate.
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    void SegmentedVector<T, A, F>::pop_back()
+    {
+        if (empty())
+            throw std::out_of_range(__PRETTY_FUNCTION__ + std::string(": SegmentedVector is empty"));
+
+        --m_size;
+        std::destroy_at(locate(m_size));
+    }
+
+    /*******************************************************************************
+     * clear
+     *
+     * @brief destroy every element, keeping the allocated chunks
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    void SegmentedVector<T, A, F>::clear()
+    {
+        for (size_type k = 0; k < m_num_chunks && chunk_offset(k) < m_size; ++k)
+            std::destroy_n(m_chunks[k], std::min(chunk_capacity(k), m_size - chunk_offset(k)));
+
+        m_size = 0;
+    }
+
+    /*******************************************************************************
+     * reserve
+     *
+     * @brief allocate chunks until at least size_to_reserve elements fit
+     *
+     * Unlike Vector::reserve, no element is moved.
+     *
+     * @param size_to_reserve number of elements to make room for
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    void SegmentedVector<T, A, F>::reserve(size_type size_to_reserve)
+    {
+        while (capacity() < size_to_reserve)
+            add_chunk();
+    }
+
+    /*******************************************************************************
+     * chunk_count
+     *
+     * @return number of chunks holding at least one element
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    typename SegmentedVector<T, A, F>::size_type SegmentedVector<T, A, F>::chunk_count() const noexcept
+    {
+        if (empty())
+            return 0;
+
+        return std::bit_width(((m_size - 1) >> first_chunk_shift) + 1);
+    }
+
+    /*******************************************************************************
+     * chunk
+     *
+     * @param k chunk number, must be less than chunk_count()
+     * @return span over the constructed elements of chunk k
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    std::span<T> SegmentedVector<T, A, F>::chunk(size_type k) noexcept
+    {
+        return {m_chunks[k], std::min(chunk_capacity(k), m_size - chunk_offset(k))};
+    }
+
+    template <class T, typename A, std::size_t F>
+    std::span<const T> SegmentedVector<T, A, F>::chunk(size_type k) const noexcept
+    {
+        return {m_chunks[k], std::min(chunk_capacity(k), m_size - chunk_offset(k))};
+    }
+
+    /*******************************************************************************
+     * locate
+     *
+     * @brief map an index to the address of its slot
+     *
+     * Index idx lives in chunk k = bit_width(idx / FirstChunk + 1) - 1.
+     *
+     * @param idx element index, may equal size() when a slot is reserved
+     * @return pointer to the slot
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    T *SegmentedVector<T, A, F>::locate(size_type idx) const noexcept
+    {
+        size_type k = std::bit_width((idx >> first_chunk_shift) + 1) - 1;
+
+        return m_chunks[k] + (idx - chunk_offset(k));
+    }
+
+    /*******************************************************************************
+     * add_chunk
+     *
+     * @brief allocate the next chunk, doubling the capacity
+     *******************************************************************************/
+    template <class T, typename A, std::size_t F>
+    void SegmentedVector<T, A, F>::add_chunk()
+    {
+        if (m_num_chunks == max_chunks)
+            throw std::length_error("SegmentedVector: maximum size exceeded");
+
+        m_chunks[m_num_chunks] = traits::allocate(alloc, chunk_capacity(m_num_chunks));
+        ++m_num_chunks;
+    }
+}
+
+#endif // SEGMENTED_VECTOR_H
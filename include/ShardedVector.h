@@ -0,0 +1,275 @@
+/*******************************************************************************
+ *  @file ShardedVector.h
+ *  @brief This file contains methods that define and implement a vector
+ *  appended to by many threads through per-thread shards
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef SHARDED_VECTOR_H
+#define SHARDED_VECTOR_H 1
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "CustomVector.h"
+#include "Parallel.h"
+
+namespace custom
+{
+    /*******************************************************************************
+     * class ShardedVector
+     *
+     *  @brief A collection of per-worker Vectors that many threads append to
+     *  without locking, merged into one Vector at the end
+     *
+     *  Worker w appends through shard(w) (or push_back(w, val)). Each shard
+     *  sits on its own cache line, so workers never write to a line another
+     *  worker is writing. Any number of threads may append concurrently as
+     *  long as no two use the same worker id; everything else (size,
+     *  merge_into, collect, clear) requires the appends to have finished.
+     *
+     *  merge_into sizes the destination once and copies the shards into it
+     *  in parallel. Shards land in worker id order, each in its own
+     *  insertion order, so the result is deterministic. collect does the
+     *  same with moves and leaves the shards empty.
+     *
+     *  The worker ids of parallel_for_chunks make natural shard ids:
+     *
+     *      ShardedVector<Hit> hits(policy.workers(bytes));
+     *      parallel_for_chunks(first, last, [&](Row *a, Row *b, unsigned w)
+     *                          { for (; a != b; ++a) if (match(*a)) hits.push_back(w, hit(*a)); },
+     *                          policy);
+     *      Vector<Hit> all = hits.collect();
+     *
+     *  @tparam T  Type of element.
+     *  @tparam AllocType  Allocator type, default value is allocator<T>.
+     *
+     *******************************************************************************/
+    template <class T, typename AllocType = std::allocator<T>>
+    class ShardedVector
+    {
+    public:
+        using size_type = size_t;
+        using value_type = T;
+
+        static constexpr size_type cache_line_size = 64;
+
+        explicit ShardedVector(size_type shard_count = std::max(1u, std::thread::hardware_concurrency()),
+                               const AllocType &alloc = AllocType());
+
+        ShardedVector(const ShardedVector &) = delete;
+        ShardedVector &operator=(const ShardedVector &) = delete;
+
+        // Shard Access
+        Vector<T, AllocType> &shard(size_type worker);
+        const Vector<T, AllocType> &shard(size_type worker) const;
+        size_type shard_count() const noexcept { return m_shards.size(); }
+
+        // Modifiers
+        void push_back(size_type worker, const T &val) { shard(worker).push_back(val); }
+        void push_back(size_type worker, T &&val) { shard(worker).push_back(std::move(val)); }
+        template <class... Args>
+        T &emplace_back(size_type worker, Args &&...args)
+        {
+            return shard(worker).emplace_back(std::forward<Args>(args)...);
+        }
+        void reserve_per_shard(size_type n);
+        void clear();
+
+        // Merging
+        template <typename DestAlloc>
+        void merge_into(Vector<T, DestAlloc> &dest, const ParallelInit &policy = parallel_init) const;
+        Vector<T, AllocType> collect(const ParallelInit &policy = parallel_init);
+
+        // Size and Capacity
+        size_type size() const noexcept;
+        bool empty() const noexcept { return size() == 0; }
+
+    private:
+        struct alignas(cache_line_size) Shard
+        {
+            explicit Shard(const AllocType &alloc) : items{alloc} {}
+
+            Vector<T, AllocType> items;
+        };
+
+        using Shard_Alloc = typename std::allocator_traits<AllocType>::template rebind_alloc<Shard>;
+
+        // copy (Move = false) or move every shard, in order, to the end of dest
+        template <bool Move, typename DestAlloc, class Shards>
+        static void merge(Shards &shards, Vector<T, DestAlloc> &dest, const ParallelInit &policy);
+
+        Vector<Shard, Shard_Alloc> m_shards;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    SHARDED VECTOR METHODS  ---------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * constructor
+     *
+     * @param shard_count number of workers, default one per hardware thread
+     * @param alloc allocator for the shards' elements
+     *******************************************************************************/
+    template <class T, typename A>
+    ShardedVector<T, A>::ShardedVector(size_type shard_count, const A &alloc)
+        : m_shards{Shard_Alloc(alloc)}
+    {
+        if (shard_count == 0)
+            throw std::invalid_argument("ShardedVector: shard_count must be positive");
+
+        // reserved up front, the shards never move
+        m_shards.reserve(shard_count);
+        for (size_type w = 0; w < shard_count; ++w)
+            m_shards.emplace_back(alloc);
+    }
+
+    /*******************************************************************************
+     * shard
+     *
+     * @return the Vector owned by worker
+     *******************************************************************************/
+    template <class T, typename A>
+    Vector<T, A> &ShardedVector<T, A>::shard(size_type worker)
+    {
+        return m_shards.at(worker).items;
+    }
+
+    template <class T, typename A>
+    const Vector<T, A> &ShardedVector<T, A>::shard(size_type worker) const
+    {
+        return m_shards.at(worker).items;
+    }
+
+    /*******************************************************************************
+     * reserve_per_shard
+     *
+     * @brief reserve room for n elements in every shard
+     *******************************************************************************/
+    template <class T, typename A>
+    void ShardedVector<T, A>::reserve_per_shard(size_type n)
+    {
+        for (Shard &s : m_shards)
+            s.items.reserve(n);
+    }
+
+    /*******************************************************************************
+     * clear
+     *
+     * @brief empty every shard
+     *******************************************************************************/
+    template <class T, typename A>
+    void ShardedVector<T, A>::clear()
+    {
+        for (Shard &s : m_shards)
+            s.items.clear();
+    }
+
+    /*******************************************************************************
+     * size
+     *
+     * @return total number of elements over all shards
+     *******************************************************************************/
+    template <class T, typename A>
+    typename ShardedVector<T, A>::size_type ShardedVector<T, A>::size() const noexcept
+    {
+        size_type total = 0;
+        for (const Shard &s : m_shards)
+            total += s.items.size();
+
+        return total;
+    }
+
+    /*******************************************************************************
+     * merge_into
+     *
+     * @brief append copies of every shard's elements to dest
+     *
+     * @param dest destination, grown exactly once
+     * @param policy threads used for the copy
+     *******************************************************************************/
+    template <class T, typename A>
+    template <typename DestAlloc>
+    void ShardedVector<T, A>::merge_into(Vector<T, DestAlloc> &dest, const ParallelInit &policy) const
+    {
+        merge<false>(m_shards, dest, policy);
+    }
+
+    /*******************************************************************************
+     * collect
+     *
+     * @brief move every shard's elements into one Vector and empty the shards
+     *
+     * @return the merged elements
+     *******************************************************************************/
+    template <class T, typename A>
+    Vector<T, A> ShardedVector<T, A>::collect(const ParallelInit &policy)
+    {
+        Vector<T, A> result(m_shards.front().items.get_allocator());
+        merge<true>(m_shards, result, policy);
+        clear();
+
+        return result;
+    }
+
+    /*******************************************************************************
+     * merge
+     *
+     * @brief the merged range is split into equal chunks across workers; a
+     * chunk may span several shards and each worker walks the shards its
+     * chunk overlaps, so one huge shard still spreads over all workers
+     *******************************************************************************/
+    template <class T, typename A>
+    template <bool Move, typename DestAlloc, class Shards>
+    void ShardedVector<T, A>::merge(Shards &shards, Vector<T, DestAlloc> &dest, const ParallelInit &policy)
+    {
+        size_type count = shards.size();
+
+        // starts[w] is the merged index of shard w's first element
+        Vector<size_type> starts(count + 1, 0);
+        for (size_type w = 0; w < count; ++w)
+            starts[w + 1] = starts[w] + shards[w].items.size();
+
+        dest.append_construct(starts[count], [&](T *first, T *last)
+                              { detail::parallel_construct(
+                                    first, last, policy, [&](T *chunk_first, T *chunk_last, unsigned)
+                                    {
+                size_type lo = chunk_first - first;
+                size_type hi = chunk_last - first;
+                T *out = chunk_first;
+
+                // the last shard starting at or before lo
+                size_type w = std::upper_bound(starts.begin(), starts.end(), lo) - starts.begin() - 1;
+
+                try
+                {
+                    for (; lo < hi; ++w)
+                    {
+                        auto *src = shards[w].items.data();
+                        size_type from = lo - starts[w];
+                        size_type to = std::min(hi, starts[w + 1]) - starts[w];
+
+                        if constexpr (Move)
+                            out = std::uninitialized_move(src + from, src + to, out);
+                        else
+                            out = detail::construct_copy(src + from, src + to, out);
+
+                        lo = starts[w] + to;
+                    }
+                }
+                catch (...)
+                {
+                    // all or nothing per chunk, as parallel_construct expects
+                    std::destroy(chunk_first, out);
+                    throw;
+                } }); });
+    }
+}
+
+#endif // SHARDED_VECTOR_H
@@ -0,0 +1,1170 @@
+/*******************************************************************************
+ *  @file SharedVector.h
+ *  @brief This file contains methods that define and implement a shared
+ *  memory segment, an allocator on it, and a vector living inside it that
+ *  several processes can map at different addresses
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef SHARED_VECTOR_H
+#define SHARED_VECTOR_H 1
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace custom
+{
+    /*******************************************************************************
+     * class OffsetPtr
+     *
+     *  @brief Pointer storing the distance from itself to its target, so an
+     *  object holding one can be mapped at any address as long as the
+     *  target moves with it (both in the same shared segment)
+     *
+     *  Copying recomputes the distance for the new location. Null is
+     *  stored as 1, a distance no other object can have.
+     *
+     *  @tparam T  Type pointed to.
+     *******************************************************************************/
+    template <class T>
+    class OffsetPtr
+    {
+    public:
+        OffsetPtr() noexcept = default;
+        OffsetPtr(T *ptr) noexcept { set(ptr); }
+        OffsetPtr(const OffsetPtr &other) noexcept { set(other.get()); }
+
+        OffsetPtr &operator=(const OffsetPtr &other) noexcept
+        {
+            set(other.get());
+            return *this;
+        }
+        OffsetPtr &operator=(T *ptr) noexcept
+        {
+            set(ptr);
+            return *this;
+        }
+
+        T *get() const noexcept
+        {
+            if (m_offset == null_offset)
+                return nullptr;
+
+            return reinterpret_cast<T *>(reinterpret_cast<std::uintptr_t>(this) + m_offset);
+        }
+
+        T &operator*() const noexcept { return *get(); }
+        T *operator->() const noexcept { return get(); }
+        explicit operator bool() const noexcept { return m_offset != null_offset; }
+
+        friend bool operator==(const OffsetPtr &a, const OffsetPtr &b) noexcept { return a.get() == b.get(); }
+
+    private:
+        static constexpr std::ptrdiff_t null_offset = 1;
+
+        void set(T *ptr) noexcept
+        {
+            m_offset = ptr ? static_cast<std::ptrdiff_t>(reinterpret_cast<std::uintptr_t>(ptr) -
+                                                         reinterpret_cast<std::uintptr_t>(this))
+                           : null_offset;
+        }
+
+        std::ptrdiff_t m_offset = null_offset;
+    };
+
+    namespace detail
+    {
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                          std::atomic<std::uint32_t>::is_always_lock_free,
+                      "shared segments need address-free atomics");
+
+        /*******************************************************************************
+         * struct Segment_Header
+         *
+         *  @brief first bytes of a shared segment: a block allocator and a
+         *  directory of named objects, addressed by offsets from the header
+         *
+         *  Blocks are rounded up to a power of two (at least 64 bytes, and
+         *  64-byte aligned) and freed blocks are kept on a free list per
+         *  size, linked through their first 8 bytes. New blocks are cut
+         *  from the unused end of the segment. A spin lock word in the
+         *  header serializes every process using the segment; a process
+         *  dying while holding it leaves the segment locked.
+         *******************************************************************************/
+        struct Segment_Header
+        {
+            // "CVSHM001" as a little-endian word
+            static constexpr std::uint64_t magic_value = 0x3130304D48535643ull;
+            static constexpr std::size_t min_block_shift = 6;
+            static constexpr std::size_t num_classes = 48;
+            static constexpr std::size_t directory_slots = 64;
+            static constexpr std::size_t max_name = 47;
+
+            struct Directory_Entry
+            {
+                char name[max_name + 1];
+                std::uint64_t offset;
+                std::uint64_t bytes;
+            };
+
+            explicit Segment_Header(std::uint64_t segment_bytes) noexcept;
+
+            char *base() noexcept { return reinterpret_cast<char *>(this); }
+            bool valid(std::uint64_t segment_bytes) const noexcept
+            {
+                // acquire pairs with the constructor's release, so a valid
+                // magic means the rest of the header is visible too
+                return magic.load(std::memory_order_acquire) == magic_value && size == segment_bytes;
+            }
+
+            std::uint64_t allocate(std::size_t bytes);
+            void deallocate(std::uint64_t offset, std::size_t bytes) noexcept;
+
+            Directory_Entry *find(std::string_view name) noexcept;
+            std::uint64_t free_bytes() noexcept;
+
+            void lock() noexcept;
+            void unlock() noexcept { spin.store(0, std::memory_order_release); }
+
+            static constexpr std::size_t size_class(std::size_t bytes) noexcept
+            {
+                if (bytes <= (std::size_t{1} << min_block_shift))
+                    return 0;
+
+                return std::bit_width(bytes - 1) - min_block_shift;
+            }
+
+            static constexpr std::uint64_t class_bytes(std::size_t c) noexcept
+            {
+                return std::uint64_t{1} << (c + min_block_shift);
+            }
+
+            std::atomic<std::uint64_t> magic{0};
+            std::uint64_t size;
+            std::uint64_t top;
+            std::atomic<std::uint32_t> spin{0};
+            std::uint64_t free_heads[num_classes] = {};
+            Directory_Entry directory[directory_slots] = {};
+        };
+
+        inline constexpr std::uint64_t segment_data_start = (sizeof(Segment_Header) + 63) / 64 * 64;
+
+        /*******************************************************************************
+         * Segment_Lock
+         *
+         * @brief scoped lock on a segment's spin lock
+         *******************************************************************************/
+        struct Segment_Lock
+        {
+            explicit Segment_Lock(Segment_Header &h) noexcept : header(h) { header.lock(); }
+            ~Segment_Lock() { header.unlock(); }
+
+            Segment_Header &header;
+        };
+    }
+
+    template <class T>
+    class SharedAllocator;
+
+    /*******************************************************************************
+     * class SharedSegment
+     *
+     *  @brief This process's mapping of a shared memory segment
+     *
+     *  A segment is a fixed-size memfd (create(bytes)) or POSIX shared
+     *  memory object (create(name, bytes)) mapped MAP_SHARED. Other
+     *  processes reach it with open(name), or with attach(fd) on a
+     *  descriptor they inherited or received over a Unix socket, and
+     *  usually map it at a different address.
+     *
+     *  Objects are placed in the segment under a name with
+     *  find_or_construct, and looked up by the other processes with find.
+     *  Such objects must only hold offsets (OffsetPtr, or offsets from
+     *  the segment start) and trivially copyable data; SharedVector is
+     *  built that way.
+     *
+     *  Pages are only backed by memory once written, so a generously
+     *  sized segment costs address space, not RAM. The mapping and the
+     *  descriptor are released when the object is destroyed; the segment
+     *  itself lives until every mapping is gone and, for a named segment,
+     *  remove(name) has been called.
+     *******************************************************************************/
+    class SharedSegment
+    {
+    public:
+        static SharedSegment create(std::size_t bytes);
+        static SharedSegment create(const std::string &name, std::size_t bytes);
+        static SharedSegment open(const std::string &name);
+        static SharedSegment attach(int fd);
+        static bool remove(const std::string &name) noexcept { return ::shm_unlink(name.c_str()) == 0; }
+
+        SharedSegment(SharedSegment &&other) noexcept
+            : m_fd{std::exchange(other.m_fd, -1)}, m_header{std::exchange(other.m_header, nullptr)},
+              m_size{std::exchange(other.m_size, 0)}
+        {
+        }
+        SharedSegment &operator=(SharedSegment &&other) noexcept
+        {
+            std::swap(m_fd, other.m_fd);
+            std::swap(m_header, other.m_header);
+            std::swap(m_size, other.m_size);
+            return *this;
+        }
+        ~SharedSegment();
+
+        // Mapping
+        int fd() const noexcept { return m_fd; }
+        void *base() const noexcept { return m_header; }
+        std::size_t size() const noexcept { return m_size; }
+        std::size_t free_bytes() const noexcept { return m_header->free_bytes(); }
+
+        // Named objects
+        template <class Obj, class... Args>
+        Obj &find_or_construct(std::string_view name, Args &&...args);
+        template <class Obj>
+        Obj *find(std::string_view name) const;
+        template <class Obj>
+        bool destroy(std::string_view name);
+
+    private:
+        template <class T>
+        friend class SharedAllocator;
+
+        SharedSegment(int fd, std::size_t bytes, bool initialize);
+
+        static void check_name(std::string_view name);
+
+        int m_fd;
+        detail::Segment_Header *m_header = nullptr;
+        std::size_t m_size;
+    };
+
+    /*******************************************************************************
+     * class SharedAllocator
+     *
+     *  @brief Allocator handing out blocks of a SharedSegment
+     *
+     *  The pointers it returns are addresses in the calling process's
+     *  mapping; store them in the segment as offsets. Throws
+     *  std::bad_alloc when the segment is full.
+     *
+     *  @tparam T  Type of element, aligned to at most 64 bytes.
+     *******************************************************************************/
+    template <class T>
+    class SharedAllocator
+    {
+        static_assert(alignof(T) <= 64, "SharedAllocator: blocks are 64-byte aligned");
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        SharedAllocator(SharedSegment &segment) noexcept : m_header{segment.m_header} {}
+        explicit SharedAllocator(detail::Segment_Header *header) noexcept : m_header{header} {}
+
+        template <class U>
+        SharedAllocator(const SharedAllocator<U> &other) noexcept : m_header{other.segment_header()}
+        {
+        }
+
+        T *allocate(size_type n)
+        {
+            if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+                throw std::bad_array_new_length();
+
+            return reinterpret_cast<T *>(m_header->base() + m_header->allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T *block, size_type n) noexcept
+        {
+            m_header->deallocate(reinterpret_cast<char *>(block) - m_header->base(), n * sizeof(T));
+        }
+
+        detail::Segment_Header *segment_header() const noexcept { return m_header; }
+
+        template <class U>
+        friend bool operator==(const SharedAllocator &a, const SharedAllocator<U> &b) noexcept
+        {
+            return a.segment_header() == b.segment_header();
+        }
+
+    private:
+        detail::Segment_Header *m_header;
+    };
+
+    /*******************************************************************************
+     * struct Shared_Memory_Manager
+     *
+     *  @brief the Vector_Memory_Manager of a SharedVector: the block bounds
+     *  kept as byte offsets from the segment start, which mean the same in
+     *  every process, and a self-relative pointer to the segment
+     *
+     *  The bounds are atomics (relaxed; address-free, as they live in
+     *  shared memory) so readers in other processes can load them while
+     *  the writer changes them. sequence is the SharedVector's seqlock.
+     *******************************************************************************/
+    template <class T>
+    struct Shared_Memory_Manager
+    {
+        explicit Shared_Memory_Manager(detail::Segment_Header *header) noexcept : segment{header} {}
+
+        T *pointer(std::uint64_t offset) const noexcept
+        {
+            return reinterpret_cast<T *>(segment->base() + offset);
+        }
+
+        OffsetPtr<detail::Segment_Header> segment;
+        std::atomic<std::uint64_t> block_start{0};
+        std::atomic<std::uint64_t> uninitialized_block_start{0};
+        std::atomic<std::uint64_t> block_end{0};
+        std::atomic<std::uint64_t> sequence{0};
+    };
+
+    /*******************************************************************************
+     * class SharedVector
+     *
+     *  @brief Vector of trivially copyable elements living in a
+     *  SharedSegment, usable from every process that maps it
+     *
+     *  The producer builds it in place and consumers read the same pages,
+     *  so a large vector changes hands without being copied or serialized:
+     *
+     *      // feed handler
+     *      auto segment = custom::SharedSegment::create("/ticks", 1ull << 34);
+     *      auto &ticks = segment.find_or_construct<custom::SharedVector<Tick>>("ticks", segment);
+     *      { auto guard = ticks.write(); ticks.append_range(batch); }
+     *
+     *      // analytics
+     *      auto segment = custom::SharedSegment::open("/ticks");
+     *      auto *ticks = segment.find<custom::SharedVector<Tick>>("ticks");
+     *      double vwap = ticks->read([](std::span<const Tick> all) { return vwap_of(all); });
+     *
+     *  Single writer, many readers: changes the writer makes while readers
+     *  may be looking go inside a write() section, which makes them odd on
+     *  a sequence counter (a seqlock). read(fn) runs fn on the published
+     *  elements and runs it again if a write section overlapped it, so fn
+     *  only ever returns a result computed from a consistent vector; it
+     *  must not keep the span. A reallocated block stays mapped (it goes
+     *  back to the segment's free list), so an overlapped fn reads stale
+     *  bytes, not unmapped memory. version() tells whether anything was
+     *  published since a previous call.
+     *
+     *  Element access through data(), operator[] and the iterators is for
+     *  the writer, or for readers when no writer is active. Like Vector,
+     *  operator[] is bounds checked.
+     *
+     *  @tparam T  Type of element, trivially copyable.
+     *******************************************************************************/
+    template <class T>
+    class SharedVector
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SharedVector: elements are shared as bytes");
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = T *;
+        using const_iterator = const T *;
+
+        /*******************************************************************************
+         * class Write_Guard
+         *
+         *  @brief write section of the seqlock; nested guards are no-ops
+         *******************************************************************************/
+        class Write_Guard
+        {
+        public:
+            explicit Write_Guard(std::atomic<std::uint64_t> &sequence) noexcept;
+            ~Write_Guard();
+
+            Write_Guard(const Write_Guard &) = delete;
+            Write_Guard &operator=(const Write_Guard &) = delete;
+
+        private:
+            std::atomic<std::uint64_t> *m_sequence;
+        };
+
+        SharedVector(const SharedAllocator<T> &alloc);
+        ~SharedVector();
+
+        SharedVector(const SharedVector &) = delete;
+        SharedVector &operator=(const SharedVector &) = delete;
+
+        // Element Access
+        T &at(size_type idx);
+        const T &at(size_type idx) const;
+        T &operator[](size_type idx) { return at(idx); }
+        const T &operator[](size_type idx) const { return at(idx); }
+        T &front() { return at(0); }
+        T &back() { return at(size() - 1); }
+        T *data() noexcept { return start() ? mem_manager.pointer(start()) : nullptr; }
+        const T *data() const noexcept { return start() ? mem_manager.pointer(start()) : nullptr; }
+        SharedAllocator<T> get_allocator() const noexcept { return SharedAllocator<T>(mem_manager.segment.get()); }
+
+        // Modifiers
+        void push_back(const T &val);
+        template <class... Args>
+        T &emplace_back(Args &&...args);
+        template <std::ranges::input_range R>
+        void append_range(R &&rg);
+        void pop_back();
+        void resize(size_type new_size);
+        void resize(size_type new_size, const T &val);
+        void clear() noexcept { set_size(0); }
+
+        // Size and Capacity
+        void reserve(size_type size_to_reserve);
+        void shrink_to_fit();
+        size_type size() const noexcept { return (finish() - start()) / sizeof(T); }
+        size_type capacity() const noexcept { return (end_of_storage() - start()) / sizeof(T); }
+        bool empty() const noexcept { return size() == 0; }
+
+        // Publication
+        [[nodiscard]] Write_Guard write() noexcept { return Write_Guard(mem_manager.sequence); }
+        template <class Fn>
+        auto read(Fn fn) const;
+        std::uint64_t version() const noexcept { return mem_manager.sequence.load(std::memory_order_acquire) / 2; }
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        iterator begin() noexcept { return data(); }
+        const_iterator begin() const noexcept { return data(); }
+        iterator end() noexcept { return data() + size(); }
+        const_iterator end() const noexcept { return data() + size(); }
+
+    private:
+        std::uint64_t start() const noexcept { return mem_manager.block_start.load(std::memory_order_relaxed); }
+        std::uint64_t finish() const noexcept { return mem_manager.uninitialized_block_start.load(std::memory_order_relaxed); }
+        std::uint64_t end_of_storage() const noexcept { return mem_manager.block_end.load(std::memory_order_relaxed); }
+        void set_size(size_type n) noexcept
+        {
+            mem_manager.uninitialized_block_start.store(start() + n * sizeof(T), std::memory_order_relaxed);
+        }
+        void reallocate(size_type new_capacity);
+        void grow_for(size_type extra);
+
+        Shared_Memory_Manager<T> mem_manager;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    SEGMENT HEADER METHODS  ---------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    inline detail::Segment_Header::Segment_Header(std::uint64_t segment_bytes) noexcept
+        : size{segment_bytes}, top{segment_data_start}
+    {
+        // published last, with release: a process opening the segment checks it
+        magic.store(magic_value, std::memory_order_release);
+    }
+
+    /*******************************************************************************
+     * allocate
+     *
+     * @return offset of a block of at least bytes bytes
+     * @throw std::bad_alloc if the segment has no room left
+     *******************************************************************************/
+    inline std::uint64_t detail::Segment_Header::allocate(std::size_t bytes)
+    {
+        std::size_t c = size_class(bytes ? bytes : 1);
+        if (c >= num_classes)
+            throw std::bad_alloc();
+
+        Segment_Lock guard(*this);
+
+        if (std::uint64_t offset = free_heads[c])
+        {
+            std::memcpy(&free_heads[c], base() + offset, sizeof(std::uint64_t));
+            return offset;
+        }
+
+        if (size - top < class_bytes(c))
+            throw std::bad_alloc();
+
+        std::uint64_t offset = top;
+        top += class_bytes(c);
+
+        return offset;
+    }
+
+    /*******************************************************************************
+     * deallocate
+     *
+     * @brief put the block at offset (allocated for bytes bytes) on its free list
+     *******************************************************************************/
+    inline void detail::Segment_Header::deallocate(std::uint64_t offset, std::size_t bytes) noexcept
+    {
+        std::size_t c = size_class(bytes ? bytes : 1);
+        Segment_Lock guard(*this);
+
+        std::memcpy(base() + offset, &free_heads[c], sizeof(std::uint64_t));
+        free_heads[c] = offset;
+    }
+
+    /*******************************************************************************
+     * find
+     *
+     * @return the directory entry named name, or nullptr; the lock must be held
+     *******************************************************************************/
+    inline detail::Segment_Header::Directory_Entry *
+    detail::Segment_Header::find(std::string_view name) noexcept
+    {
+        for (Directory_Entry &entry : directory)
+            if (entry.offset && name == entry.name)
+                return &entry;
+
+        return nullptr;
+    }
+
+    /*******************************************************************************
+     * free_bytes
+     *
+     * @return bytes never handed out plus bytes on the free lists
+     *******************************************************************************/
+    inline std::uint64_t detail::Segment_Header::free_bytes() noexcept
+    {
+        Segment_Lock guard(*this);
+
+        std::uint64_t bytes = size - top;
+        for (std::size_t c = 0; c < num_classes; ++c)
+            for (std::uint64_t offset = free_heads[c]; offset;)
+            {
+                bytes += class_bytes(c);
+                std::memcpy(&offset, base() + offset, sizeof offset);
+            }
+
+        return bytes;
+    }
+
+    /*******************************************************************************
+     * lock
+     *
+     * @brief take the segment's spin lock, yielding while another process
+     * or thread holds it
+     *******************************************************************************/
+    inline void detail::Segment_Header::lock() noexcept
+    {
+        while (spin.exchange(1, std::memory_order_acquire))
+            while (spin.load(std::memory_order_relaxed))
+                std::this_thread::yield();
+    }
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    SHARED SEGMENT METHODS  ---------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * create
+     *
+     * @brief create an anonymous segment of bytes bytes (a memfd on Linux),
+     * shared with other processes through fd()
+     *
+     * @throw std::invalid_argument if bytes cannot hold the segment header
+     * @throw std::system_error if the segment cannot be created or mapped
+     *******************************************************************************/
+    inline SharedSegment SharedSegment::create(std::size_t bytes)
+    {
+        if (bytes < detail::segment_data_start)
+            throw std::invalid_argument("SharedSegment: size smaller than the segment header");
+
+#if defined(__linux__)
+        int fd = ::memfd_create("custom-shared-segment", MFD_CLOEXEC);
+#else
+        // no memfd: a uniquely named object, unlinked at once
+        std::string name = "/custom-shared-segment-" + std::to_string(::getpid()) + "-" +
+                           std::to_string(reinterpret_cast<std::uintptr_t>(&bytes));
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0)
+            ::shm_unlink(name.c_str());
+#endif
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "SharedSegment: cannot create segment");
+
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+        {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "SharedSegment: cannot size segment");
+        }
+
+        return SharedSegment(fd, bytes, true);
+    }
+
+    /*******************************************************************************
+     * create
+     *
+     * @brief create the named POSIX shared memory object name ("/name") of
+     * bytes bytes
+     *
+     * @throw std::system_error if it exists already or cannot be created
+     *******************************************************************************/
+    inline SharedSegment SharedSegment::create(const std::string &name, std::size_t bytes)
+    {
+        if (bytes < detail::segment_data_start)
+            throw std::invalid_argument("SharedSegment: size smaller than the segment header");
+
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "SharedSegment: cannot create " + name);
+
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+        {
+            int error = errno;
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw std::system_error(error, std::generic_category(), "SharedSegment: cannot size " + name);
+        }
+
+        return SharedSegment(fd, bytes, true);
+    }
+
+    /*******************************************************************************
+     * open
+     *
+     * @brief map the existing named segment name
+     *
+     * @throw std::system_error if it cannot be opened or mapped
+     * @throw std::invalid_argument if it is not a segment created by create
+     *******************************************************************************/
+    inline SharedSegment SharedSegment::open(const std::string &name)
+    {
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "SharedSegment: cannot open " + name);
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "SharedSegment: cannot stat " + name);
+        }
+
+        return SharedSegment(fd, static_cast<std::size_t>(info.st_size), false);
+    }
+
+    /*******************************************************************************
+     * attach
+     *
+     * @brief map the segment behind fd (a duplicate is kept, the caller
+     * still owns fd)
+     *
+     * @throw std::system_error if fd cannot be duplicated or mapped
+     * @throw std::invalid_argument if it is not a segment created by create
+     *******************************************************************************/
+    inline SharedSegment SharedSegment::attach(int fd)
+    {
+        int own = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if (own < 0)
+            throw std::system_error(errno, std::generic_category(), "SharedSegment: cannot duplicate descriptor");
+
+        struct stat info;
+        if (::fstat(own, &info) != 0)
+        {
+            int error = errno;
+            ::close(own);
+            throw std::system_error(error, std::generic_category(), "SharedSegment: cannot stat descriptor");
+        }
+
+        return SharedSegment(own, static_cast<std::size_t>(info.st_size), false);
+    }
+
+    /*******************************************************************************
+     * constructor
+     *
+     * @brief map fd (which this object then owns) and either initialize the
+     * header or check it
+     *******************************************************************************/
+    inline SharedSegment::SharedSegment(int fd, std::size_t bytes, bool initialize)
+        : m_fd{fd}, m_size{bytes}
+    {
+        void *base = MAP_FAILED;
+        if (bytes >= detail::segment_data_start)
+            base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (base == MAP_FAILED)
+        {
+            int error = bytes >= detail::segment_data_start ? errno : EINVAL;
+            ::close(fd);
+            if (error == EINVAL)
+                throw std::invalid_argument("SharedSegment: not a shared segment");
+            throw std::system_error(error, std::generic_category(), "SharedSegment: cannot map segment");
+        }
+
+        m_header = static_cast<detail::Segment_Header *>(base);
+        if (initialize)
+            ::new (base) detail::Segment_Header(bytes);
+        else if (!m_header->valid(bytes))
+        {
+            ::munmap(base, bytes);
+            ::close(fd);
+            throw std::invalid_argument("SharedSegment: not a shared segment");
+        }
+    }
+
+    /*******************************************************************************
+     * destructor
+     *
+     * @brief unmap the segment and close the descriptor; objects in the
+     * segment are left for the other processes
+     *******************************************************************************/
+    inline SharedSegment::~SharedSegment()
+    {
+        if (m_header)
+            ::munmap(m_header, m_size);
+        if (m_fd >= 0)
+            ::close(m_fd);
+    }
+
+    /*******************************************************************************
+     * find_or_construct
+     *
+     * @brief the object named name, constructed from args if there is none
+     *
+     * Construction happens outside the segment lock (it may allocate);
+     * if another process registers the name meanwhile, the new object is
+     * destroyed and theirs returned.
+     *
+     * @throw std::invalid_argument if name is empty or too long, or names
+     * an object of another size
+     * @throw std::length_error if the directory is full
+     *******************************************************************************/
+    template <class Obj, class... Args>
+    Obj &SharedSegment::find_or_construct(std::string_view name, Args &&...args)
+    {
+        if (Obj *existing = find<Obj>(name))
+            return *existing;
+
+        SharedAllocator<Obj> alloc(m_header);
+        Obj *obj = alloc.allocate(1);
+        try
+        {
+            ::new (static_cast<void *>(obj)) Obj(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            alloc.deallocate(obj, 1);
+            throw;
+        }
+
+        Obj *winner = nullptr;
+        {
+            detail::Segment_Lock guard(*m_header);
+            if (detail::Segment_Header::Directory_Entry *entry = m_header->find(name))
+                winner = reinterpret_cast<Obj *>(m_header->base() + entry->offset);
+            else
+            {
+                detail::Segment_Header::Directory_Entry *slot = nullptr;
+                for (detail::Segment_Header::Directory_Entry &entry : m_header->directory)
+                    if (!entry.offset)
+                    {
+                        slot = &entry;
+                        break;
+                    }
+
+                if (slot)
+                {
+                    std::memcpy(slot->name, name.data(), name.size());
+                    slot->name[name.size()] = '\0';
+                    slot->bytes = sizeof(Obj);
+                    slot->offset = reinterpret_cast<char *>(obj) - m_header->base();
+                    return *obj;
+                }
+            }
+        }
+
+        obj->~Obj();
+        alloc.deallocate(obj, 1);
+
+        if (!winner)
+            throw std::length_error("SharedSegment: object directory full");
+        return *winner;
+    }
+
+    /*******************************************************************************
+     * find
+     *
+     * @return the object named name in this mapping, or nullptr
+     * @throw std::invalid_argument if name is invalid or names an object of
+     * another size
+     *******************************************************************************/
+    template <class Obj>
+    Obj *SharedSegment::find(std::string_view name) const
+    {
+        check_name(name);
+        detail::Segment_Lock guard(*m_header);
+
+        detail::Segment_Header::Directory_Entry *entry = m_header->find(name);
+        if (!entry)
+            return nullptr;
+        if (entry->bytes != sizeof(Obj))
+            throw std::invalid_argument("SharedSegment: object has another type");
+
+        return reinterpret_cast<Obj *>(m_header->base() + entry->offset);
+    }
+
+    /*******************************************************************************
+     * destroy
+     *
+     * @brief remove the object named name, destroy it and free its block;
+     * no other process may still be using it
+     *
+     * @return false if there was no such object
+     *******************************************************************************/
+    template <class Obj>
+    bool SharedSegment::destroy(std::string_view name)
+    {
+        Obj *obj = find<Obj>(name);
+        if (!obj)
+            return false;
+
+        {
+            detail::Segment_Lock guard(*m_header);
+            if (detail::Segment_Header::Directory_Entry *entry = m_header->find(name))
+                entry->offset = 0;
+        }
+
+        obj->~Obj();
+        SharedAllocator<Obj>(m_header).deallocate(obj, 1);
+
+        return true;
+    }
+
+    /*******************************************************************************
+     * check_name
+     *
+     * @throw std::invalid_argument if name is empty or longer than max_name
+     *******************************************************************************/
+    inline void SharedSegment::check_name(std::string_view name)
+    {
+        if (name.empty() || name.size() > detail::Segment_Header::max_name)
+            throw std::invalid_argument("SharedSegment: object names are 1 to 47 characters");
+    }
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    SHARED VECTOR METHODS  ----------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * Write_Guard
+     *
+     * @brief make the sequence odd while the writer changes the vector, and
+     * even again (publishing the changes) when done
+     *******************************************************************************/
+    template <class T>
+    SharedVector<T>::Write_Guard::Write_Guard(std::atomic<std::uint64_t> &sequence) noexcept
+        : m_sequence{nullptr}
+    {
+        std::uint64_t seq = sequence.load(std::memory_order_relaxed);
+        if (seq & 1)
+            return;
+
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_sequence = &sequence;
+    }
+
+    template <class T>
+    SharedVector<T>::Write_Guard::~Write_Guard()
+    {
+        if (m_sequence)
+            m_sequence->store(m_sequence->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /*******************************************************************************
+     * constructor
+     *
+     * @param alloc allocator of the segment holding the elements (a
+     * SharedSegment converts to one)
+     *******************************************************************************/
+    template <class T>
+    SharedVector<T>::SharedVector(const SharedAllocator<T> &alloc)
+        : mem_manager{alloc.segment_header()}
+    {
+    }
+
+    /*******************************************************************************
+     * destructor
+     *
+     * @brief give the block back to the segment
+     *******************************************************************************/
+    template <class T>
+    SharedVector<T>::~SharedVector()
+    {
+        if (capacity())
+            get_allocator().deallocate(data(), capacity());
+    }
+
+    /*******************************************************************************
+     * at
+     *
+     * @throw std::out_of_range if idx is not below size()
+     *******************************************************************************/
+    template <class T>
+    T &SharedVector<T>::at(size_type idx)
+    {
+        if (idx >= size())
+            throw std::out_of_range("SharedVector: index out of range");
+
+        return data()[idx];
+    }
+
+    template <class T>
+    const T &SharedVector<T>::at(size_type idx) const
+    {
+        if (idx >= size())
+            throw std::out_of_range("SharedVector: index out of range");
+
+        return data()[idx];
+    }
+
+    /*******************************************************************************
+     * push_back / emplace_back
+     *
+     * @brief append one element, doubling the capacity when full
+     *******************************************************************************/
+    template <class T>
+    void SharedVector<T>::push_back(const T &val)
+    {
+        emplace_back(val);
+    }
+
+    template <class T>
+    template <class... Args>
+    T &SharedVector<T>::emplace_back(Args &&...args)
+    {
+        // built before growing, so an argument referring into the vector stays valid
+        T val(std::forward<Args>(args)...);
+
+        if (finish() == end_of_storage())
+            grow_for(1);
+
+        size_type n = size();
+        T *slot = data() + n;
+        std::memcpy(static_cast<void *>(slot), &val, sizeof(T));
+        set_size(n + 1);
+
+        return *slot;
+    }
+
+    /*******************************************************************************
+     * append_range
+     *
+     * @brief append every element of rg, copying contiguous ranges of T with
+     * one memcpy
+     *******************************************************************************/
+    template <class T>
+    template <std::ranges::input_range R>
+    void SharedVector<T>::append_range(R &&rg)
+    {
+        if constexpr (std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+                      std::is_same_v<std::ranges::range_value_t<R>, T>)
+        {
+            size_type count = std::ranges::size(rg);
+            if (count == 0)
+                return;
+
+            const T *src = std::ranges::data(rg);
+            const T *old = data();
+            bool aliased = src >= old && src < old + size();
+            size_type src_index = src - old;
+
+            grow_for(count);
+            if (aliased)
+                src = data() + src_index;
+
+            size_type n = size();
+            std::memcpy(static_cast<void *>(data() + n), src, count * sizeof(T));
+            set_size(n + count);
+        }
+        else
+        {
+            for (auto &&val : rg)
+                emplace_back(std::forward<decltype(val)>(val));
+        }
+    }
+
+    /*******************************************************************************
+     * pop_back
+     *
+     * @throw std::out_of_range if the vector is empty
+     *******************************************************************************/
+    template <class T>
+    void SharedVector<T>::pop_back()
+    {
+        if (empty())
+            throw std::out_of_range("SharedVector: pop_back on empty vector");
+
+        set_size(size() - 1);
+    }
+
+    /*******************************************************************************
+     * resize
+     *
+     * @brief resize to new_size, value-initializing (or setting to val) new
+     * elements
+     *******************************************************************************/
+    template <class T>
+    void SharedVector<T>::resize(size_type new_size)
+    {
+        resize(new_size, T());
+    }
+
+    template <class T>
+    void SharedVector<T>::resize(size_type new_size, const T &val)
+    {
+        size_type n = size();
+        if (new_size > n)
+        {
+            T copy = val;
+            reserve(new_size);
+            std::uninitialized_fill(data() + n, data() + new_size, copy);
+        }
+
+        set_size(new_size);
+    }
+
+    /*******************************************************************************
+     * reserve
+     *
+     * @brief make room for size_to_reserve elements
+     * @throw std::bad_alloc if the segment has no room left
+     *******************************************************************************/
+    template <class T>
+    void SharedVector<T>::reserve(size_type size_to_reserve)
+    {
+        if (size_to_reserve > capacity())
+            reallocate(size_to_reserve);
+    }
+
+    /*******************************************************************************
+     * shrink_to_fit
+     *
+     * @brief move the elements to a block of exactly size() elements
+     *******************************************************************************/
+    template <class T>
+    void SharedVector<T>::shrink_to_fit()
+    {
+        if (size() != capacity())
+            reallocate(size());
+    }
+
+    /*******************************************************************************
+     * read
+     *
+     * @brief fn(std::span<const T>) on a consistent view of the published
+     * vector, retried while a write section overlaps it
+     *
+     * @return what fn returns
+     *******************************************************************************/
+    template <class T>
+    template <class Fn>
+    auto SharedVector<T>::read(Fn fn) const
+    {
+        const std::atomic<std::uint64_t> &sequence = mem_manager.sequence;
+        std::uint64_t segment_size = mem_manager.segment->size;
+
+        for (;;)
+        {
+            std::uint64_t seq = sequence.load(std::memory_order_acquire);
+            if (seq & 1)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::uint64_t first = start();
+            std::uint64_t last = finish();
+
+            // a torn pair is discarded below, but must not send fn off the mapping
+            if (first <= last && last <= segment_size && (last - first) % sizeof(T) == 0)
+            {
+                std::span<const T> view(mem_manager.pointer(first), (last - first) / sizeof(T));
+
+                if constexpr (std::is_void_v<std::invoke_result_t<Fn &, std::span<const T>>>)
+                {
+                    fn(view);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (sequence.load(std::memory_order_relaxed) == seq)
+                        return;
+                }
+                else
+                {
+                    auto result = fn(view);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (sequence.load(std::memory_order_relaxed) == seq)
+                        return result;
+                }
+            }
+        }
+    }
+
+    /*******************************************************************************
+     * grow_for
+     *
+     * @brief make room for extra more elements, at least doubling the capacity
+     *******************************************************************************/
+    template <class T>
+    void SharedVector<T>::grow_for(size_type extra)
+    {
+        size_type needed = size() + extra;
+        if (needed > capacity())
+            reallocate(std::max(needed, capacity() * 2));
+    }
+
+    /*******************************************************************************
+     * reallocate
+     *
+     * @brief copy the elements to a new block of new_capacity elements and
+     * return the old one to the segment
+     *
+     * The old block goes back on the segment's free list, still mapped, so
+     * a reader overlapping this (and about to retry) cannot fault on it.
+     *******************************************************************************/
+    template <class T>
+    void SharedVector<T>::reallocate(size_type new_capacity)
+    {
+        SharedAllocator<T> alloc = get_allocator();
+        size_type n = size();
+        size_type old_capacity = capacity();
+        T *old_block = data();
+
+        T *block = new_capacity ? alloc.allocate(new_capacity) : nullptr;
+        if (n)
+            std::memcpy(static_cast<void *>(block), old_block, n * sizeof(T));
+
+        std::uint64_t offset = block ? reinterpret_cast<char *>(block) - mem_manager.segment->base() : 0;
+        mem_manager.block_start.store(offset, std::memory_order_relaxed);
+        mem_manager.uninitialized_block_start.store(offset + n * sizeof(T), std::memory_order_relaxed);
+        mem_manager.block_end.store(offset + new_capacity * sizeof(T), std::memory_order_relaxed);
+
+        if (old_capacity)
+            alloc.deallocate(old_block, old_capacity);
+    }
+}
+
+#endif // SHARED_VECTOR_H
@@ -0,0 +1,324 @@
+/*******************************************************************************
+ *  @file SlotMap.h
+ *  @brief This file contains methods that define and implement a container
+ *  of densely stored elements addressed by generation-checked handles
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "CustomVector.h"
+
+namespace custom
+{
+    /*******************************************************************************
+     * struct SlotMapKey
+     *
+     *  @brief Handle to a SlotMap element: a slot index and the generation the
+     *  slot had when the element was inserted
+     *
+     *  Erasing an element advances its slot's generation, so every key to it
+     *  goes stale instead of silently referring to whatever reuses the slot.
+     *  value() / from_value() pack the key into 64 bits for storage elsewhere.
+     *******************************************************************************/
+    struct SlotMapKey
+    {
+        std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+        std::uint32_t generation = 0;
+
+        constexpr std::uint64_t value() const noexcept { return std::uint64_t{generation} << 32 | index; }
+        static constexpr SlotMapKey from_value(std::uint64_t value) noexcept
+        {
+            return {static_cast<std::uint32_t>(value), static_cast<std::uint32_t>(value >> 32)};
+        }
+
+        friend constexpr bool operator==(const SlotMapKey &, const SlotMapKey &) = default;
+    };
+
+    /*******************************************************************************
+     * class SlotMap
+     *
+     *  @brief Elements stored densely in a Vector, reached through stable
+     *  SlotMapKeys via a sparse slot index and a free list of slots
+     *
+     *  insert takes a slot off the free list (or appends one) and the element
+     *  goes at the end of the dense Vector. erase moves the last element into
+     *  the hole and pops the back, so both are O(1) and nothing shifts; the
+     *  erased slot's generation advances and it returns to the free list.
+     *  Lookup is two array reads and a generation compare, and a stale or
+     *  foreign key is detected rather than aliasing a newer element.
+     *
+     *  Iteration runs over the dense Vector in no particular order, with
+     *  key_at(i) giving the key of the i-th element. Pointers, references
+     *  and iterators to elements are invalidated by insert and erase; keys
+     *  stay valid until their own element is erased.
+     *
+     *  A slot is occupied while its generation is odd. Generations wrap after
+     *  2^31 reuses of one slot.
+     *
+     *  @tparam T  Type of element, move assignable.
+     *  @tparam AllocType  Allocator type, default value is allocator<T>.
+     *
+     *******************************************************************************/
+    template <class T, typename AllocType = std::allocator<T>>
+    class SlotMap
+    {
+        struct Slot
+        {
+            std::uint32_t index; // dense index while occupied, next free slot otherwise
+            std::uint32_t generation;
+        };
+
+        using Slot_Alloc = typename std::allocator_traits<AllocType>::template rebind_alloc<Slot>;
+        using Index_Alloc = typename std::allocator_traits<AllocType>::template rebind_alloc<std::uint32_t>;
+
+    public:
+        using size_type = size_t;
+        using value_type = T;
+        using key_type = SlotMapKey;
+        using Iterator = typename Vector<T, AllocType>::Iterator;
+        using Const_Iterator = typename Vector<T, AllocType>::Const_Iterator;
+
+        static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+        SlotMap(const AllocType &alloc = AllocType());
+
+        // Element Access
+        T *get(key_type key) noexcept;
+        const T *get(key_type key) const noexcept;
+        T &at(key_type key);
+        const T &at(key_type key) const;
+        T &operator[](key_type key) noexcept { return m_values.data()[m_slots.data()[key.index].index]; }
+        const T &operator[](key_type key) const noexcept { return m_values.data()[m_slots.data()[key.index].index]; }
+        bool contains(key_type key) const noexcept { return get(key) != nullptr; }
+
+        // Dense Access
+        T *data() noexcept { return m_values.data(); }
+        const T *data() const noexcept { return m_values.data(); }
+        key_type key_at(size_type dense_idx) const;
+
+        // Modifiers
+        key_type insert(const T &val) { return emplace(val); }
+        key_type insert(T &&val) { return emplace(std::move(val)); }
+        template <class... Args>
+        key_type emplace(Args &&...args);
+        bool erase(key_type key);
+        void clear();
+
+        // Size and Capacity
+        void reserve(size_type n);
+        size_type size() const noexcept { return m_values.size(); }
+        bool empty() const noexcept { return m_values.empty(); }
+        size_type capacity() const noexcept { return m_values.capacity(); }
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        Iterator begin() noexcept { return m_values.begin(); }
+        Iterator end() noexcept { return m_values.end(); }
+        Const_Iterator begin() const noexcept { return m_values.begin(); }
+        Const_Iterator end() const noexcept { return m_values.end(); }
+
+    private:
+        Vector<T, AllocType> m_values;
+        Vector<std::uint32_t, Index_Alloc> m_dense_to_slot; // slot of each element, for erase and key_at
+        Vector<Slot, Slot_Alloc> m_slots;
+        std::uint32_t m_free_head = npos;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    SLOT MAP METHODS  ---------------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * default constructor
+     *
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, typename A>
+    SlotMap<T, A>::SlotMap(const A &alloc)
+        : m_values{alloc}, m_dense_to_slot{Index_Alloc(alloc)}, m_slots{Slot_Alloc(alloc)}
+    {
+    }
+
+    /*******************************************************************************
+     * get
+     *
+     * @return pointer to the element of key, nullptr if it was erased or the
+     * key never came from this map
+     *******************************************************************************/
+    template <class T, typename A>
+    T *SlotMap<T, A>::get(key_type key) noexcept
+    {
+        return const_cast<T *>(std::as_const(*this).get(key));
+    }
+
+    template <class T, typename A>
+    const T *SlotMap<T, A>::get(key_type key) const noexcept
+    {
+        if (key.index >= m_slots.size())
+            return nullptr;
+
+        const Slot &slot = m_slots.data()[key.index];
+        return slot.generation == key.generation && (key.generation & 1) ? m_values.data() + slot.index : nullptr;
+    }
+
+    /*******************************************************************************
+     * at
+     *
+     * @brief checked access to the element of key
+     *
+     * @throw std::out_of_range if the key is stale or foreign
+     *******************************************************************************/
+    template <class T, typename A>
+    T &SlotMap<T, A>::at(key_type key)
+    {
+        return const_cast<T &>(std::as_const(*this).at(key));
+    }
+
+    template <class T, typename A>
+    const T &SlotMap<T, A>::at(key_type key) const
+    {
+        const T *val = get(key);
+        if (!val)
+            throw std::out_of_range("SlotMap: stale or invalid key");
+
+        return *val;
+    }
+
+    /*******************************************************************************
+     * key_at
+     *
+     * @brief key of the element at position dense_idx of the dense order
+     *******************************************************************************/
+    template <class T, typename A>
+    typename SlotMap<T, A>::key_type SlotMap<T, A>::key_at(size_type dense_idx) const
+    {
+        std::uint32_t slot = m_dense_to_slot.at(dense_idx);
+        return {slot, m_slots.data()[slot].generation};
+    }
+
+    /*******************************************************************************
+     * emplace
+     *
+     * @brief construct an element from args at the end of the dense Vector
+     *
+     * Each step leaves the map consistent if a later one throws: a new slot
+     * only joins the free list, and a failed construction pops the index
+     * pushed for it.
+     *
+     * @return key of the new element
+     * @throw std::length_error if every 32-bit slot index is in use
+     *******************************************************************************/
+    template <class T, typename A>
+    template <class... Args>
+    typename SlotMap<T, A>::key_type SlotMap<T, A>::emplace(Args &&...args)
+    {
+        if (m_free_head == npos)
+        {
+            if (m_slots.size() == npos)
+                throw std::length_error("SlotMap: out of slot indices");
+
+            m_slots.push_back(Slot{npos, 0});
+            m_free_head = static_cast<std::uint32_t>(m_slots.size() - 1);
+        }
+
+        m_dense_to_slot.push_back(m_free_head);
+        try
+        {
+            m_values.emplace_back(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            m_dense_to_slot.pop_back();
+            throw;
+        }
+
+        std::uint32_t idx = m_free_head;
+        Slot &slot = m_slots.data()[idx];
+        m_free_head = slot.index;
+        slot.index = static_cast<std::uint32_t>(m_values.size() - 1);
+        ++slot.generation;
+
+        return {idx, slot.generation};
+    }
+
+    /*******************************************************************************
+     * erase
+     *
+     * @brief remove the element of key, moving the last element into its place
+     *
+     * @return false if key was stale or foreign and nothing was erased
+     *******************************************************************************/
+    template <class T, typename A>
+    bool SlotMap<T, A>::erase(key_type key)
+    {
+        if (!get(key))
+            return false;
+
+        Slot &slot = m_slots.data()[key.index];
+        std::uint32_t hole = slot.index;
+        std::uint32_t last = static_cast<std::uint32_t>(m_values.size() - 1);
+
+        if (hole != last)
+        {
+            m_values.data()[hole] = std::move(m_values.data()[last]);
+            std::uint32_t moved = m_dense_to_slot.data()[last];
+            m_dense_to_slot.data()[hole] = moved;
+            m_slots.data()[moved].index = hole;
+        }
+        m_values.pop_back();
+        m_dense_to_slot.pop_back();
+
+        ++slot.generation;
+        slot.index = m_free_head;
+        m_free_head = key.index;
+
+        return true;
+    }
+
+    /*******************************************************************************
+     * clear
+     *
+     * @brief erase every element, invalidating all keys and keeping the slots
+     *******************************************************************************/
+    template <class T, typename A>
+    void SlotMap<T, A>::clear()
+    {
+        for (size_type i = 0; i < m_dense_to_slot.size(); ++i)
+        {
+            std::uint32_t idx = m_dense_to_slot.data()[i];
+            Slot &slot = m_slots.data()[idx];
+            ++slot.generation;
+            slot.index = m_free_head;
+            m_free_head = idx;
+        }
+
+        m_values.clear();
+        m_dense_to_slot.clear();
+    }
+
+    /*******************************************************************************
+     * reserve
+     *
+     * @brief make room for n elements without reallocating
+     *******************************************************************************/
+    template <class T, typename A>
+    void SlotMap<T, A>::reserve(size_type n)
+    {
+        m_values.reserve(n);
+        m_dense_to_slot.reserve(n);
+        m_slots.reserve(n);
+    }
+}
+
+#endif // SLOT_MAP_H
@@ -0,0 +1,548 @@
+/*******************************************************************************
+ *  @file SnapshotVector.h
+ *  @brief This file contains methods that define and implement a copy-on-write
+ *  vector for read-mostly data shared between threads
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef SNAPSHOT_VECTOR_H
+#define SNAPSHOT_VECTOR_H 1
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "CustomVector.h"
+
+namespace custom
+{
+    template <class T, typename AllocType>
+    class SnapshotPublisher;
+
+    /*******************************************************************************
+     * class SnapshotVector
+     *
+     *  @brief An immutable, reference counted vector with copy-on-write updates
+     *
+     *  All copies of a SnapshotVector share one buffer, so copying is O(1): a
+     *  single relaxed increment of an atomic reference count. Read access never
+     *  locks. Mutating members first make the buffer unique (copying it only if
+     *  another SnapshotVector still refers to it), so a change is never visible
+     *  through any other copy.
+     *
+     *  For bulk edits, fill a Vector and move it into a SnapshotVector; no copy
+     *  is made. SnapshotPublisher hands snapshots to reader threads.
+     *
+     *  @tparam T  Type of element.
+     *  @tparam AllocType  Allocator type, default value is allocator<T>.
+     *
+     *******************************************************************************/
+    template <class T, typename AllocType = std::allocator<T>>
+    class SnapshotVector
+    {
+    public:
+        using size_type = size_t;
+        using value_type = T;
+        using const_iterator = const T *;
+        using iterator = const_iterator;
+
+        SnapshotVector() noexcept = default;
+        SnapshotVector(Vector<T, AllocType> &&items);
+        SnapshotVector(std::initializer_list<T> ilist, const AllocType &alloc = AllocType());
+
+        SnapshotVector(const SnapshotVector &other) noexcept;
+        SnapshotVector(SnapshotVector &&other) noexcept;
+
+        SnapshotVector &operator=(const SnapshotVector &other) noexcept;
+        SnapshotVector &operator=(SnapshotVector &&other) noexcept;
+
+        ~SnapshotVector() { release(m_block); }
+
+        // Element Access (read only)
+        const T &at(size_type idx) const;
+        const T &operator[](size_type idx) const { return m_block->items.data()[idx]; }
+        const T *data() const noexcept { return m_block ? m_block->items.data() : nullptr; }
+
+        // Size
+        size_type size() const noexcept { return m_block ? m_block->items.size() : 0; }
+        bool empty() const noexcept { return size() == 0; }
+
+        // Number of SnapshotVectors sharing this buffer
+        size_type use_count() const noexcept;
+
+        // Modifiers (copy-on-write)
+        void set(size_type idx, const T &val);
+        void push_back(const T &val);
+        Vector<T, AllocType> &edit();
+
+        friend void swap(SnapshotVector &a, SnapshotVector &b) noexcept
+        {
+            std::swap(a.m_block, b.m_block);
+        }
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        const_iterator begin() const noexcept { return data(); }
+        const_iterator cbegin() const noexcept { return data(); }
+        const_iterator end() const noexcept { return data() + size(); }
+        const_iterator cend() const noexcept { return data() + size(); }
+
+    private:
+        friend class SnapshotPublisher<T, AllocType>;
+
+        struct Snapshot_Block
+        {
+            explicit Snapshot_Block(Vector<T, AllocType> &&vec) : items(std::move(vec)) {}
+
+            std::atomic<size_type> refs{1};
+            Vector<T, AllocType> items;
+        };
+
+        using block_alloc_type = typename std::allocator_traits<AllocType>::template rebind_alloc<Snapshot_Block>;
+        using block_traits = std::allocator_traits<block_alloc_type>;
+
+        explicit SnapshotVector(Snapshot_Block *block) noexcept : m_block(block) {}
+
+        static Snapshot_Block *make_block(Vector<T, AllocType> &&items);
+        static void acquire(Snapshot_Block *block) noexcept;
+        static void release(Snapshot_Block *block) noexcept;
+
+        void make_unique();
+
+        Snapshot_Block *m_block = nullptr;
+    };
+
+    /*******************************************************************************
+     * class SnapshotPublisher
+     *
+     *  @brief Publishes SnapshotVectors from a writer to many reader threads
+     *
+     *  The current block pointer and a 16-bit count of readers in the middle of
+     *  load() share one 64-bit atomic word (split reference counting). load()
+     *  pins the block with a fetch_add, takes a reference on the block and then
+     *  hands the pin back with a compare-exchange on the word. It never blocks
+     *  and never copies elements, but it is lock-free rather than wait-free:
+     *  every load writes to the shared word and to the block's count, so heavy
+     *  read traffic contends on those cache lines and the hand-back may retry.
+     *  publish() swaps in the new block and transfers any in-flight pins onto
+     *  the old one before dropping its reference, so a block is freed only once
+     *  the last reader's snapshot is gone.
+     *
+     *  At most max_loading readers are admitted to load() at once; a reader
+     *  whose pin pushes the count past that hands it back and retries, so the
+     *  count only reaches its spare top bit when more than max_loading threads
+     *  are in load() together and cannot carry into the pointer bits below
+     *  2 * max_loading threads.
+     *
+     *  publish() may be called concurrently with load(). Concurrent publishers
+     *  are safe but the last one wins, so writers normally build a new Vector
+     *  (or edit() a loaded snapshot) and publish from a single thread.
+     *
+     *  @tparam T  Type of element.
+     *  @tparam AllocType  Allocator type, default value is allocator<T>.
+     *
+     *******************************************************************************/
+    template <class T, typename AllocType = std::allocator<T>>
+    class SnapshotPublisher
+    {
+    public:
+        using snapshot_type = SnapshotVector<T, AllocType>;
+
+        SnapshotPublisher(const AllocType &alloc = AllocType());
+        explicit SnapshotPublisher(snapshot_type initial);
+
+        // the published word cannot be copied
+        SnapshotPublisher(const SnapshotPublisher &) = delete;
+        SnapshotPublisher &operator=(const SnapshotPublisher &) = delete;
+
+        ~SnapshotPublisher();
+
+        snapshot_type load() const;
+        void publish(snapshot_type next);
+        void publish(Vector<T, AllocType> &&items) { publish(snapshot_type(std::move(items))); }
+
+    private:
+        using block_type = typename snapshot_type::Snapshot_Block;
+
+        static constexpr int count_bits = 16;
+        static constexpr std::uint64_t count_mask = (std::uint64_t{1} << count_bits) - 1;
+
+    public:
+        static constexpr std::uint64_t max_loading = std::uint64_t{1} << (count_bits - 1);
+
+    private:
+        static std::uint64_t pack(block_type *block);
+        static block_type *unpack(std::uint64_t word) noexcept
+        {
+            return reinterpret_cast<block_type *>(static_cast<std::uintptr_t>(word >> count_bits));
+        }
+
+        void unpin(block_type *block, std::uint64_t word) const noexcept;
+
+        mutable std::atomic<std::uint64_t> m_word;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    SNAPSHOT VECTOR METHODS  --------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * @brief Vector constructor
+     *
+     * Takes ownership of the elements of items without copying them.
+     *
+     * @param items vector to publish
+     *******************************************************************************/
+    template <class T, typename A>
+    SnapshotVector<T, A>::SnapshotVector(Vector<T, A> &&items)
+        : m_block{make_block(std::move(items))}
+    {
+    }
+
+    /*******************************************************************************
+     * @brief initializer_list constructor
+     *
+     * @param ilist list of type T objects
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, typename A>
+    SnapshotVector<T, A>::SnapshotVector(std::initializer_list<T> ilist, const A &alloc)
+        : m_block{make_block(Vector<T, A>(ilist, alloc))}
+    {
+    }
+
+    /*******************************************************************************
+     * copy constructor
+     *
+     * @brief shares the buffer of other, O(1)
+     *******************************************************************************/
+    template <class T, typename A>
+    SnapshotVector<T, A>::SnapshotVector(const SnapshotVector &other) noexcept
+        : m_block{other.m_block}
+    {
+        acquire(m_block);
+    }
+
+    /*******************************************************************************
+     * @brief move constructor
+     *******************************************************************************/
+    template <class T, typename A>
+    SnapshotVector<T, A>::SnapshotVector(SnapshotVector &&other) noexcept
+        : m_block{std::exchange(other.m_block, nullptr)}
+    {
+    }
+
+    /*******************************************************************************
+     * copy assignment operator
+     *
+     * @return SnapshotVector reference
+     *******************************************************************************/
+    template <class T, typename A>
+    SnapshotVector<T, A> &SnapshotVector<T, A>::operator=(const SnapshotVector &other) noexcept
+    {
+        SnapshotVector temp(other);
+        swap(*this, temp);
+
+        return *this;
+    }
+
+    /*******************************************************************************
+     * @brief move assignment operator
+     *
+     * @return SnapshotVector reference
+     *******************************************************************************/
+    template <class T, typename A>
+    SnapshotVector<T, A> &SnapshotVector<T, A>::operator=(SnapshotVector &&other) noexcept
+    {
+        SnapshotVector temp(std::move(other));
+        swap(*this, temp);
+
+        return *this;
+    }
+
+    /*******************************************************************************
+     * at
+     *
+     * @return const reference to the element at idx
+     *******************************************************************************/
+    template <class T, typename A>
+    const T &SnapshotVector<T, A>::at(size_type idx) const
+    {
+        if (idx >= size())
+            throw std::out_of_range("Invalid index");
+
+        return data()[idx];
+    }
+
+    /*******************************************************************************
+     * use_count
+     *
+     * @return number of SnapshotVectors (and publishers) sharing the buffer
+     *******************************************************************************/
+    template <class T, typename A>
+    typename SnapshotVector<T, A>::size_type SnapshotVector<T, A>::use_count() const noexcept
+    {
+        return m_block ? m_block->refs.load(std::memory_order_relaxed) : 0;
+    }
+
+    /*******************************************************************************
+     * set
+     *
+     * @brief replace the element at idx, copying the buffer if it is shared
+     *******************************************************************************/
+    template <class T, typename A>
+    void SnapshotVector<T, A>::set(size_type idx, const T &val)
+    {
+        if (idx >= size())
+            throw std::out_of_range("Invalid index");
+
+        make_unique();
+        m_block->items[idx] = val;
+    }
+
+    /*******************************************************************************
+     * push_back
+     *
+     * @brief append val, copying the buffer if it is shared
+     *******************************************************************************/
+    template <class T, typename A>
+    void SnapshotVector<T, A>::push_back(const T &val)
+    {
+        make_unique();
+        m_block->items.push_back(val);
+    }
+
+    /*******************************************************************************
+     * edit
+     *
+     * @brief make the buffer unique and return it for batched edits
+     *
+     * The returned reference is invalidated by any copy of this SnapshotVector,
+     * since the copy would then see the edits.
+     *
+     * @return reference to the underlying vector
+     *******************************************************************************/
+    template <class T, typename A>
+    Vector<T, A> &SnapshotVector<T, A>::edit()
+    {
+        make_unique();
+
+        return m_block->items;
+    }
+
+    /*******************************************************************************
+     * make_block
+     *
+     * @brief allocate a block holding items with a reference count of one
+     *
+     * The block comes from the allocator of items (rebound), so stateful
+     * allocators keep their state for the block too.
+     *******************************************************************************/
+    template <class T, typename A>
+    typename SnapshotVector<T, A>::Snapshot_Block *
+    SnapshotVector<T, A>::make_block(Vector<T, A> &&items)
+    {
+        block_alloc_type alloc(items.get_allocator());
+        Snapshot_Block *block = block_traits::allocate(alloc, 1);
+
+        return std::construct_at(block, std::move(items));
+    }
+
+    /*******************************************************************************
+     * acquire
+     *
+     * @brief add a reference to block
+     *******************************************************************************/
+    template <class T, typename A>
+    void SnapshotVector<T, A>::acquire(Snapshot_Block *block) noexcept
+    {
+        if (block)
+            block->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /*******************************************************************************
+     * release
+     *
+     * @brief drop a reference to block, freeing it when it was the last one
+     *******************************************************************************/
+    template <class T, typename A>
+    void SnapshotVector<T, A>::release(Snapshot_Block *block) noexcept
+    {
+        if (!block || block->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+
+        // copy the allocator out before the block (and its Vector) is destroyed
+        block_alloc_type alloc(block->items.get_allocator());
+        std::destroy_at(block);
+        block_traits::deallocate(alloc, block, 1);
+    }
+
+    /*******************************************************************************
+     * make_unique
+     *
+     * @brief ensure no other SnapshotVector shares the buffer
+     *******************************************************************************/
+    template <class T, typename A>
+    void SnapshotVector<T, A>::make_unique()
+    {
+        if (!m_block)
+        {
+            m_block = make_block(Vector<T, A>());
+            return;
+        }
+
+        if (m_block->refs.load(std::memory_order_acquire) == 1)
+            return;
+
+        Snapshot_Block *copy = make_block(Vector<T, A>(m_block->items));
+        release(std::exchange(m_block, copy));
+    }
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    SNAPSHOT PUBLISHER METHODS  -----------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * default constructor
+     *
+     * @brief publishes an empty snapshot
+     *******************************************************************************/
+    template <class T, typename A>
+    SnapshotPublisher<T, A>::SnapshotPublisher(const A &alloc)
+        : SnapshotPublisher(snapshot_type(Vector<T, A>(alloc)))
+    {
+    }
+
+    /*******************************************************************************
+     * @brief snapshot constructor
+     *
+     * @param initial first snapshot to publish
+     *******************************************************************************/
+    template <class T, typename A>
+    SnapshotPublisher<T, A>::SnapshotPublisher(snapshot_type initial)
+    {
+        // the publisher always owns a block so that load() never sees null
+        if (!initial.m_block)
+            initial.make_unique();
+
+        m_word.store(pack(initial.m_block), std::memory_order_release);
+        initial.m_block = nullptr;
+    }
+
+    /*******************************************************************************
+     * destructor
+     *
+     * @brief drops the publisher's reference to the current block
+     *******************************************************************************/
+    template <class T, typename A>
+    SnapshotPublisher<T, A>::~SnapshotPublisher()
+    {
+        snapshot_type::release(unpack(m_word.load(std::memory_order_acquire)));
+    }
+
+    /*******************************************************************************
+     * load
+     *
+     * @brief take a snapshot of the currently published vector
+     *
+     * The fetch_add pins the current block: a publisher that swaps it out
+     * transfers the pin into the block's reference count. After taking a
+     * proper reference the reader hands its pin back. A reader that finds
+     * more than max_loading pins on the word backs off without taking a
+     * reference, keeping the count clear of the pointer bits.
+     *
+     * @return snapshot sharing the published buffer
+     *******************************************************************************/
+    template <class T, typename A>
+    typename SnapshotPublisher<T, A>::snapshot_type SnapshotPublisher<T, A>::load() const
+    {
+        while (true)
+        {
+            std::uint64_t word = m_word.fetch_add(1, std::memory_order_acquire) + 1;
+            block_type *block = unpack(word);
+
+            if ((word & count_mask) > max_loading)
+            {
+                unpin(block, word);
+                std::this_thread::yield();
+                continue;
+            }
+
+            block->refs.fetch_add(1, std::memory_order_relaxed);
+            unpin(block, word);
+            return snapshot_type(block);
+        }
+    }
+
+    /*******************************************************************************
+     * unpin
+     *
+     * @brief hand back the pin taken by the fetch_add that returned word
+     *
+     * Decrements the word while it still holds block; once a publisher has
+     * swapped block out the pin was transferred into its reference count and
+     * that reference is dropped instead (pins are interchangeable, so one
+     * transferred pin is ours).
+     *
+     * @param block block pinned by the caller
+     * @param word value of the word just after the caller's fetch_add
+     *******************************************************************************/
+    template <class T, typename A>
+    void SnapshotPublisher<T, A>::unpin(block_type *block, std::uint64_t word) const noexcept
+    {
+        while (unpack(word) == block && (word & count_mask) != 0)
+        {
+            if (m_word.compare_exchange_weak(word, word - 1, std::memory_order_relaxed))
+                return;
+        }
+        snapshot_type::release(block);
+    }
+
+    /*******************************************************************************
+     * publish
+     *
+     * @brief make next the snapshot returned by subsequent load() calls
+     *
+     * @param next snapshot to publish, an empty one publishes an empty vector
+     *******************************************************************************/
+    template <class T, typename A>
+    void SnapshotPublisher<T, A>::publish(snapshot_type next)
+    {
+        if (!next.m_block)
+            next.make_unique();
+
+        std::uint64_t next_word = pack(next.m_block);
+        next.m_block = nullptr;
+
+        std::uint64_t old_word = m_word.exchange(next_word, std::memory_order_acq_rel);
+        block_type *old_block = unpack(old_word);
+
+        // readers still inside load() now hold references on the old block
+        old_block->refs.fetch_add(old_word & count_mask, std::memory_order_relaxed);
+        snapshot_type::release(old_block);
+    }
+
+    /*******************************************************************************
+     * pack
+     *
+     * @brief combine a block pointer with a zero reader count
+     *******************************************************************************/
+    template <class T, typename A>
+    std::uint64_t SnapshotPublisher<T, A>::pack(block_type *block)
+    {
+        auto bits = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(block));
+
+        if (bits >> (64 - count_bits))
+            throw std::runtime_error("SnapshotPublisher: pointer does not fit in 48 bits");
+
+        return bits << count_bits;
+    }
+}
+
+#endif // SNAPSHOT_VECTOR_H
@@ -0,0 +1,360 @@
+/*******************************************************************************
+ *  @file SortedVector.h
+ *  @brief This file contains methods that define and implement a sorted set
+ *  stored contiguously in a custom Vector
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef SORTED_VECTOR_H
+#define SORTED_VECTOR_H 1
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "CustomVector.h"
+
+namespace custom
+{
+    namespace detail
+    {
+        /*******************************************************************************
+         * branchless_partition_point
+         *
+         * @brief find the first element of [first, first + len) for which pred
+         * is false, assuming the range is partitioned by pred
+         *
+         * The loop halves the range every iteration whatever the comparison
+         * result, so the only data-dependent choice is a conditional move and
+         * there is no branch for the predictor to miss.
+         *
+         * @return pointer to the partition point
+         *******************************************************************************/
+        template <class T, class Pred>
+        T *branchless_partition_point(T *first, size_t len, Pred pred)
+        {
+            if (len == 0)
+                return first;
+
+            while (len > 1)
+            {
+                size_t half = len / 2;
+                first = pred(first[half]) ? first + half : first;
+                len -= half;
+            }
+
+            return first + pred(*first);
+        }
+
+        /*******************************************************************************
+         * sort_unique
+         *
+         * @brief sort batch and drop elements equivalent to an earlier one
+         *
+         * The sort is stable, so of several equivalent elements the first one
+         * in the original order is kept.
+         *******************************************************************************/
+        template <class T, class A, class Compare>
+        void sort_unique(Vector<T, A> &batch, Compare &comp)
+        {
+            T *first = batch.data();
+            T *last = first + batch.size();
+
+            std::stable_sort(first, last, comp);
+
+            T *new_last = std::unique(first, last, [&comp](const T &a, const T &b)
+                                      { return !comp(a, b) && !comp(b, a); });
+
+            for (size_t n = last - new_last; n > 0; --n)
+                batch.pop_back();
+        }
+
+        /*******************************************************************************
+         * merge_sorted_batch
+         *
+         * @brief merge a sorted, duplicate free batch into sorted items
+         *
+         * Elements of batch equivalent to an element already in items are
+         * dropped. The destination is sized once and every element is moved
+         * exactly once, instead of one O(n) Vector::insert per batch element.
+         *
+         * @return number of elements inserted
+         *******************************************************************************/
+        template <class T, class A, class Compare>
+        size_t merge_sorted_batch(Vector<T, A> &items, Vector<T, A> &batch, Compare &comp)
+        {
+            if (batch.empty())
+                return 0;
+
+            // common case: the whole batch sorts after the existing elements
+            if (items.empty() || comp(items.back(), batch.front()))
+            {
+                items.reserve(items.size() + batch.size());
+                for (T &val : batch)
+                    items.push_back(std::move(val));
+
+                return batch.size();
+            }
+
+            Vector<T, A> merged(items.get_allocator());
+            merged.reserve(items.size() + batch.size());
+
+            T *a = items.data();
+            T *a_end = a + items.size();
+            T *b = batch.data();
+            T *b_end = b + batch.size();
+            size_t inserted = 0;
+
+            while (a != a_end && b != b_end)
+            {
+                if (comp(*b, *a))
+                {
+                    merged.push_back(std::move(*b++));
+                    ++inserted;
+                }
+                else
+                {
+                    // on a tie the existing element wins
+                    if (!comp(*a, *b))
+                        ++b;
+                    merged.push_back(std::move(*a++));
+                }
+            }
+
+            for (; a != a_end; ++a)
+                merged.push_back(std::move(*a));
+
+            for (; b != b_end; ++b, ++inserted)
+                merged.push_back(std::move(*b));
+
+            swap(items, merged);
+
+            return inserted;
+        }
+    }
+
+    /*******************************************************************************
+     * class SortedVector
+     *
+     *  @brief A set of unique elements kept sorted in a contiguous Vector
+     *
+     *  Lookups are a branchless binary search over contiguous memory, which
+     *  for small and medium read-heavy sets beats the pointer chasing of a
+     *  node based std::set. Single inserts and erases shift the tail, so
+     *  bulk loads should go through insert_batch, which sorts the batch and
+     *  merges it in one pass.
+     *
+     *  Elements are only exposed as const, since modifying one in place could
+     *  break the ordering.
+     *
+     *  @tparam T  Type of element.
+     *  @tparam Compare  Strict weak ordering, default value is less<T>.
+     *  @tparam AllocType  Allocator type, default value is allocator<T>.
+     *
+     *******************************************************************************/
+    template <class T, class Compare = std::less<T>, typename AllocType = std::allocator<T>>
+    class SortedVector
+    {
+    public:
+        using size_type = size_t;
+        using value_type = T;
+        using key_compare = Compare;
+        using const_iterator = const T *;
+        using iterator = const_iterator;
+
+        SortedVector(const Compare &comp = Compare(), const AllocType &alloc = AllocType());
+        SortedVector(std::initializer_list<T> ilist, const Compare &comp = Compare(),
+                     const AllocType &alloc = AllocType());
+
+        // Lookup
+        template <class K>
+        const_iterator lower_bound(const K &key) const;
+        template <class K>
+        const_iterator upper_bound(const K &key) const;
+        template <class K>
+        const_iterator find(const K &key) const;
+        template <class K>
+        bool contains(const K &key) const { return find(key) != end(); }
+
+        // Element Access
+        const T &at(size_type idx) const { return m_items.at(idx); }
+        const T &operator[](size_type idx) const { return m_items.data()[idx]; }
+        const T *data() const noexcept { return m_items.data(); }
+        AllocType get_allocator() const noexcept { return m_items.get_allocator(); }
+
+        // Modifiers
+        std::pair<const_iterator, bool> insert(const T &val) { return insert(T(val)); }
+        std::pair<const_iterator, bool> insert(T &&val);
+        template <class InputIt>
+        size_type insert_batch(InputIt first, InputIt last);
+        size_type insert_batch(std::initializer_list<T> ilist) { return insert_batch(ilist.begin(), ilist.end()); }
+        template <class K>
+        size_type erase(const K &key);
+        void clear() { m_items.clear(); }
+
+        // Size and Capacity
+        void reserve(size_type n) { m_items.reserve(n); }
+        size_type size() const noexcept { return m_items.size(); }
+        size_type capacity() const noexcept { return m_items.capacity(); }
+        bool empty() const noexcept { return m_items.empty(); }
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        const_iterator begin() const noexcept { return data(); }
+        const_iterator cbegin() const noexcept { return data(); }
+        const_iterator end() const noexcept { return data() + size(); }
+        const_iterator cend() const noexcept { return data() + size(); }
+
+    private:
+        Vector<T, AllocType> m_items;
+        Compare m_comp;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    SORTED VECTOR METHODS  ----------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * default constructor
+     *
+     * @param comp comparison object
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, class C, typename A>
+    SortedVector<T, C, A>::SortedVector(const C &comp, const A &alloc)
+        : m_items{alloc}, m_comp{comp}
+    {
+    }
+
+    /*******************************************************************************
+     * @brief initializer_list constructor
+     *
+     * @param ilist list of type T objects, need not be sorted
+     * @param comp comparison object
+     * @param alloc allocator
+     *******************************************************************************/
+    template <class T, class C, typename A>
+    SortedVector<T, C, A>::SortedVector(std::initializer_list<T> ilist, const C &comp, const A &alloc)
+        : m_items{ilist, alloc}, m_comp{comp}
+    {
+        detail::sort_unique(m_items, m_comp);
+    }
+
+    /*******************************************************************************
+     * lower_bound
+     *
+     * @return iterator to the first element not less than key
+     *******************************************************************************/
+    template <class T, class C, typename A>
+    template <class K>
+    typename SortedVector<T, C, A>::const_iterator SortedVector<T, C, A>::lower_bound(const K &key) const
+    {
+        return detail::branchless_partition_point(data(), size(), [&](const T &val)
+                                                  { return m_comp(val, key); });
+    }
+
+    /*******************************************************************************
+     * upper_bound
+     *
+     * @return iterator to the first element greater than key
+     *******************************************************************************/
+    template <class T, class C, typename A>
+    template <class K>
+    typename SortedVector<T, C, A>::const_iterator SortedVector<T, C, A>::upper_bound(const K &key) const
+    {
+        return detail::branchless_partition_point(data(), size(), [&](const T &val)
+                                                  { return !m_comp(key, val); });
+    }
+
+    /*******************************************************************************
+     * find
+     *
+     * @return iterator to the element equivalent to key, or end()
+     *******************************************************************************/
+    template <class T, class C, typename A>
+    template <class K>
+    typename SortedVector<T, C, A>::const_iterator SortedVector<T, C, A>::find(const K &key) const
+    {
+        const_iterator pos = lower_bound(key);
+
+        if (pos != end() && !m_comp(key, *pos))
+            return pos;
+
+        return end();
+    }
+
+    /*******************************************************************************
+     * insert
+     *
+     * @brief insert val unless an equivalent element is already present
+     *
+     * @return iterator to the element equivalent to val, and whether val
+     *  was inserted
+     *******************************************************************************/
+    template <class T, class C, typename A>
+    std::pair<typename SortedVector<T, C, A>::const_iterator, bool> SortedVector<T, C, A>::insert(T &&val)
+    {
+        const_iterator pos = lower_bound(val);
+
+        if (pos != end() && !m_comp(val, *pos))
+            return {pos, false};
+
+        size_type idx = pos - begin();
+        m_items.insert(m_items.begin() + idx, std::move(val));
+
+        return {begin() + idx, true};
+    }
+
+    /*******************************************************************************
+     * insert_batch
+     *
+     * @brief insert every element of [first, last) in a single merge pass
+     *
+     * The batch is copied, sorted and de-duplicated, then merged with the
+     * existing elements. Cost is O(m log m + n) for a batch of m elements
+     * instead of O(m * n) for m single inserts.
+     *
+     * @return number of elements inserted
+     *******************************************************************************/
+    template <class T, class C, typename A>
+    template <class InputIt>
+    typename SortedVector<T, C, A>::size_type SortedVector<T, C, A>::insert_batch(InputIt first, InputIt last)
+    {
+        Vector<T, A> batch(m_items.get_allocator());
+        for (; first != last; ++first)
+            batch.push_back(*first);
+
+        detail::sort_unique(batch, m_comp);
+
+        return detail::merge_sorted_batch(m_items, batch, m_comp);
+    }
+
+    /*******************************************************************************
+     * erase
+     *
+     * @brief remove the element equivalent to key
+     *
+     * @return number of elements removed (0 or 1)
+     *******************************************************************************/
+    template <class T, class C, typename A>
+    template <class K>
+    typename SortedVector<T, C, A>::size_type SortedVector<T, C, A>::erase(const K &key)
+    {
+        const_iterator pos = find(key);
+
+        if (pos == end())
+            return 0;
+
+        m_items.erase(m_items.begin() + (pos - begin()));
+
+        return 1;
+    }
+}
+
+#endif // SORTED_VECTOR_H
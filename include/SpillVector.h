@@ -0,0 +1,579 @@
+/*******************************************************************************
+ *  @file SpillVector.h
+ *  @brief This file contains methods that define and implement a vector
+ *  that keeps a bounded number of chunks in memory and spills the rest to
+ *  a local file
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef SPILL_VECTOR_H
+#define SPILL_VECTOR_H 1
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "CustomVector.h"
+
+namespace custom
+{
+    /*******************************************************************************
+     * class SpillVector
+     *
+     *  @brief An append-only vector of trivially copyable elements whose
+     *  memory use is capped: it is split into fixed-size chunks, at most
+     *  resident_chunks() of which are in memory, and the least recently used
+     *  chunk is written to a spill file to make room for the next one
+     *
+     *  A job that outgrows RAM with a Vector gets OOM-killed; with a
+     *  SpillVector it slows down instead. Access goes through get/set (an
+     *  element reference could be evicted under its holder), whole chunks
+     *  at a time through for_each_chunk / transform_chunks, or the input
+     *  iterator. The chunk last touched is remembered, so sequential access
+     *  costs a compare per element, not an LRU update.
+     *
+     *  When chunks are faulted in in order, the next prefetch_chunks spilled
+     *  chunks are announced to the kernel with posix_fadvise(WILLNEED),
+     *  which reads them in the background while the current one is
+     *  processed.
+     *
+     *  The spill file is created in the given directory (default: the
+     *  system temporary directory) and unlinked at once, so it never
+     *  outlives the process. Chunks are only written when dirty. Not
+     *  thread-safe, even for reads.
+     *
+     *  @tparam T  Type of element, trivially copyable.
+     *  @tparam AllocType  Allocator for the resident chunks, default allocator<T>.
+     *
+     *******************************************************************************/
+    template <class T, typename AllocType = std::allocator<T>>
+    class SpillVector
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SpillVector: elements are written to disk as bytes");
+
+        static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+        struct Chunk
+        {
+            T *frame = nullptr;           // resident copy, nullptr when spilled or never touched
+            bool dirty = false;           // frame differs from the file
+            bool on_disk = false;         // the file holds a copy
+            std::uint32_t newer = npos;   // LRU list of resident chunks
+            std::uint32_t older = npos;
+        };
+
+        using Chunk_Alloc = typename std::allocator_traits<AllocType>::template rebind_alloc<Chunk>;
+        using Frame_Alloc = typename std::allocator_traits<AllocType>::template rebind_alloc<T *>;
+
+    public:
+        using size_type = size_t;
+        using value_type = T;
+
+        static constexpr size_type default_chunk_bytes = size_t{1} << 20;
+        static constexpr size_type prefetch_chunks = 4;
+
+        /*******************************************************************************
+         * class Const_Iterator
+         *
+         *  @brief input iterator yielding elements by value, in order
+         *******************************************************************************/
+        class Const_Iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = T;
+            using reference = T;
+
+            Const_Iterator() = default;
+            Const_Iterator(const SpillVector *vec, size_type idx) : m_vec(vec), m_idx(idx) {}
+
+            T operator*() const { return m_vec->get(m_idx); }
+            Const_Iterator &operator++()
+            {
+                ++m_idx;
+                return *this;
+            }
+            Const_Iterator operator++(int)
+            {
+                Const_Iterator temp = *this;
+                ++m_idx;
+                return temp;
+            }
+
+            friend bool operator==(const Const_Iterator &a, const Const_Iterator &b) { return a.m_idx == b.m_idx; }
+
+        private:
+            const SpillVector *m_vec = nullptr;
+            size_type m_idx = 0;
+        };
+
+        explicit SpillVector(size_type resident_bytes, size_type chunk_bytes = default_chunk_bytes,
+                             const std::filesystem::path &spill_dir = std::filesystem::temp_directory_path(),
+                             const AllocType &alloc = AllocType());
+        ~SpillVector();
+
+        SpillVector(const SpillVector &) = delete;
+        SpillVector &operator=(const SpillVector &) = delete;
+
+        // Element Access
+        T get(size_type idx) const;
+        void set(size_type idx, const T &val);
+        T front() const { return get(0); }
+        T back() const { return get(size() - 1); }
+
+        // Chunk Access
+        template <class Fn>
+        void for_each_chunk(Fn fn) const;
+        template <class Fn>
+        void transform_chunks(Fn fn);
+
+        // Modifiers
+        void push_back(const T &val);
+        void clear();
+
+        // Size and Capacity
+        size_type size() const noexcept { return m_size; }
+        bool empty() const noexcept { return m_size == 0; }
+        size_type chunk_size() const noexcept { return m_chunk_elems; }
+        size_type chunk_count() const noexcept { return m_chunks.size(); }
+        size_type resident_chunks() const noexcept { return m_resident; }
+        size_type max_resident_chunks() const noexcept { return m_max_resident; }
+
+        // Statistics
+        size_type faults() const noexcept { return m_faults; }
+        size_type evictions() const noexcept { return m_evictions; }
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        Const_Iterator begin() const { return Const_Iterator(this, 0); }
+        Const_Iterator end() const { return Const_Iterator(this, m_size); }
+
+    private:
+        T *chunk_frame(size_type c, bool for_write) const;
+        T *fault(size_type c) const;
+        void evict_oldest() const;
+        void unlink_lru(std::uint32_t c) const;
+        void push_lru(std::uint32_t c) const;
+        void prefetch_after(size_type c) const;
+        void write_chunk(size_type c) const;
+        void read_chunk(size_type c) const;
+        off_t file_offset(size_type c) const noexcept { return static_cast<off_t>(c * m_chunk_elems * sizeof(T)); }
+
+        mutable AllocType m_alloc;
+        size_type m_chunk_elems;
+        size_type m_max_resident;
+        size_type m_size = 0;
+        int m_fd = -1;
+
+        mutable Vector<Chunk, Chunk_Alloc> m_chunks;
+        mutable Vector<T *, Frame_Alloc> m_free_frames;
+        mutable size_type m_resident = 0;
+        mutable std::uint32_t m_newest = npos;
+        mutable std::uint32_t m_oldest = npos;
+
+        // last chunk handed out, so sequential access skips the LRU
+        mutable size_type m_hot = std::numeric_limits<size_type>::max();
+        mutable T *m_hot_frame = nullptr;
+        mutable size_type m_last_fault = std::numeric_limits<size_type>::max();
+        mutable size_type m_prefetched_until = 0;
+
+        mutable size_type m_faults = 0;
+        mutable size_type m_evictions = 0;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    SPILL VECTOR METHODS  -----------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * constructor
+     *
+     * @param resident_bytes memory budget for resident chunks, at least two
+     * chunks are kept whatever it says
+     * @param chunk_bytes size of a chunk, rounded down to whole elements
+     * @param spill_dir directory for the (immediately unlinked) spill file
+     * @param alloc allocator for the resident chunks
+     *
+     * @throw std::invalid_argument if a chunk cannot hold one element
+     * @throw std::system_error if the spill file cannot be created
+     *******************************************************************************/
+    template <class T, typename A>
+    SpillVector<T, A>::SpillVector(size_type resident_bytes, size_type chunk_bytes,
+                                   const std::filesystem::path &spill_dir, const A &alloc)
+        : m_alloc{alloc}, m_chunk_elems{chunk_bytes / sizeof(T)},
+          m_max_resident{std::max<size_type>(2, resident_bytes / (chunk_bytes ? chunk_bytes : 1))},
+          m_chunks{Chunk_Alloc(alloc)}, m_free_frames{Frame_Alloc(alloc)}
+    {
+        if (m_chunk_elems == 0)
+            throw std::invalid_argument("SpillVector: chunk smaller than an element");
+
+#if defined(O_TMPFILE)
+        m_fd = ::open(spill_dir.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+#endif
+        if (m_fd < 0)
+        {
+            // no O_TMPFILE (or a file system without it): create and unlink
+            std::string name = (spill_dir / "spillvector-XXXXXX").string();
+            m_fd = ::mkstemp(name.data());
+            if (m_fd >= 0)
+                ::unlink(name.c_str());
+        }
+        if (m_fd < 0)
+            throw std::system_error(errno, std::generic_category(), "SpillVector: cannot create spill file");
+    }
+
+    /*******************************************************************************
+     * destructor
+     *
+     * @brief free the resident chunks and close (and so delete) the spill file
+     *******************************************************************************/
+    template <class T, typename A>
+    SpillVector<T, A>::~SpillVector()
+    {
+        for (size_type c = 0; c < m_chunks.size(); ++c)
+            if (m_chunks.data()[c].frame)
+                std::allocator_traits<A>::deallocate(m_alloc, m_chunks.data()[c].frame, m_chunk_elems);
+        for (size_type f = 0; f < m_free_frames.size(); ++f)
+            std::allocator_traits<A>::deallocate(m_alloc, m_free_frames.data()[f], m_chunk_elems);
+
+        ::close(m_fd);
+    }
+
+    /*******************************************************************************
+     * get
+     *
+     * @return a copy of element idx, faulting its chunk in if needed
+     * @throw std::out_of_range if idx is not below size()
+     * @throw std::system_error if the spill file cannot be read or written
+     *******************************************************************************/
+    template <class T, typename A>
+    T SpillVector<T, A>::get(size_type idx) const
+    {
+        if (idx >= m_size)
+            throw std::out_of_range("SpillVector: index out of range");
+
+        return chunk_frame(idx / m_chunk_elems, false)[idx % m_chunk_elems];
+    }
+
+    /*******************************************************************************
+     * set
+     *
+     * @brief overwrite element idx
+     *
+     * @throw std::out_of_range if idx is not below size()
+     * @throw std::system_error if the spill file cannot be read or written
+     *******************************************************************************/
+    template <class T, typename A>
+    void SpillVector<T, A>::set(size_type idx, const T &val)
+    {
+        if (idx >= m_size)
+            throw std::out_of_range("SpillVector: index out of range");
+
+        chunk_frame(idx / m_chunk_elems, true)[idx % m_chunk_elems] = val;
+    }
+
+    /*******************************************************************************
+     * for_each_chunk
+     *
+     * @brief call fn(std::span<const T>) on each chunk in order
+     *
+     * The span is valid only during the call. Chunks are faulted in in
+     * order, so the spilled ones ahead are prefetched.
+     *******************************************************************************/
+    template <class T, typename A>
+    template <class Fn>
+    void SpillVector<T, A>::for_each_chunk(Fn fn) const
+    {
+        for (size_type c = 0; c < m_chunks.size(); ++c)
+        {
+            size_type n = std::min(m_chunk_elems, m_size - c * m_chunk_elems);
+            fn(std::span<const T>(chunk_frame(c, false), n));
+        }
+    }
+
+    /*******************************************************************************
+     * transform_chunks
+     *
+     * @brief call fn(std::span<T>) on each chunk in order, letting it modify
+     * the elements
+     *
+     * Every chunk is marked dirty, and is written back when evicted.
+     *******************************************************************************/
+    template <class T, typename A>
+    template <class Fn>
+    void SpillVector<T, A>::transform_chunks(Fn fn)
+    {
+        for (size_type c = 0; c < m_chunks.size(); ++c)
+        {
+            size_type n = std::min(m_chunk_elems, m_size - c * m_chunk_elems);
+            fn(std::span<T>(chunk_frame(c, true), n));
+        }
+    }
+
+    /*******************************************************************************
+     * push_back
+     *
+     * @brief append val, starting a new chunk when the last one is full
+     *******************************************************************************/
+    template <class T, typename A>
+    void SpillVector<T, A>::push_back(const T &val)
+    {
+        size_type c = m_size / m_chunk_elems;
+        if (c == m_chunks.size())
+        {
+            if (c >= npos)
+                throw std::length_error("SpillVector: too many chunks");
+            m_chunks.push_back(Chunk{});
+        }
+
+        chunk_frame(c, true)[m_size % m_chunk_elems] = val;
+        ++m_size;
+    }
+
+    /*******************************************************************************
+     * clear
+     *
+     * @brief remove every element, keeping the frames for reuse and
+     * truncating the spill file
+     *******************************************************************************/
+    template <class T, typename A>
+    void SpillVector<T, A>::clear()
+    {
+        for (size_type c = 0; c < m_chunks.size(); ++c)
+            if (m_chunks.data()[c].frame)
+                m_free_frames.push_back(m_chunks.data()[c].frame);
+
+        m_chunks.clear();
+        m_size = 0;
+        m_resident = 0;
+        m_newest = m_oldest = npos;
+        m_hot = std::numeric_limits<size_type>::max();
+        m_last_fault = std::numeric_limits<size_type>::max();
+        m_prefetched_until = 0;
+
+        if (::ftruncate(m_fd, 0) != 0)
+            throw std::system_error(errno, std::generic_category(), "SpillVector: cannot truncate spill file");
+    }
+
+    /*******************************************************************************
+     * chunk_frame
+     *
+     * @brief resident frame of chunk c, marked most recently used
+     *
+     * @param for_write mark the chunk dirty
+     *******************************************************************************/
+    template <class T, typename A>
+    T *SpillVector<T, A>::chunk_frame(size_type c, bool for_write) const
+    {
+        Chunk &chunk = m_chunks.data()[c];
+        if (c != m_hot)
+        {
+            if (chunk.frame)
+            {
+                unlink_lru(static_cast<std::uint32_t>(c));
+                push_lru(static_cast<std::uint32_t>(c));
+            }
+            else
+                fault(c);
+
+            m_hot = c;
+            m_hot_frame = chunk.frame;
+        }
+
+        chunk.dirty |= for_write;
+        return m_hot_frame;
+    }
+
+    /*******************************************************************************
+     * fault
+     *
+     * @brief make chunk c resident, evicting the least recently used chunk
+     * if the budget is used up
+     *
+     * A chunk never written to the file starts zeroed.
+     *******************************************************************************/
+    template <class T, typename A>
+    T *SpillVector<T, A>::fault(size_type c) const
+    {
+        if (m_free_frames.empty())
+        {
+            if (m_resident < m_max_resident)
+                m_free_frames.push_back(std::allocator_traits<A>::allocate(m_alloc, m_chunk_elems));
+            else
+                evict_oldest();
+        }
+
+        Chunk &chunk = m_chunks.data()[c];
+        chunk.frame = m_free_frames.data()[m_free_frames.size() - 1];
+        m_free_frames.pop_back();
+
+        try
+        {
+            if (chunk.on_disk)
+                read_chunk(c);
+            else
+                std::memset(static_cast<void *>(chunk.frame), 0, m_chunk_elems * sizeof(T));
+        }
+        catch (...)
+        {
+            m_free_frames.push_back(chunk.frame);
+            chunk.frame = nullptr;
+            throw;
+        }
+
+        chunk.dirty = false;
+        push_lru(static_cast<std::uint32_t>(c));
+        ++m_resident;
+        ++m_faults;
+
+        if (c == m_last_fault + 1)
+            prefetch_after(c);
+        else
+            m_prefetched_until = 0;
+        m_last_fault = c;
+
+        return chunk.frame;
+    }
+
+    /*******************************************************************************
+     * evict_oldest
+     *
+     * @brief write the least recently used chunk back if dirty and free its frame
+     *******************************************************************************/
+    template <class T, typename A>
+    void SpillVector<T, A>::evict_oldest() const
+    {
+        std::uint32_t c = m_oldest;
+        Chunk &chunk = m_chunks.data()[c];
+
+        if (chunk.dirty)
+        {
+            write_chunk(c);
+            chunk.on_disk = true;
+            chunk.dirty = false;
+        }
+
+        unlink_lru(c);
+        m_free_frames.push_back(chunk.frame);
+        chunk.frame = nullptr;
+        --m_resident;
+        ++m_evictions;
+
+        if (m_hot == c)
+            m_hot = std::numeric_limits<size_type>::max();
+    }
+
+    /*******************************************************************************
+     * unlink_lru / push_lru
+     *
+     * @brief remove resident chunk c from the LRU list / add it as the newest
+     *******************************************************************************/
+    template <class T, typename A>
+    void SpillVector<T, A>::unlink_lru(std::uint32_t c) const
+    {
+        Chunk &chunk = m_chunks.data()[c];
+        (chunk.newer == npos ? m_newest : m_chunks.data()[chunk.newer].older) = chunk.older;
+        (chunk.older == npos ? m_oldest : m_chunks.data()[chunk.older].newer) = chunk.newer;
+        chunk.newer = chunk.older = npos;
+    }
+
+    template <class T, typename A>
+    void SpillVector<T, A>::push_lru(std::uint32_t c) const
+    {
+        Chunk &chunk = m_chunks.data()[c];
+        chunk.older = m_newest;
+        chunk.newer = npos;
+        (m_newest == npos ? m_oldest : m_chunks.data()[m_newest].newer) = c;
+        m_newest = c;
+    }
+
+    /*******************************************************************************
+     * prefetch_after
+     *
+     * @brief ask the kernel to start reading the spilled chunks following c
+     *
+     * Each chunk is announced once per sequential run; the read into the
+     * page cache happens in the background, and the later pread of the
+     * chunk is a memory copy.
+     *******************************************************************************/
+    template <class T, typename A>
+    void SpillVector<T, A>::prefetch_after(size_type c) const
+    {
+#if defined(POSIX_FADV_WILLNEED)
+        size_type first = std::max(c + 1, m_prefetched_until);
+        size_type last = std::min(c + 1 + prefetch_chunks, m_chunks.size());
+
+        for (size_type next = first; next < last; ++next)
+            if (m_chunks.data()[next].on_disk && !m_chunks.data()[next].frame)
+                ::posix_fadvise(m_fd, file_offset(next), m_chunk_elems * sizeof(T), POSIX_FADV_WILLNEED);
+
+        m_prefetched_until = std::max(m_prefetched_until, last);
+#else
+        (void)c;
+#endif
+    }
+
+    /*******************************************************************************
+     * write_chunk / read_chunk
+     *
+     * @brief copy chunk c's frame to / from its place in the spill file,
+     * retrying short transfers
+     *
+     * @throw std::system_error on an I/O error or (reading) end of file
+     *******************************************************************************/
+    template <class T, typename A>
+    void SpillVector<T, A>::write_chunk(size_type c) const
+    {
+        const char *bytes = reinterpret_cast<const char *>(m_chunks.data()[c].frame);
+        size_type total = m_chunk_elems * sizeof(T);
+
+        for (size_type done = 0; done < total;)
+        {
+            ssize_t n = ::pwrite(m_fd, bytes + done, total - done, file_offset(c) + done);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                throw std::system_error(errno, std::generic_category(), "SpillVector: cannot write spill file");
+            done += n;
+        }
+    }
+
+    template <class T, typename A>
+    void SpillVector<T, A>::read_chunk(size_type c) const
+    {
+        char *bytes = reinterpret_cast<char *>(m_chunks.data()[c].frame);
+        size_type total = m_chunk_elems * sizeof(T);
+
+        for (size_type done = 0; done < total;)
+        {
+            ssize_t n = ::pread(m_fd, bytes + done, total - done, file_offset(c) + done);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                throw std::system_error(n == 0 ? EIO : errno, std::generic_category(),
+                                        "SpillVector: cannot read spill file");
+            done += n;
+        }
+    }
+}
+
+#endif // SPILL_VECTOR_H
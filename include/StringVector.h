@@ -0,0 +1,769 @@
+/*******************************************************************************
+ *  @file StringVector.h
+ *  @brief This file contains methods that define and implement a sequence of
+ *  strings stored in one character buffer with an offset index
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef STRING_VECTOR_H
+#define STRING_VECTOR_H 1
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "CustomVector.h"
+
+namespace custom
+{
+    namespace detail
+    {
+        template <class Offset>
+        concept string_offset = std::is_same_v<Offset, std::uint32_t> || std::is_same_v<Offset, std::uint64_t>;
+
+        // serialized form: header, (count + 1) offsets, then the characters
+        struct StringTableHeader
+        {
+            static constexpr std::uint64_t magic_value = 0x3130434556525453; // "STRVEC01"
+
+            std::uint64_t magic;
+            std::uint64_t count;
+            std::uint64_t char_count;
+            std::uint64_t offset_bytes;
+        };
+
+        inline constexpr std::uint64_t unknown_stream_size = std::numeric_limits<std::uint64_t>::max();
+
+        // bytes left to read from is, or unknown_stream_size if it cannot seek
+        inline std::uint64_t remaining_bytes(std::istream &is)
+        {
+            std::streambuf *buf = is.rdbuf();
+            std::streampos here = buf->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+            if (here == std::streampos(-1))
+                return unknown_stream_size;
+
+            std::streampos end = buf->pubseekoff(0, std::ios_base::end, std::ios_base::in);
+            buf->pubseekpos(here, std::ios_base::in);
+            if (end == std::streampos(-1) || end < here)
+                return unknown_stream_size;
+
+            return static_cast<std::uint64_t>(end - here);
+        }
+
+        /*******************************************************************************
+         * read_elements
+         *
+         * @brief read n trivially copyable elements from is onto the empty v
+         *
+         * Reads in 1 MiB steps, growing v as they arrive, so a header that
+         * claims more than a stream of unknown size holds fails on the read
+         * rather than on one huge allocation. Check is afterwards.
+         *******************************************************************************/
+        template <class V>
+        void read_elements(std::istream &is, V &v, std::uint64_t n)
+        {
+            using E = typename V::value_type;
+            constexpr std::uint64_t step = (std::uint64_t{1} << 20) / sizeof(E);
+
+            for (std::uint64_t done = 0; done < n && is;)
+            {
+                std::uint64_t k = std::min(step, n - done);
+                if (done + k > v.capacity())
+                    v.reserve(std::max<std::uint64_t>(2 * v.capacity(), done + k));
+
+                v.resize(done + k);
+                is.read(reinterpret_cast<char *>(v.data() + done), k * sizeof(E));
+                done += k;
+            }
+        }
+
+        /*******************************************************************************
+         * prefix_key
+         *
+         * @brief the first 8 bytes of s as a big-endian integer, zero padded
+         *
+         * Integer order of two keys is the lexicographic order of the first
+         * 8 bytes (as unsigned char, like std::string_view::compare).
+         *******************************************************************************/
+        inline std::uint64_t prefix_key(std::string_view s) noexcept
+        {
+            std::uint64_t key = 0;
+            std::size_t n = s.size() < 8 ? s.size() : 8;
+
+            for (std::size_t i = 0; i < 8; ++i)
+                key = key << 8 | (i < n ? static_cast<unsigned char>(s[i]) : 0);
+
+            return key;
+        }
+
+        /*******************************************************************************
+         * prefix_key
+         *
+         * @brief prefix_key({s, len}) with one 8-byte load when 8 bytes are
+         * readable at s, rather than a byte loop
+         *
+         * @param readable bytes that may be read starting at s, >= len
+         *******************************************************************************/
+        inline std::uint64_t prefix_key(const char *s, std::size_t len, std::size_t readable) noexcept
+        {
+            if (readable < 8)
+                return prefix_key(std::string_view(s, len));
+
+            std::uint64_t word;
+            std::memcpy(&word, s, 8);
+            if constexpr (std::endian::native == std::endian::little)
+            {
+                // compiles to a single bswap
+                std::uint64_t swapped = 0;
+                for (int i = 0; i < 8; ++i)
+                    swapped |= (word >> (8 * i) & 0xff) << (56 - 8 * i);
+                word = swapped;
+            }
+
+            // drop the bytes past the end of the string; two shifts keep a
+            // length of 0 (a shift by 64) defined and the whole thing branchless
+            std::size_t n = len < 8 ? len : 8;
+            return word & ~((~std::uint64_t{0} >> 4 * n) >> 4 * n);
+        }
+    }
+
+    /*******************************************************************************
+     * class StringVectorView
+     *
+     *  @brief Read-only StringVector layout over memory owned elsewhere: a
+     *  character buffer and size() + 1 offsets into it
+     *
+     *  String i is chars[offsets[i], offsets[i + 1]). This is what
+     *  StringVector::view() returns, and what from_bytes() makes of a
+     *  buffer written by StringVector::serialize (a file mapped into
+     *  memory, say) without copying anything.
+     *
+     *  @tparam Offset  std::uint32_t (up to 4 GiB of characters) or std::uint64_t.
+     *
+     *******************************************************************************/
+    template <detail::string_offset Offset = std::uint32_t>
+    class StringVectorView
+    {
+    public:
+        using size_type = size_t;
+        using value_type = std::string_view;
+
+        /*******************************************************************************
+         * class Const_Iterator
+         *
+         *  @brief random access iterator yielding string_views by value
+         *******************************************************************************/
+        class Const_Iterator
+        {
+        public:
+            using iterator_concept = std::random_access_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::string_view;
+            using reference = std::string_view;
+
+            Const_Iterator() = default;
+            Const_Iterator(const char *chars, const Offset *offsets, size_type idx)
+                : m_chars(chars), m_offsets(offsets), m_idx(idx) {}
+
+            std::string_view operator*() const { return (*this)[0]; }
+            std::string_view operator[](difference_type n) const
+            {
+                size_type idx = m_idx + n;
+                return {m_chars + m_offsets[idx], static_cast<size_t>(m_offsets[idx + 1] - m_offsets[idx])};
+            }
+
+            Const_Iterator &operator++()
+            {
+                ++m_idx;
+                return *this;
+            }
+            Const_Iterator operator++(int)
+            {
+                Const_Iterator temp = *this;
+                ++m_idx;
+                return temp;
+            }
+            Const_Iterator &operator--()
+            {
+                --m_idx;
+                return *this;
+            }
+            Const_Iterator operator--(int)
+            {
+                Const_Iterator temp = *this;
+                --m_idx;
+                return temp;
+            }
+
+            Const_Iterator &operator+=(difference_type n)
+            {
+                m_idx += n;
+                return *this;
+            }
+            Const_Iterator &operator-=(difference_type n)
+            {
+                m_idx -= n;
+                return *this;
+            }
+
+            Const_Iterator operator+(difference_type n) const { return Const_Iterator(m_chars, m_offsets, m_idx + n); }
+            Const_Iterator operator-(difference_type n) const { return Const_Iterator(m_chars, m_offsets, m_idx - n); }
+            friend Const_Iterator operator+(difference_type n, const Const_Iterator &it) { return it + n; }
+
+            friend difference_type operator-(const Const_Iterator &a, const Const_Iterator &b)
+            {
+                return static_cast<difference_type>(a.m_idx) - static_cast<difference_type>(b.m_idx);
+            }
+
+            friend bool operator==(const Const_Iterator &a, const Const_Iterator &b) { return a.m_idx == b.m_idx; }
+            friend auto operator<=>(const Const_Iterator &a, const Const_Iterator &b) { return a.m_idx <=> b.m_idx; }
+
+        private:
+            // the buffers themselves, so iterators outlive the view they came from
+            const char *m_chars = nullptr;
+            const Offset *m_offsets = nullptr;
+            size_type m_idx = 0;
+        };
+
+        StringVectorView() = default;
+        StringVectorView(std::span<const char> chars, std::span<const Offset> offsets);
+
+        static StringVectorView from_bytes(std::span<const std::byte> bytes);
+
+        // Element Access
+        std::string_view operator[](size_type idx) const noexcept
+        {
+            return {m_chars + m_offsets[idx], static_cast<size_t>(m_offsets[idx + 1] - m_offsets[idx])};
+        }
+        std::string_view at(size_type idx) const;
+        size_type length(size_type idx) const noexcept { return m_offsets[idx + 1] - m_offsets[idx]; }
+
+        // Prefix Comparison
+        std::uint64_t prefix_key(size_type idx) const noexcept
+        {
+            return detail::prefix_key(m_chars + m_offsets[idx], length(idx), m_offsets[m_size] - m_offsets[idx]);
+        }
+        int compare(size_type a, size_type b) const noexcept;
+        bool starts_with(size_type idx, std::string_view prefix) const noexcept;
+        size_type count_prefix(std::string_view prefix) const noexcept;
+
+        // Size and Raw Storage
+        size_type size() const noexcept { return m_size; }
+        bool empty() const noexcept { return m_size == 0; }
+        size_type char_count() const noexcept { return m_size ? m_offsets[m_size] : 0; }
+        std::span<const char> chars() const noexcept { return {m_chars, char_count()}; }
+        std::span<const Offset> offsets() const noexcept { return {m_offsets, m_size + 1}; }
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        Const_Iterator begin() const noexcept { return Const_Iterator(m_chars, m_offsets, 0); }
+        Const_Iterator end() const noexcept { return Const_Iterator(m_chars, m_offsets, m_size); }
+
+    private:
+        static constexpr Offset empty_offsets[1] = {0};
+
+        const char *m_chars = nullptr;
+        const Offset *m_offsets = empty_offsets;
+        size_type m_size = 0;
+    };
+
+    /*******************************************************************************
+     * class StringVector
+     *
+     *  @brief A sequence of strings stored back to back in one Vector<char>,
+     *  with a Vector of size() + 1 offsets marking where each one starts
+     *
+     *  Vector<std::string> makes one heap allocation per string longer than
+     *  the small string buffer and a pointer dereference per access; here
+     *  tens of millions of short tokens cost two allocations and 4 (or 8)
+     *  bytes of index each, and sit contiguously for scans. Access returns
+     *  std::string_view, valid until the next modification.
+     *
+     *  Strings are appended and removed at the back only. append() of a
+     *  range sizes both buffers once. serialize() writes the two buffers
+     *  as they are, and StringVectorView::from_bytes reads them in place.
+     *
+     *  @tparam Offset  std::uint32_t (up to 4 GiB of characters) or std::uint64_t.
+     *  @tparam AllocType  Allocator type for the characters, default allocator<char>.
+     *
+     *******************************************************************************/
+    template <detail::string_offset Offset = std::uint32_t, typename AllocType = std::allocator<char>>
+    class StringVector
+    {
+        using Offset_Alloc = typename std::allocator_traits<AllocType>::template rebind_alloc<Offset>;
+
+    public:
+        using size_type = size_t;
+        using value_type = std::string_view;
+        using Const_Iterator = typename StringVectorView<Offset>::Const_Iterator;
+
+        StringVector(const AllocType &alloc = AllocType());
+        StringVector(std::initializer_list<std::string_view> ilist, const AllocType &alloc = AllocType());
+
+        // Element Access
+        std::string_view operator[](size_type idx) const noexcept
+        {
+            return {m_chars.data() + m_offsets.data()[idx], length(idx)};
+        }
+        std::string_view at(size_type idx) const { return view().at(idx); }
+        std::string_view front() const { return at(0); }
+        std::string_view back() const { return at(size() - 1); }
+        size_type length(size_type idx) const noexcept
+        {
+            return m_offsets.data()[idx + 1] - m_offsets.data()[idx];
+        }
+
+        // Modifiers
+        void push_back(std::string_view str);
+        template <std::ranges::input_range R>
+            requires std::convertible_to<std::ranges::range_reference_t<R>, std::string_view>
+        void append(R &&strings);
+        void pop_back();
+        void clear();
+
+        // Prefix Comparison
+        std::uint64_t prefix_key(size_type idx) const noexcept { return view().prefix_key(idx); }
+        int compare(size_type a, size_type b) const noexcept { return view().compare(a, b); }
+        bool starts_with(size_type idx, std::string_view prefix) const noexcept
+        {
+            return view().starts_with(idx, prefix);
+        }
+        size_type count_prefix(std::string_view prefix) const noexcept { return view().count_prefix(prefix); }
+
+        // Size and Capacity
+        void reserve(size_type strings, size_type chars);
+        size_type size() const noexcept { return m_offsets.size() - 1; }
+        bool empty() const noexcept { return size() == 0; }
+        size_type char_count() const noexcept { return m_chars.size(); }
+        size_type memory_usage() const noexcept
+        {
+            return m_chars.capacity() + m_offsets.capacity() * sizeof(Offset);
+        }
+
+        // Serialization
+        StringVectorView<Offset> view() const noexcept
+        {
+            return StringVectorView<Offset>({m_chars.data(), m_chars.size()}, {m_offsets.data(), m_offsets.size()});
+        }
+        size_type serialized_size() const noexcept;
+        void serialize(std::span<std::byte> out) const;
+        void write(std::ostream &os) const;
+        static StringVector read(std::istream &is, const AllocType &alloc = AllocType());
+
+        //--------------------------------------------
+        // Iterator Methods
+        //--------------------------------------------
+        Const_Iterator begin() const noexcept { return view().begin(); }
+        Const_Iterator end() const noexcept { return view().end(); }
+
+    private:
+        void check_length(size_type chars) const;
+
+        Vector<char, AllocType> m_chars;
+        Vector<Offset, Offset_Alloc> m_offsets;
+    };
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    STRING VECTOR VIEW METHODS  -----------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * constructor
+     *
+     * @param chars character buffer
+     * @param offsets size() + 1 non-decreasing offsets into chars, starting at 0
+     *
+     * @throw std::invalid_argument if offsets is empty or points past chars
+     *******************************************************************************/
+    template <detail::string_offset Offset>
+    StringVectorView<Offset>::StringVectorView(std::span<const char> chars, std::span<const Offset> offsets)
+        : m_chars{chars.data()}, m_offsets{offsets.data()}, m_size{offsets.empty() ? 0 : offsets.size() - 1}
+    {
+        if (offsets.empty() || offsets.front() != 0 || offsets.back() > chars.size())
+            throw std::invalid_argument("StringVectorView: offsets do not fit the characters");
+    }
+
+    /*******************************************************************************
+     * from_bytes
+     *
+     * @brief view a buffer written by StringVector::serialize, in place
+     *
+     * Only the header, sizes and the first and last offsets are checked;
+     * reading every offset would touch the whole index of a mapped file.
+     *
+     * @param bytes the serialized buffer, aligned to 8 bytes
+     * @throw std::invalid_argument if bytes is not such a buffer
+     *******************************************************************************/
+    template <detail::string_offset Offset>
+    StringVectorView<Offset> StringVectorView<Offset>::from_bytes(std::span<const std::byte> bytes)
+    {
+        using Header = detail::StringTableHeader;
+
+        Header header;
+        if (bytes.size() < sizeof(Header) || reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(Offset))
+            throw std::invalid_argument("StringVectorView: buffer too small or misaligned");
+
+        std::memcpy(&header, bytes.data(), sizeof(Header));
+        if (header.magic != Header::magic_value || header.offset_bytes != sizeof(Offset))
+            throw std::invalid_argument("StringVectorView: not a serialized StringVector of this offset type");
+
+        // count + 1 offsets, then char_count characters, must fit after the
+        // header; compared without sums that a corrupt header could overflow
+        size_type available = bytes.size() - sizeof(Header);
+        if (header.count >= available / sizeof(Offset))
+            throw std::invalid_argument("StringVectorView: buffer truncated");
+
+        size_type offset_bytes = (header.count + 1) * sizeof(Offset);
+        if (header.char_count > available - offset_bytes)
+            throw std::invalid_argument("StringVectorView: buffer truncated");
+
+        const std::byte *offsets = bytes.data() + sizeof(Header);
+        const std::byte *chars = offsets + offset_bytes;
+
+        return StringVectorView({reinterpret_cast<const char *>(chars), header.char_count},
+                                {reinterpret_cast<const Offset *>(offsets), header.count + 1});
+    }
+
+    /*******************************************************************************
+     * at
+     *
+     * @brief bounds checked access to string idx
+     *******************************************************************************/
+    template <detail::string_offset Offset>
+    std::string_view StringVectorView<Offset>::at(size_type idx) const
+    {
+        if (idx >= m_size)
+            throw std::out_of_range("StringVector: index out of range");
+
+        return (*this)[idx];
+    }
+
+    /*******************************************************************************
+     * compare
+     *
+     * @brief three-way comparison of strings a and b
+     *
+     * The 8-byte prefix keys settle most comparisons of distinct strings
+     * with one integer compare, before touching the rest of the bytes.
+     *
+     * @return negative, zero or positive like std::string_view::compare
+     *******************************************************************************/
+    template <detail::string_offset Offset>
+    int StringVectorView<Offset>::compare(size_type a, size_type b) const noexcept
+    {
+        std::uint64_t key_a = prefix_key(a);
+        std::uint64_t key_b = prefix_key(b);
+
+        if (key_a != key_b)
+            return key_a < key_b ? -1 : 1;
+
+        return (*this)[a].compare((*this)[b]);
+    }
+
+    /*******************************************************************************
+     * starts_with
+     *
+     * @return true if string idx begins with prefix
+     *******************************************************************************/
+    template <detail::string_offset Offset>
+    bool StringVectorView<Offset>::starts_with(size_type idx, std::string_view prefix) const noexcept
+    {
+        return length(idx) >= prefix.size() &&
+               std::memcmp(m_chars + m_offsets[idx], prefix.data(), prefix.size()) == 0;
+    }
+
+    /*******************************************************************************
+     * count_prefix
+     *
+     * @brief number of strings beginning with prefix
+     *
+     * Prefixes of up to 8 bytes are matched with one masked 8-byte load
+     * per string, in native byte order, instead of a memcmp call. Bytes
+     * past the string's end may be loaded but are never significant, as
+     * the length test rejects strings shorter than the prefix.
+     *******************************************************************************/
+    template <detail::string_offset Offset>
+    typename StringVectorView<Offset>::size_type
+    StringVectorView<Offset>::count_prefix(std::string_view prefix) const noexcept
+    {
+        size_type count = 0;
+
+        if (prefix.size() > 8)
+        {
+            for (size_type i = 0; i < m_size; ++i)
+                count += starts_with(i, prefix);
+            return count;
+        }
+
+        std::uint64_t key = 0;
+        std::uint64_t mask = 0;
+        std::memcpy(&key, prefix.data(), prefix.size());
+        std::memset(&mask, 0xff, prefix.size());
+
+        // the last strings may not have 8 readable bytes ahead of them
+        size_type total = char_count();
+        size_type i = 0;
+        for (; i < m_size && total - m_offsets[i] >= 8; ++i)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, m_chars + m_offsets[i], 8);
+            count += ((word & mask) == key) & (length(i) >= prefix.size());
+        }
+        for (; i < m_size; ++i)
+            count += starts_with(i, prefix);
+
+        return count;
+    }
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    STRING VECTOR METHODS  ----------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    /*******************************************************************************
+     * default constructor
+     *
+     * @param alloc allocator
+     *******************************************************************************/
+    template <detail::string_offset Offset, typename A>
+    StringVector<Offset, A>::StringVector(const A &alloc)
+        : m_chars{alloc}, m_offsets{Offset_Alloc(alloc)}
+    {
+        m_offsets.push_back(0);
+    }
+
+    /*******************************************************************************
+     * @brief initializer_list constructor
+     *
+     * @param ilist strings to copy
+     * @param alloc allocator
+     *******************************************************************************/
+    template <detail::string_offset Offset, typename A>
+    StringVector<Offset, A>::StringVector(std::initializer_list<std::string_view> ilist, const A &alloc)
+        : StringVector(alloc)
+    {
+        append(ilist);
+    }
+
+    /*******************************************************************************
+     * push_back
+     *
+     * @brief append a copy of str
+     *
+     * @throw std::length_error if the characters would overflow Offset
+     *******************************************************************************/
+    template <detail::string_offset Offset, typename A>
+    void StringVector<Offset, A>::push_back(std::string_view str)
+    {
+        check_length(str.size());
+
+        // str may point into m_chars, which growing would free
+        size_type old_chars = m_chars.size();
+        std::less<const char *> before;
+        bool inside = !before(str.data(), m_chars.data()) && before(str.data(), m_chars.data() + old_chars);
+        size_type from = inside ? str.data() - m_chars.data() : 0;
+
+        // append_construct sizes exactly, so grow geometrically here
+        if (m_chars.capacity() - old_chars < str.size())
+            m_chars.reserve(std::max(2 * m_chars.capacity(), old_chars + str.size()));
+
+        const char *source = inside ? m_chars.data() + from : str.data();
+        m_offsets.push_back(static_cast<Offset>(old_chars + str.size()));
+        m_chars.append_construct(str.size(), [&](char *first, char *)
+                                 { std::memcpy(first, source, str.size()); });
+    }
+
+    /*******************************************************************************
+     * append
+     *
+     * @brief append every string of a range, sizing both buffers once when
+     * the range can be traversed twice
+     *******************************************************************************/
+    template <detail::string_offset Offset, typename A>
+    template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, std::string_view>
+    void StringVector<Offset, A>::append(R &&strings)
+    {
+        if constexpr (std::ranges::forward_range<R>)
+        {
+            size_type count = 0;
+            size_type chars = 0;
+            for (std::string_view str : strings)
+            {
+                ++count;
+                chars += str.size();
+            }
+
+            check_length(chars);
+            reserve(size() + count, char_count() + chars);
+        }
+
+        for (std::string_view str : strings)
+            push_back(str);
+    }
+
+    /*******************************************************************************
+     * pop_back
+     *
+     * @brief remove the last string
+     *******************************************************************************/
+    template <detail::string_offset Offset, typename A>
+    void StringVector<Offset, A>::pop_back()
+    {
+        if (empty())
+            throw std::out_of_range("StringVector: pop_back on empty vector");
+
+        m_offsets.pop_back();
+        m_chars.resize(m_offsets.back());
+    }
+
+    /*******************************************************************************
+     * clear
+     *
+     * @brief remove every string, keeping both buffers
+     *******************************************************************************/
+    template <detail::string_offset Offset, typename A>
+    void StringVector<Offset, A>::clear()
+    {
+        m_chars.clear();
+        m_offsets.resize(1);
+    }
+
+    /*******************************************************************************
+     * reserve
+     *
+     * @brief make room for strings strings holding chars characters in total
+     *******************************************************************************/
+    template <detail::string_offset Offset, typename A>
+    void StringVector<Offset, A>::reserve(size_type strings, size_type chars)
+    {
+        m_offsets.reserve(strings + 1);
+        m_chars.reserve(chars);
+    }
+
+    /*******************************************************************************
+     * serialized_size
+     *
+     * @return bytes serialize() writes
+     *******************************************************************************/
+    template <detail::string_offset Offset, typename A>
+    typename StringVector<Offset, A>::size_type StringVector<Offset, A>::serialized_size() const noexcept
+    {
+        return sizeof(detail::StringTableHeader) + m_offsets.size() * sizeof(Offset) + m_chars.size();
+    }
+
+    /*******************************************************************************
+     * serialize
+     *
+     * @brief write header, offsets and characters to out, as they are in memory
+     *
+     * @param out at least serialized_size() bytes
+     * @throw std::invalid_argument if out is too small
+     *******************************************************************************/
+    template <detail::string_offset Offset, typename A>
+    void StringVector<Offset, A>::serialize(std::span<std::byte> out) const
+    {
+        if (out.size() < serialized_size())
+            throw std::invalid_argument("StringVector: serialize buffer too small");
+
+        detail::StringTableHeader header{detail::StringTableHeader::magic_value, size(), char_count(), sizeof(Offset)};
+
+        std::byte *dest = out.data();
+        std::memcpy(dest, &header, sizeof(header));
+        dest += sizeof(header);
+        std::memcpy(dest, m_offsets.data(), m_offsets.size() * sizeof(Offset));
+        dest += m_offsets.size() * sizeof(Offset);
+        std::memcpy(dest, m_chars.data(), m_chars.size());
+    }
+
+    /*******************************************************************************
+     * write
+     *
+     * @brief serialize to a stream without an intermediate buffer
+     *******************************************************************************/
+    template <detail::string_offset Offset, typename A>
+    void StringVector<Offset, A>::write(std::ostream &os) const
+    {
+        detail::StringTableHeader header{detail::StringTableHeader::magic_value, size(), char_count(), sizeof(Offset)};
+
+        os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        os.write(reinterpret_cast<const char *>(m_offsets.data()), m_offsets.size() * sizeof(Offset));
+        os.write(m_chars.data(), m_chars.size());
+    }
+
+    /*******************************************************************************
+     * read
+     *
+     * @brief read a StringVector written by write()
+     *
+     * @throw std::runtime_error on a malformed or truncated stream
+     *******************************************************************************/
+    template <detail::string_offset Offset, typename A>
+    StringVector<Offset, A> StringVector<Offset, A>::read(std::istream &is, const A &alloc)
+    {
+        detail::StringTableHeader header;
+        if (!is.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+            header.magic != detail::StringTableHeader::magic_value || header.offset_bytes != sizeof(Offset) ||
+            header.char_count > std::numeric_limits<Offset>::max())
+            throw std::runtime_error("StringVector: not a serialized StringVector of this offset type");
+
+        // count + 1 offsets, then char_count characters, must fit in what is
+        // left of the stream; compared without sums that could overflow
+        std::uint64_t remaining = detail::remaining_bytes(is);
+        if (header.count >= remaining / sizeof(Offset) ||
+            header.char_count > remaining - (header.count + 1) * sizeof(Offset))
+            throw std::runtime_error("StringVector: truncated stream");
+
+        StringVector result(alloc);
+        if (remaining != detail::unknown_stream_size)
+        {
+            result.m_offsets.reserve(header.count + 1);
+            result.m_chars.reserve(header.char_count);
+        }
+
+        detail::read_elements(is, result.m_offsets, header.count + 1);
+        detail::read_elements(is, result.m_chars, header.char_count);
+        if (!is)
+            throw std::runtime_error("StringVector: truncated stream");
+
+        const Offset *offsets = result.m_offsets.data();
+        bool ordered = offsets[0] == 0 && offsets[header.count] == header.char_count;
+        for (size_type i = 0; i < header.count; ++i)
+            ordered &= offsets[i] <= offsets[i + 1];
+        if (!ordered)
+            throw std::runtime_error("StringVector: offsets out of order");
+
+        return result;
+    }
+
+    /*******************************************************************************
+     * check_length
+     *
+     * @throw std::length_error if adding chars characters would overflow Offset
+     *******************************************************************************/
+    template <detail::string_offset Offset, typename A>
+    void StringVector<Offset, A>::check_length(size_type chars) const
+    {
+        if (chars > std::numeric_limits<Offset>::max() - char_count())
+            throw std::length_error("StringVector: too many characters for the offset type");
+    }
+}
+
+#endif // STRING_VECTOR_H
@@ -0,0 +1,499 @@
+/*******************************************************************************
+ *  @file VectorExpr.h
+ *  @brief This file contains methods that define and implement lazy
+ *  element-wise arithmetic on Vectors of numbers (expression templates)
+ *
+ *  @author Leslie Aririguzo
+ *******************************************************************************/
+
+#ifndef VECTOR_EXPR_H
+#define VECTOR_EXPR_H 1
+
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "CustomVector.h"
+
+/*******************************************************************************
+ *  Including this header gives Vectors of arithmetic types element-wise
+ *  operators. They do not compute anything: a + b * c builds a small
+ *  expression object that refers to a, b and c, and the work happens when
+ *  the expression is assigned to a Vector,
+ *
+ *      custom::Vector<float> out(n);
+ *      out = custom::where(price > 0.f, custom::sqrt(volume) * price + bias, 0.f);
+ *      out += weight * 2.f;
+ *
+ *  in a single loop that reads each operand once, writes the destination
+ *  once and allocates nothing (unless the destination has to be resized).
+ *  The loop body is the whole expression inlined, so the compiler can
+ *  vectorize it (GCC does so from -O3; sqrt, exp and log also need
+ *  -fno-math-errno).
+ *
+ *  Operands are Vectors, other expressions, and scalars (broadcast, and
+ *  converted to the element type of the other operand so float stays
+ *  float). Provided are + - * / and unary -, the comparisons < <= > >=
+ *  (yielding bool masks), where(mask, x, y) and sqrt, abs, exp and log.
+ *  There is no element-wise == or !=; those operators are left free to
+ *  compare whole containers (Vector's own operator==).
+ *
+ *  Operands of one expression must have the same size
+ *  (std::invalid_argument otherwise). Expressions hold pointers to the
+ *  Vectors they read, so store one in a variable only while those Vectors
+ *  are alive and not resized.
+ *******************************************************************************/
+
+namespace custom
+{
+    namespace detail
+    {
+        template <class X>
+        struct is_arithmetic_vector : std::false_type
+        {
+        };
+
+        template <class T, class A>
+        struct is_arithmetic_vector<Vector<T, A>> : std::is_arithmetic<T>
+        {
+        };
+
+        template <class X>
+        concept expression_node = requires { typename X::expression_tag; };
+
+        // something an expression can be built on
+        template <class X>
+        concept expr_operand = is_arithmetic_vector<X>::value || expression_node<X>;
+
+        template <class X>
+        concept scalar_operand = std::is_arithmetic_v<X>;
+
+        template <class L, class R>
+        concept binary_operands = (expr_operand<L> && (expr_operand<R> || scalar_operand<R>)) ||
+                                  (scalar_operand<L> && expr_operand<R>);
+
+        /*******************************************************************************
+         * class VectorLeaf
+         *
+         *  @brief the elements of a Vector inside an expression
+         *******************************************************************************/
+        template <class T>
+        class VectorLeaf
+        {
+        public:
+            using expression_tag = void;
+            using value_type = T;
+            static constexpr bool is_scalar = false;
+
+            VectorLeaf(const T *data, size_t size) : m_data{data}, m_size{size} {}
+
+            size_t size() const noexcept { return m_size; }
+            T operator[](size_t i) const { return m_data[i]; }
+
+        private:
+            const T *m_data;
+            size_t m_size;
+        };
+
+        /*******************************************************************************
+         * class ScalarLeaf
+         *
+         *  @brief a scalar broadcast to every position
+         *******************************************************************************/
+        template <class T>
+        class ScalarLeaf
+        {
+        public:
+            using expression_tag = void;
+            using value_type = T;
+            static constexpr bool is_scalar = true;
+
+            explicit ScalarLeaf(T val) : m_val{val} {}
+
+            size_t size() const noexcept { return 0; }
+            T operator[](size_t) const { return m_val; }
+
+        private:
+            T m_val;
+        };
+
+        // the node representing x inside an expression
+        template <expr_operand X>
+        auto as_node(const X &x)
+        {
+            if constexpr (is_arithmetic_vector<X>::value)
+                return VectorLeaf<typename X::value_type>(x.data(), x.size());
+            else
+                return x;
+        }
+
+        template <class X>
+        using node_t = decltype(as_node(std::declval<const X &>()));
+
+        // a scalar next to an operand takes the operand's element type, unless
+        // that is a mask (bool)
+        template <class Node, scalar_operand S>
+        auto as_scalar_node(S val)
+        {
+            using V = typename Node::value_type;
+            using T = std::conditional_t<std::is_same_v<V, bool>, S, V>;
+
+            return ScalarLeaf<T>(static_cast<T>(val));
+        }
+
+        /*******************************************************************************
+         * common_size
+         *
+         * @return the size shared by the non-scalar nodes
+         * @throw std::invalid_argument if two of them differ
+         *******************************************************************************/
+        template <class... Nodes>
+        size_t common_size(const Nodes &...nodes)
+        {
+            size_t size = 0;
+            bool found = false;
+
+            auto check = [&](const auto &node)
+            {
+                if constexpr (!std::remove_cvref_t<decltype(node)>::is_scalar)
+                {
+                    if (found && node.size() != size)
+                        throw std::invalid_argument("VectorExpr: operand sizes differ");
+                    size = node.size();
+                    found = true;
+                }
+            };
+            (check(nodes), ...);
+
+            return size;
+        }
+
+        /*******************************************************************************
+         * class BinaryExpr
+         *
+         *  @brief Op applied to the elements of two nodes at the same position
+         *******************************************************************************/
+        template <class Op, class L, class R>
+        class BinaryExpr
+        {
+        public:
+            using expression_tag = void;
+            using value_type = decltype(Op{}(std::declval<typename L::value_type>(),
+                                             std::declval<typename R::value_type>()));
+            static constexpr bool is_scalar = false;
+
+            BinaryExpr(L left, R right)
+                : m_left{left}, m_right{right}, m_size{common_size(left, right)}
+            {
+            }
+
+            size_t size() const noexcept { return m_size; }
+            value_type operator[](size_t i) const { return Op{}(m_left[i], m_right[i]); }
+
+        private:
+            L m_left;
+            R m_right;
+            size_t m_size;
+        };
+
+        /*******************************************************************************
+         * class UnaryExpr
+         *
+         *  @brief Op applied to each element of a node
+         *******************************************************************************/
+        template <class Op, class E>
+        class UnaryExpr
+        {
+        public:
+            using expression_tag = void;
+            using value_type = decltype(Op{}(std::declval<typename E::value_type>()));
+            static constexpr bool is_scalar = false;
+
+            explicit UnaryExpr(E expr) : m_expr{expr} {}
+
+            size_t size() const noexcept { return m_expr.size(); }
+            value_type operator[](size_t i) const { return Op{}(m_expr[i]); }
+
+        private:
+            E m_expr;
+        };
+
+        // mask ? x : y without a branch
+        template <std::floating_point V>
+        V blend(bool mask, V x, V y) noexcept
+        {
+            if constexpr (sizeof(V) == 4 || sizeof(V) == 8)
+            {
+                using U = std::conditional_t<sizeof(V) == 4, std::uint32_t, std::uint64_t>;
+                U bits = -U(mask);
+
+                return std::bit_cast<V>(U((std::bit_cast<U>(x) & bits) | (std::bit_cast<U>(y) & ~bits)));
+            }
+            else
+                return mask ? x : y;
+        }
+
+        /*******************************************************************************
+         * class WhereExpr
+         *
+         *  @brief x where the mask is set, y elsewhere
+         *******************************************************************************/
+        template <class M, class X, class Y>
+        class WhereExpr
+        {
+        public:
+            using expression_tag = void;
+            using value_type = std::common_type_t<typename X::value_type, typename Y::value_type>;
+            static constexpr bool is_scalar = false;
+
+            WhereExpr(M mask, X x, Y y)
+                : m_mask{mask}, m_x{x}, m_y{y}, m_size{common_size(mask, x, y)}
+            {
+            }
+
+            size_t size() const noexcept { return m_size; }
+            value_type operator[](size_t i) const
+            {
+                bool mask = m_mask[i];
+
+                // floating point evaluates both sides without trapping, so
+                // pick with a bitwise blend the compiler can vectorize;
+                // integer sides (a division, say) are only evaluated if chosen
+                if constexpr (std::is_floating_point_v<typename X::value_type> &&
+                              std::is_floating_point_v<typename Y::value_type>)
+                    return blend(mask, value_type(m_x[i]), value_type(m_y[i]));
+                else
+                    return mask ? value_type(m_x[i]) : value_type(m_y[i]);
+            }
+
+        private:
+            M m_mask;
+            X m_x;
+            Y m_y;
+            size_t m_size;
+        };
+
+        /*******************************************************************************
+         * make_binary
+         *
+         * @brief build Op(l, r) from any mix of operands and one scalar
+         *******************************************************************************/
+        template <class Op, class L, class R>
+        auto make_binary(const L &l, const R &r)
+        {
+            if constexpr (scalar_operand<R>)
+            {
+                auto left = as_node(l);
+                auto right = as_scalar_node<decltype(left)>(r);
+                return BinaryExpr<Op, decltype(left), decltype(right)>(left, right);
+            }
+            else if constexpr (scalar_operand<L>)
+            {
+                auto right = as_node(r);
+                auto left = as_scalar_node<decltype(right)>(l);
+                return BinaryExpr<Op, decltype(left), decltype(right)>(left, right);
+            }
+            else
+                return BinaryExpr<Op, node_t<L>, node_t<R>>(as_node(l), as_node(r));
+        }
+
+        struct sqrt_op
+        {
+            template <class X>
+            auto operator()(X x) const { return std::sqrt(x); }
+        };
+
+        struct abs_op
+        {
+            template <class X>
+            auto operator()(X x) const
+            {
+                if constexpr (std::is_unsigned_v<X>)
+                    return x;
+                else
+                    return std::abs(x);
+            }
+        };
+
+        struct exp_op
+        {
+            template <class X>
+            auto operator()(X x) const { return std::exp(x); }
+        };
+
+        struct log_op
+        {
+            template <class X>
+            auto operator()(X x) const { return std::log(x); }
+        };
+
+        /*******************************************************************************
+         * compound_assign
+         *
+         * @brief dst[i] = Op(dst[i], rhs[i]) in a single loop
+         *
+         * @throw std::invalid_argument if rhs is not a scalar and differs in size
+         *******************************************************************************/
+        template <class Op, class T, class A, class R>
+        Vector<T, A> &compound_assign(Vector<T, A> &dst, const R &rhs)
+        {
+            auto node = [&]
+            {
+                if constexpr (scalar_operand<R>)
+                    return ScalarLeaf<T>(static_cast<T>(rhs));
+                else
+                    return as_node(rhs);
+            }();
+
+            if constexpr (!decltype(node)::is_scalar)
+                if (node.size() != dst.size())
+                    throw std::invalid_argument("VectorExpr: operand sizes differ");
+
+            T *out = dst.data();
+            for (size_t i = 0, n = dst.size(); i < n; ++i)
+                out[i] = static_cast<T>(Op{}(out[i], node[i]));
+
+            return dst;
+        }
+    }
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    ELEMENT-WISE OPERATORS  ---------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    template <class L, class R>
+        requires detail::binary_operands<L, R>
+    auto operator+(const L &l, const R &r) { return detail::make_binary<std::plus<>>(l, r); }
+
+    template <class L, class R>
+        requires detail::binary_operands<L, R>
+    auto operator-(const L &l, const R &r) { return detail::make_binary<std::minus<>>(l, r); }
+
+    template <class L, class R>
+        requires detail::binary_operands<L, R>
+    auto operator*(const L &l, const R &r) { return detail::make_binary<std::multiplies<>>(l, r); }
+
+    template <class L, class R>
+        requires detail::binary_operands<L, R>
+    auto operator/(const L &l, const R &r) { return detail::make_binary<std::divides<>>(l, r); }
+
+    template <class L, class R>
+        requires detail::binary_operands<L, R>
+    auto operator<(const L &l, const R &r) { return detail::make_binary<std::less<>>(l, r); }
+
+    template <class L, class R>
+        requires detail::binary_operands<L, R>
+    auto operator<=(const L &l, const R &r) { return detail::make_binary<std::less_equal<>>(l, r); }
+
+    template <class L, class R>
+        requires detail::binary_operands<L, R>
+    auto operator>(const L &l, const R &r) { return detail::make_binary<std::greater<>>(l, r); }
+
+    template <class L, class R>
+        requires detail::binary_operands<L, R>
+    auto operator>=(const L &l, const R &r) { return detail::make_binary<std::greater_equal<>>(l, r); }
+
+    template <detail::expr_operand E>
+    auto operator-(const E &expr)
+    {
+        return detail::UnaryExpr<std::negate<>, detail::node_t<E>>(detail::as_node(expr));
+    }
+
+    template <detail::expr_operand E>
+    auto sqrt(const E &expr)
+    {
+        return detail::UnaryExpr<detail::sqrt_op, detail::node_t<E>>(detail::as_node(expr));
+    }
+
+    template <detail::expr_operand E>
+    auto abs(const E &expr)
+    {
+        return detail::UnaryExpr<detail::abs_op, detail::node_t<E>>(detail::as_node(expr));
+    }
+
+    template <detail::expr_operand E>
+    auto exp(const E &expr)
+    {
+        return detail::UnaryExpr<detail::exp_op, detail::node_t<E>>(detail::as_node(expr));
+    }
+
+    template <detail::expr_operand E>
+    auto log(const E &expr)
+    {
+        return detail::UnaryExpr<detail::log_op, detail::node_t<E>>(detail::as_node(expr));
+    }
+
+    /*******************************************************************************
+     * where
+     *
+     * @brief element-wise select: x[i] where mask[i] is true, y[i] elsewhere
+     *
+     * @param mask operand whose elements convert to bool (a comparison, say)
+     * @param x operand or scalar
+     * @param y operand or scalar
+     *******************************************************************************/
+    template <detail::expr_operand M, class X, class Y>
+        requires(detail::expr_operand<X> || detail::scalar_operand<X>) &&
+                (detail::expr_operand<Y> || detail::scalar_operand<Y>)
+    auto where(const M &mask, const X &x, const Y &y)
+    {
+        auto node = [](const auto &operand, const auto &other)
+        {
+            using O = std::remove_cvref_t<decltype(operand)>;
+            using P = std::remove_cvref_t<decltype(other)>;
+
+            if constexpr (detail::expr_operand<O>)
+                return detail::as_node(operand);
+            else if constexpr (detail::expr_operand<P>)
+                return detail::as_scalar_node<detail::node_t<P>>(operand);
+            else
+                return detail::ScalarLeaf<std::common_type_t<O, P>>(operand);
+        };
+
+        auto x_node = node(x, y);
+        auto y_node = node(y, x);
+        auto m_node = detail::as_node(mask);
+
+        return detail::WhereExpr<decltype(m_node), decltype(x_node), decltype(y_node)>(m_node, x_node, y_node);
+    }
+
+    //--------------------------------------------------------------------------------------------
+    //-------------------------    COMPOUND ASSIGNMENT  ------------------------------------------
+    //--------------------------------------------------------------------------------------------
+
+    template <class T, class A, class R>
+        requires std::is_arithmetic_v<T> && (detail::expr_operand<R> || detail::scalar_operand<R>)
+    Vector<T, A> &operator+=(Vector<T, A> &dst, const R &rhs)
+    {
+        return detail::compound_assign<std::plus<>>(dst, rhs);
+    }
+
+    template <class T, class A, class R>
+        requires std::is_arithmetic_v<T> && (detail::expr_operand<R> || detail::scalar_operand<R>)
+    Vector<T, A> &operator-=(Vector<T, A> &dst, const R &rhs)
+    {
+        return detail::compound_assign<std::minus<>>(dst, rhs);
+    }
+
+    template <class T, class A, class R>
+        requires std::is_arithmetic_v<T> && (detail::expr_operand<R> || detail::scalar_operand<R>)
+    Vector<T, A> &operator*=(Vector<T, A> &dst, const R &rhs)
+    {
+        return detail::compound_assign<std::multiplies<>>(dst, rhs);
+    }
+
+    template <class T, class A, class R>
+        requires std::is_arithmetic_v<T> && (detail::expr_operand<R> || detail::scalar_operand<R>)
+    Vector<T, A> &operator/=(Vector<T, A> &dst, const R &rhs)
+    {
+        return detail::compound_assign<std::divides<>>(dst, rhs);
+    }
+}
+
+#endif // VECTOR_EXPR_H
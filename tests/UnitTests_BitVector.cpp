@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "BitVector.h"
+
+using namespace custom;
+
+//--------------------------------------------------------------------------------------------
+//---------------   class BitVector tests    -------------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(BitVectorTests, constructors)
+{
+    BitVector<> empty;
+    EXPECT_EQ(empty.size(), 0);
+    EXPECT_TRUE(empty.none());
+    EXPECT_TRUE(empty.all());
+
+    BitVector<> ones(70, true);
+    EXPECT_EQ(ones.size(), 70);
+    EXPECT_EQ(ones.word_count(), 2);
+    EXPECT_EQ(ones.count(), 70);
+    EXPECT_TRUE(ones.all());
+
+    BitVector<> list{true, false, true};
+    EXPECT_TRUE(list[0]);
+    EXPECT_FALSE(list[1]);
+    EXPECT_TRUE(list.at(2));
+    EXPECT_THROW(list.at(3), std::out_of_range);
+}
+
+TEST(BitVectorTests, packedStorage)
+{
+    BitVector<> bits(1000);
+    EXPECT_EQ(bits.word_count(), 16);
+    EXPECT_GE(bits.capacity(), 1000);
+}
+
+TEST(BitVectorTests, proxyReference)
+{
+    BitVector<> bits(10);
+
+    bits[3] = true;
+    bits[7] = bits[3];
+    EXPECT_TRUE(bits.test(3));
+    EXPECT_TRUE(bits.test(7));
+
+    bits[3].flip();
+    EXPECT_FALSE(bits[3]);
+    EXPECT_EQ(bits.count(), 1);
+}
+
+TEST(BitVectorTests, pushPopResize)
+{
+    BitVector<> bits;
+    for (int i = 0; i < 130; ++i)
+        bits.push_back(i % 3 == 0);
+
+    EXPECT_EQ(bits.size(), 130);
+    EXPECT_EQ(bits.count(), 44);
+
+    bits.pop_back();
+    bits.pop_back();
+    EXPECT_EQ(bits.size(), 128);
+    EXPECT_EQ(bits.word_count(), 2);
+
+    bits.resize(200, true);
+    EXPECT_EQ(bits.count(), 43 + 72);
+    EXPECT_TRUE(bits.test(199));
+
+    // shrinking drops the flags past the new size
+    bits.resize(10);
+    EXPECT_EQ(bits.count(), 4);
+    bits.resize(64);
+    EXPECT_EQ(bits.count(), 4);
+}
+
+TEST(BitVectorTests, anyAllNone)
+{
+    BitVector<> bits(1000);
+    EXPECT_TRUE(bits.none());
+    EXPECT_FALSE(bits.any());
+
+    bits.set(999);
+    EXPECT_TRUE(bits.any());
+    EXPECT_FALSE(bits.all());
+
+    bits.set();
+    EXPECT_TRUE(bits.all());
+    EXPECT_EQ(bits.count(), 1000);
+
+    bits.reset();
+    EXPECT_TRUE(bits.none());
+}
+
+TEST(BitVectorTests, findFirstNext)
+{
+    BitVector<> bits(300);
+    EXPECT_EQ(bits.find_first(), BitVector<>::npos);
+
+    bits.set(5);
+    bits.set(64);
+    bits.set(299);
+
+    EXPECT_EQ(bits.find_first(), 5);
+    EXPECT_EQ(bits.find_next(5), 64);
+    EXPECT_EQ(bits.find_next(64), 299);
+    EXPECT_EQ(bits.find_next(299), BitVector<>::npos);
+    EXPECT_EQ(bits.find_next(1000), BitVector<>::npos);
+}
+
+TEST(BitVectorTests, bitwiseOperations)
+{
+    BitVector<> a(100), b(100);
+    a.set(1);
+    a.set(50);
+    b.set(50);
+    b.set(99);
+
+    EXPECT_EQ((a & b).count(), 1);
+    EXPECT_EQ((a | b).count(), 3);
+    EXPECT_EQ((a ^ b).count(), 2);
+
+    // not keeps the unused tail bits cleared
+    BitVector<> inverted = ~a;
+    EXPECT_EQ(inverted.count(), 98);
+    EXPECT_FALSE(inverted.test(50));
+    EXPECT_EQ(~inverted, a);
+
+    BitVector<> c(99);
+    EXPECT_THROW(a &= c, std::invalid_argument);
+}
+
+TEST(BitVectorTests, iteration)
+{
+    BitVector<> bits{true, false, true, true};
+
+    int set_count = 0;
+    for (bool flag : bits)
+        set_count += flag;
+
+    EXPECT_EQ(set_count, 3);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "CachingAllocator.h"
+#include "CustomVector.h"
+
+using namespace custom;
+
+//--------------------------------------------------------------------------------------------
+//---------------   class CachingAllocator tests    ------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(CachingAllocatorTests, reuseReleasedBlock)
+{
+    CachingAllocator<int> alloc;
+    BlockCacheStats before = BlockCache::thread_stats();
+
+    int *first = alloc.allocate(100);
+    alloc.deallocate(first, 100);
+
+    // same size class, so the block comes straight back
+    int *second = alloc.allocate(120);
+    EXPECT_EQ(first, second);
+    alloc.deallocate(second, 120);
+
+    BlockCacheStats after = BlockCache::thread_stats();
+    EXPECT_EQ(after.hits, before.hits + 1);
+}
+
+TEST(CachingAllocatorTests, vectorLoopHitsCache)
+{
+    using CachedVector = Vector<double, CachingAllocator<double>>;
+    {
+        CachedVector warm(64, 1.0);
+    }
+    BlockCacheStats before = BlockCache::thread_stats();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        CachedVector scratch(64, i);
+        EXPECT_EQ(scratch[63], i);
+    }
+
+    BlockCacheStats after = BlockCache::thread_stats();
+    EXPECT_EQ(after.hits - before.hits, 100);
+    EXPECT_EQ(after.misses, before.misses);
+}
+
+TEST(CachingAllocatorTests, budgetBoundsCache)
+{
+    CachingAllocator<char> alloc;
+    BlockCache::trim();
+    BlockCache::set_thread_budget(4096);
+
+    char *blocks[4];
+    for (char *&block : blocks)
+        block = alloc.allocate(2048);
+    for (char *block : blocks)
+        alloc.deallocate(block, 2048);
+
+    // only two 2 KiB blocks fit, the rest went to the central depot
+    EXPECT_EQ(BlockCache::thread_stats().bytes_cached, 4096);
+    EXPECT_GE(BlockCache::central_stats().bytes_cached, 4096);
+
+    BlockCache::set_thread_budget(0);
+    EXPECT_EQ(BlockCache::thread_stats().bytes_cached, 0);
+    BlockCache::set_thread_budget(BlockCache::default_thread_budget);
+}
+
+TEST(CachingAllocatorTests, crossThreadReturn)
+{
+    CachingAllocator<int> alloc;
+    BlockCache::trim();
+    size_t central_hits = BlockCache::central_stats().central_hits;
+
+    // a block freed by an exiting thread lands in the central depot ...
+    int *block = nullptr;
+    std::thread producer([&]
+                         { block = alloc.allocate(1000); });
+    producer.join();
+
+    std::thread consumer([&]
+                         { alloc.deallocate(block, 1000); });
+    consumer.join();
+
+    // ... where another thread can pick it up
+    int *reused = alloc.allocate(1000);
+    EXPECT_EQ(reused, block);
+    EXPECT_EQ(BlockCache::central_stats().central_hits, central_hits + 1);
+    alloc.deallocate(reused, 1000);
+}
+
+TEST(CachingAllocatorTests, largeBlocksBypassCache)
+{
+    CachingAllocator<char> alloc;
+    BlockCacheStats before = BlockCache::thread_stats();
+
+    char *big = alloc.allocate(BlockCache::max_block_bytes + 1);
+    big[0] = 'x';
+    alloc.deallocate(big, BlockCache::max_block_bytes + 1);
+
+    BlockCacheStats after = BlockCache::thread_stats();
+    EXPECT_EQ(after.hits, before.hits);
+    EXPECT_EQ(after.misses, before.misses);
+    EXPECT_EQ(after.bytes_cached, before.bytes_cached);
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "CircularVector.h"
+
+using namespace custom;
+
+//--------------------------------------------------------------------------------------------
+//---------------   class CircularVector tests    --------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(CircularVectorTests, fifoWrapsWithoutGrowing)
+{
+    CircularVector<int> ring(4);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ring.push_back(i);
+        if (ring.size() == 3)
+            ring.pop_front();
+    }
+
+    // the window slid 100 times through the same 4-element block
+    EXPECT_EQ(ring.capacity(), 4);
+    EXPECT_EQ(ring.size(), 2);
+    EXPECT_EQ(ring.front(), 98);
+    EXPECT_EQ(ring.back(), 99);
+    EXPECT_THROW(ring.at(2), std::out_of_range);
+}
+
+TEST(CircularVectorTests, bothEndsAndRandomAccess)
+{
+    CircularVector<std::string> ring;
+    ring.push_back("c");
+    ring.push_front("b");
+    ring.push_back("d");
+    ring.push_front("a");
+
+    ASSERT_EQ(ring.size(), 4);
+    for (size_t i = 0; i < ring.size(); ++i)
+        EXPECT_EQ(ring[i], std::string(1, 'a' + i));
+
+    ring.pop_back();
+    ring.pop_front();
+    EXPECT_EQ(ring.front(), "b");
+    EXPECT_EQ(ring.back(), "c");
+
+    ring.pop_back();
+    ring.pop_back();
+    EXPECT_TRUE(ring.empty());
+    EXPECT_THROW(ring.pop_front(), std::out_of_range);
+}
+
+TEST(CircularVectorTests, growthLinearizes)
+{
+    CircularVector<int> ring(4);
+    ring.push_back(2);
+    ring.push_back(3);
+    ring.push_front(1);
+    ring.push_front(0);
+
+    // wrapped: [2 3 | 0 1]
+    auto [first, second] = ring.as_spans();
+    EXPECT_EQ(first.size(), 2);
+    EXPECT_EQ(second.size(), 2);
+
+    // growing moves the elements once, in order, to a doubled block
+    ring.push_back(4);
+    EXPECT_EQ(ring.capacity(), 8);
+    EXPECT_TRUE(ring.as_spans().second.empty());
+    for (int i = 0; i < 5; ++i)
+        EXPECT_EQ(ring[i], i);
+
+    ring.push_front(-1);
+    EXPECT_EQ(ring.front(), -1);
+    EXPECT_EQ(ring.size(), 6);
+}
+
+TEST(CircularVectorTests, overwriteOldest)
+{
+    using Ring = CircularVector<int>;
+    Ring window(3, Ring::Overflow::overwrite_oldest);
+
+    for (int i = 1; i <= 5; ++i)
+        window.push_back(i);
+
+    EXPECT_EQ(window.size(), 3);
+    EXPECT_EQ(window.capacity(), 3);
+    EXPECT_EQ(window[0], 3);
+    EXPECT_EQ(window[2], 5);
+
+    // args referring to an element being replaced still work
+    window.push_back(window.front());
+    EXPECT_EQ(window.back(), 3);
+    EXPECT_EQ(window.front(), 4);
+
+    // push_front drops the back instead
+    window.push_front(0);
+    EXPECT_EQ(window.front(), 0);
+    EXPECT_EQ(window.back(), 5);
+
+    EXPECT_THROW(Ring(0, Ring::Overflow::overwrite_oldest), std::invalid_argument);
+}
+
+TEST(CircularVectorTests, spansLinearizeAndCopy)
+{
+    CircularVector<int> ring(5);
+    for (int i = 0; i < 5; ++i)
+        ring.push_back(i);
+    ring.pop_front();
+    ring.pop_front();
+    ring.push_back(5);
+    ring.push_back(6);
+
+    size_t total = ring.as_spans().first.size() + ring.as_spans().second.size();
+    EXPECT_EQ(total, 5);
+
+    CircularVector<int> copy(ring);
+    EXPECT_TRUE(copy.as_spans().second.empty());
+
+    std::span<int> flat = ring.linearize();
+    ASSERT_EQ(flat.size(), 5);
+    for (int i = 0; i < 5; ++i)
+        EXPECT_EQ(flat[i], i + 2);
+
+    int expected = 2;
+    for (int num : copy)
+        EXPECT_EQ(num, expected++);
+    EXPECT_EQ(copy.end() - copy.begin(), 5);
+
+    CircularVector<int> moved(std::move(copy));
+    EXPECT_EQ(moved.size(), 5);
+    EXPECT_TRUE(copy.empty());
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include "CompressedVector.h"
+#include "CustomVector.h"
+
+using namespace custom;
+
+//--------------------------------------------------------------------------------------------
+//---------------   class CompressedVector tests    ------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(CompressedVectorTests, sortedIdsUseDelta)
+{
+    CompressedVector<std::uint64_t> ids;
+    for (std::uint64_t id = 1000000; id < 1000000 + 3 * 128 + 17; ++id)
+        ids.push_back(id * 3);
+
+    EXPECT_EQ(ids.size(), 3 * 128 + 17);
+    EXPECT_EQ(ids.block_count(), 4);
+    EXPECT_EQ(ids.block_encoding(0), CompressedVector<std::uint64_t>::Encoding::delta);
+    EXPECT_EQ(ids.block_bits(0), 2);
+
+    for (size_t i = 0; i < ids.size(); ++i)
+        ASSERT_EQ(ids[i], (1000000 + i) * 3);
+
+    // the 17 values in the tail are still uncompressed
+    EXPECT_EQ(ids.at(3 * 128 + 16), (1000000 + 3 * 128 + 16) * 3);
+    EXPECT_THROW(ids.at(ids.size()), std::out_of_range);
+}
+
+TEST(CompressedVectorTests, smallRangeUsesFrameOfReference)
+{
+    std::mt19937 gen(7);
+    Vector<std::int32_t> plain;
+    CompressedVector<std::int32_t> packed;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::int32_t val = -500 + static_cast<std::int32_t>(gen() % 1000);
+        plain.push_back(val);
+        packed.push_back(val);
+    }
+
+    EXPECT_EQ(packed.block_encoding(0), CompressedVector<std::int32_t>::Encoding::frame_of_reference);
+    EXPECT_LE(packed.block_bits(0), 10);
+
+    for (size_t i = 0; i < plain.size(); ++i)
+        ASSERT_EQ(packed[i], plain[i]);
+}
+
+TEST(CompressedVectorTests, extremesRoundTrip)
+{
+    CompressedVector<std::int64_t> values;
+    for (int i = 0; i < 256; ++i)
+        values.push_back(i % 2 ? std::numeric_limits<std::int64_t>::max() : std::numeric_limits<std::int64_t>::min());
+
+    EXPECT_EQ(values.block_bits(0), 64);
+    EXPECT_EQ(values[0], std::numeric_limits<std::int64_t>::min());
+    EXPECT_EQ(values[255], std::numeric_limits<std::int64_t>::max());
+
+    // a constant block needs no packed words at all
+    CompressedVector<std::uint16_t> constant;
+    for (int i = 0; i < 128; ++i)
+        constant.push_back(42);
+    EXPECT_EQ(constant.block_bits(0), 0);
+    EXPECT_EQ(constant[127], 42);
+}
+
+TEST(CompressedVectorTests, blockAndIteratorScans)
+{
+    CompressedVector<std::uint32_t> values;
+    std::uint64_t expected_sum = 0;
+    for (std::uint32_t i = 0; i < 1000; ++i)
+    {
+        values.push_back(i * i % 4093);
+        expected_sum += i * i % 4093;
+    }
+
+    std::uint64_t block_sum = 0;
+    size_t count = 0;
+    values.for_each_block([&](std::span<const std::uint32_t> block)
+                          {
+        count += block.size();
+        for (std::uint32_t val : block)
+            block_sum += val; });
+    EXPECT_EQ(count, 1000);
+    EXPECT_EQ(block_sum, expected_sum);
+
+    std::uint64_t iter_sum = 0;
+    for (std::uint32_t val : values)
+        iter_sum += val;
+    EXPECT_EQ(iter_sum, expected_sum);
+    EXPECT_EQ(std::distance(values.begin(), values.end()), 1000);
+
+    values.clear();
+    EXPECT_TRUE(values.empty());
+    EXPECT_EQ(values.begin(), values.end());
+}
+
+TEST(CompressedVectorTests, compressesTimestamps)
+{
+    std::mt19937_64 gen(3);
+    CompressedVector<std::uint64_t> stamps;
+    std::uint64_t now = 1700000000000000000ull;
+
+    for (int i = 0; i < 128 * 100; ++i)
+        stamps.push_back(now += gen() % 1000000);
+
+    // about 20 bits per value instead of 64
+    EXPECT_LT(stamps.memory_usage() * 2, stamps.size() * sizeof(std::uint64_t));
+}
@@ -1,6 +1,14 @@
 #include <gtest/gtest.h>
 #include <numeric>
 #include <memory>
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include "CustomVector.h"
 
 using namespace custom;
@@ -312,19 +320,36 @@ TEST(IteratorTests, iteratorEnd)
 
 TEST(IteratorTests, iteratorSequence)
 {
-    GTEST_SKIP() << "Not yet implemented";
+    Vector<int> vec{1, 2, 3, 4};
+
+    int expected = 1;
+    for (Vector<int>::Iterator itr = vec.begin(); itr != vec.end(); ++itr)
+        EXPECT_EQ(*itr, expected++);
+
+    expected = 4;
+    for (auto itr = vec.crbegin(); itr != vec.crend(); ++itr)
+        EXPECT_EQ(*itr, expected--);
 }
 
 TEST(IteratorTests, preFix)
 {
-    // + & -
-    GTEST_SKIP() << "Not yet implemented";
+    Vector<int> vec{1, 2, 3};
+    Vector<int>::Iterator itr = vec.begin();
+
+    EXPECT_EQ(*++itr, 2);
+    EXPECT_EQ(*++itr, 3);
+    EXPECT_EQ(*--itr, 2);
 }
 
 TEST(IteratorTests, postFix)
 {
-    // + & -
-    GTEST_SKIP() << "Not yet implemented";
+    Vector<int> vec{1, 2, 3};
+    Vector<int>::Iterator itr = vec.begin();
+
+    EXPECT_EQ(*itr++, 1);
+    EXPECT_EQ(*itr++, 2);
+    EXPECT_EQ(*itr--, 3);
+    EXPECT_EQ(*itr, 2);
 }
 
 TEST(IteratorTests, comparision)
@@ -338,23 +363,62 @@ TEST(IteratorTests, comparision)
     EXPECT_TRUE(a == b);
 }
 
-TEST(IteratorTests, TODO)
+TEST(IteratorTests, arithmeticAndComparison)
 {
-    /*
-    Other operations to test
-    +=
-    -=
-    itr += val
-    itr + 5
-    itr - 5
-
-    itr1 - itr2
-    itr1 == itr2
-    itr1 != itr2
-
-    const begin, end
-    */
-    GTEST_SKIP() << "Not yet implemented";
+    Vector<int> vec{10, 20, 30, 40, 50, 60};
+    Vector<int>::Iterator itr = vec.begin();
+
+    itr += 4;
+    EXPECT_EQ(*itr, 50);
+    itr -= 2;
+    EXPECT_EQ(*itr, 30);
+    EXPECT_EQ(*(itr + 2), 50);
+    EXPECT_EQ(*(2 + itr), 50);
+    EXPECT_EQ(*(itr - 2), 10);
+    EXPECT_EQ(itr[1], 40);
+
+    EXPECT_EQ(vec.end() - vec.begin(), 6);
+    EXPECT_TRUE(itr == vec.begin() + 2);
+    EXPECT_TRUE(itr != vec.begin());
+    EXPECT_TRUE(vec.begin() <= itr);
+    EXPECT_TRUE(vec.end() >= itr);
+
+    // const begin, end
+    const Vector<int> &cvec = vec;
+    Vector<int>::const_iterator citr = cvec.begin();
+    ++citr;
+    EXPECT_EQ(*citr, 20);
+    EXPECT_EQ(cvec.end() - citr, 5);
+
+    // iterator converts to const_iterator and compares with it
+    Vector<int>::const_iterator converted = itr;
+    EXPECT_TRUE(converted == itr);
+    EXPECT_TRUE(converted > cvec.begin());
+}
+
+TEST(IteratorTests, contiguousRange)
+{
+    using Iter = Vector<int>::iterator;
+    using ConstIter = Vector<int>::const_iterator;
+
+    static_assert(std::contiguous_iterator<Iter>);
+    static_assert(std::contiguous_iterator<ConstIter>);
+    static_assert(std::is_same_v<std::iter_reference_t<ConstIter>, const int &>);
+    static_assert(std::ranges::contiguous_range<Vector<int>>);
+    static_assert(std::ranges::contiguous_range<const Vector<int>>);
+    static_assert(std::ranges::sized_range<Vector<int>>);
+
+    Vector<int> vec{3, 1, 2};
+    EXPECT_EQ(std::ranges::data(vec), vec.data());
+    EXPECT_EQ(std::to_address(vec.end()), vec.data() + 3);
+
+    std::ranges::sort(vec);
+    EXPECT_EQ(vec[0], 1);
+    EXPECT_EQ(vec[2], 3);
+
+    Vector<int> dest(3, 0);
+    std::ranges::copy(vec, dest.begin());
+    EXPECT_TRUE(std::ranges::equal(vec, dest));
 }
 
 
@@ -586,3 +650,263 @@ TEST(AccessorTests, other)
 
     */
 }
+
+TEST_F(VectorTest, insertMiddle)
+{
+    auto insert_itr = vec_int.insert(vec_int.begin() + 2, 40);
+
+    EXPECT_EQ(*insert_itr, 40);
+    ASSERT_EQ(vec_int.size(), 6);
+    EXPECT_EQ(vec_int[1], 2);
+    EXPECT_EQ(vec_int[2], 40);
+    EXPECT_EQ(vec_int[3], 3);
+    EXPECT_EQ(vec_int[5], 5);
+
+    // inserting an element of the vector itself
+    vec_int.insert(vec_int.begin(), vec_int[5]);
+    EXPECT_EQ(vec_int[0], 5);
+    EXPECT_EQ(vec_int[6], 5);
+}
+
+TEST(ModifierTests, emplaceBack)
+{
+    Vector<std::string> v;
+
+    v.emplace_back(3, 'x');
+    std::string moved = "moved";
+    v.push_back(std::move(moved));
+
+    ASSERT_EQ(v.size(), 2);
+    EXPECT_EQ(v[0], "xxx");
+    EXPECT_EQ(v[1], "moved");
+}
+
+namespace
+{
+    // counts live objects; the copy or move that would exceed budget throws
+    struct Tracked
+    {
+        static inline int live = 0;
+        static inline int budget = 1 << 30;
+
+        int value;
+
+        Tracked(int v) : value(v) { ++live; }
+        Tracked(const Tracked &other) : value(other.value) { spend(); }
+        Tracked(Tracked &&other) : value(other.value) { spend(); }
+        ~Tracked() { --live; }
+
+        static void spend()
+        {
+            if (budget-- == 0)
+                throw std::runtime_error("budget spent");
+            ++live;
+        }
+    };
+}
+
+TEST(ModifierTests, emplaceBackThrowingGrowth)
+{
+    {
+        Vector<Tracked> v;
+        v.reserve(4);
+        for (int i = 0; i < 4; ++i)
+            v.emplace_back(i);
+
+        // the new element is built, then relocating the third old one throws
+        Tracked::budget = 2;
+        EXPECT_THROW(v.emplace_back(4), std::runtime_error);
+        Tracked::budget = 1 << 30;
+
+        EXPECT_EQ(v.size(), 4);
+        EXPECT_EQ(Tracked::live, 4);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+// Constant Evaluation
+namespace
+{
+    constexpr int sumOfSquares(int n)
+    {
+        Vector<int> v;
+        for (int i = 1; i <= n; ++i)
+            v.push_back(i * i);
+
+        int sum = 0;
+        for (int num : v)
+            sum += num;
+
+        return sum;
+    }
+
+    constexpr int afterModifiers()
+    {
+        Vector<int> v{5, 1, 4};
+        v.reserve(10);
+        v.insert(v.begin() + 1, 9);
+        v.erase(v.begin());
+        v.resize(5, 7);
+        v.pop_back();
+
+        Vector<int> copy(v);
+        Vector<int> moved(std::move(copy));
+        moved.assign(2, moved.back() + moved.front());
+
+        return moved[0] + static_cast<int>(moved.size());
+    }
+
+    constexpr auto makePrimes = []
+    {
+        Vector<int> primes;
+        for (int n = 2; primes.size() < 10; ++n)
+        {
+            bool is_prime = true;
+            for (int p : primes)
+                is_prime = is_prime && n % p != 0;
+            if (is_prime)
+                primes.push_back(n);
+        }
+        return primes;
+    };
+}
+
+TEST(ConstexprTests, constantEvaluation)
+{
+    static_assert(sumOfSquares(4) == 30);
+    static_assert(Vector<int>(3, 2).size() == 3);
+    static_assert(Vector<int>{1, 2, 3}.back() == 3);
+    static_assert(afterModifiers() == 18);
+}
+
+TEST(ConstexprTests, materialize)
+{
+    constexpr auto primes = materialize<makePrimes().size()>(makePrimes);
+
+    static_assert(primes.size() == 10);
+    static_assert(primes[0] == 2);
+    static_assert(primes[9] == 29);
+    EXPECT_EQ(primes[4], 11);
+}
+
+// Range Construction
+TEST(ConstructorTests, iteratorRangeConstructor)
+{
+    std::list<std::string> words{"a", "bb", "ccc"};
+    Vector<std::string> v(words.begin(), words.end());
+
+    ASSERT_EQ(v.size(), 3);
+    EXPECT_EQ(v.capacity(), 3);
+    EXPECT_EQ(v[2], "ccc");
+
+    // (n, val) must still select the fill constructor
+    Vector<int> filled(4, 9);
+    EXPECT_EQ(filled.size(), 4);
+    EXPECT_EQ(filled[3], 9);
+}
+
+TEST(ConstructorTests, fromRangeConstructor)
+{
+    Vector<int> squares(from_range, std::views::iota(1, 6) | std::views::transform([](int i)
+                                                                                  { return i * i; }));
+    ASSERT_EQ(squares.size(), 5);
+    EXPECT_EQ(squares.capacity(), 5);
+    EXPECT_EQ(squares[4], 25);
+
+    // a single pass input range grows geometrically
+    std::istringstream input("4 5 6");
+    Vector<int> parsed(from_range, std::views::istream<int>(input));
+    ASSERT_EQ(parsed.size(), 3);
+    EXPECT_EQ(parsed[0], 4);
+    EXPECT_EQ(parsed[2], 6);
+}
+
+TEST(ModifierTests, appendRange)
+{
+    Vector<int> all;
+    Vector<int> part_a{1, 2, 3};
+    std::vector<int> part_b{4, 5};
+    std::list<int> part_c{6};
+
+    all.append_range(part_a);
+    all.append_range(part_b);
+    all.append(part_c.begin(), part_c.end());
+    all.append_range(Vector<int>());
+
+    ASSERT_EQ(all.size(), 6);
+    for (int i = 0; i < 6; ++i)
+        EXPECT_EQ(all[i], i + 1);
+
+    // repeated appends grow geometrically, not one element at a time
+    Vector<int> grown;
+    for (int i = 0; i < 100; ++i)
+        grown.append_range(part_b);
+    EXPECT_EQ(grown.size(), 200);
+    EXPECT_LT(grown.capacity(), 400);
+}
+
+TEST(ModifierTests, appendRangeThrowingCopy)
+{
+    {
+        Vector<Tracked> v;
+        v.emplace_back(0);
+        std::vector<Tracked> more{1, 2, 3, 4};
+
+        // the first two copies land in v's storage, the third throws
+        Tracked::budget = 2;
+        EXPECT_THROW(v.append_range(more), std::runtime_error);
+        Tracked::budget = 1 << 30;
+
+        EXPECT_EQ(v.size(), 1);
+        EXPECT_EQ(Tracked::live, 5);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+TEST(ModifierTests, shrinkToFit)
+{
+    Vector<std::string> v;
+    v.reserve(100);
+    for (int i = 0; i < 10; ++i)
+        v.push_back(std::to_string(i));
+
+    v.shrink_to_fit();
+    ASSERT_EQ(v.size(), 10);
+    EXPECT_EQ(v.capacity(), 10);
+    EXPECT_EQ(v[9], "9");
+
+    v.clear();
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 0);
+    EXPECT_EQ(v.data(), nullptr);
+}
+
+TEST(ModifierTests, dedup)
+{
+    Vector<int> sorted{1, 1, 2, 3, 3, 3, 7};
+    EXPECT_EQ(sorted.unique_sorted(), 3);
+    EXPECT_EQ(sorted, (Vector<int>{1, 2, 3, 7}));
+
+    // first occurrences are kept, in their order
+    Vector<std::string> words{"b", "a", "b", "c", "a", "b"};
+    EXPECT_EQ(words.unique_unsorted(), 3);
+    EXPECT_EQ(words, (Vector<std::string>{"b", "a", "c"}));
+
+    Vector<int> mixed(100000);
+    for (int i = 0; i < 100000; ++i)
+        mixed[i] = (i * 7919) % 1000;
+    EXPECT_EQ(mixed.dedup(), 99000);
+    ASSERT_EQ(mixed.size(), 1000);
+    EXPECT_EQ(mixed[0], 0);
+    EXPECT_EQ(mixed[1], 919);
+    std::sort(mixed.begin(), mixed.end());
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(mixed[i], i);
+
+    // an already sorted vector takes the sorted pass
+    EXPECT_EQ(mixed.dedup(), 0);
+    EXPECT_EQ(mixed.size(), 1000);
+
+    Vector<double> empty;
+    EXPECT_EQ(empty.dedup(), 0);
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "FlatMap.h"
+
+using namespace custom;
+
+//--------------------------------------------------------------------------------------------
+//---------------   class FlatMap tests    ---------------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(FlatMapTests, insertAndFind)
+{
+    FlatMap<std::string, int> m;
+
+    EXPECT_TRUE(m.insert({"b", 2}).second);
+    EXPECT_TRUE(m.insert({"a", 1}).second);
+    EXPECT_FALSE(m.insert({"a", 100}).second);
+
+    ASSERT_EQ(m.size(), 2);
+    EXPECT_EQ(m.at("a"), 1);
+    EXPECT_EQ(m.begin()->first, "a");
+    EXPECT_TRUE(m.contains("b"));
+    EXPECT_EQ(m.find("c"), m.end());
+    EXPECT_THROW(m.at("c"), std::out_of_range);
+}
+
+TEST(FlatMapTests, subscriptAndAssign)
+{
+    FlatMap<int, std::string> m;
+
+    m[3] = "three";
+    m[1] = "one";
+    EXPECT_EQ(m[3], "three");
+    EXPECT_EQ(m.size(), 2);
+
+    EXPECT_FALSE(m.insert_or_assign(3, "drei").second);
+    EXPECT_EQ(m.at(3), "drei");
+
+    EXPECT_EQ(m.erase(1), 1);
+    EXPECT_FALSE(m.contains(1));
+}
+
+TEST(FlatMapTests, insertBatch)
+{
+    FlatMap<int, int> m{{10, 1}, {30, 3}};
+
+    std::vector<std::pair<int, int>> batch{{20, 2}, {40, 4}, {10, 99}, {20, 98}, {0, 0}};
+    EXPECT_EQ(m.insert_batch(batch.begin(), batch.end()), 3);
+
+    ASSERT_EQ(m.size(), 5);
+    int expected_key = 0;
+    for (auto &[key, val] : m)
+    {
+        EXPECT_EQ(key, expected_key);
+        expected_key += 10;
+    }
+
+    // existing values and the first occurrence in the batch win
+    EXPECT_EQ(m.at(10), 1);
+    EXPECT_EQ(m.at(20), 2);
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "GatherScatter.h"
+
+using namespace custom;
+
+namespace
+{
+    template <class I>
+    Vector<I> random_indices(std::size_t n, std::size_t bound, unsigned seed)
+    {
+        std::mt19937 gen(seed);
+        Vector<I> idx(n);
+        for (std::size_t i = 0; i < n; ++i)
+            idx.data()[i] = static_cast<I>(gen() % bound);
+        return idx;
+    }
+
+    template <class T>
+    Vector<T> iota_vector(std::size_t n)
+    {
+        Vector<T> v(n);
+        for (std::size_t i = 0; i < n; ++i)
+            v.data()[i] = static_cast<T>(i * 3 + 1);
+        return v;
+    }
+
+    template <class T, class I>
+    void expect_take_matches(std::size_t n, std::size_t count)
+    {
+        Vector<T> src = iota_vector<T>(n);
+        Vector<I> idx = random_indices<I>(count, n, 11);
+
+        Vector<T> out = take(src, idx);
+        ASSERT_EQ(out.size(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            ASSERT_EQ(out.data()[i], src.data()[idx.data()[i]]);
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+//---------------   gather / scatter / permutation / compress tests    -----------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(GatherScatterTests, takeGathersEveryElementType)
+{
+    // sizes that leave a tail after whole vectors, and sources past the prefetch threshold
+    expect_take_matches<std::uint32_t, std::uint32_t>(1000, 1003);
+    expect_take_matches<std::int64_t, std::int32_t>(1000, 77);
+    expect_take_matches<float, std::uint64_t>(1000, 129);
+    expect_take_matches<double, std::size_t>(1 << 20, 5000);
+    expect_take_matches<std::uint32_t, std::uint32_t>(1 << 20, 5000);
+    expect_take_matches<std::uint16_t, int>(1000, 100);
+
+    Vector<std::string> words{"zero", "one", "two"};
+    Vector<int> idx{2, 2, 0};
+    Vector<std::string> picked = take(words, idx);
+    EXPECT_TRUE(std::ranges::equal(picked, Vector<std::string>{"two", "two", "zero"}));
+
+    EXPECT_TRUE(take(words, Vector<int>{}).empty());
+    EXPECT_THROW(take(words, Vector<int>{0, 3}), std::out_of_range);
+    EXPECT_THROW(take(words, Vector<int>{-1}), std::out_of_range);
+}
+
+TEST(GatherScatterTests, scatterWritesInOrder)
+{
+    Vector<std::uint64_t> dest(100, 0);
+    Vector<std::uint32_t> idx = random_indices<std::uint32_t>(1000, 100, 5);
+    Vector<std::uint64_t> values = iota_vector<std::uint64_t>(1000);
+
+    scatter(dest, idx, values);
+
+    // the last value written to each position wins
+    Vector<std::uint64_t> expected(100, 0);
+    for (std::size_t i = 0; i < 1000; ++i)
+        expected.data()[idx.data()[i]] = values.data()[i];
+    EXPECT_TRUE(std::ranges::equal(dest, expected));
+
+    Vector<float> big(1 << 20, 0.f);
+    Vector<std::int64_t> far = random_indices<std::int64_t>(3000, 1 << 20, 9);
+    Vector<float> ones(3000, 1.f);
+    scatter(big, far, ones);
+    for (std::size_t i = 0; i < 3000; ++i)
+        ASSERT_EQ(big.data()[far.data()[i]], 1.f);
+
+    EXPECT_THROW(scatter(dest, Vector<int>{1, 2}, Vector<std::uint64_t>{1}), std::invalid_argument);
+    EXPECT_THROW(scatter(dest, Vector<int>{100}, Vector<std::uint64_t>{1}), std::out_of_range);
+}
+
+TEST(GatherScatterTests, applyPermutationInPlace)
+{
+    std::mt19937 gen(3);
+    Vector<std::uint32_t> perm(1000);
+    std::iota(perm.begin(), perm.end(), 0u);
+    std::shuffle(perm.begin(), perm.end(), gen);
+
+    Vector<std::string> names;
+    for (int i = 0; i < 1000; ++i)
+        names.push_back("name" + std::to_string(i));
+
+    Vector<std::string> expected = take(names, perm);
+    apply_permutation(names, perm);
+    EXPECT_TRUE(std::ranges::equal(names, expected));
+
+    // identity and a single swap
+    Vector<int> small{10, 20, 30};
+    apply_permutation(small, Vector<int>{0, 1, 2});
+    EXPECT_TRUE(std::ranges::equal(small, Vector<int>{10, 20, 30}));
+    apply_permutation(small, Vector<int>{2, 1, 0});
+    EXPECT_TRUE(std::ranges::equal(small, Vector<int>{30, 20, 10}));
+
+    // invalid permutations are rejected before anything moves
+    EXPECT_THROW(apply_permutation(small, Vector<int>{0, 0, 1}), std::invalid_argument);
+    EXPECT_THROW(apply_permutation(small, Vector<int>{0, 1, 3}), std::invalid_argument);
+    EXPECT_THROW(apply_permutation(small, Vector<int>{0, 1}), std::invalid_argument);
+    EXPECT_TRUE(std::ranges::equal(small, Vector<int>{30, 20, 10}));
+}
+
+TEST(GatherScatterTests, compressByBitsAndFlags)
+{
+    std::mt19937 gen(4);
+    constexpr std::size_t n = 1000;
+
+    BitVector<> bits(n);
+    Vector<std::uint8_t> flags(n, 0);
+    for (std::size_t i = 0; i < n; ++i)
+        if (gen() % 3 == 0)
+        {
+            bits.set(i);
+            flags.data()[i] = 1;
+        }
+    // a dense run and an empty run of whole words
+    for (std::size_t i = 128; i < 256; ++i)
+    {
+        bits.set(i);
+        flags.data()[i] = 7;
+    }
+    for (std::size_t i = 256; i < 384; ++i)
+    {
+        bits.reset(i);
+        flags.data()[i] = 0;
+    }
+
+    Vector<std::uint32_t> u32 = iota_vector<std::uint32_t>(n);
+    Vector<double> f64 = iota_vector<double>(n);
+    Vector<std::string> text;
+    for (std::size_t i = 0; i < n; ++i)
+        text.push_back(std::to_string(i));
+
+    Vector<std::uint32_t> expected_u32;
+    Vector<double> expected_f64;
+    Vector<std::string> expected_text;
+    for (std::size_t i = 0; i < n; ++i)
+        if (bits.test(i))
+        {
+            expected_u32.push_back(u32.data()[i]);
+            expected_f64.push_back(f64.data()[i]);
+            expected_text.push_back(text.data()[i]);
+        }
+
+    EXPECT_TRUE(std::ranges::equal(compress(u32, bits), expected_u32));
+    EXPECT_TRUE(std::ranges::equal(compress(f64, bits), expected_f64));
+    EXPECT_TRUE(std::ranges::equal(compress(text, bits), expected_text));
+    EXPECT_TRUE(std::ranges::equal(compress(u32, flags), expected_u32));
+    EXPECT_TRUE(std::ranges::equal(compress(f64, flags), expected_f64));
+    EXPECT_TRUE(std::ranges::equal(compress(text, flags), expected_text));
+
+    EXPECT_TRUE(compress(u32, BitVector<>(n)).empty());
+    EXPECT_TRUE(std::ranges::equal(compress(u32, BitVector<>(n, true)), u32));
+    EXPECT_THROW(compress(u32, BitVector<>(n - 1)), std::invalid_argument);
+    EXPECT_THROW(compress(u32, Vector<bool>(n + 1)), std::invalid_argument);
+}
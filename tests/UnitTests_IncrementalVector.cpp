@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "IncrementalVector.h"
+
+using namespace custom;
+
+namespace
+{
+    // counts blocks whose middle element was wiped before they came back
+    int wiped_blocks = 0;
+
+    template <class T>
+    struct Checking_Allocator
+    {
+        using value_type = T;
+        using size_type = std::size_t;
+
+        Checking_Allocator() = default;
+        template <class U>
+        Checking_Allocator(const Checking_Allocator<U> &) noexcept {}
+
+        T *allocate(size_type n) { return std::allocator<T>().allocate(n); }
+        void deallocate(T *block, size_type n) noexcept
+        {
+            // element i holds i in every block the test fills
+            if (n >= 2 && block[n / 2 - 1] != static_cast<T>(n / 2 - 1))
+                ++wiped_blocks;
+            std::allocator<T>().deallocate(block, n);
+        }
+
+        friend bool operator==(const Checking_Allocator &, const Checking_Allocator &) noexcept { return true; }
+    };
+}
+
+//--------------------------------------------------------------------------------------------
+//---------------   class IncrementalVector tests    -----------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(IncrementalVectorTests, indexingDuringMigration)
+{
+    IncrementalVector<int> nums;
+    nums.set_migration_step(2);
+    EXPECT_THROW(nums.at(0), std::out_of_range);
+
+    for (int i = 0; i < 8; ++i)
+        nums.push_back(i);
+    EXPECT_EQ(nums.capacity(), 8);
+    EXPECT_FALSE(nums.migrating());
+
+    // growth allocates 16 and moves two elements per append
+    nums.push_back(8);
+    EXPECT_EQ(nums.capacity(), 16);
+    EXPECT_TRUE(nums.migrating());
+
+    for (int i = 0; i < 9; ++i)
+        EXPECT_EQ(nums[i], i);
+
+    nums.push_back(9);
+    nums.push_back(10);
+    nums.push_back(11);
+    EXPECT_FALSE(nums.migrating());
+
+    EXPECT_EQ(nums.size(), 12);
+    EXPECT_EQ(nums.front(), 0);
+    EXPECT_EQ(nums.back(), 11);
+    EXPECT_TRUE(std::is_sorted(nums.begin(), nums.end()));
+}
+
+TEST(IncrementalVectorTests, migrationFinishesBeforeNextGrowth)
+{
+    IncrementalVector<std::string> words;
+    words.set_migration_step(1);
+
+    // with a step of one the old block empties exactly as the new one fills
+    for (int i = 0; i < 10000; ++i)
+    {
+        if (words.size() == words.capacity())
+        {
+            ASSERT_FALSE(words.migrating());
+        }
+        words.push_back(std::to_string(i));
+    }
+
+    for (int i = 0; i < 10000; ++i)
+        ASSERT_EQ(words[i], std::to_string(i));
+}
+
+TEST(IncrementalVectorTests, popClearAndReserveWhileMigrating)
+{
+    IncrementalVector<std::string> words;
+    words.set_migration_step(1);
+    for (int i = 0; i < 9; ++i)
+        words.push_back(std::string(20, char('a' + i)));
+    ASSERT_TRUE(words.migrating());
+
+    // pop back into the elements still waiting in the old block
+    while (words.size() > 3)
+        words.pop_back();
+    EXPECT_TRUE(words.migrating());
+    EXPECT_EQ(words[0], std::string(20, 'a'));
+    EXPECT_EQ(words.back(), std::string(20, 'c'));
+
+    words.pop_back();
+    words.pop_back();
+    EXPECT_FALSE(words.migrating());
+    words.push_back(std::string(20, 'b'));
+    words.push_back(std::string(20, 'c'));
+
+    for (int i = 0; i < 20; ++i)
+        words.push_back(words.front());
+    EXPECT_EQ(words[22], std::string(20, 'a'));
+
+    words.reserve(100);
+    EXPECT_FALSE(words.migrating());
+    EXPECT_EQ(words.capacity(), 100);
+    EXPECT_EQ(words[1], std::string(20, 'b'));
+
+    IncrementalVector<std::string> copy(words);
+    words.clear();
+    EXPECT_TRUE(words.empty());
+    EXPECT_THROW(words.pop_back(), std::out_of_range);
+    EXPECT_EQ(copy.size(), 23);
+    EXPECT_EQ(copy[2], std::string(20, 'c'));
+}
+
+TEST(IncrementalVectorTests, failedMigrationKeepsElements)
+{
+    static int copies = 0;
+
+    // copyable only, so migration copies and may fail
+    struct Fragile
+    {
+        explicit Fragile(int v) : value{v} {}
+        Fragile(const Fragile &other) : value{other.value}
+        {
+            if (++copies == 3)
+                throw std::runtime_error("copy failed");
+        }
+        int value;
+    };
+
+    IncrementalVector<Fragile> items;
+    items.set_migration_step(4);
+    for (int i = 0; i < 8; ++i)
+        items.emplace_back(i);
+
+    EXPECT_THROW(items.emplace_back(8), std::runtime_error);
+    EXPECT_EQ(items.size(), 8);
+    EXPECT_TRUE(items.migrating());
+    for (int i = 0; i < 8; ++i)
+        EXPECT_EQ(items[i].value, i);
+
+    items.emplace_back(8);
+    items.finish_migration();
+    EXPECT_FALSE(items.migrating());
+    EXPECT_EQ(items[8].value, 8);
+    EXPECT_EQ(items[3].value, 3);
+}
+
+TEST(IncrementalVectorTests, foreignAllocatorBlocksUntouched)
+{
+    // a 1 MiB old block spans whole release granules, which a page-backed
+    // allocator would have dropped during the migration
+    {
+        IncrementalVector<int, Checking_Allocator<int>> nums;
+        for (int i = 0; i < 300000; ++i)
+            nums.push_back(i);
+        nums.finish_migration();
+        EXPECT_EQ(nums[123456], 123456);
+    }
+    EXPECT_EQ(wiped_blocks, 0);
+
+    static_assert(detail::page_backed_allocator<std::allocator<int>>);
+    static_assert(!detail::page_backed_allocator<Checking_Allocator<int>>);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "CustomVector.h"
+#include "MallocAllocator.h"
+#include "NumaAllocator.h"
+
+using namespace custom;
+
+namespace
+{
+    // hands out garbage from allocate and counts allocate_zeroed calls
+    struct ZeroedCounts
+    {
+        int zeroed = 0;
+        int plain = 0;
+    };
+
+    template <class T>
+    struct RecordingAllocator
+    {
+        using value_type = T;
+        using size_type = std::size_t;
+
+        explicit RecordingAllocator(ZeroedCounts *counts) : counts{counts} {}
+        template <class U>
+        RecordingAllocator(const RecordingAllocator<U> &other) : counts{other.counts} {}
+
+        T *allocate(std::size_t n)
+        {
+            ++counts->plain;
+            T *block = static_cast<T *>(std::malloc(n * sizeof(T)));
+            std::memset(static_cast<void *>(block), 0xAB, n * sizeof(T));
+            return block;
+        }
+        T *allocate_zeroed(std::size_t n)
+        {
+            ++counts->zeroed;
+            return static_cast<T *>(std::calloc(n, sizeof(T)));
+        }
+        void deallocate(T *block, std::size_t) noexcept { std::free(block); }
+
+        template <class U>
+        bool operator==(const RecordingAllocator<U> &other) const { return counts == other.counts; }
+
+        ZeroedCounts *counts;
+    };
+}
+
+//--------------------------------------------------------------------------------------------
+//---------------   zeroed allocation tests    -----------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(ZeroedAllocationTests, sizeConstructorUsesZeroedBlock)
+{
+    ZeroedCounts counts;
+    RecordingAllocator<long> alloc(&counts);
+
+    Vector<long, RecordingAllocator<long>> zeros(1000, alloc);
+    EXPECT_EQ(counts.zeroed, 1);
+    EXPECT_EQ(counts.plain, 0);
+    for (long value : zeros)
+        ASSERT_EQ(value, 0);
+
+    // an explicit value still fills
+    Vector<long, RecordingAllocator<long>> sevens(10, 7, alloc);
+    EXPECT_EQ(counts.plain, 1);
+    EXPECT_EQ(sevens[9], 7);
+
+    // non-scalar types are value-initialized the usual way
+    Vector<std::string> words(3);
+    EXPECT_EQ(words[2], "");
+}
+
+TEST(ZeroedAllocationTests, resizeGrowsIntoZeroedBlock)
+{
+    ZeroedCounts counts;
+    RecordingAllocator<int> alloc(&counts);
+
+    Vector<int, RecordingAllocator<int>> nums({1, 2, 3}, alloc);
+    nums.resize(1000);
+    EXPECT_EQ(counts.zeroed, 1);
+    ASSERT_EQ(nums.size(), 1000);
+    EXPECT_EQ(nums[2], 3);
+    for (size_t i = 3; i < nums.size(); ++i)
+        ASSERT_EQ(nums[i], 0);
+
+    // within capacity the stale tail has to be cleared explicitly
+    nums[500] = 9;
+    nums.resize(1);
+    nums.resize(1000);
+    EXPECT_EQ(counts.zeroed, 1);
+    EXPECT_EQ(nums[0], 1);
+    EXPECT_EQ(nums[500], 0);
+    EXPECT_EQ(nums[1], 0);
+}
+
+TEST(ZeroedAllocationTests, mallocAndNumaAllocators)
+{
+    Vector<double, MallocAllocator<double>> small(16);
+    EXPECT_EQ(small[15], 0.0);
+
+    // large enough for calloc and the NUMA allocator to use fresh mappings
+    constexpr size_t big = size_t{4} << 20;
+    Vector<std::uint32_t, MallocAllocator<std::uint32_t>> histogram(big);
+    Vector<std::uint8_t, NumaAllocator<std::uint8_t>> bitmap(big);
+    histogram[big / 2] += 5;
+    bitmap[big - 1] |= 1;
+
+    EXPECT_EQ(histogram[0], 0u);
+    EXPECT_EQ(histogram[big / 2], 5u);
+    EXPECT_EQ(histogram[big - 1], 0u);
+    EXPECT_EQ(bitmap[big - 2], 0);
+    EXPECT_EQ(bitmap[big - 1], 1);
+
+    struct alignas(64) Line
+    {
+        int value;
+    };
+    MallocAllocator<Line> aligned;
+    Line *lines = aligned.allocate_zeroed(3);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(lines) % 64, 0u);
+    EXPECT_EQ(lines[2].value, 0);
+    aligned.deallocate(lines, 3);
+}
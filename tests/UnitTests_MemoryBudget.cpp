@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MallocAllocator.h"
+#include "MemoryBudget.h"
+
+using namespace custom;
+
+//--------------------------------------------------------------------------------------------
+//-------------------------------   memory budget tests    -----------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(MemoryBudgetTests, chargesTagAndGlobal)
+{
+    MemoryBudget &budget = MemoryBudget::tag("test.charges");
+    MemoryBudget &global = MemoryBudget::global();
+    EXPECT_EQ(&MemoryBudget::tag("test.charges"), &budget);
+    EXPECT_EQ(budget.parent(), &global);
+    EXPECT_EQ(budget.name(), "test.charges");
+
+    MemoryBudget::flush_thread();
+    std::int64_t global_before = global.current();
+    {
+        Vector<std::uint64_t, AccountedAllocator<std::uint64_t>> v{AccountedAllocator<std::uint64_t>(budget)};
+        v.reserve(1000);
+        MemoryBudget::flush_thread();
+        EXPECT_EQ(budget.current(), 8000);
+        EXPECT_EQ(global.current() - global_before, 8000);
+
+        // small charges stay in the thread's batch until flushed
+        v.reserve(1010);
+        EXPECT_EQ(budget.current(), 8000);
+        MemoryBudget::flush_thread();
+        EXPECT_EQ(budget.current(), 8080);
+        EXPECT_GE(budget.peak(), 8080);
+
+        v.shrink_to_fit();
+    }
+    MemoryBudget::flush_thread();
+    EXPECT_EQ(budget.current(), 0);
+    EXPECT_EQ(global.current(), global_before);
+
+    // the zeroed path of the upstream allocator is kept
+    using Zeroed = AccountedAllocator<int, MallocAllocator<int>>;
+    Vector<int, Zeroed> zeroed(1 << 16, Zeroed(budget));
+    EXPECT_EQ(zeroed.data()[12345], 0);
+    EXPECT_EQ(budget.current(), 1 << 18);
+
+    bool seen = false;
+    MemoryBudget::for_each([&](const MemoryBudget &b)
+                           { seen |= &b == &budget; });
+    EXPECT_TRUE(seen);
+}
+
+TEST(MemoryBudgetTests, hardLimitFailsGrowth)
+{
+    MemoryBudget &budget = MemoryBudget::tag("test.hard");
+    // room for 1024 ints while growth holds the old and the new block
+    budget.set_hard_limit(4096 + 2048);
+
+    Vector<int, AccountedAllocator<int>> v{AccountedAllocator<int>(budget)};
+    for (int i = 0; i < 1024; ++i)
+        v.push_back(i);
+
+    EXPECT_THROW(v.push_back(0), budget_exceeded);
+    EXPECT_THROW(v.reserve(2000), std::bad_alloc);
+    ASSERT_EQ(v.size(), 1024u);
+    EXPECT_EQ(v.data()[1023], 1023);
+
+    try
+    {
+        v.reserve(1025);
+        FAIL();
+    }
+    catch (const budget_exceeded &e)
+    {
+        EXPECT_EQ(&e.budget(), &budget);
+        EXPECT_EQ(e.requested(), 4100u);
+        EXPECT_NE(std::string(e.what()).find("test.hard"), std::string::npos);
+    }
+
+    // failed charges are not counted
+    MemoryBudget::flush_thread();
+    EXPECT_EQ(budget.current(), 4096);
+
+    v.clear();
+    v.shrink_to_fit();
+    budget.set_hard_limit(MemoryBudget::unlimited);
+    v.reserve(100000);
+    EXPECT_EQ(v.capacity(), 100000u);
+}
+
+TEST(MemoryBudgetTests, softLimitCallback)
+{
+    MemoryBudget &budget = MemoryBudget::tag("test.soft");
+    using Alloc = AccountedAllocator<char>;
+
+    Vector<char, Alloc> cache{Alloc(budget)};
+    cache.reserve(1 << 20);
+
+    int calls = 0;
+    budget.set_soft_limit(2 << 20, [&](MemoryBudget &b)
+                          {
+        ++calls;
+        EXPECT_EQ(&b, &budget);
+        cache.shrink_to_fit(); });
+
+    Vector<char, Alloc> work{Alloc(budget)};
+    work.reserve(512 << 10);
+    EXPECT_EQ(calls, 0);
+
+    // crossing the limit runs the callback once, which releases the cache
+    work.reserve(3 << 20);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(cache.capacity(), 0u);
+    work.reserve(4 << 20);
+    EXPECT_EQ(calls, 1);
+
+    // dropping back below re-arms it
+    work.clear();
+    work.shrink_to_fit();
+    work.reserve(3 << 20);
+    EXPECT_EQ(calls, 2);
+
+    budget.set_soft_limit(MemoryBudget::unlimited, nullptr);
+}
+
+TEST(MemoryBudgetTests, threadsFlushOnExit)
+{
+    MemoryBudget &budget = MemoryBudget::tag("test.threads");
+    MemoryBudget::flush_thread();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&budget]
+                             {
+            using Alloc = AccountedAllocator<int>;
+            Vector<Vector<int, Alloc>> kept;
+            for (int i = 0; i < 200; ++i)
+            {
+                Vector<int, Alloc> v{Alloc(budget)};
+                v.reserve(i + 1);
+                if (i % 2 == 0)
+                    kept.push_back(std::move(v));
+            }
+            // 10000 of the 20100 reserved ints are kept until the thread ends
+            MemoryBudget::flush_thread();
+            EXPECT_GE(budget.peak(), 40000); });
+    for (std::thread &t : threads)
+        t.join();
+
+    EXPECT_EQ(budget.current(), 0);
+    EXPECT_GE(budget.peak(), 40000);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include "CustomVector.h"
+#include "NumaAllocator.h"
+#include "Parallel.h"
+
+using namespace custom;
+
+// small grain so the tests really run on several threads
+static const ParallelInit four_workers{.threads = 4, .grain_bytes = 64};
+
+//--------------------------------------------------------------------------------------------
+//---------------   parallel construction tests    -------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(ParallelTests, chunkMappingIsStable)
+{
+    Vector<int> owner(1000, -1, four_workers);
+
+    // record which worker first touched each element ...
+    parallel_for_chunks(owner.data(), owner.data() + owner.size(), [](int *first, int *last, unsigned w)
+                        { std::fill(first, last, static_cast<int>(w)); },
+                        four_workers);
+
+    // ... and check a second pass hands every chunk to the same worker
+    std::atomic<int> moved{0};
+    parallel_for_chunks(owner.data(), owner.data() + owner.size(), [&](int *first, int *last, unsigned w)
+                        {
+        for (; first != last; ++first)
+            if (*first != static_cast<int>(w))
+                ++moved; },
+                        four_workers);
+
+    EXPECT_EQ(moved.load(), 0);
+    EXPECT_EQ(owner.front(), 0);
+    EXPECT_EQ(owner.back(), 3);
+}
+
+TEST(ParallelTests, constructResizeReserve)
+{
+    Vector<std::string> words(1000, "abc", four_workers);
+    EXPECT_EQ(words.size(), 1000);
+    EXPECT_EQ(words[999], "abc");
+
+    words.resize(3000, "xyz", four_workers);
+    EXPECT_EQ(words.size(), 3000);
+    EXPECT_EQ(words[999], "abc");
+    EXPECT_EQ(words[1000], "xyz");
+
+    words.reserve(10000, four_workers);
+    EXPECT_EQ(words.capacity(), 10000);
+    EXPECT_EQ(words[2999], "xyz");
+
+    words.resize(10, "", four_workers);
+    EXPECT_EQ(words.size(), 10);
+    EXPECT_EQ(words[9], "abc");
+
+    // below one grain everything stays on the calling thread
+    Vector<int> small(8, 5, parallel_init);
+    EXPECT_EQ(small[7], 5);
+}
+
+TEST(ParallelTests, failedChunkIsCleanedUp)
+{
+    static std::atomic<int> live{0};
+    static std::atomic<int> copies{0};
+
+    struct Counted
+    {
+        Counted() { ++live; }
+        Counted(const Counted &)
+        {
+            if (++copies == 500)
+                throw std::runtime_error("copy failed");
+            ++live;
+        }
+        ~Counted() { --live; }
+    };
+
+    {
+        Counted proto;
+        EXPECT_THROW((Vector<Counted>(1000, proto, four_workers)), std::runtime_error);
+    }
+
+    EXPECT_EQ(live.load(), 0);
+}
+
+TEST(ParallelTests, parallelForEach)
+{
+    Vector<long> nums(4096, 1, four_workers);
+    parallel_for_each(nums.data(), nums.data() + nums.size(), [](long &num)
+                      { num *= 2; },
+                      four_workers);
+
+    long sum = 0;
+    for (long num : nums)
+        sum += num;
+    EXPECT_EQ(sum, 8192);
+}
+
+//--------------------------------------------------------------------------------------------
+//---------------   class NumaAllocator tests    ---------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(NumaAllocatorTests, policiesFallBackGracefully)
+{
+    EXPECT_GE(NumaAllocator<int>::node_count(), 1u);
+
+    for (NumaPolicy policy : {NumaPolicy::local, NumaPolicy::interleave, NumaPolicy::bind})
+    {
+        NumaAllocator<double> alloc(policy);
+
+        // large enough to be mmapped
+        Vector<double, NumaAllocator<double>> big(1 << 18, 1.5, four_workers, alloc);
+        EXPECT_EQ(big[(1 << 18) - 1], 1.5);
+
+        Vector<double, NumaAllocator<double>> small(10, 2.5, alloc);
+        small.push_back(3.5);
+        EXPECT_EQ(small.back(), 3.5);
+    }
+}
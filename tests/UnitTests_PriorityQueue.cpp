@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "PriorityQueue.h"
+
+using namespace custom;
+
+namespace
+{
+    // no default constructor, so it is stored without padding
+    struct Job
+    {
+        explicit Job(int p) : priority(p) {}
+
+        int priority;
+
+        bool operator<(const Job &other) const { return priority < other.priority; }
+    };
+
+    template <class Queue>
+    std::vector<typename Queue::value_type> drain(Queue &queue)
+    {
+        std::vector<typename Queue::value_type> out;
+        while (!queue.empty())
+        {
+            out.push_back(queue.top());
+            queue.pop();
+        }
+        return out;
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+//---------------   class PriorityQueue tests    ---------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(PriorityQueueTests, popsInPriorityOrder)
+{
+    std::mt19937 gen(7);
+    std::vector<int> values(5000);
+    for (int &val : values)
+        val = static_cast<int>(gen() % 1000);
+
+    PriorityQueue<int> max_heap;
+    EXPECT_THROW(max_heap.top(), std::out_of_range);
+    EXPECT_THROW(max_heap.pop(), std::out_of_range);
+    for (int val : values)
+        max_heap.push(val);
+    EXPECT_EQ(max_heap.size(), values.size());
+
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+    EXPECT_EQ(drain(max_heap), expected);
+
+    // other arities, a min-heap and a type stored without padding
+    PriorityQueue<int, std::greater<int>, 2> binary;
+    PriorityQueue<int, std::greater<int>, 8> octary;
+    PriorityQueue<std::string, std::greater<std::string>> strings;
+    for (int val : values)
+    {
+        binary.push(val);
+        octary.push(val);
+        strings.push(std::to_string(val));
+    }
+
+    std::reverse(expected.begin(), expected.end());
+    EXPECT_EQ(drain(binary), expected);
+    EXPECT_EQ(drain(octary), expected);
+
+    std::vector<std::string> expected_strings;
+    for (int val : values)
+        expected_strings.push_back(std::to_string(val));
+    std::sort(expected_strings.begin(), expected_strings.end());
+    EXPECT_EQ(drain(strings), expected_strings);
+}
+
+TEST(PriorityQueueTests, heapifyPushRangeAndPushPop)
+{
+    std::vector<std::uint64_t> deadlines;
+    for (std::uint64_t i = 0; i < 1000; ++i)
+        deadlines.push_back((i * 7919) % 1000);
+
+    PriorityQueue<std::uint64_t, std::greater<std::uint64_t>> timers(deadlines);
+    EXPECT_EQ(timers.size(), 1000);
+    EXPECT_EQ(timers.top(), 0);
+
+    // a small batch is pushed one by one, a large one rebuilds the heap
+    timers.push_range(std::vector<std::uint64_t>{5000, 2000});
+    std::vector<std::uint64_t> batch(3000, 1500);
+    timers.push_range(batch);
+    EXPECT_EQ(timers.size(), 4002);
+
+    // nothing queued ranks above 0, so push_pop hands it straight back
+    EXPECT_EQ(timers.push_pop(0), 0);
+    EXPECT_EQ(timers.push_pop(3000), 0);
+    EXPECT_EQ(timers.top(), 1);
+
+    std::vector<std::uint64_t> order = drain(timers);
+    EXPECT_EQ(order.size(), 4002);
+    EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+    EXPECT_EQ(order.back(), 5000);
+
+    timers.push(3);
+    timers.clear();
+    EXPECT_TRUE(timers.empty());
+}
+
+TEST(PriorityQueueTests, nonDefaultConstructibleElements)
+{
+    PriorityQueue<Job> jobs;
+    for (int p : {3, 9, 1, 7})
+        jobs.emplace(p);
+    jobs.push(Job(5));
+
+    EXPECT_EQ(jobs.size(), 5);
+    EXPECT_EQ(jobs.top().priority, 9);
+    EXPECT_EQ(jobs.push_pop(Job(4)).priority, 9);
+
+    std::vector<int> order;
+    for (const Job &job : drain(jobs))
+        order.push_back(job.priority);
+    EXPECT_EQ(order, (std::vector<int>{7, 5, 4, 3, 1}));
+
+    jobs.push(Job(2));
+    jobs.clear();
+    EXPECT_TRUE(jobs.empty());
+
+    // the padded queue is reset to its padding, not emptied
+    PriorityQueue<int> padded;
+    padded.push(4);
+    padded.clear();
+    EXPECT_TRUE(padded.empty());
+    padded.push(6);
+    EXPECT_EQ(padded.top(), 6);
+}
+
+//--------------------------------------------------------------------------------------------
+//---------------   class HandlePriorityQueue tests    ---------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(HandlePriorityQueueTests, decreaseKeyUpdateAndErase)
+{
+    HandlePriorityQueue<int, std::greater<int>> timers;
+    EXPECT_THROW(timers.top_key(), std::out_of_range);
+
+    std::vector<SlotMapKey> keys;
+    for (int i = 0; i < 100; ++i)
+        keys.push_back(timers.push(1000 + i));
+
+    EXPECT_EQ(timers.top(), 1000);
+    EXPECT_EQ(timers.top_key(), keys[0]);
+
+    timers.decrease_key(keys[50], 10);
+    EXPECT_EQ(timers.top(), 10);
+    EXPECT_EQ(timers.top_key(), keys[50]);
+    EXPECT_THROW(timers.decrease_key(keys[50], 20), std::invalid_argument);
+
+    // update moves either way
+    timers.update(keys[50], 5000);
+    EXPECT_EQ(*timers.get(keys[50]), 5000);
+    EXPECT_EQ(timers.top_key(), keys[0]);
+    timers.update(keys[99], 1);
+    EXPECT_EQ(timers.top_key(), keys[99]);
+
+    EXPECT_TRUE(timers.erase(keys[99]));
+    EXPECT_FALSE(timers.erase(keys[99]));
+    EXPECT_FALSE(timers.contains(keys[99]));
+    EXPECT_EQ(timers.get(keys[99]), nullptr);
+    EXPECT_THROW(timers.update(keys[99], 3), std::out_of_range);
+
+    for (int i = 10; i < 20; ++i)
+        EXPECT_TRUE(timers.erase(keys[i]));
+
+    timers.pop();
+    EXPECT_FALSE(timers.contains(keys[0]));
+
+    // every remaining key still finds its own element
+    for (int i = 1; i < 99; ++i)
+    {
+        if (i >= 10 && i < 20)
+            continue;
+        ASSERT_EQ(*timers.get(keys[i]), i == 50 ? 5000 : 1000 + i);
+    }
+
+    std::vector<int> order = drain(timers);
+    EXPECT_EQ(order.size(), 88);
+    EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+
+    SlotMapKey again = timers.push(1);
+    timers.clear();
+    EXPECT_FALSE(timers.contains(again));
+}
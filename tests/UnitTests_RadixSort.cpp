@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include "CustomVector.h"
+#include "RadixSort.h"
+
+using namespace custom;
+
+// small grain so the tests really run on several threads
+static const ParallelInit four_workers{.threads = 4, .grain_bytes = 64};
+
+namespace
+{
+    template <class T>
+    Vector<T> randomVector(size_t n, T low, T high)
+    {
+        std::mt19937_64 gen(n);
+        Vector<T> v;
+        v.reserve(n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            if constexpr (std::is_floating_point_v<T>)
+                v.push_back(std::uniform_real_distribution<T>(low, high)(gen));
+            else
+                v.push_back(std::uniform_int_distribution<T>(low, high)(gen));
+        }
+
+        return v;
+    }
+
+    template <class T>
+    void expectSorted(Vector<T> v, const ParallelInit &policy)
+    {
+        Vector<T> expected(v);
+        std::sort(expected.begin(), expected.end());
+
+        radix_sort(v, policy);
+        EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+//---------------   radix_sort tests    ------------------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(RadixSortTests, integers)
+{
+    for (size_t n : {0, 1, 100, 5000})
+    {
+        expectSorted(randomVector<std::uint64_t>(n, 0, UINT64_MAX), four_workers);
+        expectSorted(randomVector<std::int32_t>(n, INT32_MIN, INT32_MAX), four_workers);
+        expectSorted(randomVector<std::int16_t>(n, -300, 300), parallel_init);
+    }
+
+    // only the low byte varies, so seven of the eight passes are skipped
+    expectSorted(randomVector<std::uint64_t>(5000, 1000000, 1000200), four_workers);
+
+    Vector<std::int8_t> bytes{5, -3, 127, -128, 0};
+    radix_sort(bytes);
+    EXPECT_EQ(bytes.front(), -128);
+    EXPECT_EQ(bytes.back(), 127);
+}
+
+TEST(RadixSortTests, floatingPoint)
+{
+    expectSorted(randomVector<double>(5000, -1e9, 1e9), four_workers);
+    expectSorted(randomVector<float>(5000, -1.f, 1.f), four_workers);
+
+    Vector<double> special = randomVector<double>(1000, -5, 5);
+    special.push_back(std::numeric_limits<double>::infinity());
+    special.push_back(-std::numeric_limits<double>::infinity());
+    special.push_back(-0.0);
+    special.push_back(0.0);
+    special.push_back(std::numeric_limits<double>::denorm_min());
+    radix_sort(special, four_workers);
+
+    EXPECT_TRUE(std::is_sorted(special.begin(), special.end()));
+    EXPECT_EQ(special.front(), -std::numeric_limits<double>::infinity());
+    EXPECT_EQ(special.back(), std::numeric_limits<double>::infinity());
+}
+
+TEST(RadixSortTests, byKeyIsStable)
+{
+    struct Event
+    {
+        std::int64_t time = 0;
+        std::string name;
+    };
+
+    Vector<Event> events;
+    for (int i = 0; i < 3000; ++i)
+        events.push_back({(i * 7919) % 100 - 50, std::to_string(i)});
+
+    radix_sort_by_key(events, &Event::time, four_workers);
+
+    for (size_t i = 1; i < events.size(); ++i)
+    {
+        ASSERT_LE(events[i - 1].time, events[i].time);
+        if (events[i - 1].time == events[i].time)
+        {
+            ASSERT_LT(std::stoi(events[i - 1].name), std::stoi(events[i].name));
+        }
+    }
+}
+
+TEST(RadixSortTests, keyValuePairs)
+{
+    Vector<std::uint32_t> keys = randomVector<std::uint32_t>(4000, 0, 1000);
+    Vector<std::uint32_t> values(keys);
+    for (std::uint32_t &val : values)
+        val *= 3;
+
+    radix_sort(keys, values, four_workers);
+
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+    for (size_t i = 0; i < keys.size(); ++i)
+        ASSERT_EQ(values[i], keys[i] * 3);
+
+    Vector<std::uint32_t> short_values(3, 0);
+    EXPECT_THROW(radix_sort(keys, short_values), std::invalid_argument);
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include "SegmentedVector.h"
+
+using namespace custom;
+
+//--------------------------------------------------------------------------------------------
+//---------------   class SegmentedVector tests    -------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(SegmentedVectorTests, DefaultConstructor)
+{
+    SegmentedVector<int> v;
+    EXPECT_EQ(v.size(), 0);
+    EXPECT_EQ(v.capacity(), 0);
+    EXPECT_EQ(v.chunk_count(), 0);
+    EXPECT_TRUE(v.begin() == v.end());
+}
+
+TEST(SegmentedVectorTests, ParamConstructor)
+{
+    SegmentedVector<int, std::allocator<int>, 4> v(50, 7);
+
+    ASSERT_EQ(v.size(), 50);
+    for (int num : v)
+        EXPECT_EQ(num, 7);
+}
+
+TEST(SegmentedVectorTests, pushBackAndIndex)
+{
+    SegmentedVector<int, std::allocator<int>, 4> v;
+
+    for (int i = 0; i < 1000; ++i)
+        v.push_back(i);
+
+    ASSERT_EQ(v.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(v[i], i);
+
+    EXPECT_EQ(v.front(), 0);
+    EXPECT_EQ(v.back(), 999);
+    EXPECT_THROW(v.at(1000), std::out_of_range);
+}
+
+TEST(SegmentedVectorTests, growthKeepsAddresses)
+{
+    SegmentedVector<int, std::allocator<int>, 2> v;
+    v.push_back(1);
+    v.push_back(2);
+
+    int *first = &v[0];
+    int *second = &v[1];
+
+    for (int i = 0; i < 10000; ++i)
+        v.push_back(i);
+
+    // no element may have been relocated by the growth
+    EXPECT_EQ(first, &v[0]);
+    EXPECT_EQ(second, &v[1]);
+    EXPECT_EQ(*first, 1);
+    EXPECT_EQ(*second, 2);
+}
+
+TEST(SegmentedVectorTests, chunks)
+{
+    SegmentedVector<int, std::allocator<int>, 4> v;
+    for (int i = 0; i < 20; ++i)
+        v.push_back(i);
+
+    // chunk sizes are 4, 8, 16 so 20 elements fill 4 + 8 + 8
+    ASSERT_EQ(v.chunk_count(), 3);
+    EXPECT_EQ(v.chunk(0).size(), 4);
+    EXPECT_EQ(v.chunk(1).size(), 8);
+    EXPECT_EQ(v.chunk(2).size(), 8);
+    EXPECT_EQ(v.capacity(), 28);
+
+    int expected = 0;
+    for (size_t k = 0; k < v.chunk_count(); ++k)
+        for (int num : v.chunk(k))
+            EXPECT_EQ(num, expected++);
+
+    EXPECT_EQ(expected, 20);
+}
+
+TEST(SegmentedVectorTests, copyAndMove)
+{
+    SegmentedVector<std::string> v{"a", "b", "c"};
+    for (int i = 0; i < 100; ++i)
+        v.push_back(std::to_string(i));
+
+    SegmentedVector<std::string> copy(v);
+    ASSERT_EQ(copy.size(), v.size());
+    for (size_t i = 0; i < v.size(); ++i)
+        EXPECT_EQ(copy[i], v[i]);
+
+    SegmentedVector<std::string> moved(std::move(copy));
+    EXPECT_EQ(copy.size(), 0);
+    ASSERT_EQ(moved.size(), v.size());
+    EXPECT_EQ(moved[2], "c");
+    EXPECT_EQ(moved.back(), "99");
+}
+
+TEST(SegmentedVectorTests, popBackAndClear)
+{
+    SegmentedVector<int> v;
+    for (int i = 0; i < 40; ++i)
+        v.push_back(i);
+
+    size_t cap = v.capacity();
+    v.pop_back();
+    EXPECT_EQ(v.back(), 38);
+
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), cap);
+    EXPECT_THROW(v.pop_back(), std::out_of_range);
+}
+
+TEST(SegmentedVectorTests, iterators)
+{
+    SegmentedVector<int, std::allocator<int>, 4> v(30);
+    std::iota(v.begin(), v.end(), 0);
+
+    EXPECT_EQ(std::accumulate(v.cbegin(), v.cend(), 0), 435);
+    EXPECT_EQ(v.end() - v.begin(), 30);
+
+    SegmentedVector<int, std::allocator<int>, 4>::const_iterator it = v.begin() + 10;
+    EXPECT_EQ(*it, 10);
+    EXPECT_TRUE(it < v.end());
+}
+
+TEST(SegmentedVectorTests, throwingCopyLeaksNothing)
+{
+    static int live = 0;
+    static int copies_left = 0;
+
+    struct Counted
+    {
+        Counted() { ++live; }
+        Counted(const Counted &)
+        {
+            if (copies_left-- == 0)
+                throw std::runtime_error("copy failed");
+            ++live;
+        }
+        ~Counted() { --live; }
+    };
+
+    {
+        Counted proto;
+
+        // fails in the second chunk, after the first is full
+        copies_left = 40;
+        using Segmented = SegmentedVector<Counted, std::allocator<Counted>, 16>;
+        EXPECT_THROW(Segmented(100, proto), std::runtime_error);
+        EXPECT_EQ(live, 1);
+
+        copies_left = 100;
+        Segmented full(100, proto);
+        copies_left = 50;
+        EXPECT_THROW(Segmented copy(full), std::runtime_error);
+        EXPECT_EQ(live, 101);
+
+        copies_left = 4;
+        std::initializer_list<Counted> ilist{proto, proto, proto, proto};
+        copies_left = 2;
+        EXPECT_THROW(Segmented{ilist}, std::runtime_error);
+        EXPECT_EQ(live, 105);
+    }
+    EXPECT_EQ(live, 0);
+}
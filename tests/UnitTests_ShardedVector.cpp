@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "ShardedVector.h"
+
+using namespace custom;
+
+// small grain so the merges really run on several threads
+static const ParallelInit four_workers{.threads = 4, .grain_bytes = 64};
+
+//--------------------------------------------------------------------------------------------
+//---------------   class ShardedVector tests    ---------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(ShardedVectorTests, concurrentAppendsMergeInShardOrder)
+{
+    ShardedVector<int> hits(4);
+    EXPECT_EQ(hits.shard_count(), 4);
+    EXPECT_THROW(hits.shard(4), std::out_of_range);
+    EXPECT_THROW(ShardedVector<int>(0), std::invalid_argument);
+
+    // worker w appends w * 1000 + i, shards of different lengths
+    Vector<std::thread> threads;
+    for (int w = 0; w < 4; ++w)
+        threads.push_back(std::thread([&hits, w]
+                                      { for (int i = 0; i < 100 * (w + 1); ++i)
+                                            hits.push_back(w, w * 1000 + i); }));
+    for (std::thread &t : threads)
+        t.join();
+
+    EXPECT_EQ(hits.size(), 1000);
+
+    Vector<int> all{-1};
+    hits.merge_into(all, four_workers);
+
+    ASSERT_EQ(all.size(), 1001);
+    EXPECT_EQ(all[0], -1);
+
+    size_t i = 1;
+    for (int w = 0; w < 4; ++w)
+        for (int j = 0; j < 100 * (w + 1); ++j, ++i)
+            EXPECT_EQ(all[i], w * 1000 + j);
+
+    // merge_into copies, the shards are unchanged
+    EXPECT_EQ(hits.size(), 1000);
+}
+
+TEST(ShardedVectorTests, collectMovesAndEmpties)
+{
+    ShardedVector<std::string> words(3);
+    words.reserve_per_shard(16);
+    EXPECT_EQ(words.shard(2).capacity(), 16);
+
+    words.emplace_back(2, "c");
+    words.emplace_back(0, 3, 'a');
+    words.push_back(1, std::string("b"));
+
+    Vector<std::string> all = words.collect(four_workers);
+
+    ASSERT_EQ(all.size(), 3);
+    EXPECT_EQ(all[0], "aaa");
+    EXPECT_EQ(all[1], "b");
+    EXPECT_EQ(all[2], "c");
+    EXPECT_TRUE(words.empty());
+
+    // an empty ShardedVector merges to nothing
+    EXPECT_EQ(words.collect().size(), 0);
+}
+
+TEST(ShardedVectorTests, shardsOnOwnCacheLines)
+{
+    ShardedVector<int> counts(8);
+
+    for (size_t w = 0; w < counts.shard_count(); ++w)
+    {
+        auto address = reinterpret_cast<std::uintptr_t>(&counts.shard(w));
+        EXPECT_EQ(address % ShardedVector<int>::cache_line_size, 0);
+    }
+}
+
+TEST(ShardedVectorTests, failedMergeIsCleanedUp)
+{
+    static std::atomic<int> live{0};
+    static std::atomic<int> copies{0};
+
+    struct Counted
+    {
+        Counted() { ++live; }
+        Counted(const Counted &)
+        {
+            if (++copies == 300)
+                throw std::runtime_error("copy failed");
+            ++live;
+        }
+        ~Counted() { --live; }
+    };
+
+    {
+        ShardedVector<Counted> items(4);
+        items.reserve_per_shard(100);
+        for (size_t w = 0; w < 4; ++w)
+            for (int i = 0; i < 100; ++i)
+                items.emplace_back(w);
+
+        Vector<Counted> all;
+        EXPECT_THROW(items.merge_into(all, four_workers), std::runtime_error);
+
+        // nothing was appended and nothing leaked
+        EXPECT_EQ(all.size(), 0);
+        EXPECT_EQ(live.load(), 400);
+    }
+
+    EXPECT_EQ(live.load(), 0);
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "SharedVector.h"
+
+using namespace custom;
+
+namespace
+{
+    struct Node
+    {
+        int value;
+        OffsetPtr<Node> next;
+    };
+}
+
+//--------------------------------------------------------------------------------------------
+//------------------------------   shared vector tests    ------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(SharedVectorTests, offsetPtrFollowsItsBlock)
+{
+    alignas(Node) std::array<unsigned char, 2 * sizeof(Node)> first{};
+    alignas(Node) std::array<unsigned char, 2 * sizeof(Node)> second{};
+
+    Node *nodes = ::new (first.data()) Node[2];
+    nodes[0] = {1, &nodes[1]};
+    nodes[1] = {2, nullptr};
+
+    // a byte copy of the block (a second mapping) keeps the links inside it
+    std::memcpy(second.data(), first.data(), first.size());
+    Node *moved = std::launder(reinterpret_cast<Node *>(second.data()));
+    EXPECT_EQ(moved[0].next.get(), &moved[1]);
+    EXPECT_EQ(moved[0].next->value, 2);
+    EXPECT_FALSE(moved[1].next);
+
+    // copying a pointer recomputes the distance
+    OffsetPtr<Node> copy = moved[0].next;
+    EXPECT_EQ(copy.get(), &moved[1]);
+}
+
+TEST(SharedVectorTests, mappingsAtDifferentAddresses)
+{
+    SharedSegment segment = SharedSegment::create(std::size_t{16} << 20);
+    SharedVector<std::uint64_t> &writer =
+        segment.find_or_construct<SharedVector<std::uint64_t>>("ticks", segment);
+
+    for (std::uint64_t i = 0; i < 100000; ++i)
+        writer.push_back(i * 3);
+
+    SharedSegment view = SharedSegment::attach(segment.fd());
+    ASSERT_NE(view.base(), segment.base());
+
+    SharedVector<std::uint64_t> *reader = view.find<SharedVector<std::uint64_t>>("ticks");
+    ASSERT_NE(reader, nullptr);
+    ASSERT_EQ(reader->size(), 100000u);
+    EXPECT_NE(reader->data(), writer.data());
+    EXPECT_EQ(reader->at(99999), 299997u);
+
+    std::uint64_t sum = reader->read([](std::span<const std::uint64_t> all)
+                                     { return std::accumulate(all.begin(), all.end(), std::uint64_t{0}); });
+    EXPECT_EQ(sum, 3 * (std::uint64_t{99999} * 100000 / 2));
+
+    // growth through either mapping is seen by the other
+    std::array<std::uint64_t, 3> tail{7, 8, 9};
+    reader->append_range(tail);
+    reader->append_range(std::span<const std::uint64_t>(reader->data(), 2));
+    ASSERT_EQ(writer.size(), 100005u);
+    EXPECT_EQ(writer.at(100002), 9u);
+    EXPECT_EQ(writer.at(100004), 3u);
+
+    EXPECT_EQ(&segment.find_or_construct<SharedVector<std::uint64_t>>("ticks", segment), &writer);
+    EXPECT_EQ(view.find<SharedVector<std::uint64_t>>("missing"), nullptr);
+    EXPECT_THROW(view.find<SharedVector<std::uint64_t>>(std::string(48, 'x')), std::invalid_argument);
+    EXPECT_THROW(view.find<int>("ticks"), std::invalid_argument);
+    EXPECT_THROW(writer.at(100005), std::out_of_range);
+}
+
+TEST(SharedVectorTests, segmentAllocatorReusesBlocks)
+{
+    SharedSegment segment = SharedSegment::create(std::size_t{1} << 20);
+    std::size_t initial_free = segment.free_bytes();
+
+    auto &v = segment.find_or_construct<SharedVector<int>>("v", segment);
+    v.resize(1000, 5);
+    EXPECT_EQ(v.at(999), 5);
+    v.reserve(5000);
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 1000u);
+
+    // the segment is fixed size
+    EXPECT_THROW(v.reserve(1 << 20), std::bad_alloc);
+    EXPECT_EQ(v.size(), 1000u);
+
+    EXPECT_TRUE(segment.destroy<SharedVector<int>>("v"));
+    EXPECT_FALSE(segment.destroy<SharedVector<int>>("v"));
+    EXPECT_EQ(segment.free_bytes(), initial_free);
+
+    EXPECT_THROW(SharedSegment::create(64), std::invalid_argument);
+    EXPECT_THROW(SharedSegment::open("/custom_vector_no_such_segment"), std::system_error);
+}
+
+TEST(SharedVectorTests, publishToAnotherProcess)
+{
+    std::string name = "/custom_vector_test_" + std::to_string(::getpid());
+    SharedSegment::remove(name);
+    SharedSegment segment = SharedSegment::create(name, std::size_t{8} << 20);
+    auto &v = segment.find_or_construct<SharedVector<std::uint32_t>>("gen", segment);
+
+    constexpr std::uint32_t generations = 300;
+
+    pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0)
+    {
+        // every published state holds gen * 64 copies of gen
+        int status = 0;
+        try
+        {
+            SharedSegment mine = SharedSegment::open(name);
+            auto *shared = mine.find<SharedVector<std::uint32_t>>("gen");
+            for (std::uint32_t seen = 0; seen != generations;)
+            {
+                seen = shared->read([&](std::span<const std::uint32_t> all)
+                                    {
+                    std::uint32_t gen = all.empty() ? 0 : all[0];
+                    for (std::uint32_t x : all)
+                        if (x != gen)
+                            return ~0u;
+                    return all.size() == std::size_t{gen} * 64 ? gen : ~0u; });
+                if (seen == ~0u)
+                {
+                    status = 1;
+                    break;
+                }
+            }
+        }
+        catch (...)
+        {
+            status = 2;
+        }
+        ::_exit(status);
+    }
+
+    for (std::uint32_t gen = 1; gen <= generations; ++gen)
+    {
+        auto guard = v.write();
+        v.clear();
+        v.resize(std::size_t{gen} * 64, gen);
+    }
+
+    int status = -1;
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_EQ(v.version(), generations);
+
+    EXPECT_TRUE(SharedSegment::remove(name));
+    EXPECT_THROW(SharedSegment::create(name + "/bad", 1 << 20), std::system_error);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "SlotMap.h"
+
+using namespace custom;
+
+//--------------------------------------------------------------------------------------------
+//---------------   class SlotMap tests    ---------------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(SlotMapTests, insertEraseAndStaleKeys)
+{
+    SlotMap<std::string> names;
+    EXPECT_FALSE(names.contains(SlotMapKey{}));
+
+    SlotMapKey a = names.insert("a");
+    SlotMapKey b = names.insert("b");
+    SlotMapKey c = names.emplace(3, 'c');
+    EXPECT_EQ(names.size(), 3);
+    EXPECT_EQ(names[a], "a");
+    EXPECT_EQ(names.at(c), "ccc");
+
+    // erasing the first element moves the last into its place
+    EXPECT_TRUE(names.erase(a));
+    EXPECT_FALSE(names.erase(a));
+    EXPECT_EQ(names.size(), 2);
+    EXPECT_EQ(names.data()[0], "ccc");
+    EXPECT_EQ(names.key_at(0), c);
+    EXPECT_EQ(names.at(b), "b");
+    EXPECT_EQ(*names.get(c), "ccc");
+
+    // the freed slot is reused under a new generation
+    SlotMapKey d = names.insert("d");
+    EXPECT_EQ(d.index, a.index);
+    EXPECT_NE(d.generation, a.generation);
+    EXPECT_EQ(names.get(a), nullptr);
+    EXPECT_THROW(names.at(a), std::out_of_range);
+    EXPECT_EQ(names.at(d), "d");
+
+    EXPECT_EQ(SlotMapKey::from_value(d.value()), d);
+    EXPECT_FALSE(names.contains(SlotMapKey{d.index + 10, 1}));
+
+    names.clear();
+    EXPECT_TRUE(names.empty());
+    EXPECT_FALSE(names.contains(b));
+    EXPECT_FALSE(names.contains(d));
+    EXPECT_EQ(names.begin(), names.end());
+}
+
+TEST(SlotMapTests, churnKeepsKeysAndDenseOrderConsistent)
+{
+    SlotMap<int> entities;
+    std::vector<std::pair<SlotMapKey, int>> live;
+    std::vector<SlotMapKey> dead;
+
+    for (int frame = 0; frame < 200; ++frame)
+    {
+        for (int i = 0; i < 50; ++i)
+        {
+            int val = frame * 100 + i;
+            live.emplace_back(entities.insert(val), val);
+        }
+        // destroy every third entity, oldest first
+        for (std::size_t i = 0; i < live.size(); i += 3)
+        {
+            ASSERT_TRUE(entities.erase(live[i].first));
+            dead.push_back(live[i].first);
+            live[i] = live.back();
+            live.pop_back();
+        }
+    }
+
+    ASSERT_EQ(entities.size(), live.size());
+    for (auto &[key, val] : live)
+        ASSERT_EQ(entities.at(key), val);
+    for (SlotMapKey key : dead)
+        ASSERT_FALSE(entities.contains(key));
+
+    for (std::size_t i = 0; i < entities.size(); ++i)
+        ASSERT_EQ(&entities[entities.key_at(i)], entities.data() + i);
+
+    long long sum = 0;
+    for (int val : entities)
+        sum += val;
+    long long expected = 0;
+    for (auto &entry : live)
+        expected += entry.second;
+    EXPECT_EQ(sum, expected);
+}
+
+namespace
+{
+    struct ThrowOnDemand
+    {
+        ThrowOnDemand(bool fail)
+        {
+            if (fail)
+                throw std::runtime_error("construction failed");
+        }
+    };
+}
+
+TEST(SlotMapTests, failedInsertLeavesMapUnchanged)
+{
+    SlotMap<ThrowOnDemand> map;
+    SlotMapKey first = map.emplace(false);
+
+    EXPECT_THROW(map.emplace(true), std::runtime_error);
+    EXPECT_EQ(map.size(), 1);
+    EXPECT_TRUE(map.contains(first));
+
+    SlotMapKey second = map.emplace(false);
+    EXPECT_TRUE(map.contains(second));
+    EXPECT_EQ(map.key_at(1), second);
+}
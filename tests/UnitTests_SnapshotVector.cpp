@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "MemoryBudget.h"
+#include "SnapshotVector.h"
+
+using namespace custom;
+
+//--------------------------------------------------------------------------------------------
+//---------------   class SnapshotVector tests    --------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(SnapshotVectorTests, copyShareBuffer)
+{
+    SnapshotVector<int> a{1, 2, 3};
+    SnapshotVector<int> b(a);
+
+    EXPECT_EQ(a.data(), b.data());
+    EXPECT_EQ(a.use_count(), 2);
+    EXPECT_EQ(b[2], 3);
+}
+
+TEST(SnapshotVectorTests, copyOnWrite)
+{
+    SnapshotVector<int> a{1, 2, 3};
+    SnapshotVector<int> b = a;
+
+    b.set(0, 10);
+    b.push_back(4);
+
+    // a still sees the original buffer
+    EXPECT_NE(a.data(), b.data());
+    EXPECT_EQ(a.size(), 3);
+    EXPECT_EQ(a[0], 1);
+    EXPECT_EQ(b.size(), 4);
+    EXPECT_EQ(b[0], 10);
+    EXPECT_EQ(a.use_count(), 1);
+
+    // a unique buffer is edited in place
+    const int *before = b.data();
+    b.set(1, 20);
+    EXPECT_EQ(before, b.data());
+    EXPECT_THROW(b.set(9, 0), std::out_of_range);
+}
+
+TEST(SnapshotVectorTests, fromVectorWithoutCopy)
+{
+    Vector<int> items{5, 6, 7};
+    const int *storage = items.data();
+
+    SnapshotVector<int> snap(std::move(items));
+    EXPECT_EQ(snap.data(), storage);
+    EXPECT_EQ(snap.at(1), 6);
+    EXPECT_THROW(snap.at(3), std::out_of_range);
+}
+
+TEST(SnapshotVectorTests, blockUsesItemsAllocator)
+{
+    using Alloc = AccountedAllocator<int>;
+    MemoryBudget &budget = MemoryBudget::tag("test.snapshot");
+    MemoryBudget::flush_thread();
+    {
+        Vector<int, Alloc> items(100, 1, Alloc(budget));
+        SnapshotVector<int, Alloc> a(std::move(items));
+        SnapshotVector<int, Alloc> b = a;
+        b.set(0, 2);
+
+        // two blocks and two element buffers, all charged to the tag
+        MemoryBudget::flush_thread();
+        EXPECT_GT(budget.current(), static_cast<std::int64_t>(2 * 100 * sizeof(int)));
+    }
+    MemoryBudget::flush_thread();
+    EXPECT_EQ(budget.current(), 0);
+}
+
+TEST(SnapshotVectorTests, publisherLoadAndPublish)
+{
+    SnapshotPublisher<int> pub;
+    EXPECT_TRUE(pub.load().empty());
+
+    pub.publish(Vector<int>{1, 2});
+    SnapshotVector<int> first = pub.load();
+    EXPECT_EQ(first.size(), 2);
+    EXPECT_EQ(first.use_count(), 2);
+
+    SnapshotVector<int> next = first;
+    next.edit().push_back(3);
+    pub.publish(next);
+
+    // the old snapshot survives being replaced
+    EXPECT_EQ(first.size(), 2);
+    EXPECT_EQ(first.use_count(), 1);
+    EXPECT_EQ(pub.load().size(), 3);
+}
+
+TEST(SnapshotVectorTests, concurrentReaders)
+{
+    SnapshotPublisher<int> pub(SnapshotVector<int>{0, 0, 0, 0});
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t)
+    {
+        readers.emplace_back([&]
+                             {
+            while (!done.load())
+            {
+                // every snapshot is internally consistent
+                SnapshotVector<int> snap = pub.load();
+                for (int num : snap)
+                    if (num != snap[0])
+                        ++bad;
+            } });
+    }
+
+    for (int i = 1; i < 2000; ++i)
+        pub.publish(Vector<int>(4, i));
+
+    done = true;
+    for (auto &reader : readers)
+        reader.join();
+
+    EXPECT_EQ(bad.load(), 0);
+    EXPECT_EQ(pub.load()[0], 1999);
+    EXPECT_EQ(pub.load().use_count(), 2);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <functional>
+#include <string>
+#include "FlatMap.h"
+#include "MemoryBudget.h"
+#include "SortedVector.h"
+
+using namespace custom;
+
+//--------------------------------------------------------------------------------------------
+//---------------   class SortedVector tests    ----------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(SortedVectorTests, initializerListSortsAndDedups)
+{
+    SortedVector<int> s{5, 1, 4, 1, 3};
+
+    ASSERT_EQ(s.size(), 4);
+    EXPECT_EQ(s[0], 1);
+    EXPECT_EQ(s[1], 3);
+    EXPECT_EQ(s[2], 4);
+    EXPECT_EQ(s[3], 5);
+}
+
+TEST(SortedVectorTests, lookup)
+{
+    SortedVector<int> s{10, 20, 30, 40, 50};
+
+    EXPECT_EQ(*s.lower_bound(20), 20);
+    EXPECT_EQ(*s.lower_bound(21), 30);
+    EXPECT_EQ(*s.upper_bound(20), 30);
+    EXPECT_EQ(s.lower_bound(51), s.end());
+    EXPECT_EQ(s.lower_bound(0), s.begin());
+
+    EXPECT_TRUE(s.contains(40));
+    EXPECT_FALSE(s.contains(41));
+    EXPECT_EQ(s.find(41), s.end());
+
+    SortedVector<int> empty;
+    EXPECT_EQ(empty.lower_bound(3), empty.end());
+    EXPECT_FALSE(empty.contains(3));
+}
+
+TEST(SortedVectorTests, lowerBoundMatchesStd)
+{
+    SortedVector<int> s;
+    for (int i = 0; i < 257; ++i)
+        s.insert(i * 2);
+
+    for (int key = -1; key < 520; ++key)
+        EXPECT_EQ(s.lower_bound(key), std::lower_bound(s.begin(), s.end(), key));
+}
+
+TEST(SortedVectorTests, insertAndErase)
+{
+    SortedVector<std::string> s;
+
+    EXPECT_TRUE(s.insert("m").second);
+    EXPECT_TRUE(s.insert("a").second);
+    EXPECT_TRUE(s.insert("z").second);
+    EXPECT_FALSE(s.insert("m").second);
+
+    ASSERT_EQ(s.size(), 3);
+    EXPECT_EQ(s[0], "a");
+    EXPECT_EQ(s[1], "m");
+    EXPECT_EQ(s[2], "z");
+
+    EXPECT_EQ(s.erase(std::string("m")), 1);
+    EXPECT_EQ(s.erase(std::string("m")), 0);
+    ASSERT_EQ(s.size(), 2);
+    EXPECT_EQ(s[1], "z");
+}
+
+TEST(SortedVectorTests, insertBatch)
+{
+    SortedVector<int> s{2, 4, 6, 8};
+
+    // interleaved batch with duplicates of itself and of existing elements
+    EXPECT_EQ(s.insert_batch({9, 1, 4, 5, 5, 7, 3}), 5);
+
+    ASSERT_EQ(s.size(), 9);
+    for (int i = 0; i < 9; ++i)
+        EXPECT_EQ(s[i], i + 1);
+
+    // batch entirely past the end is appended
+    EXPECT_EQ(s.insert_batch({12, 10, 11}), 3);
+    EXPECT_EQ(s.size(), 12);
+    EXPECT_EQ(s.at(11), 12);
+}
+
+TEST(SortedVectorTests, customCompare)
+{
+    SortedVector<int, std::greater<int>> s{1, 3, 2};
+
+    EXPECT_EQ(s[0], 3);
+    EXPECT_EQ(s[2], 1);
+    EXPECT_EQ(*s.lower_bound(2), 2);
+}
+
+TEST(SortedVectorTests, batchKeepsAllocator)
+{
+    MemoryBudget &budget = MemoryBudget::tag("test.sorted");
+    MemoryBudget::flush_thread();
+    {
+        using Alloc = AccountedAllocator<int>;
+        SortedVector<int, std::less<int>, Alloc> s({2, 4, 6, 8}, std::less<int>(), Alloc(budget));
+        EXPECT_EQ(s.insert_batch({9, 1, 5, 3}), 4);
+        EXPECT_EQ(s.get_allocator(), Alloc(budget));
+
+        using Pair_Alloc = AccountedAllocator<std::pair<int, int>>;
+        FlatMap<int, int, std::less<int>, Pair_Alloc> m({{2, 0}, {4, 0}}, std::less<int>(), Pair_Alloc(budget));
+        EXPECT_EQ(m.insert_batch({{3, 1}, {1, 1}}), 2);
+        EXPECT_EQ(m.get_allocator(), Pair_Alloc(budget));
+
+        // the merged blocks are charged to the tag, not the global budget
+        MemoryBudget::flush_thread();
+        EXPECT_EQ(budget.current(), static_cast<std::int64_t>(s.capacity() * sizeof(int) +
+                                                              m.capacity() * sizeof(std::pair<int, int>)));
+    }
+    MemoryBudget::flush_thread();
+    EXPECT_EQ(budget.current(), 0);
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include "SpillVector.h"
+
+using namespace custom;
+
+//--------------------------------------------------------------------------------------------
+//-----------------------------   spill vector tests    --------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(SpillVectorTests, spillsAndFaultsBack)
+{
+    // 64 elements per chunk, room for 4 chunks, 50 chunks of data
+    SpillVector<std::uint64_t> v(4 * 512, 512);
+    ASSERT_EQ(v.chunk_size(), 64u);
+    ASSERT_EQ(v.max_resident_chunks(), 4u);
+
+    constexpr std::size_t n = 50 * 64 + 17;
+    for (std::size_t i = 0; i < n; ++i)
+        v.push_back(i * 7);
+
+    EXPECT_EQ(v.size(), n);
+    EXPECT_EQ(v.chunk_count(), 51u);
+    EXPECT_LE(v.resident_chunks(), 4u);
+    EXPECT_GT(v.evictions(), 0u);
+
+    std::mt19937 gen(2);
+    for (int k = 0; k < 5000; ++k)
+    {
+        std::size_t i = gen() % n;
+        ASSERT_EQ(v.get(i), i * 7);
+        if (k % 3 == 0)
+        {
+            v.set(i, i * 7 + 1);
+            ASSERT_EQ(v.get(i), i * 7 + 1);
+            v.set(i, i * 7);
+        }
+        ASSERT_LE(v.resident_chunks(), 4u);
+    }
+
+    EXPECT_EQ(v.front(), 0u);
+    EXPECT_EQ(v.back(), (n - 1) * 7);
+    EXPECT_THROW(v.get(n), std::out_of_range);
+    EXPECT_THROW(v.set(n, 0), std::out_of_range);
+}
+
+TEST(SpillVectorTests, iterationAndChunks)
+{
+    SpillVector<int> v(3 * 256, 256);
+    for (int i = 0; i < 1000; ++i)
+        v.push_back(i);
+
+    int expected = 0;
+    for (int x : v)
+        ASSERT_EQ(x, expected++);
+    EXPECT_EQ(expected, 1000);
+
+    v.transform_chunks([](std::span<int> chunk)
+                       { for (int &x : chunk) x *= 2; });
+
+    std::size_t seen = 0;
+    v.for_each_chunk([&](std::span<const int> chunk)
+                     {
+        ASSERT_LE(chunk.size(), v.chunk_size());
+        for (int x : chunk)
+        {
+            ASSERT_EQ(x, static_cast<int>(2 * seen));
+            ++seen;
+        } });
+    EXPECT_EQ(seen, 1000u);
+
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.begin(), v.end());
+    v.push_back(5);
+    EXPECT_EQ(v.get(0), 5);
+}
+
+TEST(SpillVectorTests, spillFileLifetime)
+{
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "spillvector_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+    {
+        SpillVector<double> v(2 * 128, 128, dir);
+        for (int i = 0; i < 4096; ++i)
+            v.push_back(i * 0.5);
+        EXPECT_EQ(v.get(7), 3.5);
+
+        // the spill file is unlinked as soon as it is created
+        EXPECT_TRUE(std::filesystem::is_empty(dir));
+    }
+    EXPECT_TRUE(std::filesystem::is_empty(dir));
+    std::filesystem::remove_all(dir);
+
+    EXPECT_THROW(SpillVector<int>(1024, 256, dir / "missing"), std::system_error);
+    EXPECT_THROW(SpillVector<std::uint64_t>(1024, 4), std::invalid_argument);
+}
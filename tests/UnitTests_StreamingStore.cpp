@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include "CustomVector.h"
+#include "StreamingStore.h"
+
+using namespace custom;
+
+namespace
+{
+    struct Rgb
+    {
+        std::uint8_t r, g, b;
+    };
+
+    struct Wide
+    {
+        double x[3];
+        int tag;
+    };
+
+    struct Huge
+    {
+        char bytes[100];
+    };
+
+    // streams everything while in scope
+    struct StreamAll
+    {
+        StreamAll() : saved(streaming_threshold()) { set_streaming_threshold(0); }
+        ~StreamAll() { set_streaming_threshold(saved); }
+        size_t saved;
+    };
+
+    // fill and copy at every alignment offset within a cache line
+    template <class T>
+    void checkKernels(const T &val)
+    {
+        constexpr size_t n = 300;
+        alignas(64) static unsigned char dst[(n + 64) * sizeof(T)];
+        alignas(64) static unsigned char src[(n + 64) * sizeof(T)];
+
+        for (size_t offset = 0; offset < 64; ++offset)
+        {
+            T *fill_dest = reinterpret_cast<T *>(dst + offset);
+            std::memset(dst, 0xAB, sizeof(dst));
+            detail::stream_fill(fill_dest, n, val);
+
+            for (size_t i = 0; i < n; ++i)
+                ASSERT_EQ(std::memcmp(&fill_dest[i], &val, sizeof(T)), 0) << offset << " " << i;
+
+            // bytes around the range are untouched
+            ASSERT_EQ(dst[offset + n * sizeof(T)], 0xAB);
+            if (offset)
+            {
+                ASSERT_EQ(dst[offset - 1], 0xAB);
+            }
+
+            for (size_t i = 0; i < sizeof(src); ++i)
+                src[i] = static_cast<unsigned char>(i * 7);
+
+            T *copy_dest = reinterpret_cast<T *>(dst + offset);
+            const T *copy_src = reinterpret_cast<const T *>(src + (63 - offset));
+            detail::stream_copy(copy_src, n, copy_dest);
+            ASSERT_EQ(std::memcmp(copy_dest, copy_src, n * sizeof(T)), 0) << offset;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------
+//---------------   streaming store tests    -------------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(StreamingStoreTests, kernelsAllSizes)
+{
+    checkKernels<char>('z');
+    checkKernels<std::uint32_t>(0xDEADBEEF);
+    checkKernels<Rgb>({1, 2, 3});
+    checkKernels<Wide>({{1.5, 2.5, 3.5}, 9});
+    checkKernels<Huge>({"huge"});
+}
+
+TEST(StreamingStoreTests, vectorPathsUseKernels)
+{
+    StreamAll stream;
+
+    Vector<int> filled(1000, 7);
+    EXPECT_EQ(filled[0], 7);
+    EXPECT_EQ(filled[999], 7);
+
+    for (int i = 0; i < 1000; ++i)
+        filled[i] = i;
+
+    Vector<int> copied(filled);
+    EXPECT_EQ(copied[999], 999);
+
+    // relocation
+    copied.reserve(5000);
+    EXPECT_EQ(copied[500], 500);
+
+    copied.resize(3000, -1);
+    EXPECT_EQ(copied[999], 999);
+    EXPECT_EQ(copied[2999], -1);
+
+    // non-trivial types keep the ordinary paths
+    Vector<std::string> words(100, "word");
+    Vector<std::string> other(words);
+    EXPECT_EQ(other[99], "word");
+}
+
+TEST(StreamingStoreTests, thresholdIsTunable)
+{
+    size_t saved = streaming_threshold();
+    EXPECT_EQ(saved, detail::default_streaming_threshold);
+
+    set_streaming_threshold(SIZE_MAX);
+    EXPECT_FALSE(detail::use_streaming<int>(1 << 30));
+
+    set_streaming_threshold(4096);
+    EXPECT_FALSE(detail::use_streaming<int>(1023));
+#if defined(__SSE2__)
+    EXPECT_TRUE(detail::use_streaming<int>(1024));
+#endif
+
+    set_streaming_threshold(saved);
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "StringVector.h"
+
+using namespace custom;
+
+//--------------------------------------------------------------------------------------------
+//---------------   class StringVector tests    ----------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(StringVectorTests, pushAppendAndAccess)
+{
+    StringVector<> words;
+    EXPECT_TRUE(words.empty());
+    EXPECT_THROW(words.at(0), std::out_of_range);
+    EXPECT_THROW(words.pop_back(), std::out_of_range);
+
+    words.push_back("alpha");
+    words.push_back("");
+    words.push_back("gamma");
+    EXPECT_EQ(words.size(), 3);
+    EXPECT_EQ(words.char_count(), 10);
+    EXPECT_EQ(words.front(), "alpha");
+    EXPECT_EQ(words[1], "");
+    EXPECT_EQ(words.back(), "gamma");
+
+    // a string taken from the vector itself survives the growth it causes
+    for (int i = 0; i < 100; ++i)
+        words.push_back(words[0]);
+    EXPECT_EQ(words.back(), "alpha");
+
+    std::vector<std::string> more{"delta", "epsilon"};
+    words.append(more);
+    EXPECT_EQ(words.size(), 105);
+    EXPECT_EQ(words.back(), "epsilon");
+
+    words.pop_back();
+    EXPECT_EQ(words.back(), "delta");
+    EXPECT_EQ(words.char_count(), 10 + 500 + 5);
+
+    std::vector<std::string_view> seen(words.begin(), words.begin() + 3);
+    EXPECT_EQ(seen, (std::vector<std::string_view>{"alpha", "", "gamma"}));
+    EXPECT_EQ(std::ranges::count(words, "alpha"), 101);
+
+    words.clear();
+    EXPECT_TRUE(words.empty());
+    EXPECT_EQ(words.begin(), words.end());
+}
+
+TEST(StringVectorTests, prefixComparison)
+{
+    StringVector<std::uint64_t> words{"apple", "app", "application", "banana", "ap", "applesauce-extra"};
+
+    EXPECT_TRUE(words.starts_with(0, "app"));
+    EXPECT_FALSE(words.starts_with(4, "app"));
+    EXPECT_EQ(words.count_prefix("app"), 4);
+    EXPECT_EQ(words.count_prefix(""), 6);
+    EXPECT_EQ(words.count_prefix("applesauce"), 1);
+    EXPECT_EQ(words.count_prefix("b"), 1);
+
+    // compare agrees with std::string_view ordering, including past 8 bytes
+    for (std::size_t a = 0; a < words.size(); ++a)
+        for (std::size_t b = 0; b < words.size(); ++b)
+        {
+            int expected = words[a].compare(words[b]);
+            int actual = words.compare(a, b);
+            EXPECT_EQ(actual < 0, expected < 0);
+            EXPECT_EQ(actual > 0, expected > 0);
+        }
+
+    StringVector<> high{"\xff", "a"};
+    EXPECT_GT(high.compare(0, 1), 0);
+}
+
+TEST(StringVectorTests, serializeRoundTrip)
+{
+    StringVector<> words{"one", "two", "", "three"};
+
+    std::vector<std::uint64_t> storage((words.serialized_size() + 7) / 8);
+    std::span<std::byte> bytes(reinterpret_cast<std::byte *>(storage.data()), words.serialized_size());
+    words.serialize(bytes);
+
+    auto view = StringVectorView<>::from_bytes(bytes);
+    ASSERT_EQ(view.size(), 4);
+    EXPECT_EQ(view[0], "one");
+    EXPECT_EQ(view[2], "");
+    EXPECT_EQ(view.at(3), "three");
+    EXPECT_EQ(view.count_prefix("t"), 2);
+
+    // the view reads the buffer in place
+    EXPECT_GE(view[0].data(), reinterpret_cast<const char *>(bytes.data()));
+    EXPECT_LT(view[0].data(), reinterpret_cast<const char *>(bytes.data() + bytes.size()));
+
+    EXPECT_THROW(StringVectorView<std::uint64_t>::from_bytes(bytes), std::invalid_argument);
+    EXPECT_THROW(StringVectorView<>::from_bytes(bytes.first(40)), std::invalid_argument);
+    EXPECT_THROW(words.serialize(bytes.first(8)), std::invalid_argument);
+
+    std::stringstream stream;
+    words.write(stream);
+    auto copy = StringVector<>::read(stream);
+    ASSERT_EQ(copy.size(), words.size());
+    EXPECT_TRUE(std::ranges::equal(copy, words));
+
+    std::stringstream truncated(stream.str().substr(0, 40));
+    EXPECT_THROW(StringVector<>::read(truncated), std::runtime_error);
+}
+
+TEST(StringVectorTests, corruptHeaderSizes)
+{
+    StringVector<> words{"one", "two", "three"};
+    std::stringstream stream;
+    words.write(stream);
+    const std::string good = stream.str();
+
+    constexpr std::uint64_t huge = std::numeric_limits<std::uint64_t>::max();
+    // header words: magic, count, char_count, offset_bytes
+    for (auto [field, value] : {std::pair{1, huge}, {1, huge / 4}, {1, std::uint64_t{1} << 40},
+                                {2, huge}, {2, huge - 8}, {2, std::uint64_t{12}}})
+    {
+        std::string bad = good;
+        std::memcpy(bad.data() + 8 * field, &value, sizeof(value));
+
+        std::stringstream in(bad);
+        EXPECT_THROW(StringVector<>::read(in), std::runtime_error) << field << " " << value;
+
+        std::vector<std::uint64_t> storage((bad.size() + 7) / 8);
+        std::memcpy(storage.data(), bad.data(), bad.size());
+        std::span<const std::byte> bytes(reinterpret_cast<const std::byte *>(storage.data()), bad.size());
+        EXPECT_THROW(StringVectorView<>::from_bytes(bytes), std::invalid_argument) << field << " " << value;
+    }
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include "CustomVector.h"
+#include "VectorExpr.h"
+
+using namespace custom;
+
+namespace
+{
+    // counts every allocation, to check expressions create no temporaries
+    inline int allocations = 0;
+
+    template <class T>
+    struct CountingAllocator
+    {
+        using value_type = T;
+        using size_type = std::size_t;
+
+        CountingAllocator() = default;
+        template <class U>
+        CountingAllocator(const CountingAllocator<U> &) {}
+
+        T *allocate(std::size_t n)
+        {
+            ++allocations;
+            return std::allocator<T>().allocate(n);
+        }
+        void deallocate(T *block, std::size_t n) { std::allocator<T>().deallocate(block, n); }
+
+        template <class U>
+        bool operator==(const CountingAllocator<U> &) const { return true; }
+    };
+}
+
+//--------------------------------------------------------------------------------------------
+//---------------   expression template tests    ---------------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(VectorExprTests, fusedArithmeticWithoutTemporaries)
+{
+    using FloatVector = Vector<float, CountingAllocator<float>>;
+    FloatVector a{1, 2, 3, 4}, b{5, 6, 7, 8}, c{2, 2, 2, 2};
+    FloatVector dst(4);
+
+    allocations = 0;
+    dst = a + b * c - 1.f;
+    dst += a / 2.f;
+    dst -= -c;
+    EXPECT_EQ(allocations, 0);
+
+    for (size_t i = 0; i < 4; ++i)
+        EXPECT_FLOAT_EQ(dst[i], a[i] + b[i] * c[i] - 1.f + a[i] / 2.f + c[i]);
+
+    // a scalar takes the element type of the other operand
+    auto scaled = a * 2.0;
+    static_assert(std::is_same_v<decltype(scaled[0]), float>);
+
+    // the destination may be an operand
+    a = a * a + a;
+    EXPECT_FLOAT_EQ(a[3], 20.f);
+
+    // evaluating into an empty Vector allocates its storage once
+    allocations = 0;
+    FloatVector fresh = b - c;
+    EXPECT_EQ(allocations, 1);
+    EXPECT_EQ(fresh.size(), 4);
+    EXPECT_FLOAT_EQ(fresh[0], 3.f);
+}
+
+TEST(VectorExprTests, functionsMasksAndWhere)
+{
+    Vector<double> x{-4, -1, 0, 1, 4, 9};
+    Vector<double> out(6);
+
+    out = where(x > 0., sqrt(x), abs(x) * 10.);
+    EXPECT_DOUBLE_EQ(out[0], 40.);
+    EXPECT_DOUBLE_EQ(out[2], 0.);
+    EXPECT_DOUBLE_EQ(out[4], 2.);
+    EXPECT_DOUBLE_EQ(out[5], 3.);
+
+    out = where(x <= -1., 1., 0.);
+    EXPECT_DOUBLE_EQ(out[1], 1.);
+    EXPECT_DOUBLE_EQ(out[2], 0.);
+
+    out = exp(log(where(x >= 1., x, 1.)));
+    EXPECT_DOUBLE_EQ(out[0], 1.);
+    EXPECT_NEAR(out[5], 9., 1e-12);
+
+    Vector<int> counts{3, -2, 7};
+    Vector<int> clipped = where(counts < 0, 0, counts) * 2;
+    EXPECT_EQ(clipped[0], 6);
+    EXPECT_EQ(clipped[1], 0);
+    EXPECT_EQ(clipped[2], 14);
+
+    // == still compares whole containers elsewhere; masks come from < <= > >=
+    Vector<bool> mask = counts >= 3;
+    EXPECT_TRUE(mask[0]);
+    EXPECT_FALSE(mask[1]);
+}
+
+TEST(VectorExprTests, sizeMismatchThrows)
+{
+    Vector<float> a(3, 1.f), b(4, 1.f);
+
+    EXPECT_THROW(a + b, std::invalid_argument);
+    EXPECT_THROW(where(a > 0.f, a, b), std::invalid_argument);
+    EXPECT_THROW(a += b, std::invalid_argument);
+
+    // the destination is resized to the expression
+    b = a * 3.f;
+    EXPECT_EQ(b.size(), 3);
+    EXPECT_FLOAT_EQ(b[2], 3.f);
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include "CustomVector.h"
+
+using namespace custom;
+
+namespace
+{
+    // padding-free, but == ignores the revision, so its bytes must not be hashed
+    struct Tagged
+    {
+        std::uint32_t id;
+        std::uint32_t revision;
+
+        bool operator==(const Tagged &other) const { return id == other.id; }
+    };
+
+    // == compares every member, so it opts into the byte hash
+    struct Point
+    {
+        using is_byte_hashable = std::true_type;
+
+        std::int32_t x;
+        std::int32_t y;
+
+        bool operator==(const Point &) const = default;
+    };
+}
+
+template <>
+struct std::hash<Tagged>
+{
+    std::size_t operator()(const Tagged &t) const noexcept { return t.id; }
+};
+
+//--------------------------------------------------------------------------------------------
+//--------------------------------   vector hash tests    ------------------------------------
+//--------------------------------------------------------------------------------------------
+
+TEST(VectorHashTests, equalVectorsHashEqual)
+{
+    Vector<std::uint32_t> a(1000);
+    std::iota(a.data(), a.data() + a.size(), 0u);
+    Vector<std::uint32_t> b = a;
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(hash(a), hash(b));
+    EXPECT_EQ(std::hash<Vector<std::uint32_t>>{}(a), hash(a));
+    EXPECT_NE(hash(a, 1), hash(a));
+
+    // a change anywhere, including the overlapped tail, changes the hash
+    std::unordered_set<std::uint64_t> seen{hash(a)};
+    for (std::size_t i : {std::size_t{0}, std::size_t{17}, std::size_t{500}, std::size_t{998}, std::size_t{999}})
+    {
+        b = a;
+        b[i] ^= 1;
+        EXPECT_NE(a, b);
+        EXPECT_TRUE(seen.insert(hash(b)).second);
+    }
+
+    // every length of a prefix hashes differently
+    for (std::size_t n = 0; n < 300; ++n)
+    {
+        Vector<std::uint32_t> prefix(a.data(), a.data() + n);
+        EXPECT_TRUE(seen.insert(hash(prefix)).second) << n;
+    }
+
+    // swapping two 64-byte stripes changes the hash
+    b = a;
+    std::swap_ranges(b.data(), b.data() + 16, b.data() + 16);
+    EXPECT_NE(hash(a), hash(b));
+}
+
+TEST(VectorHashTests, simdMatchesScalar)
+{
+    std::mt19937_64 gen(5);
+    Vector<std::uint64_t> words(1 << 12);
+    for (std::size_t i = 0; i < words.size(); ++i)
+        words.data()[i] = gen();
+
+    const char *bytes = reinterpret_cast<const char *>(words.data());
+    // hash_long takes more than 64 bytes; start at odd offsets too
+    for (std::size_t len = 65; len + 8 <= words.size() * 8; len += len < 3000 ? 1 : 997)
+    {
+        EXPECT_EQ(detail::hash_long<detail::Simd_Stripes>(bytes + len % 8, len, 42),
+                  detail::hash_long<detail::Scalar_Stripes>(bytes + len % 8, len, 42))
+            << len;
+    }
+}
+
+TEST(VectorHashTests, elementwiseFallback)
+{
+    Vector<std::string> a{"alpha", "beta", "gamma"};
+    Vector<std::string> b{"alpha", "beta", "gamma"};
+    EXPECT_EQ(hash(a), hash(b));
+    b[2] = "delta";
+    EXPECT_NE(hash(a), hash(b));
+    EXPECT_NE(hash(Vector<std::string>{"ab", "c"}), hash(Vector<std::string>{"a", "bc"}));
+
+    // floating point goes through std::hash, so -0.0 and 0.0 agree as == does
+    Vector<double> zero{0.0, 1.5};
+    Vector<double> negative_zero{-0.0, 1.5};
+    EXPECT_EQ(zero, negative_zero);
+    EXPECT_EQ(hash(zero), hash(negative_zero));
+
+    // an element hash equal to the combine key does not erase the state before it
+    EXPECT_NE(detail::hash_combine(1, detail::hash_key[2]), detail::hash_combine(2, detail::hash_key[2]));
+    EXPECT_NE(detail::hash_combine(detail::hash_key[1], 1), detail::hash_combine(detail::hash_key[1], 2));
+
+    EXPECT_NE(hash(Vector<int>{}), hash(Vector<int>{0}));
+    EXPECT_NE(hash(Vector<std::string>{}), hash(Vector<std::string>{""}));
+}
+
+TEST(VectorHashTests, keysUnorderedMap)
+{
+    std::unordered_map<Vector<int>, int> results;
+    for (int n = 0; n < 200; ++n)
+    {
+        Vector<int> key(n);
+        std::iota(key.begin(), key.end(), n);
+        results.emplace(std::move(key), n);
+    }
+
+    Vector<int> query(50);
+    std::iota(query.begin(), query.end(), 50);
+    auto found = results.find(query);
+    ASSERT_NE(found, results.end());
+    EXPECT_EQ(found->second, 50);
+
+    query.push_back(0);
+    EXPECT_EQ(results.find(query), results.end());
+
+    std::unordered_set<Vector<Vector<int>>> nested;
+    nested.insert(Vector<Vector<int>>{{1, 2}, {3}});
+    EXPECT_TRUE(nested.contains(Vector<Vector<int>>{{1, 2}, {3}}));
+    EXPECT_FALSE(nested.contains(Vector<Vector<int>>{{1}, {2, 3}}));
+}
+
+TEST(VectorHashTests, byteHashOnlyWhenOptedIn)
+{
+    static_assert(detail::byte_hashable<std::uint64_t>);
+    static_assert(detail::byte_hashable<Point>);
+    static_assert(!detail::byte_hashable<Tagged>);
+
+    Vector<Tagged> a{{1, 0}, {2, 0}};
+    Vector<Tagged> b{{1, 7}, {2, 9}};
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(hash(a), hash(b));
+
+    Vector<Tagged> tags{{3, 0}, {1, 0}, {3, 1}, {1, 2}, {5, 0}};
+    EXPECT_EQ(tags.unique_unsorted(), 2);
+    ASSERT_EQ(tags.size(), 3);
+    EXPECT_EQ(tags[0].revision, 0);
+    EXPECT_EQ(tags[2].id, 5);
+
+    Vector<Point> points{{1, 2}, {3, 4}, {1, 2}};
+    EXPECT_EQ(hash(points), detail::hash_bytes(points.data(), points.size() * sizeof(Point)));
+    EXPECT_EQ(points.unique_unsorted(), 1);
+}